@@ -0,0 +1,115 @@
+#include "pihm.h"
+
+void BenchmarkRhs(pihm_struct pihm, void *cvode_mem, N_Vector CV_Y, int nrhs)
+{
+    int             i;
+    int             t;
+    int             cv_flag;
+    double          elapsed;
+    double          rhs_elapsed;
+    realtype        solvert;
+    N_Vector        dy;
+#if defined(_OPENMP)
+    double          start_omp;
+#else
+    clock_t         start;
+#endif
+
+    t = pihm->ctrl.starttime;
+
+    dy = N_VNew(NumStateVar());
+    if (dy == NULL)
+    {
+        PIHMprintf(VL_ERROR, "Error creating RHS vector.\n");
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    FirstTouch(dy);
+
+    /*
+     * Set up hydrology step inputs at model start time the same way a model
+     * step does
+     */
+    ApplyBc(&pihm->forc, pihm->river, t);
+
+#if defined(_NOAH_)
+    ApplyForc(&pihm->forc, pihm->elem, t, pihm->ctrl.rad_mode,
+        &pihm->siteinfo);
+    Noah(pihm->elem, (double)pihm->ctrl.etstep);
+#else
+    ApplyForc(&pihm->forc, pihm->elem, t);
+    IntcpSnowEt(t, (double)pihm->ctrl.etstep, pihm->elem, &pihm->cal);
+#endif
+
+    ElemToHydro(pihm->elem, pihm->river, &pihm->hydro);
+
+    /* Warm up caches */
+    ODE(0.0, CV_Y, dy, pihm);
+
+#if defined(_OPENMP)
+    start_omp = omp_get_wtime();
+#else
+    start = clock();
+#endif
+
+    for (i = 0; i < nrhs; i++)
+    {
+        ODE(0.0, CV_Y, dy, pihm);
+    }
+
+#if defined(_OPENMP)
+    elapsed = omp_get_wtime() - start_omp;
+#else
+    elapsed = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+#endif
+
+    PIHMprintf(VL_NORMAL, "%d RHS evaluations in %.3lf s (%d elements, "
+        "%d river segments).\n", nrhs, elapsed, nelem, nriver);
+    PIHMprintf(VL_NORMAL, "%.1lf RHS evaluations per second.\n",
+        (elapsed > 0.0) ? (double)nrhs / elapsed : 0.0);
+
+    /*
+     * Integrate the hydrology ODE over one land surface step to split the
+     * solver time into RHS evaluations and CVODE internals (vector operations
+     * and linear solver)
+     */
+    pihm->rhstime.nrhs = 0;
+    pihm->rhstime.elapsed = 0.0;
+
+#if defined(_OPENMP)
+    start_omp = omp_get_wtime();
+#else
+    start = clock();
+#endif
+
+    cv_flag = CVodeSetStopTime(cvode_mem, (realtype)pihm->ctrl.etstep);
+    if (!CheckCVodeFlag(cv_flag))
+    {
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    cv_flag = CVode(cvode_mem, (realtype)pihm->ctrl.etstep, CV_Y, &solvert,
+        CV_NORMAL);
+    if (!CheckCVodeFlag(cv_flag))
+    {
+        PIHMexit(EXIT_FAILURE);
+    }
+
+#if defined(_OPENMP)
+    elapsed = omp_get_wtime() - start_omp;
+#else
+    elapsed = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+#endif
+    rhs_elapsed = pihm->rhstime.elapsed;
+
+    PIHMprintf(VL_NORMAL, "CVODE solution of %d s in %.3lf s "
+        "(%ld RHS evaluations):\n", pihm->ctrl.etstep, elapsed,
+        pihm->rhstime.nrhs);
+    PIHMprintf(VL_NORMAL, "  RHS evaluations  %.3lf s (%.1lf%%)\n",
+        rhs_elapsed, (elapsed > 0.0) ? 100.0 * rhs_elapsed / elapsed : 0.0);
+    PIHMprintf(VL_NORMAL, "  CVODE internals  %.3lf s (%.1lf%%)\n",
+        elapsed - rhs_elapsed,
+        (elapsed > 0.0) ? 100.0 * (elapsed - rhs_elapsed) / elapsed : 0.0);
+
+    N_VDestroy(dy);
+}
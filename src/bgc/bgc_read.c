@@ -526,15 +526,15 @@ void ReadAnnFile(tsdata_struct *ts, const char *fn)
     PIHMprintf(VL_VERBOSE, " Reading %s\n", fn);
 
     ts->length = CountLine(fid, cmdstr, 1, "EOF");
+    ts->cursor = 0;
     ts->ftime = (int *)malloc(ts->length * sizeof(int));
-    ts->data = (double **)malloc(ts->length * sizeof(double *));
+    ts->data = (double *)malloc(ts->length * sizeof(double));
 
     FindLine(fid, "BOF", &lno, fn);
     for (i = 0; i < ts->length; i++)
     {
-        ts->data[i] = (double *)malloc(sizeof(double));
         NextLine(fid, cmdstr, &lno);
-        match = sscanf(cmdstr, "%s %lf", timestr, &ts->data[i][0]);
+        match = sscanf(cmdstr, "%s %lf", timestr, &ts->data[i]);
 
         if (match != 2)
         {
@@ -170,19 +170,49 @@ void ReadBgcIc(const char *fn, elem_struct *elem, river_struct *river)
 {
     FILE           *init_file;
     int             i;
+#if !defined(_LUMPED_)
+    bgcic_struct   *ic;
+#endif
+#if !defined(_LUMPED_) && !defined(_LEACHING_)
+    river_bgcic_struct *river_ic;
+#endif
 
     init_file = fopen(fn, "rb");
     CheckFile(init_file, fn);
     PIHMprintf(VL_VERBOSE, " Reading %s\n", fn);
 
+#if defined(_LUMPED_)
+    if (fread(&elem[LUMPED].restart_input, sizeof(bgcic_struct), 1,
+        init_file) != 1)
+    {
+        PIHMprintf(VL_ERROR, "Error reading %s.\n", fn);
+        PIHMexit(EXIT_FAILURE);
+    }
+#else
+    /* Initial conditions are stored in the order of element and river ids
+     * in the input files, which may differ from the model order */
+    ic = (bgcic_struct *)malloc(nelem * sizeof(bgcic_struct));
+
+    if (fread(ic, sizeof(bgcic_struct), nelem, init_file) != (size_t)nelem)
+    {
+        PIHMprintf(VL_ERROR, "Error reading %s.\n", fn);
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < nelem; i++)
+    {
+        elem[i].restart_input = ic[elem[i].ind - 1];
+    }
+
+    free(ic);
+#endif
+
 #if defined(_LUMPED_)
     i = LUMPED;
 #else
     for (i = 0; i < nelem; i++)
 #endif
     {
-        fread(&elem[i].restart_input, sizeof(bgcic_struct), 1, init_file);
-
         /* If simulation is accelerated spinup, adjust soil C pool sizes if
          * needed */
         if (spinup_mode == ACC_SPINUP_MODE)
@@ -200,11 +230,22 @@ void ReadBgcIc(const char *fn, elem_struct *elem, river_struct *river)
     }
 
 #if !defined(_LUMPED_) && !defined(_LEACHING_)
+    river_ic = (river_bgcic_struct *)malloc(nriver *
+        sizeof(river_bgcic_struct));
+
+    if (fread(river_ic, sizeof(river_bgcic_struct), nriver, init_file) !=
+        (size_t)nriver)
+    {
+        PIHMprintf(VL_ERROR, "Error reading %s.\n", fn);
+        PIHMexit(EXIT_FAILURE);
+    }
+
     for (i = 0; i < nriver; i++)
     {
-        fread(&river[i].restart_input, sizeof(river_bgcic_struct), 1,
-            init_file);
+        river[i].restart_input = river_ic[river[i].ind - 1];
     }
+
+    free(river_ic);
 #endif
 
     fclose(init_file);
@@ -215,6 +256,12 @@ void WriteBgcIc(const char *outputdir, elem_struct *elem, river_struct *river)
     int             i;
     FILE           *restart_file;
     char            restart_fn[MAXSTRING];
+#if !defined(_LUMPED_)
+    bgcic_struct   *ic;
+#endif
+#if !defined(_LUMPED_) && !defined(_LEACHING_)
+    river_bgcic_struct *river_ic;
+#endif
 
     sprintf(restart_fn, "%s/restart/%s.bgcic", outputdir, project);
 
@@ -246,19 +293,55 @@ void WriteBgcIc(const char *outputdir, elem_struct *elem, river_struct *river)
             elem[i].restart_output.soil4n *= KS4_ACC;
         }
 
-        fwrite(&(elem[i].restart_output), sizeof(bgcic_struct), 1,
-            restart_file);
     }
 
+#if defined(_LUMPED_)
+    if (fwrite(&elem[LUMPED].restart_output, sizeof(bgcic_struct), 1,
+        restart_file) != 1)
+    {
+        PIHMprintf(VL_ERROR, "Error writing %s.\n", restart_fn);
+        PIHMexit(EXIT_FAILURE);
+    }
+#else
+    /* Restart files are written in the order of element and river ids in the
+     * input files, which may differ from the model order */
+    ic = (bgcic_struct *)malloc(nelem * sizeof(bgcic_struct));
+
+    for (i = 0; i < nelem; i++)
+    {
+        ic[elem[i].ind - 1] = elem[i].restart_output;
+    }
+
+    if (fwrite(ic, sizeof(bgcic_struct), nelem, restart_file) !=
+        (size_t)nelem)
+    {
+        PIHMprintf(VL_ERROR, "Error writing %s.\n", restart_fn);
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    free(ic);
+#endif
+
 #if !defined(_LUMPED_) && !defined(_LEACHING_)
+    river_ic = (river_bgcic_struct *)malloc(nriver *
+        sizeof(river_bgcic_struct));
+
     for (i = 0; i < nriver; i++)
     {
         river[i].restart_output.streamn = river[i].ns.streamn;
         river[i].restart_output.sminn = river[i].ns.sminn;
 
-        fwrite(&(river[i].restart_output), sizeof(river_bgcic_struct), 1,
-            restart_file);
+        river_ic[river[i].ind - 1] = river[i].restart_output;
     }
+
+    if (fwrite(river_ic, sizeof(river_bgcic_struct), nriver, restart_file) !=
+        (size_t)nriver)
+    {
+        PIHMprintf(VL_ERROR, "Error writing %s.\n", restart_fn);
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    free(river_ic);
 #endif
 
     fclose(restart_file);
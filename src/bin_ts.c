@@ -0,0 +1,225 @@
+#include "pihm.h"
+
+int ReadBinTs(const char *filename, int nvrbl, int *nts, tsdata_struct **ts,
+    tsmap_struct *map)
+{
+    /*
+     * Map binary time series file (filename.bin) into memory if it exists
+     * and is not older than the text file. Forcing times and values are
+     * used in place without copying. The file is mapped privately so that
+     * pages are shared by all model runs using the same file unless they are
+     * modified (e.g., by climate scenarios). Returns 0 if the text file should be read
+     */
+#if !defined(_WIN32) && !defined(_WIN64)
+    char            binfn[MAXSTRING];
+    struct stat     txt_st;
+    struct stat     bin_st;
+    int             fd;
+    int             i;
+    char           *addr;
+    bintshdr_struct *hdr;
+    bintsdir_struct *dir;
+
+    map->addr = NULL;
+    map->size = 0;
+
+    sprintf(binfn, "%s.bin", filename);
+
+    if (convert_mode || stat(binfn, &bin_st) != 0)
+    {
+        return 0;
+    }
+
+    if (stat(filename, &txt_st) == 0 && txt_st.st_mtime > bin_st.st_mtime)
+    {
+        PIHMprintf(VL_NORMAL, "Warning: %s is older than %s and is not used.\n",
+            binfn, filename);
+        return 0;
+    }
+
+    PIHMprintf(VL_VERBOSE, " Reading %s\n", binfn);
+
+    fd = open(binfn, O_RDONLY);
+    if (fd < 0)
+    {
+        PIHMprintf(VL_ERROR, "Error opening %s.\n", binfn);
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    addr = (char *)mmap(NULL, (size_t)bin_st.st_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE, fd, 0);
+    close(fd);
+    if ((void *)addr == MAP_FAILED)
+    {
+        PIHMprintf(VL_ERROR, "Error mapping %s into memory.\n", binfn);
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    map->addr = addr;
+    map->size = (size_t)bin_st.st_size;
+
+    /* Check header */
+    hdr = (bintshdr_struct *)addr;
+    if (map->size < sizeof(bintshdr_struct) ||
+        strncmp(hdr->magic, BINTS_MAGIC, sizeof(hdr->magic)) != 0 ||
+        hdr->version != BINTS_VERSION || hdr->nvrbl != nvrbl || hdr->nts < 0 ||
+        map->size < sizeof(bintshdr_struct) +
+        (size_t)hdr->nts * sizeof(bintsdir_struct))
+    {
+        PIHMprintf(VL_ERROR, "Error: %s is not a valid binary time series "
+            "file with %d variable(s).\n", binfn, nvrbl);
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    dir = (bintsdir_struct *)(addr + sizeof(bintshdr_struct));
+
+    *nts = hdr->nts;
+    *ts = (tsdata_struct *)malloc(*nts * sizeof(tsdata_struct));
+
+    for (i = 0; i < *nts; i++)
+    {
+        if (dir[i].length < 0 || dir[i].ftime_offset < 0 ||
+            dir[i].data_offset < 0 ||
+            (size_t)dir[i].ftime_offset +
+            (size_t)dir[i].length * sizeof(int32_t) > map->size ||
+            (size_t)dir[i].data_offset +
+            (size_t)dir[i].length * nvrbl * sizeof(double) > map->size)
+        {
+            PIHMprintf(VL_ERROR,
+                "Error reading the %dth time series in %s.\n", i + 1, binfn);
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        (*ts)[i].length = (int)dir[i].length;
+        (*ts)[i].cursor = 0;
+        (*ts)[i].zlvl_wind = dir[i].zlvl_wind;
+        (*ts)[i].ftime = (int *)(addr + dir[i].ftime_offset);
+        (*ts)[i].data = (double *)(addr + dir[i].data_offset);
+    }
+
+    return 1;
+#else
+    /* Binary time series files are not mapped on Windows */
+    map->addr = NULL;
+    map->size = 0;
+
+    return 0;
+#endif
+}
+
+void WriteBinTs(const char *filename, int nvrbl, int nts,
+    const tsdata_struct *ts)
+{
+    /*
+     * Write time series to binary time series file (filename.bin). The file
+     * is written to a temporary file first, and then renamed, so that model
+     * runs that have mapped the old file are not affected
+     */
+    char            binfn[MAXSTRING];
+    char            tmpfn[MAXSTRING];
+    FILE           *fp;
+    bintshdr_struct hdr;
+    bintsdir_struct dir;
+    int64_t         offset;
+    int32_t         ftime;
+    int             i, j;
+    const char      pad[8] = {0};
+
+    sprintf(binfn, "%s.bin", filename);
+    sprintf(tmpfn, "%s.bin.tmp", filename);
+
+    fp = fopen(tmpfn, "wb");
+    CheckFile(fp, tmpfn);
+    PIHMprintf(VL_VERBOSE, " Writing %s\n", binfn);
+
+    memset(&hdr, 0, sizeof(bintshdr_struct));
+    strncpy(hdr.magic, BINTS_MAGIC, sizeof(hdr.magic));
+    hdr.version = BINTS_VERSION;
+    hdr.nts = nts;
+    hdr.nvrbl = nvrbl;
+    fwrite(&hdr, sizeof(bintshdr_struct), 1, fp);
+
+    /* Directory. Forcing times of each time series are padded to 8 bytes so
+     * that forcing values are aligned */
+    offset = sizeof(bintshdr_struct) + nts * sizeof(bintsdir_struct);
+    for (i = 0; i < nts; i++)
+    {
+        memset(&dir, 0, sizeof(bintsdir_struct));
+        dir.length = ts[i].length;
+        /* Only meteorological forcing has wind observation height */
+        dir.zlvl_wind = (nvrbl == NUM_METEO_VAR) ? ts[i].zlvl_wind : 0.0;
+        dir.ftime_offset = offset;
+        offset += (ts[i].length * sizeof(int32_t) + 7) / 8 * 8;
+        dir.data_offset = offset;
+        offset += ts[i].length * nvrbl * sizeof(double);
+        fwrite(&dir, sizeof(bintsdir_struct), 1, fp);
+    }
+
+    for (i = 0; i < nts; i++)
+    {
+        for (j = 0; j < ts[i].length; j++)
+        {
+            ftime = (int32_t)ts[i].ftime[j];
+            fwrite(&ftime, sizeof(int32_t), 1, fp);
+        }
+        fwrite(pad, 1, (8 - ts[i].length * sizeof(int32_t) % 8) % 8, fp);
+
+        fwrite(ts[i].data, sizeof(double), ts[i].length * nvrbl, fp);
+    }
+
+    if (ferror(fp) || fclose(fp) != 0)
+    {
+        PIHMprintf(VL_ERROR, "Error writing %s.\n", tmpfn);
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    if (rename(tmpfn, binfn) != 0)
+    {
+        PIHMprintf(VL_ERROR, "Error renaming %s to %s.\n", tmpfn, binfn);
+        PIHMexit(EXIT_FAILURE);
+    }
+}
+
+void WriteBinForc(pihm_struct pihm)
+{
+    /*
+     * Convert time series input files to binary time series files
+     */
+    PIHMprintf(VL_NORMAL, "Converting time series input files to binary.\n");
+
+    WriteBinTs(pihm->filename.meteo, NUM_METEO_VAR, pihm->forc.nmeteo,
+        pihm->forc.meteo);
+
+    if (pihm->forc.nlai > 0)
+    {
+        WriteBinTs(pihm->filename.lai, 1, pihm->forc.nlai, pihm->forc.lai);
+    }
+
+    if (pihm->forc.nbc > 0)
+    {
+        WriteBinTs(pihm->filename.bc, 1, pihm->forc.nbc, pihm->forc.bc);
+    }
+
+#if defined(_NOAH_)
+    if (pihm->ctrl.rad_mode == TOPO_SOL)
+    {
+        WriteBinTs(pihm->filename.rad, 2, pihm->forc.nrad, pihm->forc.rad);
+    }
+#endif
+}
+
+void FreeBinTs(int nts, tsdata_struct *ts, tsmap_struct *map)
+{
+    int             i;
+
+    for (i = 0; i < nts; i++)
+    {
+        free(ts[i].value);
+    }
+    free(ts);
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    munmap(map->addr, map->size);
+#endif
+    map->addr = NULL;
+}
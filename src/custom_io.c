@@ -2,8 +2,345 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <setjmp.h>
+#if !defined(_WIN32) && !defined(_WIN64)
+# include <pthread.h>
+#endif
+#if defined(_OPENMP)
+# include <omp.h>
+#endif
 #include "custom_io.h"
 
+/* Return point of the library call in progress (NULL outside library calls).
+ * Errors in the thread of the call return to the caller of the library
+ * instead of terminating the process */
+jmp_buf        *exit_env = NULL;
+#if !defined(_WIN32) && !defined(_WIN64)
+pthread_t       exit_thread;
+#endif
+
+/* Heap blocks allocated and files opened in the thread of a library call that
+ * creates or initializes a model are tracked in a hash table. If the call
+ * fails, they are freed (closed), because partially initialized model
+ * structures cannot be freed by the cleanup functions of the model */
+int             tracking = 0;
+void          **track_ptr = NULL;
+int            *track_type = NULL;
+size_t          track_size = 0;
+size_t          track_used = 0;
+#if !defined(_WIN32) && !defined(_WIN64)
+pthread_mutex_t track_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+#if defined(_DEBUG_)
+static long int alloc_count = 0;
+#endif
+
+/* Allocation wrappers. Parenthesized function names are not expanded by the
+ * allocation macros */
+void *_custom_calloc(size_t num, size_t size)
+{
+    void           *ptr;
+
+#if defined(_DEBUG_)
+# if defined(_OPENMP)
+#  pragma omp atomic
+# endif
+    alloc_count++;
+#endif
+
+    ptr = (calloc)(num, size);
+
+    if (tracking && ptr != NULL && TrackedThread())
+    {
+        TrackPtr(ptr, TRACK_HEAP);
+    }
+
+    return ptr;
+}
+
+void *_custom_malloc(size_t size)
+{
+    void           *ptr;
+
+#if defined(_DEBUG_)
+# if defined(_OPENMP)
+#  pragma omp atomic
+# endif
+    alloc_count++;
+#endif
+
+    ptr = (malloc)(size);
+
+    if (tracking && ptr != NULL && TrackedThread())
+    {
+        TrackPtr(ptr, TRACK_HEAP);
+    }
+
+    return ptr;
+}
+
+void *_custom_realloc(void *ptr, size_t size)
+{
+    /*
+     * Blocks allocated before tracking started remain untracked when they
+     * are reallocated
+     */
+    void           *new_ptr;
+    int             tracked = 0;
+
+#if defined(_DEBUG_)
+# if defined(_OPENMP)
+#  pragma omp atomic
+# endif
+    alloc_count++;
+#endif
+
+    if (tracking)
+    {
+        tracked = (ptr != NULL) ? UntrackPtr(ptr) : TrackedThread();
+    }
+
+    new_ptr = (realloc)(ptr, size);
+
+    if (tracked)
+    {
+        if (new_ptr != NULL)
+        {
+            TrackPtr(new_ptr, TRACK_HEAP);
+        }
+        else if (ptr != NULL)
+        {
+            TrackPtr(ptr, TRACK_HEAP);
+        }
+    }
+
+    return new_ptr;
+}
+
+void _custom_free(void *ptr)
+{
+    if (tracking && ptr != NULL)
+    {
+        UntrackPtr(ptr);
+    }
+
+    (free)(ptr);
+}
+
+FILE *_custom_fopen(const char *fn, const char *mode)
+{
+    FILE           *fp;
+
+    fp = (fopen)(fn, mode);
+
+    if (tracking && fp != NULL && TrackedThread())
+    {
+        TrackPtr(fp, TRACK_FILE);
+    }
+
+    return fp;
+}
+
+int _custom_fclose(FILE *fp)
+{
+    if (tracking && fp != NULL)
+    {
+        UntrackPtr(fp);
+    }
+
+    return (fclose)(fp);
+}
+
+#if defined(_DEBUG_)
+long int AllocCount(void)
+{
+    long int        count;
+
+# if defined(_OPENMP)
+#  pragma omp atomic read
+# endif
+    count = alloc_count;
+
+    return count;
+}
+#endif
+
+void StartTracking(void)
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&track_mutex);
+#endif
+    track_size = TRACK_INIT_SIZE;
+    track_used = 0;
+    track_ptr = (void **)(calloc)(track_size, sizeof(void *));
+    track_type = (int *)(calloc)(track_size, sizeof(int));
+    tracking = (track_ptr != NULL && track_type != NULL);
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_unlock(&track_mutex);
+#endif
+}
+
+void StopTracking(int release)
+{
+    /*
+     * Stop tracking. If release is true, tracked blocks are freed and tracked
+     * files are closed
+     */
+    size_t          i;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&track_mutex);
+#endif
+    for (i = 0; release && tracking && i < track_size; i++)
+    {
+        if (track_type[i] == TRACK_HEAP)
+        {
+            (free)(track_ptr[i]);
+        }
+        else if (track_type[i] == TRACK_FILE)
+        {
+            (fclose)((FILE *)track_ptr[i]);
+        }
+    }
+
+    (free)(track_ptr);
+    (free)(track_type);
+    track_ptr = NULL;
+    track_type = NULL;
+    track_size = 0;
+    track_used = 0;
+    tracking = 0;
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_unlock(&track_mutex);
+#endif
+}
+
+int TrackedThread(void)
+{
+    /*
+     * Allocations are tracked in the thread of the library call, including
+     * OpenMP parallel regions, but not in background threads of models
+     */
+#if defined(_OPENMP)
+    if (omp_in_parallel())
+    {
+        return 1;
+    }
+#endif
+#if !defined(_WIN32) && !defined(_WIN64)
+    return pthread_equal(pthread_self(), exit_thread);
+#else
+    return 1;
+#endif
+}
+
+size_t TrackSlot(const void *ptr)
+{
+    /*
+     * Find the slot of ptr in the hash table using linear probing, or the
+     * empty slot where ptr would be inserted
+     */
+    size_t          i;
+
+    i = (((size_t)ptr >> 4) * 2654435761u) & (track_size - 1);
+    while (track_type[i] != TRACK_EMPTY && track_ptr[i] != ptr)
+    {
+        i = (i + 1) & (track_size - 1);
+    }
+
+    return i;
+}
+
+void TrackPtr(void *ptr, int type)
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&track_mutex);
+#endif
+    if (tracking)
+    {
+        size_t          i;
+
+        if (2 * (track_used + 1) > track_size)
+        {
+            /* Grow the table, which also discards deleted slots */
+            void          **old_ptr;
+            int            *old_type;
+            size_t          old_size;
+
+            old_ptr = track_ptr;
+            old_type = track_type;
+            old_size = track_size;
+
+            track_size *= 2;
+            track_used = 0;
+            track_ptr = (void **)(calloc)(track_size, sizeof(void *));
+            track_type = (int *)(calloc)(track_size, sizeof(int));
+            if (track_ptr == NULL || track_type == NULL)
+            {
+                fprintf(stderr, "Error allocating memory.\n");
+                exit(EXIT_FAILURE);
+            }
+
+            for (i = 0; i < old_size; i++)
+            {
+                if (old_type[i] > TRACK_EMPTY)
+                {
+                    size_t          j;
+
+                    j = TrackSlot(old_ptr[i]);
+                    track_ptr[j] = old_ptr[i];
+                    track_type[j] = old_type[i];
+                    track_used++;
+                }
+            }
+
+            (free)(old_ptr);
+            (free)(old_type);
+        }
+
+        i = TrackSlot(ptr);
+        if (track_type[i] == TRACK_EMPTY)
+        {
+            track_used++;
+        }
+        track_ptr[i] = ptr;
+        track_type[i] = type;
+    }
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_unlock(&track_mutex);
+#endif
+}
+
+int UntrackPtr(const void *ptr)
+{
+    /*
+     * Remove ptr from the hash table. Returns 1 if ptr is tracked. Deleted
+     * slots are kept to continue probing
+     */
+    int             found = 0;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&track_mutex);
+#endif
+    if (tracking)
+    {
+        size_t          i;
+
+        i = TrackSlot(ptr);
+        if (track_type[i] > TRACK_EMPTY)
+        {
+            track_type[i] = TRACK_DELETED;
+            found = 1;
+        }
+    }
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_unlock(&track_mutex);
+#endif
+
+    return found;
+}
+
 void _custom_exit(const char *fn, int lineno, const char *func, int debug,
     int error)
 {
@@ -17,11 +354,42 @@ void _custom_exit(const char *fn, int lineno, const char *func, int debug,
         }
         fprintf(stderr, "...\n\n");
         fflush(stderr);
+
+        if (ErrorReturns())
+        {
+            longjmp(*exit_env, error);
+        }
     }
 
     exit(error);
 }
 
+int ErrorReturns(void)
+{
+    /*
+     * Errors return to the caller of the library only from the thread that
+     * made the library call, and not from inside OpenMP parallel regions
+     */
+    if (exit_env == NULL)
+    {
+        return 0;
+    }
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (!pthread_equal(pthread_self(), exit_thread))
+    {
+        return 0;
+    }
+#endif
+#if defined(_OPENMP)
+    if (omp_in_parallel())
+    {
+        return 0;
+    }
+#endif
+
+    return 1;
+}
+
 void _custom_printf(const char *fn, int lineno, const char *func, int debug,
     int model_verbosity, int verbosity, const char *fmt, ...)
 {
@@ -59,6 +427,10 @@ void CheckFile(const FILE *fp, const char *fn)
     {
         fprintf(stderr, "Error opening %s.\n", fn);
         fflush(stderr);
+        if (ErrorReturns())
+        {
+            longjmp(*exit_env, EXIT_FAILURE);
+        }
         exit(EXIT_FAILURE);
     }
 }
@@ -186,6 +558,10 @@ void FindLine(FILE *fp, const char *token, int *lno, const char *filename)
         fprintf(stderr, "Cannot find required keyword %s.\n", token);
         fprintf(stderr, "Error reading %s.\n", filename);
         fflush(stderr);
+        if (ErrorReturns())
+        {
+            longjmp(*exit_env, EXIT_FAILURE);
+        }
         exit(EXIT_FAILURE);
     }
 }
@@ -0,0 +1,48 @@
+#include "pihm.h"
+
+int NextCplEvent(const ctrl_struct *ctrl, const forc_struct *forc, int t)
+{
+    /*
+     * Find the next coupling event after model time t, i.e., the next model
+     * step at which hydrology inputs may change. Inputs are applied at the
+     * beginning of model steps, so a change after time tchg takes effect at
+     * the first model step after tchg
+     */
+    int             tevent;
+    int             tchg;
+    int             k;
+
+    /* End of simulation */
+    tevent = ctrl->endtime;
+
+    /* Meteorological and LAI forcing, and land surface processes */
+    tchg = ctrl->starttime +
+        ((t - ctrl->starttime) / ctrl->etstep + 1) * ctrl->etstep;
+    tevent = (tchg < tevent) ? tchg : tevent;
+
+#if defined(_DAILY_)
+    /* Daily BGC and Cycles processes */
+    tchg = ctrl->starttime +
+        ((t - ctrl->starttime) / DAYINSEC + 1) * DAYINSEC;
+    tevent = (tchg < tevent) ? tchg : tevent;
+#endif
+
+    /* Boundary conditions */
+    for (k = 0; k < forc->nbc; k++)
+    {
+        tchg = NextForcChange(&forc->bc[k], 1, t);
+        tchg = ctrl->starttime +
+            ((tchg - ctrl->starttime) / ctrl->stepsize + 1) * ctrl->stepsize;
+        tevent = (tchg < tevent) ? tchg : tevent;
+    }
+
+    for (k = 0; k < forc->nriverbc; k++)
+    {
+        tchg = NextForcChange(&forc->riverbc[k], 1, t);
+        tchg = ctrl->starttime +
+            ((tchg - ctrl->starttime) / ctrl->stepsize + 1) * ctrl->stepsize;
+        tevent = (tchg < tevent) ? tchg : tevent;
+    }
+
+    return tevent;
+}
@@ -3,16 +3,12 @@
 void ReadBedrock(const char *filename, atttbl_struct *atttbl,
     meshtbl_struct *meshtbl, ctrl_struct *ctrl)
 {
-    FILE           *br_file;
+    txtfile_struct  txt;
     int             i;
-    char            cmdstr[MAXSTRING];
-    int             match;
-    int             index;
-    int             lno = 0;
+    int             n = 0;
+    int             bad;
 
-    br_file = fopen (filename, "r");
-    CheckFile (br_file, filename);
-    PIHMprintf (VL_VERBOSE, " Reading %s\n", filename);
+    ReadTextFile (filename, &txt);
 
     /* Start reading bedrock file */
     /* Read fbr boundary conditions */
@@ -23,60 +19,108 @@ void ReadBedrock(const char *filename, atttbl_struct *atttbl,
     }
 
     /* Skip header line */
-    NextLine (br_file, cmdstr, &lno);
+    n++;
+
+    /* Records are parsed in parallel. The first bad record is reported */
+    bad = nelem;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
     for (i = 0; i < nelem; i++)
     {
-        NextLine (br_file, cmdstr, &lno);
-        match = sscanf(cmdstr, "%d %d %d %d",
-            &index,
-            &atttbl->fbr_bc[i][0], &atttbl->fbr_bc[i][1],
-            &atttbl->fbr_bc[i][2]);
-        if (match != 4 || i != index - 1)
+        const char     *str;
+        int             index;
+
+        str = TextLine (&txt, n + i);
+        if (!ScanInt (&str, &index) ||
+            !ScanInt (&str, &atttbl->fbr_bc[i][0]) ||
+            !ScanInt (&str, &atttbl->fbr_bc[i][1]) ||
+            !ScanInt (&str, &atttbl->fbr_bc[i][2]) ||
+            i != index - 1)
         {
-            PIHMprintf(VL_ERROR,
-                "Error reading boundary condition type for fractured bedrock"
-                "layer of the %dth element.\n", i + 1);
-            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
-            PIHMexit(EXIT_FAILURE);
+#if defined(_OPENMP)
+# pragma omp critical
+#endif
+            {
+                bad = (i < bad) ? i : bad;
+            }
         }
     }
 
+    if (bad < nelem)
+    {
+        PIHMprintf(VL_ERROR,
+            "Error reading boundary condition type for fractured bedrock"
+            "layer of the %dth element.\n", bad + 1);
+        PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename,
+            TextLno (&txt, n + bad));
+        PIHMexit(EXIT_FAILURE);
+    }
+    n += nelem;
+
     /* Read bedrock elevations */
     meshtbl->zbed = (double *)malloc (meshtbl->numnode * sizeof (double));
 
     /* Skip header line */
-    NextLine (br_file, cmdstr, &lno);
+    n++;
+
+    bad = meshtbl->numnode;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
     for (i = 0; i < meshtbl->numnode; i++)
     {
-        NextLine (br_file, cmdstr, &lno);
-        match = sscanf (cmdstr, "%d %lf", &index, &meshtbl->zbed[i]);
-        if (match != 2 || i != index - 1)
+        const char     *str;
+        int             index;
+
+        str = TextLine (&txt, n + i);
+        if (!ScanInt (&str, &index) ||
+            !ScanDouble (&str, &meshtbl->zbed[i]) ||
+            i != index - 1)
         {
-            PIHMprintf (VL_ERROR,
-                "Error reading bedrock description of the %dth node.\n", i + 1);
-            PIHMprintf (VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
-            PIHMexit (EXIT_FAILURE);
+#if defined(_OPENMP)
+# pragma omp critical
+#endif
+            {
+                bad = (i < bad) ? i : bad;
+            }
         }
     }
 
-    NextLine (br_file, cmdstr, &lno);
+    if (bad < meshtbl->numnode)
+    {
+        PIHMprintf (VL_ERROR,
+            "Error reading bedrock description of the %dth node.\n", bad + 1);
+        PIHMprintf (VL_ERROR, "Error in %s near Line %d.\n", filename,
+            TextLno (&txt, n + bad));
+        PIHMexit (EXIT_FAILURE);
+    }
+    n += meshtbl->numnode;
+
     ctrl->prtvrbl[FBRUNSAT_CTRL] =
-        ReadPrtCtrl (cmdstr, "FBRUNSAT", filename, lno);
+        ReadPrtCtrl (TextLine (&txt, n), "FBRUNSAT", filename,
+        TextLno (&txt, n));
+    n++;
 
-    NextLine (br_file, cmdstr, &lno);
-    ctrl->prtvrbl[FBRGW_CTRL] = ReadPrtCtrl (cmdstr, "FBRGW", filename, lno);
+    ctrl->prtvrbl[FBRGW_CTRL] =
+        ReadPrtCtrl (TextLine (&txt, n), "FBRGW", filename, TextLno (&txt, n));
+    n++;
 
-    NextLine (br_file, cmdstr, &lno);
     ctrl->prtvrbl[FBRINFIL_CTRL] =
-        ReadPrtCtrl(cmdstr, "FBRINFIL", filename, lno);
+        ReadPrtCtrl (TextLine (&txt, n), "FBRINFIL", filename,
+        TextLno (&txt, n));
+    n++;
 
-    NextLine (br_file, cmdstr, &lno);
     ctrl->prtvrbl[FBRRECHG_CTRL] =
-        ReadPrtCtrl (cmdstr, "FBRRECHG", filename, lno);
+        ReadPrtCtrl (TextLine (&txt, n), "FBRRECHG", filename,
+        TextLno (&txt, n));
+    n++;
 
-    NextLine (br_file, cmdstr, &lno);
     ctrl->prtvrbl[FBRFLOW_CTRL] =
-        ReadPrtCtrl (cmdstr, "FBRFLOW", filename, lno);
+        ReadPrtCtrl (TextLine (&txt, n), "FBRFLOW", filename,
+        TextLno (&txt, n));
 
-    fclose (br_file);
+    FreeTextFile (&txt);
 }
@@ -1,11 +1,11 @@
 #include "pihm.h"
 
-void ApplyBc(forc_struct *forc, elem_struct *elem, river_struct *river, int t)
+void ApplyBc(forc_struct *forc, river_struct *river, int t)
 {
     /* Element boundary conditions */
     if (forc->nbc > 0)
     {
-        ApplyElemBc(forc, elem, t);
+        ApplyElemBc(forc, t);
     }
 
     /* River boundary condition */
@@ -37,51 +37,33 @@ void ApplyForc(forc_struct *forc, elem_struct *elem, int t)
 #endif
 }
 
-void ApplyElemBc(forc_struct *forc, elem_struct *elem, int t)
+void ApplyElemBc(forc_struct *forc, int t)
 {
-    int             i, k;
+    /*
+     * Only element edges with boundary conditions are visited, using the
+     * boundary condition variables forced by each series (see InitBcMap)
+     */
+    int             k;
+
+    CheckForcTime(forc->bc, forc->nbc, t);
 
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
     for (k = 0; k < forc->nbc; k++)
     {
-        IntrplForc(&forc->bc[k], t, 1);
-    }
+        int             n;
 
-#if defined(_OPENMP)
-# pragma omp parallel for
-#endif
-    for (i = 0; i < nelem; i++)
-    {
-        int             ind;
-        int             j;
+        IntrplForc(&forc->bc[k], t, 1);
 
-        for (j = 0; j < NUM_EDGE; j++)
+        if (forc->bc[k].changed)
         {
-            if (elem[i].attrib.bc_type[j] > 0)
+            for (n = 0; n < forc->bc[k].nbcvar; n++)
             {
-                ind = elem[i].attrib.bc_type[j] - 1;
-                elem[i].bc.head[j] = forc->bc[ind].value[0];
-            }
-            else if (elem[i].attrib.bc_type[j] < 0)
-            {
-                ind = -elem[i].attrib.bc_type[j] - 1;
-                elem[i].bc.flux[j] = forc->bc[ind].value[0];
+                *forc->bc[k].bcvar[n] = forc->bc[k].value[0];
             }
 
-#if defined(_FBR_)
-            if (elem[i].attrib.fbrbc_type[j] > 0)
-            {
-                ind = elem[i].attrib.fbrbc_type[j] - 1;
-                elem[i].fbr_bc.head[j] = forc->bc[ind].value[0];
-            }
-            else if (elem[i].attrib.fbrbc_type[j] < 0)
-            {
-                ind = -elem[i].attrib.fbrbc_type[j] - 1;
-                elem[i].fbr_bc.flux[j] = forc->bc[ind].value[0];
-            }
-#endif
+            forc->bc[k].changed = 0;
         }
     }
 }
@@ -93,20 +75,64 @@ void ApplyMeteoForc(forc_struct *forc, elem_struct *elem, int t, int rad_mode,
 void ApplyMeteoForc(forc_struct *forc, elem_struct *elem, int t)
 #endif
 {
-    int             i, k;
+    int             k;
 #if defined(_NOAH_)
+    int             i;
     spa_data        spa;
 #endif
 
     /*
      * Meteorological forcing for PIHM
      */
+    if (forc->metstream != NULL)
+    {
+        UpdMeteoStream(forc, t);
+    }
+
+    CheckForcTime(forc->meteo, forc->nmeteo, t);
+
+    /* Forcing of each station is applied to the elements using the station
+     * (see InitMeteoMap). Derived forcing is calculated once for each
+     * station, and stations with unchanged forcing are skipped */
 #if defined(_OPENMP)
-# pragma omp parallel for
+# pragma omp parallel for schedule(dynamic)
 #endif
     for (k = 0; k < forc->nmeteo; k++)
     {
+        const double   *value;
+        double          prcp;
+        double          soldn;
+        int             n;
+
         IntrplForc(&forc->meteo[k], t, NUM_METEO_VAR);
+
+        if (!forc->meteo[k].changed)
+        {
+            continue;
+        }
+
+        value = forc->meteo[k].value;
+        prcp = value[PRCP_TS] / 1000.0;
+        soldn = (value[SOLAR_TS] > 0.0) ? value[SOLAR_TS] : 0.0;
+
+        for (n = 0; n < forc->meteo[k].ngrid; n++)
+        {
+            int             j;
+
+            j = forc->meteo[k].grid[n];
+
+            elem[j].wf.prcp = prcp;
+            elem[j].es.sfctmp = value[SFCTMP_TS];
+            elem[j].ps.rh = value[RH_TS];
+            elem[j].ps.sfcspd = value[SFCSPD_TS];
+            elem[j].ef.soldn = soldn;
+#if defined(_NOAH_)
+            elem[j].ef.longwave = value[LONGWAVE_TS];
+#endif
+            elem[j].ps.sfcprs = value[PRES_TS];
+        }
+
+        forc->meteo[k].changed = 0;
     }
 
 #if defined(_NOAH_)
@@ -117,6 +143,8 @@ void ApplyMeteoForc(forc_struct *forc, elem_struct *elem, int t)
     {
         if (forc->nrad > 0)
         {
+            CheckForcTime(forc->rad, forc->nrad, t);
+
 # if defined(_OPENMP)
 #  pragma omp parallel for
 # endif
@@ -128,33 +156,18 @@ void ApplyMeteoForc(forc_struct *forc, elem_struct *elem, int t)
 
         /* Calculate Sun position for topographic solar radiation */
         SunPos(siteinfo, t, &spa);
-    }
-#endif
 
-#if defined(_OPENMP)
-# pragma omp parallel for
-#endif
-    for (i = 0; i < nelem; i++)
-    {
-        int             ind;
-
-        ind = elem[i].attrib.meteo_type - 1;
+        /* Solar radiation depends on element topography and is calculated
+         * at every step */
+# if defined(_OPENMP)
+#  pragma omp parallel for
+# endif
+        for (i = 0; i < nelem; i++)
+        {
+            int             ind;
 
-        elem[i].wf.prcp = forc->meteo[ind].value[PRCP_TS] / 1000.0;
-        elem[i].es.sfctmp = forc->meteo[ind].value[SFCTMP_TS];
-        elem[i].ps.rh = forc->meteo[ind].value[RH_TS];
-        elem[i].ps.sfcspd = forc->meteo[ind].value[SFCSPD_TS];
-        elem[i].ef.soldn = forc->meteo[ind].value[SOLAR_TS];
-        elem[i].ef.soldn = (elem[i].ef.soldn > 0.0) ? elem[i].ef.soldn : 0.0;
-#if defined(_NOAH_)
-        elem[i].ef.longwave = forc->meteo[ind].value[LONGWAVE_TS];
-#endif
-        elem[i].ps.sfcprs = forc->meteo[ind].value[PRES_TS];
+            ind = elem[i].attrib.meteo_type - 1;
 
-#if defined(_NOAH_)
-        /* Calculate solar radiation */
-        if (rad_mode > 0)
-        {
             if (forc->nrad > 0)
             {
                 elem[i].ef.soldir = forc->rad[ind].value[SOLDIR_TS];
@@ -166,8 +179,8 @@ void ApplyMeteoForc(forc_struct *forc, elem_struct *elem, int t)
             elem[i].ef.soldn =
                 (elem[i].ef.soldn > 0.0) ? elem[i].ef.soldn : 0.0;
         }
-#endif
     }
+#endif
 }
 
 #if defined(_BGC_) || defined(_CYCLES_)
@@ -229,6 +242,8 @@ void ApplyLai(forc_struct *forc, elem_struct *elem, int t)
 
     if (forc->nlai > 0)
     {
+        CheckForcTime(forc->lai, forc->nlai, t);
+
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
@@ -263,6 +278,8 @@ void ApplyRiverBc(forc_struct *forc, river_struct *river, int t)
 {
     int             i, k;
 
+    CheckForcTime(forc->riverbc, forc->nriverbc, t);
+
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
@@ -291,10 +308,41 @@ void ApplyRiverBc(forc_struct *forc, river_struct *river, int t)
     }
 }
 
+void CheckForcTime(const tsdata_struct *ts, int nts, int t)
+{
+    /*
+     * Check that forcing series cover model time t before they are
+     * interpolated in parallel loops, from which errors cannot be returned
+     * to the caller of the library
+     */
+    int             k;
+
+    for (k = 0; k < nts; k++)
+    {
+        if (t < ts[k].ftime[0] || t > ts[k].ftime[ts[k].length - 1])
+        {
+            PIHMprintf(VL_ERROR,
+                "Error finding forcing for current time step.\n");
+            PIHMprintf(VL_ERROR, "Please check your forcing file.\n");
+            PIHMexit(EXIT_FAILURE);
+        }
+    }
+}
+
 void IntrplForc(tsdata_struct *ts, int t, int nvrbl)
 {
+    /*
+     * Interpolate forcing at model time t. The interval of last interpolation
+     * (ts->cursor) is used as the starting point because model time advances
+     * monotonically, so the interval is found in constant time. Binary search
+     * is only used when model time goes back (e.g., in spin-up mode)
+     */
     int             j;
-    int             first, middle, last;
+    int             k;
+    int             first, last;
+    const double   *data0;
+    const double   *data1;
+    double          dt0, dt1, dt;
 
     if (t < ts->ftime[0])
     {
@@ -308,34 +356,54 @@ void IntrplForc(tsdata_struct *ts, int t, int nvrbl)
         PIHMprintf(VL_ERROR, "Please check your forcing file.\n");
         PIHMexit(EXIT_FAILURE);
     }
-    else
+    else if (ts->length > 1)
     {
-        first = 1;
-        last = ts->length - 1;
+        k = ts->cursor;
 
-        while (first <= last)
+        if (k < 1 || k > ts->length - 1 || t < ts->ftime[k - 1])
         {
-            middle = (first + last) / 2;
-            if (t >= ts->ftime[middle - 1] && t <= ts->ftime[middle])
+            /* Find the first forcing time at or after t */
+            first = 1;
+            last = ts->length - 1;
+            while (first < last)
             {
-                for (j = 0; j < nvrbl; j++)
+                k = (first + last) / 2;
+                if (ts->ftime[k] < t)
                 {
-                    ts->value[j] =
-                        ((double)(ts->ftime[middle] - t) *
-                        ts->data[middle - 1][j] +
-                        (double)(t - ts->ftime[middle - 1]) *
-                        ts->data[middle][j]) /
-                        (double)(ts->ftime[middle] - ts->ftime[middle - 1]);
+                    first = k + 1;
+                }
+                else
+                {
+                    last = k;
                 }
-                break;
-            }
-            else if (ts->ftime[middle] > t)
-            {
-                last = middle - 1;
             }
-            else
+            k = first;
+        }
+
+        while (ts->ftime[k] < t)
+        {
+            k++;
+        }
+
+        ts->cursor = k;
+
+        data0 = ts->data + (k - 1) * nvrbl;
+        data1 = ts->data + k * nvrbl;
+        dt0 = (double)(ts->ftime[k] - t);
+        dt1 = (double)(t - ts->ftime[k - 1]);
+        dt = (double)(ts->ftime[k] - ts->ftime[k - 1]);
+
+        for (j = 0; j < nvrbl; j++)
+        {
+            double          value;
+
+            value = (dt0 * data0[j] + dt1 * data1[j]) / dt;
+
+            /* Flag changes so that unchanged forcing is not applied again */
+            if (value != ts->value[j])
             {
-                first = middle + 1;
+                ts->value[j] = value;
+                ts->changed = 1;
             }
         }
     }
@@ -607,3 +675,37 @@ double MonthlyMf(int t)
 
     return mf_tbl[pihm_time.month - 1];
 }
+
+int NextForcChange(const tsdata_struct *ts, int nvrbl, int t)
+{
+    /*
+     * Find the time after which forcing interpolated at model time t may
+     * change. Forcing is constant within intervals between identical records
+     * (ts->cursor is the interval of last interpolation), and changes at
+     * every model step otherwise
+     */
+    int             j;
+    int             k;
+    const double   *data0;
+    const double   *data1;
+
+    k = ts->cursor;
+
+    if (ts->length < 2 || k < 1 || k > ts->length - 1)
+    {
+        return t;
+    }
+
+    data0 = ts->data + (k - 1) * nvrbl;
+    data1 = ts->data + k * nvrbl;
+
+    for (j = 0; j < nvrbl; j++)
+    {
+        if (data0[j] != data1[j])
+        {
+            return t;
+        }
+    }
+
+    return ts->ftime[k];
+}
@@ -2,25 +2,29 @@
 
 void FreeMem(pihm_struct pihm)
 {
-    int             i;
-
-    FreeRivtbl(&pihm->rivtbl);
+    /* Shared input tables are freed with the model they are shared with */
+    if (!pihm->shared)
+    {
+        FreeRivtbl(&pihm->rivtbl);
 
-    FreeShptbl(&pihm->shptbl);
+        FreeShptbl(&pihm->shptbl);
 
-    FreeMatltbl(&pihm->matltbl);
+        FreeMatltbl(&pihm->matltbl);
 
-    FreeMeshtbl(&pihm->meshtbl);
+        FreeMeshtbl(&pihm->meshtbl);
 
-    FreeAtttbl(&pihm->atttbl);
+        FreeAtttbl(&pihm->atttbl);
 
-    FreeSoiltbl(&pihm->soiltbl);
+        FreeSoiltbl(&pihm->soiltbl);
 
 #if defined(_FBR_)
-    FreeGeoltbl(&pihm->geoltbl);
+        FreeGeoltbl(&pihm->geoltbl);
 #endif
 
-    FreeLctbl(&pihm->lctbl);
+        FreeLctbl(&pihm->lctbl);
+    }
+
+    FreeReducetbl(&pihm->reducetbl);
 
     FreeForc(&pihm->forc);
 
@@ -30,40 +34,104 @@ void FreeMem(pihm_struct pihm)
 
     FreeCtrl(&pihm->ctrl);
 
+    if (pihm->ctrl.lin_solver != SPGMR_SOLVER)
+    {
+        FreeSparseJac(&pihm->jac);
+    }
+    else if (pihm->ctrl.precond == BLOCK_JACOBI)
+    {
+        FreePrecond(pihm->graph.nnode, &pihm->prec);
+    }
+
+    FreeGraph(&pihm->graph);
+
+    FreeHydro(&pihm->hydro);
+
+    if (pihm->ctrl.multirate > 0)
+    {
+        FreeMultiRate(&pihm->multirate);
+    }
+
+    if (pihm->ctrl.event_cpl)
+    {
+        N_VDestroy(pihm->cpl.ydot);
+    }
+
+    free(pihm->elem);
+    free(pihm->river);
+}
+
+void FreeFailedModel(pihm_struct pihm)
+{
+    /*
+     * Stop background threads and free solver memory of a model that failed
+     * to be created. Other memory allocated and files opened for the model
+     * are tracked, and are released by StopTracking
+     */
+    if (pihm->forc.metstream != NULL)
+    {
+        StopMeteoStream(pihm->forc.metstream);
+    }
+
+    if (pihm->multirate.y != NULL)
+    {
+        N_VDestroy(pihm->multirate.y);
+    }
+    if (pihm->multirate.cvode_mem != NULL)
+    {
+        CVodeFree(&pihm->multirate.cvode_mem);
+    }
+
+    if (pihm->cpl.ydot != NULL)
+    {
+        N_VDestroy(pihm->cpl.ydot);
+    }
+}
+
+void FreeOutput(int waterbal, int ascii, print_struct *print)
+{
+    int             i;
+
     /*
      * Close files
      */
-    if (pihm->ctrl.waterbal)
+    FreeOutputWriter(&print->writer);
+
+    if (waterbal)
     {
-        fclose(pihm->print.watbal_file);
+        fclose(print->watbal_file);
     }
     if (debug_mode)
     {
-        fclose(pihm->print.cvodeperf_file);
+        fclose(print->cvodeperf_file);
     }
-    for (i = 0; i < pihm->print.nprint; i++)
+    for (i = 0; i < print->nprint; i++)
     {
-        free(pihm->print.varctrl[i].var);
-        free(pihm->print.varctrl[i].buffer);
-        fclose(pihm->print.varctrl[i].datfile);
-        if (pihm->ctrl.ascii)
+        free(print->varctrl[i].var);
+        free(print->varctrl[i].buffer);
+        free(print->varctrl[i].weight);
+        free(print->varctrl[i].id);
+        if (print->varctrl[i].datfile != NULL)
         {
-            fclose(pihm->print.varctrl[i].txtfile);
+            fclose(print->varctrl[i].datfile);
+        }
+        if (ascii)
+        {
+            fclose(print->varctrl[i].txtfile);
         }
     }
     if (tecplot)
     {
-        for (i = 0; i < pihm->print.ntpprint; i++)
+        for (i = 0; i < print->ntpprint; i++)
         {
-            fclose(pihm->print.tp_varctrl[i].datfile);
+            fclose(print->tp_varctrl[i].datfile);
         }
     }
-    free(pihm->elem);
-    free(pihm->river);
 }
 
 void FreeRivtbl(rivtbl_struct *rivtbl)
 {
+    free(rivtbl->ind);
     free(rivtbl->fromnode);
     free(rivtbl->tonode);
     free(rivtbl->down);
@@ -91,6 +159,30 @@ void FreeMatltbl(matltbl_struct *matltbl)
     free(matltbl->bedthick);
 }
 
+void FreeReducetbl(reducetbl_struct *reducetbl)
+{
+    int             i;
+
+    /* Free output reducer input structure */
+    if (reducetbl->ngroup > 0)
+    {
+        for (i = 0; i < reducetbl->ngroup; i++)
+        {
+            free(reducetbl->member[i]);
+        }
+        free(reducetbl->grpname);
+        free(reducetbl->grptype);
+        free(reducetbl->nmember);
+        free(reducetbl->member);
+    }
+    if (reducetbl->nreducer > 0)
+    {
+        free(reducetbl->var);
+        free(reducetbl->group);
+        free(reducetbl->op);
+    }
+}
+
 void FreeMeshtbl(meshtbl_struct *meshtbl)
 {
     int             i;
@@ -100,6 +192,7 @@ void FreeMeshtbl(meshtbl_struct *meshtbl)
         free(meshtbl->node[i]);
         free(meshtbl->nabr[i]);
     }
+    free(meshtbl->ind);
     free(meshtbl->node);
     free(meshtbl->nabr);
     free(meshtbl->x);
@@ -190,30 +283,48 @@ void FreeLctbl(lctbl_struct *lctbl)
 
 void FreeForc(forc_struct *forc)
 {
-    int             i, j;
+    int             i;
 
-    if (forc->nriverbc > 0)
+    if (forc->shared)
+    {
+        FreeSharedTs(forc->nriverbc, forc->riverbc);
+    }
+    else if (forc->nriverbc > 0)
     {
         for (i = 0; i < forc->nriverbc; i++)
         {
-            for (j = 0; j < forc->riverbc[i].length; j++)
-            {
-                free(forc->riverbc[i].data[j]);
-            }
             free(forc->riverbc[i].ftime);
             free(forc->riverbc[i].data);
         }
         free(forc->riverbc);
     }
 
-    if (forc->nmeteo > 0)
+    for (i = 0; i < forc->nmeteo; i++)
+    {
+        free(forc->meteo[i].grid);
+    }
+
+    for (i = 0; i < forc->nbc; i++)
+    {
+        free(forc->bc[i].bcvar);
+    }
+
+    if (forc->meteo_shared)
+    {
+        FreeSharedTs(forc->nmeteo, forc->meteo);
+    }
+    else if (forc->metstream != NULL)
+    {
+        FreeMeteoStream(forc);
+    }
+    else if (forc->nmeteo > 0 && forc->meteo_map.addr != NULL)
+    {
+        FreeBinTs(forc->nmeteo, forc->meteo, &forc->meteo_map);
+    }
+    else if (forc->nmeteo > 0)
     {
         for (i = 0; i < forc->nmeteo; i++)
         {
-            for (j = 0; j < forc->meteo[i].length; j++)
-            {
-                free(forc->meteo[i].data[j]);
-            }
             free(forc->meteo[i].ftime);
             free(forc->meteo[i].data);
             free(forc->meteo[i].value);
@@ -221,14 +332,18 @@ void FreeForc(forc_struct *forc)
         free(forc->meteo);
     }
 
-    if (forc->nlai > 0)
+    if (forc->shared)
+    {
+        FreeSharedTs(forc->nlai, forc->lai);
+    }
+    else if (forc->nlai > 0 && forc->lai_map.addr != NULL)
+    {
+        FreeBinTs(forc->nlai, forc->lai, &forc->lai_map);
+    }
+    else if (forc->nlai > 0)
     {
         for (i = 0; i < forc->nlai; i++)
         {
-            for (j = 0; j < forc->lai[i].length; j++)
-            {
-                free(forc->lai[i].data[j]);
-            }
             free(forc->lai[i].ftime);
             free(forc->lai[i].data);
             free(forc->lai[i].value);
@@ -236,14 +351,18 @@ void FreeForc(forc_struct *forc)
         free(forc->lai);
     }
 
-    if (forc->nbc > 0)
+    if (forc->shared)
+    {
+        FreeSharedTs(forc->nbc, forc->bc);
+    }
+    else if (forc->nbc > 0 && forc->bc_map.addr != NULL)
+    {
+        FreeBinTs(forc->nbc, forc->bc, &forc->bc_map);
+    }
+    else if (forc->nbc > 0)
     {
         for (i = 0; i < forc->nbc; i++)
         {
-            for (j = 0; j < forc->bc[i].length; j++)
-            {
-                free(forc->bc[i].data[j]);
-            }
             free(forc->bc[i].ftime);
             free(forc->bc[i].data);
             free(forc->bc[i].value);
@@ -252,14 +371,18 @@ void FreeForc(forc_struct *forc)
     }
 
 #if defined(_NOAH_)
-    if (forc->nrad > 0)
+    if (forc->shared)
+    {
+        FreeSharedTs(forc->nrad, forc->rad);
+    }
+    else if (forc->nrad > 0 && forc->rad_map.addr != NULL)
+    {
+        FreeBinTs(forc->nrad, forc->rad, &forc->rad_map);
+    }
+    else if (forc->nrad > 0)
     {
         for (i = 0; i < forc->nrad; i++)
         {
-            for (j = 0; j < forc->rad[i].length; j++)
-            {
-                free(forc->rad[i].data[j]);
-            }
             free(forc->rad[i].ftime);
             free(forc->rad[i].data);
             free(forc->rad[i].value);
@@ -271,10 +394,6 @@ void FreeForc(forc_struct *forc)
 #if defined(_BGC_)
     if (forc->nco2 > 0)
     {
-        for (j = 0; j < forc->co2[0].length; j++)
-        {
-            free(forc->co2[0].data[j]);
-        }
         free(forc->co2[0].ftime);
         free(forc->co2[0].data);
         free(forc->co2[0].value);
@@ -283,10 +402,6 @@ void FreeForc(forc_struct *forc)
 
     if (forc->nndep > 0)
     {
-        for (j = 0; j < forc->ndep[0].length; j++)
-        {
-            free(forc->ndep[0].data[j]);
-        }
         free(forc->ndep[0].ftime);
         free(forc->ndep[0].data);
         free(forc->ndep[0].value);
@@ -295,6 +410,19 @@ void FreeForc(forc_struct *forc)
 #endif
 }
 
+void FreeSharedTs(int nts, tsdata_struct *ts)
+{
+    int             i;
+
+    /* Forcing times and values at forcing times are owned by the model the
+     * time series are shared with */
+    for (i = 0; i < nts; i++)
+    {
+        free(ts[i].value);
+    }
+    free(ts);
+}
+
 #if defined(_BGC_)
 void FreeEpctbl(epctbl_struct *epctbl)
 {
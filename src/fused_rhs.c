@@ -0,0 +1,196 @@
+#include "pihm.h"
+
+#if defined(_FUSED_RHS_)
+void FusedRhs(double t, const double *y, double *dy, hydro_elem_struct *elem,
+    hydro_river_struct *river, const ctrl_struct *ctrl)
+{
+    /*
+     * Fused RHS kernel. All sweeps over model grids are done in one parallel
+     * region:
+     *
+     * Phase 1: states and friction slopes of each node
+     * Phase 2: fluxes across element faces and vertical fluxes, then fluxes
+     *          of river segments
+     * Phase 3: upstream flux accumulation and assembly of dy
+     *
+     * The same flux functions are called in the same order as in the
+     * unfused path, so results are bitwise identical
+     */
+#if defined(_OPENMP)
+# pragma omp parallel
+#endif
+    {
+        int             i;
+
+        /*
+         * Phase 1
+         */
+#if defined(_OPENMP)
+# pragma omp for nowait
+#endif
+        for (i = 0; i < nriver; i++)
+        {
+            river->stage[i] = (y[RIVSTG(i)] >= 0.0) ? y[RIVSTG(i)] : 0.0;
+            river->gw[i] = (y[RIVGW(i)] >= 0.0) ? y[RIVGW(i)] : 0.0;
+
+            river->rivflow[i][UP_CHANL2CHANL] = 0.0;
+            river->rivflow[i][UP_AQUIF2AQUIF] = 0.0;
+
+            dy[RIVSTG(i)] = 0.0;
+            dy[RIVGW(i)] = 0.0;
+        }
+
+#if defined(_OPENMP)
+# pragma omp for
+#endif
+        for (i = 0; i < nelem; i++)
+        {
+            elem->surf[i] = (y[SURF(i)] >= 0.0) ? y[SURF(i)] : 0.0;
+            elem->unsat[i] = (y[UNSAT(i)] >= 0.0) ? y[UNSAT(i)] : 0.0;
+            elem->gw[i] = (y[GW(i)] >= 0.0) ? y[GW(i)] : 0.0;
+
+            dy[SURF(i)] = 0.0;
+            dy[UNSAT(i)] = 0.0;
+            dy[GW(i)] = 0.0;
+
+#if defined(_FBR_)
+            elem->fbr_unsat[i] =
+                (y[FBRUNSAT(i)] >= 0.0) ? y[FBRUNSAT(i)] : 0.0;
+            elem->fbr_gw[i] = (y[FBRGW(i)] >= 0.0) ? y[FBRGW(i)] : 0.0;
+
+            dy[FBRUNSAT(i)] = 0.0;
+            dy[FBRGW(i)] = 0.0;
+#endif
+
+            /* Calculate actual surface water depth */
+            elem->surfh[i] = SurfH(elem->surf[i]);
+
+            /* Determine which layers does ET extract water from */
+            EtExtractElem(elem, i);
+
+            FusedFrictSlope(y, elem, river, i, ctrl->surf_mode);
+        }
+
+        /*
+         * Phase 2
+         */
+#if defined(_OPENMP)
+# pragma omp for
+#endif
+        for (i = 0; i < elem->nface; i++)
+        {
+            LateralFlowFace(elem, i, ctrl->surf_mode);
+        }
+
+#if defined(_OPENMP)
+# pragma omp for
+#endif
+        for (i = 0; i < nelem; i++)
+        {
+#if defined(_FBR_)
+            FbrLateralFlowElem(elem, i);
+#endif
+
+            /* Infiltration depends on overland flow of the element, thus
+             * waits for all faces. Overland flow across river edges is
+             * updated by river segments after vertical fluxes, as in the
+             * unfused path */
+            VerticalFlowElem(elem, i, (double)ctrl->stepsize);
+        }
+
+#if defined(_OPENMP)
+# pragma omp for
+#endif
+        for (i = 0; i < nriver; i++)
+        {
+            RiverSegFlow(elem, river, i, ctrl->riv_mode);
+        }
+
+        /*
+         * Phase 3
+         */
+#if defined(_OPENMP)
+# pragma omp for nowait
+#endif
+        for (i = 0; i < nriver; i++)
+        {
+            AccumUpstreamFlux(river, i);
+        }
+
+#if defined(_OPENMP)
+# pragma omp for nowait
+#endif
+        for (i = 0; i < nelem; i++)
+        {
+            ElemRhs(elem, i, t, dy);
+        }
+
+#if defined(_OPENMP)
+# pragma omp barrier
+#endif
+
+#if defined(_OPENMP)
+# pragma omp for
+#endif
+        for (i = 0; i < nriver; i++)
+        {
+            RiverRhs(river, i, t, dy);
+        }
+    }
+}
+
+void FusedFrictSlope(const double *y, hydro_elem_struct *elem,
+    const hydro_river_struct *river, int i, int surf_mode)
+{
+    /*
+     * Same as FrictSlope, but the surface water levels of neighbors are
+     * derived from the state vector because neighbors may not have been
+     * updated yet by other threads
+     */
+    int             j;
+    int             nabr;
+    double          surfh[NUM_EDGE];
+    double          stage;
+
+    if (surf_mode == DIFF_WAVE)
+    {
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            if (elem->nabr[i][j] > 0)
+            {
+                nabr = elem->nabr[i][j] - 1;
+                surfh[j] = elem->zmax[nabr] +
+                    SurfH((y[SURF(nabr)] >= 0.0) ? y[SURF(nabr)] : 0.0);
+            }
+            else if (elem->nabr[i][j] < 0)
+            {
+                nabr = -elem->nabr[i][j] - 1;
+                stage = (y[RIVSTG(nabr)] >= 0.0) ? y[RIVSTG(nabr)] : 0.0;
+
+                if (stage > river->depth[nabr])
+                {
+                    surfh[j] = river->zbed[nabr] + stage;
+                }
+                else
+                {
+                    surfh[j] = river->zmax[nabr];
+                }
+            }
+            else
+            {
+                if (elem->bc_type[i][j] == NO_FLOW)
+                {
+                    surfh[j] = elem->zmax[i] + elem->surfh[i];
+                }
+                else
+                {
+                    surfh[j] = elem->bc[i].head[j];
+                }
+            }
+        }
+
+        elem->dhbydx[i] = DhByDl(elem->nabr_y[i], elem->nabr_x[i], surfh);
+        elem->dhbydy[i] = DhByDl(elem->nabr_x[i], elem->nabr_y[i], surfh);
+    }
+}
+#endif
@@ -0,0 +1,248 @@
+#include "pihm.h"
+
+void InitGraph(const elem_struct *elem, const river_struct *river,
+    graph_struct *graph)
+{
+    int             i, j;
+    int            *counter;
+
+    /*
+     * Graph nodes are elements (0 to nelem - 1) followed by river segments
+     * (nelem to nelem + nriver - 1). Nodes are connected when they exchange
+     * water directly
+     */
+    graph->nnode = nelem + nriver;
+    graph->xadj = (int *)calloc(graph->nnode + 1, sizeof(int));
+
+    for (i = 0; i < nelem; i++)
+    {
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            graph->xadj[i + 1] += (elem[i].nabr[j] != 0) ? 1 : 0;
+        }
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        /* Left and right elements */
+        graph->xadj[nelem + i + 1] += 2;
+
+        /* Down segment, which also has this segment as an upstream segment */
+        if (river[i].down > 0)
+        {
+            graph->xadj[nelem + i + 1]++;
+            graph->xadj[nelem + river[i].down]++;
+        }
+    }
+
+    for (i = 0; i < graph->nnode; i++)
+    {
+        graph->xadj[i + 1] += graph->xadj[i];
+    }
+
+    graph->adj = (int *)malloc(graph->xadj[graph->nnode] * sizeof(int));
+    counter = (int *)malloc(graph->nnode * sizeof(int));
+
+    for (i = 0; i < graph->nnode; i++)
+    {
+        counter[i] = graph->xadj[i];
+    }
+
+    for (i = 0; i < nelem; i++)
+    {
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            if (elem[i].nabr[j] > 0)
+            {
+                graph->adj[counter[i]++] = elem[i].nabr[j] - 1;
+            }
+            else if (elem[i].nabr[j] < 0)
+            {
+                graph->adj[counter[i]++] = nelem - elem[i].nabr[j] - 1;
+            }
+        }
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        graph->adj[counter[nelem + i]++] = river[i].leftele - 1;
+        graph->adj[counter[nelem + i]++] = river[i].rightele - 1;
+
+        if (river[i].down > 0)
+        {
+            graph->adj[counter[nelem + i]++] = nelem + river[i].down - 1;
+            graph->adj[counter[nelem + river[i].down - 1]++] = nelem + i;
+        }
+    }
+
+    free(counter);
+
+    /*
+     * State variables attached to each node
+     */
+    graph->nsv = (int *)malloc(graph->nnode * sizeof(int));
+    graph->sv = (int **)malloc(graph->nnode * sizeof(int *));
+
+    for (i = 0; i < nelem; i++)
+    {
+        j = 0;
+
+        graph->nsv[i] = NSV_ELEM;
+        graph->sv[i] = (int *)malloc(NSV_ELEM * sizeof(int));
+
+        graph->sv[i][j++] = SURF(i);
+        graph->sv[i][j++] = UNSAT(i);
+        graph->sv[i][j++] = GW(i);
+#if defined(_FBR_)
+        graph->sv[i][j++] = FBRUNSAT(i);
+        graph->sv[i][j++] = FBRGW(i);
+#endif
+#if defined(_BGC_) && !defined(_LUMPED_)
+        graph->sv[i][j++] = SURFN(i);
+        graph->sv[i][j++] = SMINN(i);
+#endif
+#if defined(_CYCLES_)
+        graph->sv[i][j++] = NO3(i);
+        graph->sv[i][j++] = NH4(i);
+#endif
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        j = 0;
+
+        graph->nsv[nelem + i] = NSV_RIVER;
+        graph->sv[nelem + i] = (int *)malloc(NSV_RIVER * sizeof(int));
+
+        graph->sv[nelem + i][j++] = RIVSTG(i);
+        graph->sv[nelem + i][j++] = RIVGW(i);
+#if defined(_BGC_) && !defined(_LUMPED_)
+        graph->sv[nelem + i][j++] = STREAMN(i);
+        graph->sv[nelem + i][j++] = RIVBEDN(i);
+#endif
+#if defined(_CYCLES_)
+        graph->sv[nelem + i][j++] = STREAMNO3(i);
+        graph->sv[nelem + i][j++] = RIVBEDNO3(i);
+        graph->sv[nelem + i][j++] = STREAMNH4(i);
+        graph->sv[nelem + i][j++] = RIVBEDNH4(i);
+#endif
+    }
+}
+
+int NodesWithin(const graph_struct *graph, int node, int dist, int *list,
+    int *stamp, int *depth)
+{
+    /*
+     * Breadth-first search for all nodes within dist edges of node (including
+     * node itself). stamp should be initialized to -1 and is marked with node
+     * so that it can be reused for searches from other nodes without being
+     * reset
+     */
+    int             head = 0;
+    int             nlist = 0;
+
+    list[nlist++] = node;
+    stamp[node] = node;
+    depth[node] = 0;
+
+    while (head < nlist)
+    {
+        int             i;
+        int             curr;
+
+        curr = list[head++];
+
+        if (depth[curr] == dist)
+        {
+            continue;
+        }
+
+        for (i = graph->xadj[curr]; i < graph->xadj[curr + 1]; i++)
+        {
+            int             nb;
+
+            nb = graph->adj[i];
+            if (stamp[nb] != node)
+            {
+                stamp[nb] = node;
+                depth[nb] = depth[curr] + 1;
+                list[nlist++] = nb;
+            }
+        }
+    }
+
+    return nlist;
+}
+
+int ColorGraph(const graph_struct *graph, int dist, int *color)
+{
+    /*
+     * Greedy distance-dist coloring: nodes within dist edges of each other are
+     * assigned different colors. Returns the number of colors
+     */
+    int             i, j;
+    int             ncolor = 0;
+    int            *list;
+    int            *stamp;
+    int            *depth;
+    int            *mark;
+
+    list = (int *)malloc(graph->nnode * sizeof(int));
+    stamp = (int *)malloc(graph->nnode * sizeof(int));
+    depth = (int *)malloc(graph->nnode * sizeof(int));
+    mark = (int *)malloc(graph->nnode * sizeof(int));
+
+    for (i = 0; i < graph->nnode; i++)
+    {
+        color[i] = -1;
+        stamp[i] = -1;
+        mark[i] = -1;
+    }
+
+    for (i = 0; i < graph->nnode; i++)
+    {
+        int             nlist;
+        int             c;
+
+        nlist = NodesWithin(graph, i, dist, list, stamp, depth);
+
+        for (j = 1; j < nlist; j++)
+        {
+            if (color[list[j]] >= 0)
+            {
+                mark[color[list[j]]] = i;
+            }
+        }
+
+        c = 0;
+        while (mark[c] == i)
+        {
+            c++;
+        }
+
+        color[i] = c;
+        ncolor = (c + 1 > ncolor) ? c + 1 : ncolor;
+    }
+
+    free(list);
+    free(stamp);
+    free(depth);
+    free(mark);
+
+    return ncolor;
+}
+
+void FreeGraph(graph_struct *graph)
+{
+    int             i;
+
+    for (i = 0; i < graph->nnode; i++)
+    {
+        free(graph->sv[i]);
+    }
+
+    free(graph->xadj);
+    free(graph->adj);
+    free(graph->nsv);
+    free(graph->sv);
+}
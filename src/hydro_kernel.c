@@ -0,0 +1,594 @@
+#include "pihm.h"
+
+void InitHydro(const elem_struct *elem, const river_struct *river,
+    hydro_struct *hydro)
+{
+    int             i;
+    int             k;
+    int            *nup;
+    hydro_elem_struct *he;
+    hydro_river_struct *hr;
+
+    PIHMprintf(VL_VERBOSE, "Initialize hydrology kernel.\n");
+
+    he = &hydro->elem;
+    hr = &hydro->river;
+
+    /*
+     * Element variables
+     */
+    he->nabr = (int (*)[NUM_EDGE])malloc(nelem * sizeof(*he->nabr));
+    he->bc_type = (int (*)[NUM_EDGE])malloc(nelem * sizeof(*he->bc_type));
+    he->area = (double *)malloc(nelem * sizeof(double));
+    he->zmin = (double *)malloc(nelem * sizeof(double));
+    he->zmax = (double *)malloc(nelem * sizeof(double));
+    he->edge = (double (*)[NUM_EDGE])malloc(nelem * sizeof(*he->edge));
+    he->nabrdist = (double (*)[NUM_EDGE])malloc(nelem * sizeof(*he->nabrdist));
+    he->nabr_x = (double (*)[NUM_EDGE])malloc(nelem * sizeof(*he->nabr_x));
+    he->nabr_y = (double (*)[NUM_EDGE])malloc(nelem * sizeof(*he->nabr_y));
+    he->rough = (double *)malloc(nelem * sizeof(double));
+    he->depth = (double *)malloc(nelem * sizeof(double));
+    he->ksath = (double *)malloc(nelem * sizeof(double));
+    he->ksatv = (double *)malloc(nelem * sizeof(double));
+    he->kinfv = (double *)malloc(nelem * sizeof(double));
+    he->dinf = (double *)malloc(nelem * sizeof(double));
+    he->alpha = (double *)malloc(nelem * sizeof(double));
+    he->beta = (double *)malloc(nelem * sizeof(double));
+    he->porosity = (double *)malloc(nelem * sizeof(double));
+    he->dmac = (double *)malloc(nelem * sizeof(double));
+    he->kmach = (double *)malloc(nelem * sizeof(double));
+    he->kmacv = (double *)malloc(nelem * sizeof(double));
+    he->areafv = (double *)malloc(nelem * sizeof(double));
+    he->areafh = (double *)malloc(nelem * sizeof(double));
+#if defined(_FBR_)
+    he->fbrbc_type = (int (*)[NUM_EDGE])malloc(nelem *
+        sizeof(*he->fbrbc_type));
+    he->fbr_nabr = (int (*)[NUM_EDGE])malloc(nelem * sizeof(*he->fbr_nabr));
+    he->fbr_dist = (double (*)[NUM_EDGE])malloc(nelem *
+        sizeof(*he->fbr_dist));
+    he->zbed = (double *)malloc(nelem * sizeof(double));
+    he->geol_depth = (double *)malloc(nelem * sizeof(double));
+    he->geol_ksath = (double *)malloc(nelem * sizeof(double));
+    he->geol_ksatv = (double *)malloc(nelem * sizeof(double));
+    he->geol_alpha = (double *)malloc(nelem * sizeof(double));
+    he->geol_beta = (double *)malloc(nelem * sizeof(double));
+    he->geol_porosity = (double *)malloc(nelem * sizeof(double));
+#endif
+
+    he->bc = (bc_struct *)malloc(nelem * sizeof(bc_struct));
+#if defined(_FBR_)
+    he->fbr_bc = (bc_struct *)malloc(nelem * sizeof(bc_struct));
+#endif
+    he->surf0 = (double *)malloc(nelem * sizeof(double));
+    he->pcpdrp = (double *)malloc(nelem * sizeof(double));
+    he->edir = (double *)malloc(nelem * sizeof(double));
+    he->ett = (double *)malloc(nelem * sizeof(double));
+#if defined(_NOAH_)
+    he->gwet = (double *)malloc(nelem * sizeof(double));
+    he->fcr = (double *)malloc(nelem * sizeof(double));
+    he->sh2o = (double *)malloc(nelem * sizeof(double));
+    he->smcmax = (double *)malloc(nelem * sizeof(double));
+    he->smcmin = (double *)malloc(nelem * sizeof(double));
+#else
+    he->rzd = (double *)malloc(nelem * sizeof(double));
+#endif
+
+    he->surf = (double *)malloc(nelem * sizeof(double));
+    he->unsat = (double *)malloc(nelem * sizeof(double));
+    he->gw = (double *)malloc(nelem * sizeof(double));
+    he->surfh = (double *)malloc(nelem * sizeof(double));
+#if defined(_FBR_)
+    he->fbr_unsat = (double *)malloc(nelem * sizeof(double));
+    he->fbr_gw = (double *)malloc(nelem * sizeof(double));
+#endif
+
+    he->ovlflow = (double (*)[NUM_EDGE])calloc(nelem, sizeof(*he->ovlflow));
+    he->subsurf = (double (*)[NUM_EDGE])calloc(nelem, sizeof(*he->subsurf));
+    he->infil = (double *)malloc(nelem * sizeof(double));
+    he->rechg = (double *)malloc(nelem * sizeof(double));
+    he->edir_surf = (double *)malloc(nelem * sizeof(double));
+    he->edir_unsat = (double *)malloc(nelem * sizeof(double));
+    he->edir_gw = (double *)malloc(nelem * sizeof(double));
+    he->ett_unsat = (double *)malloc(nelem * sizeof(double));
+    he->ett_gw = (double *)malloc(nelem * sizeof(double));
+#if defined(_FBR_)
+    he->fbrflow = (double (*)[NUM_EDGE])calloc(nelem, sizeof(*he->fbrflow));
+    he->fbr_infil = (double *)malloc(nelem * sizeof(double));
+    he->fbr_rechg = (double *)malloc(nelem * sizeof(double));
+#endif
+
+    he->dhbydx = (double *)calloc(nelem, sizeof(double));
+    he->dhbydy = (double *)calloc(nelem, sizeof(double));
+
+    for (i = 0; i < nelem; i++)
+    {
+        int             j;
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            he->nabr[i][j] = elem[i].nabr[j];
+            he->bc_type[i][j] = elem[i].attrib.bc_type[j];
+            he->edge[i][j] = elem[i].topo.edge[j];
+            he->nabrdist[i][j] = elem[i].topo.nabrdist[j];
+            he->nabr_x[i][j] = elem[i].topo.nabr_x[j];
+            he->nabr_y[i][j] = elem[i].topo.nabr_y[j];
+        }
+
+        he->area[i] = elem[i].topo.area;
+        he->zmin[i] = elem[i].topo.zmin;
+        he->zmax[i] = elem[i].topo.zmax;
+        he->rough[i] = elem[i].lc.rough;
+        he->depth[i] = elem[i].soil.depth;
+        he->ksath[i] = elem[i].soil.ksath;
+        he->ksatv[i] = elem[i].soil.ksatv;
+        he->kinfv[i] = elem[i].soil.kinfv;
+        he->dinf[i] = elem[i].soil.dinf;
+        he->alpha[i] = elem[i].soil.alpha;
+        he->beta[i] = elem[i].soil.beta;
+        he->porosity[i] = elem[i].soil.porosity;
+        he->dmac[i] = elem[i].soil.dmac;
+        he->kmach[i] = elem[i].soil.kmach;
+        he->kmacv[i] = elem[i].soil.kmacv;
+        he->areafv[i] = elem[i].soil.areafv;
+        he->areafh[i] = elem[i].soil.areafh;
+
+#if defined(_FBR_)
+        he->zbed[i] = elem[i].topo.zbed;
+        he->geol_depth[i] = elem[i].geol.depth;
+        he->geol_ksath[i] = elem[i].geol.ksath;
+        he->geol_ksatv[i] = elem[i].geol.ksatv;
+        he->geol_alpha[i] = elem[i].geol.alpha;
+        he->geol_beta[i] = elem[i].geol.beta;
+        he->geol_porosity[i] = elem[i].geol.porosity;
+
+        /* Fractured bedrock flows under river segments, thus the neighbor
+         * across a river segment is the element on the other side */
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            he->fbrbc_type[i][j] = elem[i].attrib.fbrbc_type[j];
+
+            if (elem[i].nabr[j] == 0)
+            {
+                he->fbr_nabr[i][j] = 0;
+                he->fbr_dist[i][j] = 0.0;
+            }
+            else if (elem[i].nabr[j] > 0)
+            {
+                he->fbr_nabr[i][j] = elem[i].nabr[j];
+                he->fbr_dist[i][j] = elem[i].topo.nabrdist[j];
+            }
+            else
+            {
+                int             k;
+                const river_struct *rivnabr;
+                const elem_struct *nabr;
+
+                rivnabr = &river[-elem[i].nabr[j] - 1];
+                he->fbr_nabr[i][j] = (rivnabr->leftele == i + 1) ?
+                    rivnabr->rightele : rivnabr->leftele;
+                nabr = &elem[he->fbr_nabr[i][j] - 1];
+
+                he->fbr_dist[i][j] = 0.0;
+                for (k = 0; k < NUM_EDGE; k++)
+                {
+                    if (nabr->nabr[k] == elem[i].nabr[j])
+                    {
+                        he->fbr_dist[i][j] = elem[i].topo.nabrdist[j] +
+                            nabr->topo.nabrdist[k];
+                        break;
+                    }
+                }
+
+                if (he->fbr_dist[i][j] == 0.0)
+                {
+                    PIHMprintf(VL_ERROR,
+                        "Error finding distance between elements.\n");
+                    PIHMexit(EXIT_FAILURE);
+                }
+            }
+        }
+#endif
+    }
+
+    /*
+     * Element faces. Fluxes across a face shared by two elements are
+     * antisymmetric, thus each face is only visited once
+     */
+    he->nface = 0;
+    for (i = 0; i < nelem; i++)
+    {
+        int             j;
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            he->nface += (elem[i].nabr[j] == 0 || elem[i].nabr[j] > i + 1);
+        }
+    }
+
+    he->face_elem = (int (*)[2])malloc(he->nface * sizeof(*he->face_elem));
+    he->face_edge = (int (*)[2])malloc(he->nface * sizeof(*he->face_edge));
+
+    k = 0;
+    for (i = 0; i < nelem; i++)
+    {
+        int             j;
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            if (elem[i].nabr[j] == 0)
+            {
+                he->face_elem[k][0] = i;
+                he->face_edge[k][0] = j;
+                he->face_elem[k][1] = -1;
+                he->face_edge[k][1] = -1;
+                k++;
+            }
+            else if (elem[i].nabr[j] > i + 1)
+            {
+                int             jn;
+                const elem_struct *nabr;
+
+                nabr = &elem[elem[i].nabr[j] - 1];
+
+                for (jn = 0; jn < NUM_EDGE; jn++)
+                {
+                    if (nabr->nabr[jn] == i + 1)
+                    {
+                        break;
+                    }
+                }
+
+                if (jn == NUM_EDGE)
+                {
+                    PIHMprintf(VL_ERROR,
+                        "Error: Element %d is not a neighbor of Element %d.\n",
+                        i + 1, elem[i].nabr[j]);
+                    PIHMexit(EXIT_FAILURE);
+                }
+
+                he->face_elem[k][0] = i;
+                he->face_edge[k][0] = j;
+                he->face_elem[k][1] = elem[i].nabr[j] - 1;
+                he->face_edge[k][1] = jn;
+                k++;
+            }
+        }
+    }
+
+    /*
+     * River variables
+     */
+    hr->leftele = (int *)malloc(nriver * sizeof(int));
+    hr->rightele = (int *)malloc(nriver * sizeof(int));
+    hr->down = (int *)malloc(nriver * sizeof(int));
+    hr->riverbc_type = (int *)malloc(nriver * sizeof(int));
+    hr->area = (double *)malloc(nriver * sizeof(double));
+    hr->zmin = (double *)malloc(nriver * sizeof(double));
+    hr->zmax = (double *)malloc(nriver * sizeof(double));
+    hr->zbed = (double *)malloc(nriver * sizeof(double));
+    hr->node_zmax = (double *)malloc(nriver * sizeof(double));
+    hr->dist_left = (double *)malloc(nriver * sizeof(double));
+    hr->dist_right = (double *)malloc(nriver * sizeof(double));
+    hr->depth = (double *)malloc(nriver * sizeof(double));
+    hr->intrpl_ord = (int *)malloc(nriver * sizeof(int));
+    hr->coeff = (double *)malloc(nriver * sizeof(double));
+    hr->length = (double *)malloc(nriver * sizeof(double));
+    hr->width = (double *)malloc(nriver * sizeof(double));
+    hr->rough = (double *)malloc(nriver * sizeof(double));
+    hr->cwr = (double *)malloc(nriver * sizeof(double));
+    hr->ksath = (double *)malloc(nriver * sizeof(double));
+    hr->ksatv = (double *)malloc(nriver * sizeof(double));
+    hr->bedthick = (double *)malloc(nriver * sizeof(double));
+    hr->porosity = (double *)malloc(nriver * sizeof(double));
+    hr->bc = (river_bc_struct *)malloc(nriver * sizeof(river_bc_struct));
+    hr->stage = (double *)malloc(nriver * sizeof(double));
+    hr->gw = (double *)malloc(nriver * sizeof(double));
+    hr->rivflow =
+        (double (*)[NUM_RIVFLX])calloc(nriver, sizeof(*hr->rivflow));
+
+    for (i = 0; i < nriver; i++)
+    {
+        hr->leftele[i] = river[i].leftele;
+        hr->rightele[i] = river[i].rightele;
+        hr->down[i] = river[i].down;
+        hr->riverbc_type[i] = river[i].attrib.riverbc_type;
+        hr->area[i] = river[i].topo.area;
+        hr->zmin[i] = river[i].topo.zmin;
+        hr->zmax[i] = river[i].topo.zmax;
+        hr->zbed[i] = river[i].topo.zbed;
+        hr->node_zmax[i] = river[i].topo.node_zmax;
+        hr->dist_left[i] = river[i].topo.dist_left;
+        hr->dist_right[i] = river[i].topo.dist_right;
+        hr->depth[i] = river[i].shp.depth;
+        hr->intrpl_ord[i] = river[i].shp.intrpl_ord;
+        hr->coeff[i] = river[i].shp.coeff;
+        hr->length[i] = river[i].shp.length;
+        hr->width[i] = river[i].shp.width;
+        hr->rough[i] = river[i].matl.rough;
+        hr->cwr[i] = river[i].matl.cwr;
+        hr->ksath[i] = river[i].matl.ksath;
+        hr->ksatv[i] = river[i].matl.ksatv;
+        hr->bedthick[i] = river[i].matl.bedthick;
+        hr->porosity[i] = river[i].matl.porosity;
+    }
+
+    /*
+     * Upstream segments of each river segment in compressed sparse row
+     * format, so that the in-flow of each segment can be gathered in
+     * parallel
+     */
+    hr->up_start = (int *)calloc(nriver + 1, sizeof(int));
+
+    for (i = 0; i < nriver; i++)
+    {
+        if (river[i].down > nriver)
+        {
+            PIHMprintf(VL_ERROR,
+                "Error: Downstream segment of River %d is not defined.\n",
+                i + 1);
+            PIHMexit(EXIT_FAILURE);
+        }
+        else if (river[i].down > 0)
+        {
+            hr->up_start[river[i].down]++;
+        }
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        hr->up_start[i + 1] += hr->up_start[i];
+    }
+
+    hr->up = (int *)malloc(hr->up_start[nriver] * sizeof(int));
+    nup = (int *)calloc(nriver, sizeof(int));
+
+    /* Upstream segments are filled in ascending order, which keeps the
+     * summation order of the serial accumulation */
+    for (i = 0; i < nriver; i++)
+    {
+        int             down;
+
+        if (river[i].down > 0)
+        {
+            down = river[i].down - 1;
+            hr->up[hr->up_start[down] + nup[down]] = i;
+            nup[down]++;
+        }
+    }
+
+    free(nup);
+}
+
+void ElemToHydro(const elem_struct *elem, const river_struct *river,
+    hydro_struct *hydro)
+{
+    /*
+     * Copy inputs that may change between hydrology steps (forcing, boundary
+     * conditions, land surface variables) to the hydrology kernel
+     */
+    int             i;
+    hydro_elem_struct *he;
+    hydro_river_struct *hr;
+
+    he = &hydro->elem;
+    hr = &hydro->river;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        he->bc[i] = elem[i].bc;
+#if defined(_FBR_)
+        he->fbr_bc[i] = elem[i].fbr_bc;
+#endif
+        he->surf0[i] = elem[i].ws0.surf;
+        he->pcpdrp[i] = elem[i].wf.pcpdrp;
+        he->edir[i] = elem[i].wf.edir;
+        he->ett[i] = elem[i].wf.ett;
+#if defined(_NOAH_)
+        /* Fraction of transpiration from groundwater only depends on land
+         * surface variables */
+        he->gwet[i] = GwTransp(elem[i].wf.ett, elem[i].wf.et,
+            elem[i].ps.nwtbl, elem[i].ps.nroot);
+        he->fcr[i] = elem[i].ps.fcr;
+        he->sh2o[i] = elem[i].ws.sh2o[0];
+        he->smcmax[i] = elem[i].soil.smcmax;
+        he->smcmin[i] = elem[i].soil.smcmin;
+#else
+        he->rzd[i] = elem[i].ps.rzd;
+#endif
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        hr->bc[i] = river[i].bc;
+    }
+}
+
+void HydroToElem(const hydro_struct *hydro, elem_struct *elem,
+    river_struct *river)
+{
+    /*
+     * Copy hydrology kernel states and fluxes back to model structures
+     */
+    int             i;
+    const hydro_elem_struct *he;
+    const hydro_river_struct *hr;
+
+    he = &hydro->elem;
+    hr = &hydro->river;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        int             j;
+
+        elem[i].ws.surf = he->surf[i];
+        elem[i].ws.unsat = he->unsat[i];
+        elem[i].ws.gw = he->gw[i];
+        elem[i].ws.surfh = he->surfh[i];
+#if defined(_FBR_)
+        elem[i].ws.fbr_unsat = he->fbr_unsat[i];
+        elem[i].ws.fbr_gw = he->fbr_gw[i];
+#endif
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            elem[i].wf.ovlflow[j] = he->ovlflow[i][j];
+            elem[i].wf.subsurf[j] = he->subsurf[i][j];
+#if defined(_FBR_)
+            elem[i].wf.fbrflow[j] = he->fbrflow[i][j];
+#endif
+        }
+        elem[i].wf.infil = he->infil[i];
+        elem[i].wf.rechg = he->rechg[i];
+        elem[i].wf.edir_surf = he->edir_surf[i];
+        elem[i].wf.edir_unsat = he->edir_unsat[i];
+        elem[i].wf.edir_gw = he->edir_gw[i];
+        elem[i].wf.ett_unsat = he->ett_unsat[i];
+        elem[i].wf.ett_gw = he->ett_gw[i];
+#if defined(_FBR_)
+        elem[i].wf.fbr_infil = he->fbr_infil[i];
+        elem[i].wf.fbr_rechg = he->fbr_rechg[i];
+#endif
+#if defined(_NOAH_)
+        elem[i].ps.gwet = he->gwet[i];
+#endif
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        int             j;
+
+        river[i].ws.stage = hr->stage[i];
+        river[i].ws.gw = hr->gw[i];
+
+        for (j = 0; j < NUM_RIVFLX; j++)
+        {
+            river[i].wf.rivflow[j] = hr->rivflow[i][j];
+        }
+    }
+}
+
+void FreeHydro(hydro_struct *hydro)
+{
+    hydro_elem_struct *he;
+    hydro_river_struct *hr;
+
+    he = &hydro->elem;
+    hr = &hydro->river;
+
+    free(he->nabr);
+    free(he->bc_type);
+    free(he->area);
+    free(he->zmin);
+    free(he->zmax);
+    free(he->edge);
+    free(he->nabrdist);
+    free(he->nabr_x);
+    free(he->nabr_y);
+    free(he->rough);
+    free(he->depth);
+    free(he->ksath);
+    free(he->ksatv);
+    free(he->kinfv);
+    free(he->dinf);
+    free(he->alpha);
+    free(he->beta);
+    free(he->porosity);
+    free(he->dmac);
+    free(he->kmach);
+    free(he->kmacv);
+    free(he->areafv);
+    free(he->areafh);
+#if defined(_FBR_)
+    free(he->fbrbc_type);
+    free(he->fbr_nabr);
+    free(he->fbr_dist);
+    free(he->zbed);
+    free(he->geol_depth);
+    free(he->geol_ksath);
+    free(he->geol_ksatv);
+    free(he->geol_alpha);
+    free(he->geol_beta);
+    free(he->geol_porosity);
+#endif
+    free(he->bc);
+#if defined(_FBR_)
+    free(he->fbr_bc);
+#endif
+    free(he->surf0);
+    free(he->pcpdrp);
+    free(he->edir);
+    free(he->ett);
+#if defined(_NOAH_)
+    free(he->gwet);
+    free(he->fcr);
+    free(he->sh2o);
+    free(he->smcmax);
+    free(he->smcmin);
+#else
+    free(he->rzd);
+#endif
+    free(he->surf);
+    free(he->unsat);
+    free(he->gw);
+    free(he->surfh);
+#if defined(_FBR_)
+    free(he->fbr_unsat);
+    free(he->fbr_gw);
+#endif
+    free(he->ovlflow);
+    free(he->subsurf);
+    free(he->infil);
+    free(he->rechg);
+    free(he->edir_surf);
+    free(he->edir_unsat);
+    free(he->edir_gw);
+    free(he->ett_unsat);
+    free(he->ett_gw);
+#if defined(_FBR_)
+    free(he->fbrflow);
+    free(he->fbr_infil);
+    free(he->fbr_rechg);
+#endif
+    free(he->face_elem);
+    free(he->face_edge);
+    free(he->dhbydx);
+    free(he->dhbydy);
+
+    free(hr->leftele);
+    free(hr->rightele);
+    free(hr->down);
+    free(hr->up_start);
+    free(hr->up);
+    free(hr->riverbc_type);
+    free(hr->area);
+    free(hr->zmin);
+    free(hr->zmax);
+    free(hr->zbed);
+    free(hr->node_zmax);
+    free(hr->dist_left);
+    free(hr->dist_right);
+    free(hr->depth);
+    free(hr->intrpl_ord);
+    free(hr->coeff);
+    free(hr->length);
+    free(hr->width);
+    free(hr->rough);
+    free(hr->cwr);
+    free(hr->ksath);
+    free(hr->ksatv);
+    free(hr->bedthick);
+    free(hr->porosity);
+    free(hr->bc);
+    free(hr->stage);
+    free(hr->gw);
+    free(hr->rivflow);
+}
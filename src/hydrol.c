@@ -1,6 +1,7 @@
 #include "pihm.h"
 
-void Hydrol(elem_struct *elem, river_struct *river, const ctrl_struct *ctrl)
+void Hydrol(hydro_elem_struct *elem, hydro_river_struct *river,
+    const ctrl_struct *ctrl)
 {
     int             i;
 
@@ -10,7 +11,7 @@ void Hydrol(elem_struct *elem, river_struct *river, const ctrl_struct *ctrl)
     for (i = 0; i < nelem; i++)
     {
         /* Calculate actual surface water depth */
-        elem[i].ws.surfh = SurfH(elem[i].ws.surf);
+        elem->surfh[i] = SurfH(elem->surf[i]);
     }
 
     /* Determine which layers does ET extract water from */
@@ -24,7 +25,7 @@ void Hydrol(elem_struct *elem, river_struct *river, const ctrl_struct *ctrl)
     RiverFlow(elem, river, ctrl->riv_mode);
 }
 
-void EtExtract(elem_struct *elem)
+void EtExtract(hydro_elem_struct *elem)
 {
     int             i;
 
@@ -33,60 +34,63 @@ void EtExtract(elem_struct *elem)
 #endif
     for (i = 0; i < nelem; i++)
     {
-        /* Source of direct evaporation */
+        EtExtractElem(elem, i);
+    }
+}
+
+void EtExtractElem(hydro_elem_struct *elem, int i)
+{
+    /* Source of direct evaporation */
 #if defined(_NOAH_)
-        if (elem[i].ws.gw > elem[i].soil.depth - elem[i].soil.dinf)
-        {
-            elem[i].wf.edir_surf = 0.0;
-            elem[i].wf.edir_unsat = 0.0;
-            elem[i].wf.edir_gw = elem[i].wf.edir;
-        }
-        else
-        {
-            elem[i].wf.edir_surf = 0.0;
-            elem[i].wf.edir_unsat = elem[i].wf.edir;
-            elem[i].wf.edir_gw = 0.0;
-        }
+    if (elem->gw[i] > elem->depth[i] - elem->dinf[i])
+    {
+        elem->edir_surf[i] = 0.0;
+        elem->edir_unsat[i] = 0.0;
+        elem->edir_gw[i] = elem->edir[i];
+    }
+    else
+    {
+        elem->edir_surf[i] = 0.0;
+        elem->edir_unsat[i] = elem->edir[i];
+        elem->edir_gw[i] = 0.0;
+    }
 #else
-        if (elem[i].ws.surfh >= DEPRSTG)
-        {
-            elem[i].wf.edir_surf = elem[i].wf.edir;
-            elem[i].wf.edir_unsat = 0.0;
-            elem[i].wf.edir_gw = 0.0;
-        }
-        else if (elem[i].ws.gw > elem[i].soil.depth - elem[i].soil.dinf)
-        {
-            elem[i].wf.edir_surf = 0.0;
-            elem[i].wf.edir_unsat = 0.0;
-            elem[i].wf.edir_gw = elem[i].wf.edir;
-        }
-        else
-        {
-            elem[i].wf.edir_surf = 0.0;
-            elem[i].wf.edir_unsat = elem[i].wf.edir;
-            elem[i].wf.edir_gw = 0.0;
-        }
+    if (elem->surfh[i] >= DEPRSTG)
+    {
+        elem->edir_surf[i] = elem->edir[i];
+        elem->edir_unsat[i] = 0.0;
+        elem->edir_gw[i] = 0.0;
+    }
+    else if (elem->gw[i] > elem->depth[i] - elem->dinf[i])
+    {
+        elem->edir_surf[i] = 0.0;
+        elem->edir_unsat[i] = 0.0;
+        elem->edir_gw[i] = elem->edir[i];
+    }
+    else
+    {
+        elem->edir_surf[i] = 0.0;
+        elem->edir_unsat[i] = elem->edir[i];
+        elem->edir_gw[i] = 0.0;
+    }
 #endif
 
-        /* Source of transpiration */
+    /* Source of transpiration */
 #if defined(_NOAH_)
-        elem[i].ps.gwet = GwTransp(elem[i].wf.ett, elem[i].wf.et,
-            elem[i].ps.nwtbl, elem[i].ps.nroot);
-        elem[i].wf.ett_unsat = (1.0 - elem[i].ps.gwet) * elem[i].wf.ett;
-        elem[i].wf.ett_gw = elem[i].ps.gwet * elem[i].wf.ett;
+    elem->ett_unsat[i] = (1.0 - elem->gwet[i]) * elem->ett[i];
+    elem->ett_gw[i] = elem->gwet[i] * elem->ett[i];
 #else
-        if (elem[i].ws.gw > elem[i].soil.depth - elem[i].ps.rzd)
-        {
-            elem[i].wf.ett_unsat = 0.0;
-            elem[i].wf.ett_gw = elem[i].wf.ett;
-        }
-        else
-        {
-            elem[i].wf.ett_unsat = elem[i].wf.ett;
-            elem[i].wf.ett_gw = 0.0;
-        }
-#endif
+    if (elem->gw[i] > elem->depth[i] - elem->rzd[i])
+    {
+        elem->ett_unsat[i] = 0.0;
+        elem->ett_gw[i] = elem->ett[i];
     }
+    else
+    {
+        elem->ett_unsat[i] = elem->ett[i];
+        elem->ett_gw[i] = 0.0;
+    }
+#endif
 }
 
 double SurfH(double surfeqv)
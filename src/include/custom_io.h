@@ -1,15 +1,38 @@
 #ifndef CUCTOMIO_HEADER
 #define CUCTOMIO_HEADER
 
+#include <setjmp.h>
+
+extern jmp_buf *exit_env;
+#if !defined(_WIN32) && !defined(_WIN64)
+extern pthread_t exit_thread;
+#endif
+
 void            _custom_exit(const char *, int, const char *, int, int);
 void            _custom_printf(const char *, int, const char *, int, int, int,
     const char *, ...);
+void           *_custom_calloc(size_t, size_t);
+int             _custom_fclose(FILE *);
+FILE           *_custom_fopen(const char *, const char *);
+void            _custom_free(void *);
+void           *_custom_malloc(size_t);
+void           *_custom_realloc(void *, size_t);
+#if defined(_DEBUG_)
+long int        AllocCount(void);
+#endif
 void            CheckFile(const FILE *, const char *);
 int             CountLine(FILE *, char *, int, ...);
 int             CountOccurr(FILE *, const char *);
+int             ErrorReturns(void);
 void            FindLine(FILE *, const char *, int *, const char *);
 void            NextLine(FILE *, char *, int *);
 int             Readable(const char *);
+void            StartTracking(void);
+void            StopTracking(int);
+int             TrackedThread(void);
+void            TrackPtr(void *, int);
+size_t          TrackSlot(const void *);
+int             UntrackPtr(const void *);
 
 /* Maximum string length */
 #define MAXSTRING    1024
@@ -21,4 +44,20 @@ int             Readable(const char *);
 #define VL_NORMAL     0
 #define VL_VERBOSE    1
 
+/* Slots of the hash table of tracked heap blocks and files */
+#define TRACK_INIT_SIZE    1024
+#define TRACK_DELETED      -1
+#define TRACK_EMPTY        0
+#define TRACK_HEAP         1
+#define TRACK_FILE         2
+
+/* Heap allocations and files are tracked while models are created or
+ * initialized, and heap allocations are counted in debug mode */
+#define calloc(num, size)     _custom_calloc(num, size)
+#define fclose(fp)            _custom_fclose(fp)
+#define fopen(fn, mode)       _custom_fopen(fn, mode)
+#define free(ptr)             _custom_free(ptr)
+#define malloc(size)          _custom_malloc(size)
+#define realloc(ptr, size)    _custom_realloc(ptr, size)
+
 #endif
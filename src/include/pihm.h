@@ -3,6 +3,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <math.h>
 #include <string.h>
 #include <time.h>
@@ -14,6 +15,9 @@
 # include <io.h>
 #else
 # include <unistd.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <pthread.h>
 #endif
 #include <stdarg.h>
 #if defined(_OPENMP)
@@ -44,6 +48,12 @@
 /* CVDENSE header file */
 #include "cvode_dense.h"
 
+/* CVSPARSE header files */
+#include "cvode_sparse.h"
+#if defined(_KLU_)
+# include "cvode_klu.h"
+#endif
+
 #if defined(_NOAH_)
 # include "spa.h"
 #endif
@@ -158,6 +158,59 @@
 #define RELAX       0
 #define RST_FILE    1
 
+/* Linear solver type */
+#define SPGMR_SOLVER        0
+#define KLU_SOLVER          1
+
+/* Preconditioner type */
+#define NO_PRECOND      0
+#define BLOCK_JACOBI    1
+
+/* Model grid reordering type */
+#define NO_REORDER         0
+#define RCM_REORDER        1
+#define HILBERT_REORDER    2
+
+/* Size of the grid on which the Hilbert curve is defined */
+#define HILBERT_SIZE    32768
+
+/* Buffered output (bytes) that is written to disk regardless of the output
+ * flush interval */
+#define OUTPUT_BUFSIZE  67108864
+
+/* Binary output format */
+#define DAT_OUTPUT          0
+#define CONTAINER_OUTPUT    1
+
+/* Output container file */
+#define CONTAINER_MAGIC     "PIHMOUT"
+#define CONTAINER_IDX_MAGIC "PIHMIDX"
+#define CONTAINER_VERSION   1
+#define CONTAINER_HDR_SIZE  32      /* bytes of file header */
+#define CONTAINER_VAR_SIZE  112     /* bytes of variable description,
+                                     * excluding element ids */
+#define CONTAINER_IDX_SIZE  40      /* bytes of chunk header (index entry) */
+#define CONTAINER_TRL_SIZE  24      /* bytes of trailer */
+#define CONTAINER_NAME_LEN  64      /* bytes of variable name */
+#define CONTAINER_UNIT_LEN  32      /* bytes of variable unit */
+#define SHUFFLE_FILTER      1
+#define OUTPUT_CHUNK_NT     16      /* maximum records in a chunk */
+#define OUTPUT_CHUNK_NS     1024    /* maximum elements (river segments) in
+                                     * a chunk */
+#define LZ_HASH_BITS        14      /* size of LZ compressor hash table */
+
+/* K-d tree of element edges for horizon angle calculation */
+#define EDGETREE_LEAF     8     /* maximum number of edges in a leaf */
+#define EDGETREE_DEPTH    64    /* maximum depth of the tree */
+
+/* Binary time series file */
+#define BINTS_MAGIC      "PIHMTS"
+#define BINTS_VERSION    1
+
+/* Model cache file */
+#define CACHE_MAGIC      "PIHMMDL"
+#define CACHE_VERSION    1
+
 /* Average flux */
 #define SUM    0
 #define AVG    1
@@ -166,6 +219,24 @@
  * storage at steady-state (m) */
 #define SPINUP_W_TOLERANCE    0.01
 
+/* Anderson acceleration of spinup cycles */
+#define SPINUP_ACC_DEPTH      5         /* maximum number of previous cycles
+                                         * used */
+#define SPINUP_ACC_COND       1.0E-12   /* minimum relative pivot of normal
+                                         * equations */
+
+/* CVODE max step controller */
+#define STEPCTRL_WINDOW       5         /* max steps per sample window of
+                                         * solver statistics */
+
+/* Number of hydrologic states of elements and river segments */
+#if defined(_FBR_)
+# define NUM_HYDROL_ELEM      5
+#else
+# define NUM_HYDROL_ELEM      3
+#endif
+#define NUM_HYDROL_RIVER      2
+
 /* Ecosystem constants */
 #define RAD2PAR             0.45    /* ratio PAR / SWtotal (-) */
 #define EPAR                4.55    /* (umol/J) PAR photon energy ratio */
@@ -236,6 +307,17 @@
 #define ELEMVAR     0
 #define RIVERVAR    1
 
+/* Output reducers */
+#define NO_REDUCE        0
+#define REDUCE_MEAN      1      /* area-weighted mean over a group */
+#define REDUCE_SUM       2      /* area-weighted sum over a group */
+#define REDUCE_MIN       3      /* minimum over a group */
+#define REDUCE_MAX       4      /* maximum over a group */
+#define REDUCE_SELECT    5      /* values of group members */
+
+/* Output reducer group type including all elements (river segments) */
+#define ALLVAR      2
+
 #define SURF_CTRL               0
 #define UNSAT_CTRL              1
 #define GW_CTRL                 2
@@ -382,6 +464,9 @@ extern int     append_mode;
 extern int     corr_mode;
 extern int     spinup_mode;
 extern int     tecplot;
+extern int     benchmark;
+extern int     convert_mode;
+extern int     cache_mode;
 extern char    project[MAXSTRING];
 extern int     nelem;
 extern int     nriver;
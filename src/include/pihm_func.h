@@ -3,32 +3,93 @@
 
 #define _ARITH_
 
-/* State variables */
-#define SURF(i)          i
-#define UNSAT(i)         i + nelem
-#define GW(i)            i + 2 * nelem
-#define RIVSTG(i)        i + 3 * nelem
-#define RIVGW(i)         i + 3 * nelem + nriver
-#if defined(_FBR_)
-# define FBRUNSAT(i)     i + 3 * nelem + 2 * nriver
-# define FBRGW(i)        i + 4 * nelem + 2 * nriver
+/*
+ * State variables
+ *
+ * By default, each type of state variable is stored in a contiguous block. When
+ * compiled with _INTERLEAVED_, all state variables of an element (river
+ * segment) are stored next to each other, with elements followed by river
+ * segments
+ */
+#if defined(_INTERLEAVED_)
+# define SURF(i)         ((i) * NSV_ELEM)
+# define UNSAT(i)        ((i) * NSV_ELEM + 1)
+# define GW(i)           ((i) * NSV_ELEM + 2)
+# define RIVSTG(i)       (nelem * NSV_ELEM + (i) * NSV_RIVER)
+# define RIVGW(i)        (nelem * NSV_ELEM + (i) * NSV_RIVER + 1)
+# if defined(_FBR_)
+#  define FBRUNSAT(i)    ((i) * NSV_ELEM + 3)
+#  define FBRGW(i)       ((i) * NSV_ELEM + 4)
+# endif
+# if defined(_BGC_) && !defined(_LUMPED_)
+#  define SURFN(i)       ((i) * NSV_ELEM + 3)
+#  define SMINN(i)       ((i) * NSV_ELEM + 4)
+#  define STREAMN(i)     (nelem * NSV_ELEM + (i) * NSV_RIVER + 2)
+#  define RIVBEDN(i)     (nelem * NSV_ELEM + (i) * NSV_RIVER + 3)
+# else
+#  define LUMPED_SMINN   (nelem * NSV_ELEM + nriver * NSV_RIVER)
+# endif
+# if defined(_CYCLES_)
+#  define NO3(i)         ((i) * NSV_ELEM + 3)
+#  define NH4(i)         ((i) * NSV_ELEM + 4)
+#  define STREAMNO3(i)   (nelem * NSV_ELEM + (i) * NSV_RIVER + 2)
+#  define RIVBEDNO3(i)   (nelem * NSV_ELEM + (i) * NSV_RIVER + 3)
+#  define STREAMNH4(i)   (nelem * NSV_ELEM + (i) * NSV_RIVER + 4)
+#  define RIVBEDNH4(i)   (nelem * NSV_ELEM + (i) * NSV_RIVER + 5)
+# endif
+#else
+# define SURF(i)         i
+# define UNSAT(i)        i + nelem
+# define GW(i)           i + 2 * nelem
+# define RIVSTG(i)       i + 3 * nelem
+# define RIVGW(i)        i + 3 * nelem + nriver
+# if defined(_FBR_)
+#  define FBRUNSAT(i)    i + 3 * nelem + 2 * nriver
+#  define FBRGW(i)       i + 4 * nelem + 2 * nriver
+# endif
+# if defined(_BGC_) && !defined(_LUMPED_)
+#  define SURFN(i)       i + 3 * nelem + 2 * nriver
+#  define SMINN(i)       i + 4 * nelem + 2 * nriver
+#  define STREAMN(i)     i + 5 * nelem + 2 * nriver
+#  define RIVBEDN(i)     i + 5 * nelem + 3 * nriver
+# else
+#  define LUMPED_SMINN   3 * nelem + 2 * nriver
+# endif
+# if defined(_CYCLES_)
+#  define NO3(i)         i + 3 * nelem + 2 * nriver
+#  define NH4(i)         i + 4 * nelem + 2 * nriver
+#  define STREAMNO3(i)   i + 5 * nelem + 2 * nriver
+#  define RIVBEDNO3(i)   i + 5 * nelem + 3 * nriver
+#  define STREAMNH4(i)   i + 5 * nelem + 4 * nriver
+#  define RIVBEDNH4(i)   i + 5 * nelem + 5 * nriver
+# endif
 #endif
-#if defined(_BGC_) && !defined(_LUMPED_)
-# define SURFN(i)        i + 3 * nelem + 2 * nriver
-# define SMINN(i)        i + 4 * nelem + 2 * nriver
-# define STREAMN(i)      i + 5 * nelem + 2 * nriver
-# define RIVBEDN(i)      i + 5 * nelem + 3 * nriver
+
+/* Number of state variables attached to each element and river segment */
+#if defined(_FBR_) || (defined(_BGC_) && !defined(_LUMPED_)) || \
+    defined(_CYCLES_)
+# define NSV_ELEM        5
 #else
-# define LUMPED_SMINN    3 * nelem + 2 * nriver
+# define NSV_ELEM        3
 #endif
-#if defined(_CYCLES_)
-# define NO3(i)          i + 3 * nelem + 2 * nriver
-# define NH4(i)          i + 4 * nelem + 2 * nriver
-# define STREAMNO3(i)    i + 5 * nelem + 2 * nriver
-# define RIVBEDNO3(i)    i + 5 * nelem + 3 * nriver
-# define STREAMNH4(i)    i + 5 * nelem + 4 * nriver
-# define RIVBEDNH4(i)    i + 5 * nelem + 5 * nriver
+#if defined(_BGC_) && !defined(_LUMPED_)
+# define NSV_RIVER       4
+#elif defined(_CYCLES_)
+# define NSV_RIVER       6
+#else
+# define NSV_RIVER       2
 #endif
+#define MAXNSV           ((NSV_ELEM > NSV_RIVER) ? NSV_ELEM : NSV_RIVER)
+
+/* State variables of the fast subsystem in multi-rate integration. The last
+ * components accumulate exchange with the slow subsystem, and outlet
+ * discharge */
+#define FAST_SURF(i)     (i)
+#define FAST_RIVSTG(i)   (nelem + (i))
+#define FAST_UNSAT(i)    (nelem + nriver + (i))
+#define FAST_GW(i)       (2 * nelem + nriver + (i))
+#define FAST_RIVGW(i)    (3 * nelem + nriver + (i))
+#define FAST_DISCHARGE   (3 * nelem + 2 * nriver)
 
 #define AvgElev(...)      _WsAreaElev(WS_ZMAX, __VA_ARGS__)
 #define AvgZmin(...)      _WsAreaElev(WS_ZMIN, __VA_ARGS__)
@@ -67,9 +128,12 @@
  * Function Declarations
  */
 double          _WsAreaElev(int, const elem_struct *);
-void            AdjCVodeMaxStep(void *, ctrl_struct *);
-void            ApplyBc(forc_struct *, elem_struct *, river_struct *, int);
-void            ApplyElemBc(forc_struct *, elem_struct *, int);
+void            AccumUpstreamFlux(hydro_river_struct *, int);
+void            AddContainerRecords(outcont_struct *, int, const char *,
+    size_t);
+void            AppendOutput(outwriter_struct *, int, const void *, size_t);
+void            ApplyBc(forc_struct *, river_struct *, int);
+void            ApplyElemBc(forc_struct *, int);
 #if defined(_NOAH_)
 void            ApplyForc(forc_struct *, elem_struct *, int, int,
     const siteinfo_struct *);
@@ -88,62 +152,123 @@ void            ApplyMeteoForc(forc_struct *, elem_struct *, int, int,
 void            ApplyMeteoForc(forc_struct *, elem_struct *, int);
 #endif
 void            ApplyRiverBc(forc_struct *, river_struct *, int);
-double          AvgKv(const soil_struct *, double, double, double);
+double          AvgKv(const hydro_elem_struct *, int, double, double);
 double          AvgH(double, double, double);
 double          AvgHsurf(double, double, double);
 void            BackupInput(const char *, const filename_struct *);
-void            BoundFluxElem(int, int, const bc_struct *,
-    const wstate_struct *, const topo_struct *, const soil_struct *,
-    wflux_struct *);
-double          BoundFluxRiver(int, const river_wstate_struct *,
-    const river_topo_struct *, const shp_struct *, const matl_struct *,
-    const river_bc_struct *bc);
+void            BenchmarkRhs(pihm_struct, void *, N_Vector, int);
+void            BoundFluxElem(hydro_elem_struct *, int, int);
+double          BoundFluxRiver(const hydro_river_struct *, int);
 void            CalcModelStep(ctrl_struct *);
-double          ChanFlowElemToRiver(const elem_struct *, double,
-    const river_struct *, double);
-double          ChanFlowRiverToRiver(const river_struct *, const river_struct *,
-    int);
-double          ChanLeak(const river_wstate_struct *, const river_topo_struct *,
-    const shp_struct *, const matl_struct *);
+double          ChanFlowElemToRiver(const hydro_elem_struct *, int, double,
+    const hydro_river_struct *, int, double);
+double          ChanFlowRiverToRiver(const hydro_river_struct *, int, int, int);
+double          ChanLeak(const hydro_river_struct *, int);
 int             CheckCVodeFlag(int);
 void            CheckDy(double, const char *, const char *, int, double);
+void            CheckForcTime(const tsdata_struct *, int, int);
+int             ColorGraph(const graph_struct *, int, int *);
+int             CompareIntPair(const void *, const void *);
 #if defined(_BGC_)
-int             CheckSteadyState(const elem_struct *, double, int, int, int);
+int             CheckSteadyState(const elem_struct *, double, int, int, int,
+    spinprev_struct *);
 #else
-int             CheckSteadyState(const elem_struct *, double, int, int);
+int             CheckSteadyState(const elem_struct *, double, int, int,
+    spinprev_struct *);
 #endif
+void            CloseOutputContainer(outcont_struct *);
+void            CloseOutputWriter(outwriter_struct *);
 void            CorrElev(elem_struct *, river_struct *);
+int             CountTextLine(const txtfile_struct *, int, int, ...);
+int             CountTextOccurr(const txtfile_struct *, const char *);
 void            CreateOutputDir(char *);
+void            DefaultCtx(ctx_struct *);
 double          DhByDl(const double *, const double *, const double *);
-double          EffKh(const soil_struct *, double);
-double          EffKinf(const soil_struct *, double, double, double, double,
+void            DropSpinAccHist(spinacc_struct *);
+double          EffKh(const hydro_elem_struct *, int);
+double          EffKinf(const hydro_elem_struct *, int, double, double, double,
     double);
 double          EffKv(const soil_struct *, double, int);
-void            EtExtract(elem_struct *);
+void            ElemRhs(const hydro_elem_struct *, int, double, double *);
+void            ElemToHydro(const elem_struct *, const river_struct *,
+    hydro_struct *);
+void            EnterModel(const ctx_struct *, jmp_buf *);
+void            EtExtract(hydro_elem_struct *);
+void            EtExtractElem(hydro_elem_struct *, int);
+void            FastElemRhs(const hydro_elem_struct *, int, double, double *);
+void            FastHydrol(hydro_elem_struct *, hydro_river_struct *,
+    const ctrl_struct *);
+int             FastOde(realtype, N_Vector, N_Vector, void *);
+int             FastPrecSetup(realtype, N_Vector, N_Vector, booleantype,
+    booleantype *, realtype, void *, N_Vector, N_Vector, N_Vector);
+int             FastPrecSolve(realtype, N_Vector, N_Vector, N_Vector,
+    N_Vector, realtype, realtype, int, void *, N_Vector);
+void            FastRiverRhs(const hydro_river_struct *, int, double,
+    double *);
 double          FieldCapacity(double, double, double, double);
+void            FillMeteoBuf(forc_struct *, int);
+int             FindTextLine(const txtfile_struct *, int, const char *);
+void            FirstTouch(N_Vector);
+void            FlushOpenWriters(void);
+void            FlushOutput(outwriter_struct *, int);
 void            FreeAtttbl(atttbl_struct *);
+void            FreeBinTs(int, tsdata_struct *, tsmap_struct *);
 void            FreeCtrl(ctrl_struct *);
 void            FreeForc(forc_struct *);
+void            FreeGraph(graph_struct *);
+void            FreeHydro(hydro_struct *);
 void            FreeLctbl(lctbl_struct *);
 void            FreeMatltbl(matltbl_struct *);
 void            FreeMeshtbl(meshtbl_struct *);
+void            FreeMeteoStream(forc_struct *);
+void            FreeMultiRate(multirate_struct *);
+void            FreeOutput(int, int, print_struct *);
 void            FreeMem(pihm_struct);
+void            FreeOutputWriter(outwriter_struct *);
+void            FreePrecond(int, prec_struct *);
+void            FreeReducetbl(reducetbl_struct *);
 void            FreeRivtbl(rivtbl_struct *);
+void            FreeSharedTs(int, tsdata_struct *);
 void            FreeShptbl(shptbl_struct *);
 void            FreeSoiltbl(soiltbl_struct *);
-void            FrictSlope(const elem_struct *, const river_struct *, int,
-    double *, double *);
-void            Hydrol(elem_struct *, river_struct *, const ctrl_struct *);
-double          Infil(const wstate_struct *, const wstate_struct *,
-    const wflux_struct *, const topo_struct *, const soil_struct *, double);
+void            FreeSparseJac(jac_struct *);
+void            FreeSpinAcc(spinacc_struct *);
+void            FreeTextFile(txtfile_struct *);
+void            FrictSlope(const hydro_elem_struct *,
+    const hydro_river_struct *, int, double *, double *);
+void            FusedFrictSlope(const double *, hydro_elem_struct *,
+    const hydro_river_struct *, int, int);
+void            FusedRhs(double, const double *, double *, hydro_elem_struct *,
+    hydro_river_struct *, const ctrl_struct *);
+void            GetGlobalCtx(ctx_struct *);
+void            GetHydrolState(N_Vector, double *);
+uint64_t        HashFile(const char *, uint64_t);
+int             HilbertInd(int, int);
+void            HilbertOrder(const meshtbl_struct *, int *);
+void            Hydrol(hydro_elem_struct *, hydro_river_struct *,
+    const ctrl_struct *);
+void            HydroToElem(const hydro_struct *, elem_struct *,
+    river_struct *);
+double          Infil(const hydro_elem_struct *, int, double);
+void            InitBcMap(elem_struct *, forc_struct *);
 void            InitEFlux(eflux_struct *);
 void            InitEState(estate_struct *);
 void            InitForc(elem_struct *, forc_struct *, const calib_struct *);
+void            InitGraph(const elem_struct *, const river_struct *,
+    graph_struct *);
+void            InitHydro(const elem_struct *, const river_struct *,
+    hydro_struct *);
 void            Initialize(pihm_struct, N_Vector, void **);
 void            InitLc(elem_struct *, const lctbl_struct *,
     const calib_struct *);
 void            InitMesh(elem_struct *, const meshtbl_struct *);
-void            InitOutputFile(print_struct *, const char *, int, int);
+void            InitMeteoMap(const elem_struct *, forc_struct *);
+void            InitMultiRate(const graph_struct *, int, multirate_struct *);
+void            InitOutputFile(print_struct *, const char *, int, int, int);
+void            InitOutputContainer(print_struct *, const river_struct *,
+    const char *);
+void            InitOutputWriter(print_struct *, int, int);
+void            InitPrecond(const graph_struct *, prec_struct *);
 void            InitPrtVarCtrl(const char *, const char *, int, int, int,
     varctrl_struct *);
 void            InitRiver(river_struct *, elem_struct *, const rivtbl_struct *,
@@ -158,6 +283,10 @@ void            InitSoil(elem_struct *, const soiltbl_struct *,
 void            InitSoil(elem_struct *, const soiltbl_struct *,
     const calib_struct *);
 #endif
+void            InitSparseJac(const graph_struct *, jac_struct *);
+void            InitSpinAcc(spinacc_struct *);
+void            InitStatic(pihm_struct);
+void            InitStepCtrl(const ctrl_struct *, stepctrl_struct *);
 void            InitSurfL(elem_struct *, const river_struct *,
     const meshtbl_struct *);
 void            InitTecPrtVarCtrl(const char *, const char *, int, int, int,
@@ -170,7 +299,9 @@ void            InitWState(wstate_struct *);
 void            IntcpSnowEt(int, double, elem_struct *, const calib_struct *);
 void            IntrplForc(tsdata_struct *, int, int);
 double          KrFunc(double, double);
-void            LateralFlow(elem_struct *, const river_struct *, int);
+void            LateralFlow(hydro_elem_struct *, const hydro_river_struct *,
+    int);
+void            LateralFlowFace(hydro_elem_struct *, int, int);
 #if defined(_CYCLES_)
 void            MapOutput(const int *, const int *, const epconst_struct [],
     const elem_struct *, const river_struct *, const meshtbl_struct *,
@@ -179,6 +310,8 @@ void            MapOutput(const int *, const int *, const epconst_struct [],
 void            MapOutput(const int *, const int *, const elem_struct *,
     const river_struct *, const meshtbl_struct *, const char *, print_struct *);
 #endif
+void            MapReducer(const reducetbl_struct *, const elem_struct *,
+    const river_struct *, const char *, print_struct *);
 #if defined(_FBR_)
 void            MassBalance(const wstate_struct *, const wstate_struct *,
     wflux_struct *, double *, const soil_struct *, const geol_struct *, double,
@@ -187,30 +320,66 @@ void            MassBalance(const wstate_struct *, const wstate_struct *,
 void            MassBalance(const wstate_struct *, const wstate_struct *,
     wflux_struct *, double *, const soil_struct *, double, double);
 #endif
+void            LeaveModel(ctx_struct *);
+int             LzCompress(const unsigned char *, int, unsigned char *, int);
+int             MatchToken(const char *, const char *);
+#if !defined(_WIN32) && !defined(_WIN64)
+void           *MeteoStreamThread(void *);
+#endif
+uint64_t        ModelCacheKey(const pihm_struct);
 double          MonthlyLai(int, int);
 double          MonthlyMf(int);
 double          MonthlyRl(int, int);
+void            MultiRateRiverEdge(hydro_elem_struct *,
+    const hydro_river_struct *, int);
+double          MultiRateStorage(const hydro_elem_struct *,
+    const hydro_river_struct *, const double *);
+int             NextCplEvent(const ctrl_struct *, const forc_struct *, int);
+int             NextForcChange(const tsdata_struct *, int, int);
+int             NodesWithin(const graph_struct *, int, int, int *, int *,
+    int *);
 int             NumStateVar(void);
-int             Ode(realtype, N_Vector, N_Vector, void *);
-double          OutletFlux(int, const river_wstate_struct *,
-    const river_topo_struct *, const shp_struct *, const matl_struct *,
-    const river_bc_struct *);
+int             ODE(realtype, N_Vector, N_Vector, void *);
+double          OutletFlux(const hydro_river_struct *, int);
 double          OverLandFlow(double, double, double, double, double);
-double          OvlFlowElemToElem(const elem_struct *, const elem_struct *, int,
+double          OvlFlowElemToElem(const hydro_elem_struct *, int, int, int,
     double, int);
-double          OvlFlowElemToRiver(const elem_struct *, const river_struct *);
-void            ParseCmdLineParam(int, char *[], char *);
+double          OvlFlowElemToRiver(const hydro_elem_struct *, int,
+    const hydro_river_struct *, int);
+const char     *OutputUnit(const char *);
+#if !defined(_WIN32) && !defined(_WIN64)
+void           *OutputWriterThread(void *);
+#endif
+void            PackChunkIdx(const chunkidx_struct *, unsigned char *);
+void            PackDouble(double, unsigned char *);
+void            PackInt32(int32_t, unsigned char *);
+void            PackInt64(int64_t, unsigned char *);
+void            ParseCmdLineParam(int, char *[], ctx_struct *, char *);
+void            PermuteInt(const int *, int, int *);
+void            PermuteIntRow(const int *, int, int **);
 void            PIHM(pihm_struct, void *, N_Vector, double);
+int             PIHMadvance(model_struct, int, int *);
+model_struct    PIHMcreate(const ctx_struct *, const char *, model_struct);
+int             PIHMdestroy(model_struct);
+int             PIHMgetstate(model_struct, int, double *);
+int             PIHMinit(model_struct);
+int             PrecSetup(realtype, N_Vector, N_Vector, booleantype,
+    booleantype *, realtype, void *, N_Vector, N_Vector, N_Vector);
+int             PrecSolve(realtype, N_Vector, N_Vector, N_Vector, N_Vector,
+    realtype, realtype, int, void *, N_Vector);
 pihm_t_struct   PIHMTime(int);
-void            PrintCVodeFinalStats(void *);
-void            PrintData(varctrl_struct *, int, int, int, int);
+void            PrintCVodeFinalStats(int, void *);
+void            PrintData(varctrl_struct *, int, int, int, int,
+    outwriter_struct *);
 void            PrintDataTecplot(varctrl_struct *, int, int, int);
+void            PrintfOutput(outwriter_struct *, int, const char *, ...);
 void            PrintInit(const elem_struct *, const river_struct *,
     const char *, int, int, int, int);
 int             PrintNow(int, int, const pihm_t_struct *);
-void            PrintPerf(void *, int, int, double, double, double, FILE *);
-void            PrintWaterBal(FILE *, int, int, int, const elem_struct *,
-    const river_struct *);
+void            PrintPerf(void *, int, int, double, double, double,
+    perfstat_struct *, FILE *);
+void            PrintWaterBal(int, int, int, const elem_struct *,
+    const river_struct *, print_struct *);
 double          Psi(double, double, double);
 double          PtfAlpha(double, double, double, double, int);
 double          PtfBeta(double, double, double, double, int);
@@ -218,68 +387,129 @@ double          PtfKv(double, double, double, double, int);
 double          PtfThetar(double, double);
 double          PtfThetas(double, double, double, double, int);
 double          Qtz(int);
-void            ReadAlloc(pihm_struct);
+void            RcmOrder(const meshtbl_struct *, int *);
+void            ReadAlloc(pihm_struct, pihm_struct);
 void            ReadAtt(const char *, atttbl_struct *);
+int             ReadBinTs(const char *, int, int *, tsdata_struct **,
+    tsmap_struct *);
 void            ReadBc(const char *, forc_struct *, const atttbl_struct *);
 void            ReadCalib(const char *, calib_struct *);
-void            ReadForc(const char *, forc_struct *);
+void            ReadContainerIndex(const char *, const unsigned char *,
+    size_t, outcont_struct *);
+void            ReadForc(const char *, int, forc_struct *);
 void            ReadIc(const char *, elem_struct *, river_struct *);
 int             ReadKeyword(const char *, const char *, void *, char,
     const char *, int);
 void            ReadLai(const char *, forc_struct *, const atttbl_struct *);
 void            ReadLc(const char *, lctbl_struct *);
 void            ReadMesh(const char *, meshtbl_struct *);
+void            ReadMeteoStream(const char *, int, forc_struct *);
+int             ReadModelCache(const char *, uint64_t, elem_struct *,
+    river_struct *, siteinfo_struct *);
+void            ReadOutput(const char *, reducetbl_struct *);
 void            ReadPara(const char *, ctrl_struct *);
 int             ReadPrtCtrl(const char *, const char *, const char *, int);
 void            ReadRiver(const char *, rivtbl_struct *, shptbl_struct *,
     matltbl_struct *, forc_struct *);
 void            ReadSoil(const char *, soiltbl_struct *);
 void            ReadTecplot(const char *, ctrl_struct *);
+void            ReadTextFile(const char *, txtfile_struct *);
+int             ReadTextTs(const txtfile_struct *, int, int, tsdata_struct *);
 int             ReadTS(const char *, int *, double *, int);
-double          Recharge(const wstate_struct *, const wflux_struct *,
-    const soil_struct *);
+double          Recharge(const hydro_elem_struct *, int);
+void            ReorderMesh(int, meshtbl_struct *, atttbl_struct *,
+    rivtbl_struct *);
+void            RequestMeteoBuf(forc_struct *, int);
+void            ResetForcUpdate(forc_struct *);
 double          RiverCroSectArea(int, double, double);
 double          RiverEqWid(int, double, double);
-void            RiverFlow(elem_struct *, river_struct *, int);
+void            RiverFlow(hydro_elem_struct *, hydro_river_struct *, int);
+void            RiverOrder(const rivtbl_struct *, const int *, int *);
 double          RiverPerim(int, double, double);
-void            RiverToElem(river_struct *, elem_struct *, elem_struct *);
+void            RiverRhs(const hydro_river_struct *, int, double, double *);
+void            RiverSegFlow(hydro_elem_struct *, hydro_river_struct *, int,
+    int);
+void            RiverSegFastFlow(hydro_elem_struct *, hydro_river_struct *,
+    int, int);
+void            RiverSegSlowFlow(hydro_elem_struct *, hydro_river_struct *,
+    int);
+void            RiverToElem(hydro_river_struct *, int, hydro_elem_struct *);
 #if defined(_OPENMP)
-void            RunTime(double, double *, double *);
+void            RunTime(double, double *, double *, double *);
 #else
-void            RunTime (clock_t, double *, double *);
+void            RunTime (clock_t, clock_t *, double *, double *);
 #endif
 void            RelaxIc(elem_struct *, river_struct *);
+int             ScanDouble(const char **, double *);
+int             ScanInt(const char **, int *);
+int             ScanTime(const char **, int *);
 void            SetCVodeParam(pihm_struct, void *, N_Vector);
+void            SetFastCVodeParam(pihm_struct, N_Vector);
+void            SetGlobalCtx(const ctx_struct *);
+void            ShareForc(const forc_struct *, forc_struct *);
+tsdata_struct  *ShareTs(int, const tsdata_struct *);
+void            ShuffleBytes(const unsigned char *, int, int, unsigned char *);
+void            SlowElemRhs(const hydro_elem_struct *, int, double,
+    const double *, double *);
+void            SlowHydrol(hydro_elem_struct *, hydro_river_struct *,
+    const double *);
+int             SlowOde(realtype, N_Vector, N_Vector, void *);
+void            SlowRiverRhs(const hydro_river_struct *, int, double,
+    const double *, double *);
 int             SoilTex(double, double);
-void            SolveCVode(int, int *, int, double, void *, N_Vector);
+void            SolveCVode(int, int *, int, int, double, stepctrl_struct *,
+    void *, N_Vector);
+void            SolveMultiRate(pihm_struct, int *, double, void *, N_Vector);
+int             SolveSpinAcc(const spinacc_struct *, double *);
+int             SparseJac(realtype, N_Vector, N_Vector, SlsMat, void *,
+    N_Vector, N_Vector, N_Vector);
+double          SetHydrolState(double *, const double *, N_Vector,
+    elem_struct *, river_struct *);
 void            Spinup(pihm_struct, N_Vector, void *);
+void            StepCtrl(void *, double, stepctrl_struct *);
+void            StepCtrlForc(const elem_struct *, stepctrl_struct *);
+void            SpinupAcc(spinacc_struct *);
+double          StateDotProd(int, const double *, const double *);
 void            StartupScreen(void);
 int             StrTime(const char *);
-double          SubFlowElemToElem(const elem_struct *, const elem_struct *,
-    int);
-double          SubFlowElemToRiver(const elem_struct *, double,
-    const river_struct *, double, double);
-double          SubFlowRiverToRiver(const river_struct *, double,
-    const river_struct *, double);
+double          SubFlowElemToElem(const hydro_elem_struct *, int, int, int);
+double          SubFlowElemToRiver(const hydro_elem_struct *, int, double,
+    const hydro_river_struct *, int, double, double);
+double          SubFlowRiverToRiver(const hydro_river_struct *, int, double,
+    int, double);
 void            Summary(elem_struct *, river_struct *, N_Vector, double);
+void            SubFlowFace(hydro_elem_struct *, int);
+void            SurfFlowFace(hydro_elem_struct *, int, int);
 double          SurfH(double);
+const char     *TextLine(const txtfile_struct *, int);
+int             TextLno(const txtfile_struct *, int);
+void            UnpackChunkIdx(const unsigned char *, chunkidx_struct *);
+int32_t         UnpackInt32(const unsigned char *);
+int64_t         UnpackInt64(const unsigned char *);
+void            UpdMeteoStream(forc_struct *, int);
 void            UpdPrintVar(varctrl_struct *, int, int);
 void            UpdPrintVarT(varctrl_struct *, int);
-void            VerticalFlow(elem_struct *, double);
+void            VerticalFlow(hydro_elem_struct *, double);
+void            VerticalFlowElem(hydro_elem_struct *, int, double);
+void            WaitMeteoBuf(metstream_struct *, int);
 double          WiltingPoint(double, double, double, double);
+void            WriteBinForc(pihm_struct);
+void            WriteBinTs(const char *, int, int, const tsdata_struct *);
+void            WriteContainerChunks(outcont_struct *, int);
+void            WriteModelCache(const char *, uint64_t, const elem_struct *,
+    const river_struct *, const siteinfo_struct *);
+void            WriteOutputBuf(outwriter_struct *, int);
 
 /*
  * Fractured bedrock functions
  */
 #if defined(_FBR_)
-double          FbrBoundFluxElem(int, int, const bc_struct *,
-    const wstate_struct *, const topo_struct *, const geol_struct *);
-double          FbrFlowElemToElem(const elem_struct *, const elem_struct *,
-    double, double);
-double          FbrInfil(const wstate_struct *, const soil_struct *,
-    const geol_struct *, const topo_struct *);
-double          FbrRecharge(const wstate_struct *, const wflux_struct *,
-    const geol_struct *);
+double          FbrBoundFluxElem(const hydro_elem_struct *, int, int);
+double          FbrFlowElemToElem(const hydro_elem_struct *, int, int, double,
+    double);
+double          FbrInfil(const hydro_elem_struct *, int);
+void            FbrLateralFlowElem(hydro_elem_struct *, int);
+double          FbrRecharge(const hydro_elem_struct *, int);
 void            FreeGeoltbl(geoltbl_struct *);
 void            InitGeol (elem_struct *, const geoltbl_struct *,
         const calib_struct *);
@@ -295,6 +525,10 @@ void            ReadGeol(const char *, geoltbl_struct *);
 void            AdjSmProf(const soil_struct *, const pstate_struct *,
     const double *, double, wflux_struct *, wstate_struct *);
 void            AlCalc(pstate_struct *, double, int);
+double          Azimuth(double, double);
+double          BoxDist(const double *, double, double);
+void            BuildEdgeTree(const elem_struct *, const meshtbl_struct *,
+    edgetree_struct *);
 void            CalcLatFlx(const pstate_struct *, wflux_struct *);
 void            CalcSlopeAspect(elem_struct *, const meshtbl_struct *);
 void            CalHum(pstate_struct *, estate_struct *);
@@ -305,6 +539,7 @@ void            CanRes(const wstate_struct *, const estate_struct *,
     const eflux_struct *, pstate_struct *, const soil_struct *,
     const epconst_struct *);
 # endif
+int             CompareEdgeKey(const void *, const void *);
 double          CSnow(double);
 void            DefSldpth(double *, int *, double *, double, const double *,
     int);
@@ -319,16 +554,20 @@ void            Evapo(const soil_struct *, const lc_struct *,
 void            Evapo(const wstate_struct *, wflux_struct *,
     const pstate_struct *, const lc_struct *, const soil_struct *, double);
 # endif
+void            EdgeHorizon(const double *, topo_struct *);
 int             FindLayer(const double *, int, double);
 int             FindWaterTable(const double *, int, double, double *);
+void            FreeEdgeTree(edgetree_struct *);
 double          FrozRain(double, double);
 double          GwTransp(double, const double *, int, int);
+void            HorizonAngle(const edgetree_struct *, topo_struct *);
 void            HRT(wstate_struct *, const estate_struct *, eflux_struct *,
     const pstate_struct *, const lc_struct *, const soil_struct *, double *,
     double, double, double, double, double *, double *, double *);
 void            InitLsm(elem_struct *, const ctrl_struct *,
     const noahtbl_struct *, const calib_struct *);
 double          Mod(double, double);
+double          NodeHmin(const edgetree_struct *, int, const topo_struct *);
 void            Noah(elem_struct *, double);
 void            NoahHydrol(elem_struct *, double);
 # if defined(_CYCLES_)
@@ -358,6 +597,7 @@ void            ReadRad(const char *, forc_struct *);
 void            RootDist(const double *, int, int, double *);
 void            Rosr12(double *, const double *, const double *, double *,
     const double *, double *, int);
+double          SectorMaxHphi(const double *, const topo_struct *);
 void            SfcDifOff(pstate_struct *, const lc_struct *, double, double,
     int);
 # if defined(_CYCLES_)
@@ -395,6 +635,7 @@ void            SnoPac(wstate_struct *, wflux_struct *, estate_struct *,
 void            SnowNew(const estate_struct *, double, pstate_struct *);
 void            SnowPack(double, double, double *, double *, double, double);
 double          Snowz0(double, double, double);
+void            SplitEdgeTree(const double (*)[6], int, edgetree_struct *);
 # if defined(_CYCLES_)
 void            SRT(const soil_struct *, const cstate_struct *, double,
     pstate_struct *, wstate_struct *, wflux_struct *, double *, double *,
@@ -17,6 +17,9 @@ typedef struct filename_struct
     char            calib[MAXSTRING];       /* calibration file name */
     char            ic[MAXSTRING];          /* initial condition file name */
     char            tecplot[MAXSTRING];     /* tecplot control file name */
+    char            cache[MAXSTRING];       /* model cache file name */
+    char            output[MAXSTRING];      /* output reducer control file
+                                             * name */
 #if defined(_FBR_)
     char            geol[MAXSTRING];        /* geology property file name */
     char            bedrock[MAXSTRING];     /* bedrock elevation file name */
@@ -46,6 +49,7 @@ typedef struct filename_struct
 /* River input structure */
 typedef struct rivtbl_struct
 {
+    int            *ind;         /* segment id in river file */
     int            *fromnode;    /* upstream node id */
     int            *tonode;      /* downstream node id */
     int            *down;        /* downstream channel id */
@@ -81,10 +85,28 @@ typedef struct matltbl_struct
     double         *bedthick;    /* bed thickness (m) */
 } matltbl_struct;
 
+/* Output reducer input structure */
+typedef struct reducetbl_struct
+{
+    int             ngroup;       /* number of element (river segment)
+                                   * groups */
+    char          (*grpname)[MAXSTRING];  /* name of group */
+    int            *grptype;      /* group type: 0 = elements, 1 = river
+                                   * segments, 2 = all */
+    int            *nmember;      /* number of group members */
+    int           **member;       /* ids of group members */
+    int             nreducer;     /* number of reducers */
+    char          (*var)[MAXSTRING];      /* name of reduced output
+                                           * variable */
+    int            *group;        /* group of reducer */
+    int            *op;           /* reducer type */
+} reducetbl_struct;
+
 /* Mesh structure */
 typedef struct meshtbl_struct
 {
     int             numnode;    /* number of nodes */
+    int            *ind;        /* element id in mesh file */
     int           **node;       /* nodes of element */
     int           **nabr;       /* neighbors of element */
     double         *x;          /* x of node (m) */
@@ -221,28 +243,123 @@ typedef struct tsdata_struct
 {
     int             length;       /* length of time series */
     int            *ftime;        /* forcing time */
-    double        **data;         /* forcing values at forcing time */
+    double         *data;         /* forcing values at forcing time (values
+                                   * of each record are stored next to each
+                                   * other) */
+    int             cursor;       /* index of the first forcing time at or
+                                   * after model time of last interpolation */
     double         *value;        /* forcing values at model time t */
+    int             changed;      /* flag that forcing values have changed
+                                   * since they were last applied */
+    int             ngrid;        /* number of elements using the series
+                                   * (meteorological forcing) */
+    int            *grid;         /* indices of elements using the series */
+    int             nbcvar;       /* number of element edges using the series
+                                   * (boundary conditions) */
+    double        **bcvar;        /* boundary conditions of element edges
+                                   * using the series */
     double          zlvl_wind;    /* height above ground of wind observations
                                    * (m) */
 } tsdata_struct;
 
+/* Header of binary time series file */
+typedef struct bintshdr_struct
+{
+    char            magic[8];     /* BINTS_MAGIC */
+    int32_t         version;      /* BINTS_VERSION */
+    int32_t         nts;          /* number of time series */
+    int32_t         nvrbl;        /* number of variables of each record */
+    int32_t         pad;
+} bintshdr_struct;
+
+/* Directory entry of a time series in binary time series file */
+typedef struct bintsdir_struct
+{
+    int64_t         length;       /* number of records */
+    int64_t         ftime_offset; /* file offset of forcing times (int32) */
+    int64_t         data_offset;  /* file offset of forcing values (float64,
+                                   * nvrbl values of each record stored
+                                   * next to each other) */
+    double          zlvl_wind;    /* height above ground of wind observations
+                                   * (m) */
+} bintsdir_struct;
+
+/* Memory-mapped binary time series file */
+typedef struct tsmap_struct
+{
+    void           *addr;         /* start of mapping (NULL if time series
+                                   * are read from text file) */
+    size_t          size;         /* size of mapping */
+} tsmap_struct;
+
+/* Text input file read into memory */
+typedef struct txtfile_struct
+{
+    char            filename[MAXSTRING];
+    char           *buffer;       /* file contents (lines are terminated by
+                                   * '\0') */
+    int             nline;        /* number of readable lines */
+    char          **line;         /* readable lines */
+    int            *lno;          /* line numbers of readable lines */
+} txtfile_struct;
+
+/* Streaming meteorological forcing structure */
+typedef struct metstream_struct
+{
+    FILE           *file;         /* meteorological forcing file */
+    char            filename[MAXSTRING];
+    int             window;       /* number of records in each buffer */
+    long int       *start;        /* file position of the first record of
+                                   * each series */
+    long int       *pos;          /* file position of the next record to be
+                                   * read for each series */
+    int            *next_length;  /* number of records in prefetched
+                                   * buffers */
+    int           **next_ftime;   /* forcing time in prefetched buffers */
+    double        **next_data;    /* forcing values in prefetched buffers */
+    int            *rewind;       /* time to rewind to for each series (-1 if
+                                   * no rewind is needed) */
+    int            *pending;      /* flag that buffer of series is being
+                                   * refilled */
+    int             init;         /* flag that buffers have been filled */
+    double          prcp;         /* precipitation calibration */
+    double          sfctmp;       /* air temperature calibration */
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_t       thread;       /* background reader thread */
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    int             quit;         /* flag to stop background reader */
+#endif
+} metstream_struct;
+
 /* Forcing structure */
 typedef struct forc_struct
 {
     int             nbc;         /* number of boundary condition series */
     tsdata_struct  *bc;          /* boundary condition time series */
+    tsmap_struct    bc_map;      /* mapped binary boundary condition file */
     int             nmeteo;      /* number of meteorological forcing series */
     tsdata_struct  *meteo;       /* meteorological forcing series */
+    tsmap_struct    meteo_map;   /* mapped binary meteorological forcing
+                                  * file */
+    metstream_struct *metstream; /* streaming meteorological forcing (NULL
+                                  * when forcing is read into memory) */
     int             nlai;        /* number of lai series */
     tsdata_struct  *lai;         /* lai forcing series */
+    tsmap_struct    lai_map;     /* mapped binary lai forcing file */
     int             nsource;     /* number of source forcing series */
     tsdata_struct  *source;      /* source forcing series */
     int             nriverbc;    /* number of river boundary conditions */
     tsdata_struct  *riverbc;     /* river boundary condition series */
+    int             shared;      /* flag that boundary condition, lai, and
+                                  * radiation time series data are shared
+                                  * with another model */
+    int             meteo_shared; /* flag that meteorological forcing data
+                                  * are shared with another model */
 #if defined(_NOAH_)
     int             nrad;        /* number of radiation forcing series */
     tsdata_struct  *rad;         /* radiation forcing series */
+    tsmap_struct    rad_map;     /* mapped binary radiation forcing file */
 #endif
 #if defined(_BGC_)
     int             nco2;
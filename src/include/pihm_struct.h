@@ -134,6 +134,8 @@ typedef struct ctrl_struct
                                              * (when results can be printed) for
                                              * the whole simulation */
     int             cstep;                  /* current model step (from 0) */
+    int             cvode_init;             /* flag that CVODE memory has
+                                             * been initialized */
     int             prtvrbl[MAXPRINT];
 
 
@@ -159,7 +161,6 @@ typedef struct ctrl_struct
     double          abstol;                 /* absolute solver tolerance (m) */
     double          reltol;                 /* relative solver tolerance (-) */
     double          initstep;               /* initial step size (s) */
-    double          maxstep;                /* CVode maximum step size (s) */
     double          stmin;                  /* minimum allowed CVode max step
                                              * size (s) */
     double          nncfn;                  /* number of non-convergence
@@ -172,6 +173,31 @@ typedef struct ctrl_struct
     double          incr;                   /* increase factor (-)*/
     int             maxspinyears;           /* maximum number of years for
                                              * spinup run */
+    int             spinup_acc;             /* Anderson acceleration of
+                                             * spinup cycles (1 = on) */
+    int             lin_solver;             /* linear solver:
+                                             * 0 = SPGMR, 1 = KLU */
+    int             precond;                /* preconditioner type:
+                                             * 0 = none, 1 = block-Jacobi */
+    int             multirate;              /* model steps per slow step of
+                                             * multi-rate integration
+                                             * (0 = off) */
+    int             event_cpl;              /* couple hydrology with forcing
+                                             * only at coupling events
+                                             * (1 = on) */
+    int             reorder;                /* model grid reordering:
+                                             * 0 = none, 1 = reverse
+                                             * Cuthill-McKee, 2 = Hilbert
+                                             * curve */
+    int             meteo_window;           /* number of meteorological
+                                             * forcing records kept in memory
+                                             * for each series (0 = all) */
+    int             output_flush;           /* model steps between output
+                                             * flushes (0 = at the end of
+                                             * simulation) */
+    int             output_format;          /* binary output format:
+                                             * 0 = .dat files, 1 = output
+                                             * container */
 #if defined(_NOAH_)
     int             nsoil;                  /* number of standard soil layers */
     double          sldpth[MAXLYR];         /* thickness of soil layer (m) */
@@ -201,6 +227,13 @@ typedef struct varctrl_struct
     const double  **var;                /* pointers to model variables */
     double         *buffer;             /* buffer for averaging variables */
     int             counter;            /* counter for averaging variables */
+    int             reduce;             /* reducer type */
+    int             nsrc;               /* number of model variables of
+                                         * reducer */
+    double         *weight;             /* weights of model variables of
+                                         * reducer */
+    int            *id;                 /* element (river segment) ids of
+                                         * outputs (NULL for all) */
     FILE           *txtfile;            /* pointer to txt file */
     FILE           *datfile;            /* pointer to binary file */
     /* tecplot coordinate variables */
@@ -214,6 +247,188 @@ typedef struct varctrl_struct
     int           *node2;
 } varctrl_struct;
 
+/* Chunk header of output container file. Each chunk is preceded by its
+ * header, and the chunk index at the end of the file is a copy of all chunk
+ * headers. Headers are written by PackChunkIdx */
+typedef struct chunkidx_struct
+{
+    int32_t         var;               /* output variable */
+    int32_t         rec0;              /* first record */
+    int32_t         nrec;              /* number of records */
+    int32_t         item0;             /* first element (river segment) */
+    int32_t         nitem;             /* number of elements (river
+                                        * segments) */
+    int32_t         t0;                /* time of first record (s) */
+    int32_t         t1;                /* time of last record (s) */
+    int32_t         size;              /* size of chunk data (bytes). Data
+                                        * are not compressed if size is the
+                                        * size of uncompressed data */
+    int64_t         offset;            /* file position of chunk data */
+} chunkidx_struct;
+
+/* Output container structure */
+typedef struct outcont_struct
+{
+    FILE           *file;              /* output container file */
+    int             nvar;              /* number of output variables */
+    int            *nitem;             /* number of output elements (river
+                                        * segments) of each variable */
+    int            *nrec;              /* number of records of each variable
+                                        * in the file */
+    int            *nbuf;              /* number of buffered records */
+    double        **time;              /* buffered record times */
+    double        **data;              /* buffered records (element-major) */
+    int             nchunk;            /* number of chunks */
+    int             maxchunk;          /* capacity of chunk index */
+    chunkidx_struct *index;            /* chunk index */
+    unsigned char  *raw;               /* uncompressed chunk (little-endian
+                                        * doubles) */
+    unsigned char  *shuffled;          /* byte-shuffled chunk */
+    unsigned char  *packed;            /* compressed chunk */
+} outcont_struct;
+
+/* Output writer structure. Output records are appended to one set of
+ * buffers, while the other set is written to disk by the writer thread */
+typedef struct outwriter_struct
+{
+    int             nfile;             /* number of output files */
+    FILE          **file;              /* output files */
+    char          **data[2];           /* buffered output of each file */
+    size_t         *size[2];           /* buffered bytes of each file */
+    size_t         *cap[2];            /* buffer capacity of each file */
+    int             fill;              /* buffer set being filled */
+    int             flush_intvl;       /* model steps between flushes (0 = at
+                                        * the end of simulation) */
+    int             nstep;             /* model steps since last flush */
+    outcont_struct *container;         /* output container to which binary
+                                        * output is written (NULL when
+                                        * binary output is written to .dat
+                                        * files) */
+    struct outwriter_struct *next;     /* next open writer */
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_t       thread;            /* writer thread */
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    int             busy;              /* flag that the other buffer set is
+                                        * being written */
+    int             quit;              /* flag to stop writer thread */
+#endif
+} outwriter_struct;
+
+/* Anderson acceleration of spinup cycles */
+typedef struct spinacc_struct
+{
+    int             nstate;            /* number of accelerated hydrologic
+                                        * states */
+    int             nhist;             /* number of previous cycles in
+                                        * history */
+    int             ncycle;            /* number of cycles */
+    int             accelerated;       /* flag that the cycle started from
+                                        * extrapolated states */
+    double         *x;                 /* states at the beginning of cycle */
+    double         *g;                 /* states at the end of cycle */
+    double         *f;                 /* change of states over cycle */
+    double         *gprev;             /* g of the previous cycle */
+    double         *fprev;             /* f of the previous cycle */
+    double         *dg[SPINUP_ACC_DEPTH];  /* differences of g between
+                                            * cycles */
+    double         *df[SPINUP_ACC_DEPTH];  /* differences of f between
+                                            * cycles */
+    double          fnorm_prev;        /* norm of f of the previous cycle */
+} spinacc_struct;
+
+/* Domain averages at the end of the previous spinup cycle */
+typedef struct spinprev_struct
+{
+    double          totalw;            /* total water storage (m) */
+#if defined(_FBR_)
+    double          fbrgw;             /* bedrock groundwater (m) */
+#endif
+#if defined(_BGC_)
+    double          soilc;             /* daily soil carbon (kgC m-2) */
+#endif
+} spinprev_struct;
+
+/* CVODE max step controller */
+typedef struct stepctrl_struct
+{
+    double          maxstep;           /* CVODE max step (s) */
+    double          maxstep_lim;       /* upper limit of max step (s) */
+    double          stmin;             /* lower limit of max step (s) */
+    double          nncfn;             /* non-convergence failures per step
+                                        * tolerance */
+    double          nnimax;            /* non-linear iterations per step
+                                        * above which max step decreases */
+    double          nnimin;            /* non-linear iterations per step
+                                        * below which max step increases */
+    double          decr;              /* decrease factor (-) */
+    double          incr;              /* increase factor (-) */
+    long int        nst0;              /* CVODE steps at the beginning of
+                                        * sample window */
+    long int        ncfn0;             /* non-convergence failures at the
+                                        * beginning of sample window */
+    long int        nni0;              /* non-linear iterations at the
+                                        * beginning of sample window */
+    double          prcp;              /* maximum precipitation rate of the
+                                        * current forcing step (m s-1) */
+} stepctrl_struct;
+
+/* Event-driven coupling */
+typedef struct cpl_struct
+{
+    int             tevent;            /* next coupling event (ctime) */
+    N_Vector        ydot;              /* time derivatives of state
+                                        * variables at interpolated model
+                                        * steps */
+} cpl_struct;
+
+/* Multi-rate integration */
+typedef struct multirate_struct
+{
+    void           *cvode_mem;         /* CVODE memory of the fast
+                                        * subsystem */
+    N_Vector        y;                 /* fast state variables */
+    int             nfast;             /* number of fast state variables */
+    double         *y0;                /* state variables at the beginning of
+                                        * slow step */
+    double         *acc0;              /* accumulated exchange at the
+                                        * beginning of slow step */
+    double         *xrate;             /* rate of exchange with the fast
+                                        * subsystem (state variable s-1) */
+    int             ncolor;            /* number of colors of the
+                                        * element-river graph (0 = fast
+                                        * subsystem is not preconditioned) */
+    int            *colorptr;          /* start of each color in colornode */
+    int            *colornode;         /* graph nodes sorted by color */
+    double         *jac;               /* saved Jacobian diagonal of the fast
+                                        * subsystem */
+    double         *pdiag;             /* diagonal preconditioner */
+    int             kend;              /* model step at the end of slow
+                                        * step */
+    double          strg0;             /* water storage at the beginning of
+                                        * slow step (m3) */
+    double          netin;             /* precipitation minus
+                                        * evapotranspiration over slow step
+                                        * (m3) */
+    double          discharge0;        /* accumulated outlet discharge at the
+                                        * beginning of slow step (m3) */
+    double          discharge;         /* total outlet discharge (m3) */
+    double          wb_error;          /* total water balance error (m3) */
+    int             reset;             /* flag that the fast subsystem has
+                                        * been initialized */
+} multirate_struct;
+
+/* CVODE counters for performance output */
+typedef struct perfstat_struct
+{
+    long int        nst;               /* number of steps */
+    long int        nfe;               /* number of RHS evaluations */
+    long int        nni;               /* number of nonlinear iterations */
+    long int        ncfn;              /* number of nonlinear convergence
+                                        * failures */
+    long int        netf;              /* number of error test failures */
+} perfstat_struct;
+
 /* Print structure */
 typedef struct print_struct
 {
@@ -223,8 +438,355 @@ typedef struct print_struct
     int             ntpprint;          /* number of tecplot output variables */
     FILE           *watbal_file;       /* pointer to water balance file */
     FILE           *cvodeperf_file;    /* pointer to CVode performance file */
+    outwriter_struct writer;           /* output writer for binary and txt
+                                        * output files */
+    double          wb_strg_prev;      /* total water storage at the last
+                                        * water balance output (m3) */
+    double          wb_error;          /* accumulated water balance error
+                                        * (m3) */
+    perfstat_struct perf0;             /* CVODE counters at the last
+                                        * performance output */
 } print_struct;
 
+/* Hydrology kernel element variables (structure of arrays) */
+typedef struct hydro_elem_struct
+{
+    /* Constants */
+    int           (*nabr)[NUM_EDGE];       /* neighbor element (> 0) or river
+                                            * segment (< 0) */
+    int           (*bc_type)[NUM_EDGE];    /* boundary condition type */
+    double         *area;                  /* area of element (m2) */
+    double         *zmin;                  /* soil bottom elevation (m) */
+    double         *zmax;                  /* surface elevation (m) */
+    double        (*edge)[NUM_EDGE];       /* length of edge (m) */
+    double        (*nabrdist)[NUM_EDGE];   /* distance to neighbor (m) */
+    int             nface;                 /* number of element faces that are
+                                            * not shared with river segments */
+    int           (*face_elem)[2];         /* elements on both sides of face
+                                            * (-1 for domain boundary) */
+    int           (*face_edge)[2];         /* edge index of face in elements on
+                                            * both sides */
+    double        (*nabr_x)[NUM_EDGE];     /* x of neighbor centroid (m) */
+    double        (*nabr_y)[NUM_EDGE];     /* y of neighbor centroid (m) */
+    double         *rough;                 /* surface roughness (s m-1/3) */
+    double         *depth;                 /* soil depth (m) */
+    double         *ksath;                 /* horizontal saturated hydraulic
+                                            * conductivity (m s-1) */
+    double         *ksatv;                 /* vertical saturated hydraulic
+                                            * conductivity (m s-1) */
+    double         *kinfv;                 /* saturated infiltration
+                                            * conductivity (m s-1) */
+    double         *dinf;                  /* depth across which head gradient
+                                            * is calculated for infiltration
+                                            * (m) */
+    double         *alpha;                 /* alpha from van Genuchten eqn
+                                            * (m-1) */
+    double         *beta;                  /* beta (n) from van Genuchten eqn
+                                            * (-) */
+    double         *porosity;              /* soil porosity (m3 m-3) */
+    double         *dmac;                  /* macropore depth (m) */
+    double         *kmach;                 /* macropore horizontal saturated
+                                            * hydraulic conductivity (m s-1) */
+    double         *kmacv;                 /* macropore vertical saturated
+                                            * hydraulic conductivity (m s-1) */
+    double         *areafv;                /* macropore area fraction on a
+                                            * vertical cross-section (m2 m-2) */
+    double         *areafh;                /* macropore area fraction on a
+                                            * horizontal cross-section
+                                            * (m2 m-2) */
+#if defined(_FBR_)
+    int           (*fbrbc_type)[NUM_EDGE]; /* fractured bedrock boundary
+                                            * condition type */
+    int           (*fbr_nabr)[NUM_EDGE];   /* neighbor element for fractured
+                                            * bedrock flow (0 = boundary) */
+    double        (*fbr_dist)[NUM_EDGE];   /* distance to fractured bedrock
+                                            * neighbor (m) */
+    double         *zbed;                  /* impermeable bedrock elevation (m)
+                                            */
+    double         *geol_depth;            /* bedrock layer depth (m) */
+    double         *geol_ksath;            /* bedrock horizontal saturated
+                                            * hydraulic conductivity (m s-1) */
+    double         *geol_ksatv;            /* bedrock vertical saturated
+                                            * hydraulic conductivity (m s-1) */
+    double         *geol_alpha;            /* bedrock alpha from van Genuchten
+                                            * eqn (m-1) */
+    double         *geol_beta;             /* bedrock beta (n) from van
+                                            * Genuchten eqn (-) */
+    double         *geol_porosity;         /* bedrock porosity (m3 m-3) */
+#endif
+    /* Inputs that are constant within a hydrology step */
+    bc_struct      *bc;                    /* boundary conditions */
+#if defined(_FBR_)
+    bc_struct      *fbr_bc;                /* fractured bedrock boundary
+                                            * conditions */
+#endif
+    double         *surf0;                 /* surface water at the beginning of
+                                            * hydrology step (m) */
+    double         *pcpdrp;                /* combined prcp and drip (m s-1) */
+    double         *edir;                  /* direct soil evaporation (m s-1) */
+    double         *ett;                   /* total plant transpiration (m s-1)
+                                            */
+#if defined(_NOAH_)
+    double         *gwet;                  /* fraction of transpiration from
+                                            * groundwater (-) */
+    double         *fcr;                   /* reduction of infiltration caused
+                                            * by frozen ground (-) */
+    double         *sh2o;                  /* unfrozen soil moisture content of
+                                            * the top layer (m3 m-3) */
+    double         *smcmax;                /* maximum soil moisture content
+                                            * (m3 m-3) */
+    double         *smcmin;                /* residual soil moisture content
+                                            * (m3 m-3) */
+#else
+    double         *rzd;                   /* rooting depth (m) */
+#endif
+    /* States */
+    double         *surf;                  /* equivalent surface water level
+                                            * (m) */
+    double         *unsat;                 /* unsaturated zone water storage
+                                            * (m) */
+    double         *gw;                    /* groundwater level (m) */
+    double         *surfh;                 /* actual surface water level (m) */
+#if defined(_FBR_)
+    double         *fbr_unsat;             /* fractured bedrock unsaturated
+                                            * zone storage (m) */
+    double         *fbr_gw;                /* fractured bedrock groundwater
+                                            * (m) */
+#endif
+    /* Fluxes */
+    double        (*ovlflow)[NUM_EDGE];    /* overland flow (m3 s-1) */
+    double        (*subsurf)[NUM_EDGE];    /* subsurface flow (m3 s-1) */
+    double         *infil;                 /* infiltration rate (m s-1) */
+    double         *rechg;                 /* recharge rate (m s-1) */
+    double         *edir_surf;             /* direct evaporation from surface
+                                            * water (m s-1) */
+    double         *edir_unsat;            /* direct evaporation from
+                                            * unsaturated zone (m s-1) */
+    double         *edir_gw;               /* direct evaporation from saturated
+                                            * zone (m s-1) */
+    double         *ett_unsat;             /* transpiration from unsaturated
+                                            * zone (m s-1) */
+    double         *ett_gw;                /* transpiration from saturated zone
+                                            * (m s-1) */
+#if defined(_FBR_)
+    double        (*fbrflow)[NUM_EDGE];    /* lateral fractured bedrock flow
+                                            * (m3 s-1) */
+    double         *fbr_infil;             /* fractured bedrock infiltration
+                                            * (m s-1) */
+    double         *fbr_rechg;             /* fractured bedrock recharge
+                                            * (m s-1) */
+#endif
+    /* Scratch buffers, sized at initialization so that RHS evaluations do not
+     * allocate */
+    double         *dhbydx;                /* surface water gradient in x
+                                            * direction (-) */
+    double         *dhbydy;                /* surface water gradient in y
+                                            * direction (-) */
+} hydro_elem_struct;
+
+/* Hydrology kernel river variables (structure of arrays) */
+typedef struct hydro_river_struct
+{
+    /* Constants */
+    int            *leftele;               /* left neighboring element */
+    int            *rightele;              /* right neighboring element */
+    int            *down;                  /* down stream channel segment */
+    int            *up_start;              /* start of the upstream segments
+                                            * of each segment in up (size
+                                            * nriver + 1) */
+    int            *up;                    /* upstream channel segments of all
+                                            * segments, in ascending order for
+                                            * each segment */
+    int            *riverbc_type;          /* river boundary condition type */
+    double         *area;                  /* area of river segment (m2) */
+    double         *zmin;                  /* bedrock elevation (m) */
+    double         *zmax;                  /* river bank elevation (m) */
+    double         *zbed;                  /* river bed elevation (m) */
+    double         *node_zmax;             /* elevation of the downstream node
+                                            * (m) */
+    double         *dist_left;             /* distance to left neighbor (m) */
+    double         *dist_right;            /* distance to right neighbor (m) */
+    double         *depth;                 /* river channel depth (m) */
+    int            *intrpl_ord;            /* interpolation order (shape of
+                                            * channel) */
+    double         *coeff;                 /* width coefficient */
+    double         *length;                /* length of channel (m) */
+    double         *width;                 /* width of channel (m) */
+    double         *rough;                 /* river channel roughness
+                                            * (s m-1/3) */
+    double         *cwr;                   /* discharge coefficient (-) */
+    double         *ksath;                 /* bank hydraulic conductivity
+                                            * (m s-1) */
+    double         *ksatv;                 /* bed hydraulic conductivity
+                                            * (m s-1) */
+    double         *bedthick;              /* bed thickness (m) */
+    double         *porosity;              /* bed porosity (m3 m-3) */
+    /* Inputs that are constant within a hydrology step */
+    river_bc_struct *bc;                   /* boundary conditions */
+    /* States */
+    double         *stage;                 /* river stage (m) */
+    double         *gw;                    /* groundwater level (m) */
+    /* Fluxes */
+    double        (*rivflow)[NUM_RIVFLX];  /* river fluxes (m3 s-1) */
+} hydro_river_struct;
+
+/* Hydrology kernel structure: a compact copy of the element and river
+ * variables used by the right-hand side of the ODE system, synchronized with
+ * elem_struct and river_struct at hydrology step boundaries */
+typedef struct hydro_struct
+{
+    hydro_elem_struct elem;
+    hydro_river_struct river;
+} hydro_struct;
+
+/* Element-river adjacency graph structure */
+typedef struct graph_struct
+{
+    int             nnode;         /* number of nodes (elements followed by
+                                    * river segments) */
+    int            *xadj;          /* start of each node in adj */
+    int            *adj;           /* adjacent nodes */
+    int            *nsv;           /* number of state variables of each node */
+    int           **sv;            /* state variable indices of each node */
+} graph_struct;
+
+/* Block-Jacobi preconditioner structure */
+typedef struct prec_struct
+{
+    int             ncolor;        /* number of colors of the element-river
+                                    * graph */
+    int            *color;         /* color of each block */
+    int            *colorptr;      /* start of each color in colornode */
+    int            *colornode;     /* blocks sorted by color */
+    DlsMat         *jac;           /* saved Jacobian diagonal blocks */
+    DlsMat         *p;             /* factored preconditioner blocks */
+    long int      **pivot;         /* pivot arrays of factored blocks */
+} prec_struct;
+
+/* Sparse Jacobian structure (compressed sparse row) */
+typedef struct jac_struct
+{
+    int             nnz;           /* number of nonzeros */
+    int            *indexptrs;     /* start of each row */
+    int            *indexvals;     /* column indices */
+    int             ngroup;        /* number of difference quotient column
+                                    * groups */
+    int            *grpptr;        /* start of each group in grpcol */
+    int            *grpcol;        /* columns sorted by group */
+    int            *colpos;        /* data positions of the entries of each
+                                    * column */
+} jac_struct;
+
+#if defined(_DEBUG_)
+/* Heap allocation statistics of RHS evaluations */
+typedef struct allocstat_struct
+{
+    long int        nrhs;                  /* number of RHS evaluations */
+    long int        nalloc;                /* number of heap allocations in
+                                            * RHS evaluations */
+} allocstat_struct;
+#endif
+
+/* Timing of RHS evaluations in benchmark mode */
+typedef struct rhstime_struct
+{
+    long int        nrhs;                  /* number of RHS evaluations */
+    double          elapsed;               /* wall time of RHS evaluations
+                                            * (s) */
+} rhstime_struct;
+
+#if defined(_NOAH_)
+/* K-d tree of element edges for horizon angle calculation */
+typedef struct edgetree_struct
+{
+    int             nedge;         /* number of element edges */
+    int            *item;          /* element edges (NUM_EDGE * element +
+                                    * edge) in tree order */
+    double        (*edge)[6];      /* x, y, and z of both nodes of edges in
+                                    * tree order */
+    int             nnode;         /* number of tree nodes */
+    int            *child;         /* first of the two children of each node
+                                    * (-1 for leaves) */
+    int            *start;         /* first edge of each node */
+    int            *end;           /* end (exclusive) of edges of each node */
+    double        (*midbox)[4];    /* bounding box (xmin, xmax, ymin, ymax)
+                                    * of edge midpoints of each node */
+    double        (*endbox)[4];    /* bounding box of edge nodes of each
+                                    * node */
+    double         *zcmax;         /* maximum edge midpoint elevation of each
+                                    * node (m) */
+} edgetree_struct;
+
+/* Sort key of element edges */
+typedef struct edgekey_struct
+{
+    double          key;           /* midpoint coordinate */
+    int             item;          /* element edge */
+} edgekey_struct;
+#endif
+
+/* Header of model cache file */
+typedef struct cachehdr_struct
+{
+    char            magic[8];              /* CACHE_MAGIC */
+    int32_t         version;               /* CACHE_VERSION */
+    int32_t         pad;
+    uint64_t        key;                   /* hash of static input files,
+                                            * options, and model
+                                            * configuration */
+    int32_t         nelem;                 /* number of element records */
+    int32_t         nriver;                /* number of river records */
+    int32_t         elem_size;             /* size of element record */
+    int32_t         river_size;            /* size of river record */
+    double          zmax;                  /* average surface elevation (m) */
+    double          zmin;                  /* average soil bottom elevation
+                                            * (m) */
+    double          area;                  /* total area (m2) */
+} cachehdr_struct;
+
+/* Static element variables in model cache file */
+typedef struct elemcache_struct
+{
+    int             node[NUM_EDGE];        /* nodes of triangular element */
+    int             nabr[NUM_EDGE];        /* neighbor elements */
+    int             ind;                   /* index */
+    attrib_struct   attrib;
+    topo_struct     topo;
+    soil_struct     soil;
+    lc_struct       lc;
+#if defined(_FBR_)
+    geol_struct     geol;
+#endif
+    double          rzd;                   /* rooting depth (m) */
+#if !defined(_CYCLES_)
+    double          rsmin;                 /* minimum canopy resistance
+                                            * (s m-1) */
+    double          rgl;                   /* reference incoming solar flux
+                                            * for photosynthetically active
+                                            * canopy (W m-2) */
+    double          hs;                    /* parameter used in vapor
+                                            * pressure deficit function (-) */
+    double          rsmax;                 /* cuticular resistance (s m-1) */
+    double          topt;                  /* optimum transpiration air
+                                            * temperature (K) */
+#endif
+} elemcache_struct;
+
+/* Static river variables in model cache file */
+typedef struct rivcache_struct
+{
+    int             ind;                   /* river index */
+    int             leftele;               /* left neighboring element */
+    int             rightele;              /* right neighboring element */
+    int             fromnode;              /* upstream node */
+    int             tonode;                /* downstream node */
+    int             down;                  /* down stream channel segment */
+    river_attrib_struct attrib;
+    river_topo_struct topo;
+    shp_struct      shp;
+    matl_struct     matl;
+} rivcache_struct;
+
 typedef struct pihm_struct
 {
     siteinfo_struct siteinfo;
@@ -237,6 +799,7 @@ typedef struct pihm_struct
     rivtbl_struct   rivtbl;
     shptbl_struct   shptbl;
     matltbl_struct  matltbl;
+    reducetbl_struct reducetbl;
 #if defined(_NOAH_)
     noahtbl_struct  noahtbl;
 #endif
@@ -257,6 +820,77 @@ typedef struct pihm_struct
     calib_struct    cal;
     ctrl_struct     ctrl;
     print_struct    print;
+    hydro_struct    hydro;
+    graph_struct    graph;
+    prec_struct     prec;
+    jac_struct      jac;
+    rhstime_struct  rhstime;
+    multirate_struct multirate;
+    stepctrl_struct stepctrl;
+    cpl_struct      cpl;
+#if defined(_DEBUG_)
+    allocstat_struct allocstat;
+#endif
+    int             shared;    /* flag that input tables are shared with
+                                * another model */
 } *pihm_struct;
 
+/* Model context: settings and model dimensions that the model code
+ * references through global variables. Each model instance keeps its
+ * context, which is copied into the global variables when the instance is
+ * called through the library interface. The model code is not reentrant, and
+ * only one instance can be active at a time */
+typedef struct ctx_struct
+{
+    int             verbose_mode;
+    int             debug_mode;
+    int             append_mode;
+    int             corr_mode;
+    int             spinup_mode;
+    int             tecplot;
+    int             benchmark;
+    int             convert_mode;
+    int             cache_mode;
+    char            project[MAXSTRING];
+    int             nelem;
+    int             nriver;
+#if defined(_OPENMP)
+    int             nthreads;
+#endif
+#if defined(_BGC_)
+    int             first_balance;
+#endif
+} ctx_struct;
+
+/* Model instance of the library interface */
+typedef struct model_struct
+{
+    ctx_struct      ctx;
+    pihm_struct     pihm;
+    N_Vector        CV_Y;
+    void           *cvode_mem;
+    char            outputdir[MAXSTRING];
+    struct model_struct *base;         /* model that input tables and forcing
+                                        * are shared with (NULL if inputs are
+                                        * read from input files) */
+    int             nshare;            /* number of models sharing inputs of
+                                        * the model */
+    int             output;            /* flag that output files are
+                                        * open */
+    int             init;              /* flag that model has been
+                                        * initialized */
+    int             failed;            /* flag that an error occurred while
+                                        * the model was initialized or
+                                        * advanced */
+#if defined(_OPENMP)
+    double          start;             /* wall clock time at initialization */
+    double          ptime;             /* wall clock time of the last model
+                                        * step */
+#else
+    clock_t         start;             /* processor time at initialization */
+    clock_t         ptime;             /* processor time of the last model
+                                        * step */
+#endif
+} *model_struct;
+
 #endif
@@ -4,16 +4,29 @@ void InitForc(elem_struct *elem, forc_struct *forc, const calib_struct *cal)
 {
     int             i, j;
 
-    /* Apply climate scenarios */
-    for (i = 0; i < forc->nmeteo; i++)
+    /* Apply climate scenarios. Streamed forcing is modified when read */
+    if (forc->metstream != NULL)
     {
+        forc->metstream->prcp = cal->prcp;
+        forc->metstream->sfctmp = cal->sfctmp;
+    }
+
+    /* Skipped without scenarios so that pages of mapped binary forcing files
+     * are not copied */
+    if (cal->prcp != 1.0 || cal->sfctmp != 0.0)
+    {
+        for (i = 0; i < forc->nmeteo; i++)
+        {
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
-        for (j = 0; j < forc->meteo[i].length; j++)
-        {
-            forc->meteo[i].data[j][PRCP_TS] *= cal->prcp;
-            forc->meteo[i].data[j][SFCTMP_TS] += cal->sfctmp;
+            for (j = 0; j < forc->meteo[i].length; j++)
+            {
+                forc->meteo[i].data[j * NUM_METEO_VAR + PRCP_TS] *=
+                    cal->prcp;
+                forc->meteo[i].data[j * NUM_METEO_VAR + SFCTMP_TS] +=
+                    cal->sfctmp;
+            }
         }
     }
 
@@ -21,7 +34,7 @@ void InitForc(elem_struct *elem, forc_struct *forc, const calib_struct *cal)
     {
         for (i = 0; i < forc->nbc; i++)
         {
-            forc->bc[i].value = (double *)malloc(sizeof(double));
+            forc->bc[i].value = (double *)calloc(1, sizeof(double));
         }
     }
     if (forc->nmeteo > 0)
@@ -29,28 +42,28 @@ void InitForc(elem_struct *elem, forc_struct *forc, const calib_struct *cal)
         for (i = 0; i < forc->nmeteo; i++)
         {
             forc->meteo[i].value =
-                (double *)malloc(NUM_METEO_VAR * sizeof(double));
+                (double *)calloc(NUM_METEO_VAR, sizeof(double));
         }
     }
     if (forc->nlai > 0)
     {
         for (i = 0; i < forc->nlai; i++)
         {
-            forc->lai[i].value = (double *)malloc(sizeof(double));
+            forc->lai[i].value = (double *)calloc(1, sizeof(double));
         }
     }
     if (forc->nriverbc > 0)
     {
         for (i = 0; i < forc->nriverbc; i++)
         {
-            forc->riverbc[i].value = (double *)malloc(sizeof(double));
+            forc->riverbc[i].value = (double *)calloc(1, sizeof(double));
         }
     }
     if (forc->nsource > 0)
     {
         for (i = 0; i < forc->nsource; i++)
         {
-            forc->source[i].value = (double *)malloc(sizeof(double));
+            forc->source[i].value = (double *)calloc(1, sizeof(double));
         }
     }
 #if defined(_NOAH_)
@@ -58,7 +71,7 @@ void InitForc(elem_struct *elem, forc_struct *forc, const calib_struct *cal)
     {
         for (i = 0; i < forc->nrad; i++)
         {
-            forc->rad[i].value = (double *)malloc(2 * sizeof(double));
+            forc->rad[i].value = (double *)calloc(2, sizeof(double));
         }
     }
 #endif
@@ -66,12 +79,12 @@ void InitForc(elem_struct *elem, forc_struct *forc, const calib_struct *cal)
 #if defined(_BGC_)
     if (forc->nco2 > 0)
     {
-        forc->co2[0].value = (double *)malloc(sizeof(double));
+        forc->co2[0].value = (double *)calloc(1, sizeof(double));
     }
 
     if (forc->nndep > 0)
     {
-        forc->ndep[0].value = (double *)malloc(sizeof(double));
+        forc->ndep[0].value = (double *)calloc(1, sizeof(double));
     }
 #endif
 
@@ -83,4 +96,138 @@ void InitForc(elem_struct *elem, forc_struct *forc, const calib_struct *cal)
         elem[i].ps.zlvl_wind =
             forc->meteo[elem[i].attrib.meteo_type - 1].zlvl_wind;
     }
+
+    InitMeteoMap(elem, forc);
+
+    InitBcMap(elem, forc);
+}
+
+void InitMeteoMap(const elem_struct *elem, forc_struct *forc)
+{
+    /*
+     * Build the list of elements using each meteorological forcing series,
+     * so that forcing is applied to elements station by station
+     */
+    int             i, k;
+    tsdata_struct  *ts;
+
+    for (k = 0; k < forc->nmeteo; k++)
+    {
+        forc->meteo[k].ngrid = 0;
+        forc->meteo[k].changed = 1;
+    }
+
+    for (i = 0; i < nelem; i++)
+    {
+        forc->meteo[elem[i].attrib.meteo_type - 1].ngrid++;
+    }
+
+    for (k = 0; k < forc->nmeteo; k++)
+    {
+        forc->meteo[k].grid =
+            (int *)malloc(forc->meteo[k].ngrid * sizeof(int));
+        forc->meteo[k].ngrid = 0;
+    }
+
+    for (i = 0; i < nelem; i++)
+    {
+        ts = &forc->meteo[elem[i].attrib.meteo_type - 1];
+        ts->grid[ts->ngrid] = i;
+        ts->ngrid++;
+    }
+}
+
+void ResetForcUpdate(forc_struct *forc)
+{
+    /*
+     * Flag all meteorological forcing and boundary condition series as
+     * changed, so that they are applied at the next model step even if their
+     * values are the same as when they were last applied
+     */
+    int             k;
+
+    for (k = 0; k < forc->nmeteo; k++)
+    {
+        forc->meteo[k].changed = 1;
+    }
+
+    for (k = 0; k < forc->nbc; k++)
+    {
+        forc->bc[k].changed = 1;
+    }
+}
+
+void InitBcMap(elem_struct *elem, forc_struct *forc)
+{
+    /*
+     * Build the list of element edge boundary conditions set by each
+     * boundary condition series, so that edges without boundary conditions
+     * are not visited when applying boundary conditions
+     */
+    int             i, j, k;
+    tsdata_struct  *ts;
+
+    for (k = 0; k < forc->nbc; k++)
+    {
+        forc->bc[k].nbcvar = 0;
+        forc->bc[k].changed = 1;
+    }
+
+    for (i = 0; i < nelem; i++)
+    {
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            if (elem[i].attrib.bc_type[j] != 0)
+            {
+                forc->bc[abs(elem[i].attrib.bc_type[j]) - 1].nbcvar++;
+            }
+#if defined(_FBR_)
+            if (elem[i].attrib.fbrbc_type[j] != 0)
+            {
+                forc->bc[abs(elem[i].attrib.fbrbc_type[j]) - 1].nbcvar++;
+            }
+#endif
+        }
+    }
+
+    for (k = 0; k < forc->nbc; k++)
+    {
+        forc->bc[k].bcvar =
+            (double **)malloc(forc->bc[k].nbcvar * sizeof(double *));
+        forc->bc[k].nbcvar = 0;
+    }
+
+    for (i = 0; i < nelem; i++)
+    {
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            if (elem[i].attrib.bc_type[j] > 0)
+            {
+                ts = &forc->bc[elem[i].attrib.bc_type[j] - 1];
+                ts->bcvar[ts->nbcvar] = &elem[i].bc.head[j];
+                ts->nbcvar++;
+            }
+            else if (elem[i].attrib.bc_type[j] < 0)
+            {
+                ts = &forc->bc[-elem[i].attrib.bc_type[j] - 1];
+                ts->bcvar[ts->nbcvar] = &elem[i].bc.flux[j];
+                ts->nbcvar++;
+            }
+
+#if defined(_FBR_)
+            if (elem[i].attrib.fbrbc_type[j] > 0)
+            {
+                ts = &forc->bc[elem[i].attrib.fbrbc_type[j] - 1];
+                ts->bcvar[ts->nbcvar] = &elem[i].fbr_bc.head[j];
+                ts->nbcvar++;
+            }
+            else if (elem[i].attrib.fbrbc_type[j] < 0)
+            {
+                ts = &forc->bc[-elem[i].attrib.fbrbc_type[j] - 1];
+                ts->bcvar[ts->nbcvar] = &elem[i].fbr_bc.flux[j];
+                ts->nbcvar++;
+            }
+#endif
+        }
+    }
 }
@@ -11,7 +11,7 @@ void InitMesh(elem_struct *elem, const meshtbl_struct *meshtbl)
     {
         int             j;
 
-        elem[i].ind = i + 1;
+        elem[i].ind = meshtbl->ind[i];
 
         for (j = 0; j < NUM_EDGE; j++)
         {
@@ -11,7 +11,7 @@ void InitRiver(river_struct *river, elem_struct *elem,
     {
         int             j;
 
-        river[i].ind = i + 1;
+        river[i].ind = rivtbl->ind[i];
         river[i].leftele = rivtbl->leftele[i];
         river[i].rightele = rivtbl->rightele[i];
         river[i].fromnode = rivtbl->fromnode[i];
@@ -51,26 +51,31 @@ void InitTopo(elem_struct *elem, const meshtbl_struct *meshtbl)
 #if defined(_NOAH_)
 void CalcSlopeAspect(elem_struct *elem, const meshtbl_struct *meshtbl)
 {
-    const int       XCOMP = 0;
-    const int       YCOMP = 1;
-    const int       ZCOMP = 2;
-    double          x[NUM_EDGE];
-    double          y[NUM_EDGE];
-    double          zmax[NUM_EDGE];
-    double          edge_vector[2][NUM_EDGE];
-    double          normal_vector[NUM_EDGE];
-    double          vector[NUM_EDGE];
-    double          h, c;
-    double          se, ce;
-    int             nodes[2];
-    double          x1, y1, z1, x2, y2, z2, xc, yc, zc;
-    double          c1, c2, ce1, ce2, se1, se2, phi1, phi2;
-    double          integrable;
-    int             ind, ind1, ind2;
-    int             i, j, k;
+    edgetree_struct tree;
+    int             i;
+
+    /* Spatial index of element edges for horizon angle calculation */
+    BuildEdgeTree(elem, meshtbl, &tree);
 
+#if defined(_OPENMP)
+# pragma omp parallel for schedule(dynamic, 16)
+#endif
     for (i = 0; i < nelem; i++)
     {
+        const int       XCOMP = 0;
+        const int       YCOMP = 1;
+        const int       ZCOMP = 2;
+        double          x[NUM_EDGE];
+        double          y[NUM_EDGE];
+        double          zmax[NUM_EDGE];
+        double          edge_vector[2][NUM_EDGE];
+        double          normal_vector[NUM_EDGE];
+        double          c;
+        double          se, ce;
+        double          integrable;
+        int             ind;
+        int             j;
+
         for (j = 0; j < NUM_EDGE; j++)
         {
             x[j] = meshtbl->x[elem[i].node[j] - 1];
@@ -124,118 +129,7 @@ void CalcSlopeAspect(elem_struct *elem, const meshtbl_struct *meshtbl)
         elem[i].topo.svf = 0.0;
 
         /* Calculate unobstructed angle for every 10 degrees */
-        for (j = 0; j < 36; j++)
-        {
-            elem[i].topo.h_phi[j] = 90.0;
-        }
-
-        /* Consider every edge of every triangular grid */
-        for (j = 0; j < nelem; j++)
-        {
-            for (k = 0; k < NUM_EDGE; k++)
-            {
-                switch (k)
-                {
-                    case 0:
-                        nodes[0] = 1;
-                        nodes[1] = 2;
-                        break;
-                    case 1:
-                        nodes[0] = 0;
-                        nodes[1] = 2;
-                        break;
-                    case 2:
-                        nodes[0] = 0;
-                        nodes[1] = 1;
-                        break;
-                }
-                x1 = meshtbl->x[elem[j].node[nodes[0]] - 1];
-                y1 = meshtbl->y[elem[j].node[nodes[0]] - 1];
-                z1 = meshtbl->zmax[elem[j].node[nodes[0]] - 1];
-                x2 = meshtbl->x[elem[j].node[nodes[1]] - 1];
-                y2 = meshtbl->y[elem[j].node[nodes[1]] - 1];
-                z2 = meshtbl->zmax[elem[j].node[nodes[1]] - 1];
-
-                xc = 0.5 * (x1 + x2);
-                yc = 0.5 * (y1 + y2);
-                zc = 0.5 * (z1 + z2);
-
-                vector[XCOMP] = xc - elem[i].topo.x;
-                vector[YCOMP] = yc - elem[i].topo.y;
-                vector[ZCOMP] = zc - elem[i].topo.zmax;
-                c = sqrt(vector[XCOMP] * vector[XCOMP] +
-                    vector[YCOMP] * vector[YCOMP]);
-                /* Unobstructed angle of the kth edge of the jth grid */
-                h = atan(c / vector[ZCOMP]) * 180.0 / PI;
-                h = (h < 0.0) ? 90.0 : h;
-
-                /* Find out which directions are blocked */
-                edge_vector[0][XCOMP] = x1 - elem[i].topo.x;
-                edge_vector[0][YCOMP] = y1 - elem[i].topo.y;
-                edge_vector[0][ZCOMP] = z1 - elem[i].topo.zmax;
-                edge_vector[1][XCOMP] = x2 - elem[i].topo.x;
-                edge_vector[1][YCOMP] = y2 - elem[i].topo.y;
-                edge_vector[1][ZCOMP] = z2 - elem[i].topo.zmax;
-
-                c1 = sqrt(edge_vector[0][XCOMP] * edge_vector[0][XCOMP] +
-                    edge_vector[0][YCOMP] * edge_vector[0][YCOMP]);
-                c2 = sqrt(edge_vector[1][XCOMP] * edge_vector[1][XCOMP] +
-                    edge_vector[1][YCOMP] * edge_vector[1][YCOMP]);
-
-                ce1 = edge_vector[0][XCOMP] / c1;
-                se1 = edge_vector[0][YCOMP] / c1;
-                phi1 = acos(ce1) * 180.0 / PI;
-                if (se1 < 0.0)
-                {
-                    phi1 = 360.0 - phi1;
-                }
-                phi1 = Mod(360.0 - phi1 + 270.0, 360.0);
-
-                ce2 = edge_vector[1][XCOMP] / c2;
-                se2 = edge_vector[1][YCOMP] / c2;
-                phi2 = acos(ce2) * 180.0 / PI;
-                if (se2 < 0.0)
-                {
-                    phi2 = 360.0 - phi2;
-                }
-                phi2 = Mod(360.0 - phi2 + 270.0, 360.0);
-
-                if (fabs(phi1 - phi2) > 180.0)
-                {
-                    ind1 = 0;
-                    ind2 = (int)floor((phi1 < phi2 ? phi1 : phi2) / 10.0);
-                    for (ind = ind1; ind <= ind2; ind++)
-                    {
-                        if (h < elem[i].topo.h_phi[ind])
-                        {
-                            elem[i].topo.h_phi[ind] = h;
-                        }
-                    }
-
-                    ind1 = (int)floor((phi1 > phi2 ? phi1 : phi2) / 10.0);
-                    ind2 = 35;
-                    for (ind = ind1; ind <= ind2; ind++)
-                    {
-                        if (h < elem[i].topo.h_phi[ind])
-                        {
-                            elem[i].topo.h_phi[ind] = h;
-                        }
-                    }
-                }
-                else
-                {
-                    ind1 = (int)floor((phi1 < phi2 ? phi1 : phi2) / 10.0);
-                    ind2 = (int)floor((phi1 > phi2 ? phi1 : phi2) / 10.0);
-                    for (ind = ind1; ind <= ind2; ind++)
-                    {
-                        if (h < elem[i].topo.h_phi[ind])
-                        {
-                            elem[i].topo.h_phi[ind] = h;
-                        }
-                    }
-                }
-            }
-        }
+        HorizonAngle(&tree, &elem[i].topo);
 
         /* Calculate sky view factor (Eq. 7b) */
         for (ind = 0; ind < 36; ind++)
@@ -251,6 +145,465 @@ void CalcSlopeAspect(elem_struct *elem, const meshtbl_struct *meshtbl)
             elem[i].topo.svf += 0.5 / PI * integrable * 10.0 / 180.0 * PI;
         }
     }
+
+    FreeEdgeTree(&tree);
+}
+
+void BuildEdgeTree(const elem_struct *elem, const meshtbl_struct *meshtbl,
+    edgetree_struct *tree)
+{
+    /*
+     * Build a k-d tree of the edges of all elements, split at the median of
+     * edge midpoints. Every edge of every element is included, as in the
+     * original all-pairs horizon calculation
+     */
+    int             nodes[NUM_EDGE][2] = {{1, 2}, {0, 2}, {0, 1}};
+    double        (*edge)[6];
+    int             maxnode;
+    int             i, j, k;
+
+    tree->nedge = NUM_EDGE * nelem;
+    tree->item = (int *)malloc(tree->nedge * sizeof(int));
+    edge = (double (*)[6])malloc(tree->nedge * sizeof(double[6]));
+
+    for (i = 0; i < nelem; i++)
+    {
+        for (k = 0; k < NUM_EDGE; k++)
+        {
+            for (j = 0; j < 2; j++)
+            {
+                int             node;
+
+                node = elem[i].node[nodes[k][j]] - 1;
+                edge[NUM_EDGE * i + k][3 * j] = meshtbl->x[node];
+                edge[NUM_EDGE * i + k][3 * j + 1] = meshtbl->y[node];
+                edge[NUM_EDGE * i + k][3 * j + 2] = meshtbl->zmax[node];
+            }
+            tree->item[NUM_EDGE * i + k] = NUM_EDGE * i + k;
+        }
+    }
+
+    /* Leaves have at least EDGETREE_LEAF / 2 edges */
+    maxnode = 4 * tree->nedge / EDGETREE_LEAF + 2;
+    tree->child = (int *)malloc(maxnode * sizeof(int));
+    tree->start = (int *)malloc(maxnode * sizeof(int));
+    tree->end = (int *)malloc(maxnode * sizeof(int));
+    tree->midbox = (double (*)[4])malloc(maxnode * sizeof(double[4]));
+    tree->endbox = (double (*)[4])malloc(maxnode * sizeof(double[4]));
+    tree->zcmax = (double *)malloc(maxnode * sizeof(double));
+
+    tree->nnode = 1;
+    tree->start[0] = 0;
+    tree->end[0] = tree->nedge;
+    SplitEdgeTree((const double (*)[6])edge, 0, tree);
+
+    /* Store edges in tree order */
+    tree->edge = (double (*)[6])malloc(tree->nedge * sizeof(double[6]));
+    for (i = 0; i < tree->nedge; i++)
+    {
+        for (j = 0; j < 6; j++)
+        {
+            tree->edge[i][j] = edge[tree->item[i]][j];
+        }
+    }
+
+    free(edge);
+}
+
+void SplitEdgeTree(const double (*edge)[6], int node, edgetree_struct *tree)
+{
+    /*
+     * Calculate bounding boxes of a tree node and split it recursively. The
+     * two children of a node are stored next to each other
+     */
+    int             start, end;
+    int             axis;
+    int             i;
+    edgekey_struct *key;
+
+    start = tree->start[node];
+    end = tree->end[node];
+    tree->child[node] = -1;
+
+    for (i = start; i < end; i++)
+    {
+        const double   *e;
+        double          xc, yc, zc;
+        double          xlo, xhi, ylo, yhi;
+
+        e = edge[tree->item[i]];
+
+        /* Same as the midpoint calculation in EdgeHorizon */
+        xc = 0.5 * (e[0] + e[3]);
+        yc = 0.5 * (e[1] + e[4]);
+        zc = 0.5 * (e[2] + e[5]);
+
+        xlo = (e[0] < e[3]) ? e[0] : e[3];
+        xhi = (e[0] > e[3]) ? e[0] : e[3];
+        ylo = (e[1] < e[4]) ? e[1] : e[4];
+        yhi = (e[1] > e[4]) ? e[1] : e[4];
+
+        if (i == start)
+        {
+            tree->midbox[node][0] = tree->midbox[node][1] = xc;
+            tree->midbox[node][2] = tree->midbox[node][3] = yc;
+            tree->zcmax[node] = zc;
+            tree->endbox[node][0] = xlo;
+            tree->endbox[node][1] = xhi;
+            tree->endbox[node][2] = ylo;
+            tree->endbox[node][3] = yhi;
+        }
+        else
+        {
+            tree->midbox[node][0] = (xc < tree->midbox[node][0]) ?
+                xc : tree->midbox[node][0];
+            tree->midbox[node][1] = (xc > tree->midbox[node][1]) ?
+                xc : tree->midbox[node][1];
+            tree->midbox[node][2] = (yc < tree->midbox[node][2]) ?
+                yc : tree->midbox[node][2];
+            tree->midbox[node][3] = (yc > tree->midbox[node][3]) ?
+                yc : tree->midbox[node][3];
+            tree->zcmax[node] = (zc > tree->zcmax[node]) ?
+                zc : tree->zcmax[node];
+            tree->endbox[node][0] = (xlo < tree->endbox[node][0]) ?
+                xlo : tree->endbox[node][0];
+            tree->endbox[node][1] = (xhi > tree->endbox[node][1]) ?
+                xhi : tree->endbox[node][1];
+            tree->endbox[node][2] = (ylo < tree->endbox[node][2]) ?
+                ylo : tree->endbox[node][2];
+            tree->endbox[node][3] = (yhi > tree->endbox[node][3]) ?
+                yhi : tree->endbox[node][3];
+        }
+    }
+
+    if (end - start <= EDGETREE_LEAF)
+    {
+        return;
+    }
+
+    /* Split along the longer side of the box of midpoints */
+    axis = (tree->midbox[node][1] - tree->midbox[node][0] >=
+        tree->midbox[node][3] - tree->midbox[node][2]) ? 0 : 1;
+
+    key = (edgekey_struct *)malloc((end - start) * sizeof(edgekey_struct));
+    for (i = start; i < end; i++)
+    {
+        const double   *e;
+
+        e = edge[tree->item[i]];
+        key[i - start].key = 0.5 * (e[axis] + e[axis + 3]);
+        key[i - start].item = tree->item[i];
+    }
+
+    qsort(key, end - start, sizeof(edgekey_struct), CompareEdgeKey);
+
+    for (i = start; i < end; i++)
+    {
+        tree->item[i] = key[i - start].item;
+    }
+    free(key);
+
+    tree->child[node] = tree->nnode;
+    tree->nnode += 2;
+
+    tree->start[tree->child[node]] = start;
+    tree->end[tree->child[node]] = (start + end) / 2;
+    tree->start[tree->child[node] + 1] = (start + end) / 2;
+    tree->end[tree->child[node] + 1] = end;
+
+    SplitEdgeTree(edge, tree->child[node], tree);
+    SplitEdgeTree(edge, tree->child[node] + 1, tree);
+}
+
+int CompareEdgeKey(const void *a, const void *b)
+{
+    const edgekey_struct *ka = (const edgekey_struct *)a;
+    const edgekey_struct *kb = (const edgekey_struct *)b;
+
+    if (ka->key != kb->key)
+    {
+        return (ka->key < kb->key) ? -1 : 1;
+    }
+
+    return (ka->item < kb->item) ? -1 : (ka->item > kb->item);
+}
+
+void HorizonAngle(const edgetree_struct *tree, topo_struct *topo)
+{
+    /*
+     * Calculate unobstructed angle in each direction. Of the two children of a
+     * tree node, the one with the smaller possible angle is visited first,
+     * and a node is skipped if none of its edges can lower the
+     * unobstructed angle of any direction they cover, i.e., if all edge
+     * midpoints are not higher than the element, or the smallest possible
+     * angle to the edge midpoints is not smaller than the unobstructed angles
+     * of the directions covered by the edges. Results are the same as
+     * testing every edge
+     */
+    int             stack[EDGETREE_DEPTH];
+    int             nstack = 0;
+    int             j;
+
+    for (j = 0; j < 36; j++)
+    {
+        topo->h_phi[j] = 90.0;
+    }
+
+    stack[nstack++] = 0;
+
+    while (nstack > 0)
+    {
+        int             node;
+        double          hmin;
+
+        node = stack[--nstack];
+
+        if (tree->zcmax[node] <= topo->zmax)
+        {
+            continue;
+        }
+
+        /* Smallest possible angle to edge midpoints in the node, with a small
+         * margin for round-off errors */
+        hmin = NodeHmin(tree, node, topo) - 1.0E-6;
+
+        if (hmin >= SectorMaxHphi(tree->endbox[node], topo))
+        {
+            continue;
+        }
+
+        if (tree->child[node] < 0)
+        {
+            for (j = tree->start[node]; j < tree->end[node]; j++)
+            {
+                EdgeHorizon(tree->edge[j], topo);
+            }
+        }
+        else
+        {
+            int             first, second;
+
+            first = tree->child[node];
+            second = tree->child[node] + 1;
+            if (NodeHmin(tree, second, topo) < NodeHmin(tree, first, topo))
+            {
+                first = second;
+                second = tree->child[node];
+            }
+
+            stack[nstack++] = second;
+            stack[nstack++] = first;
+        }
+    }
+}
+
+double NodeHmin(const edgetree_struct *tree, int node, const topo_struct *topo)
+{
+    /*
+     * Smallest possible unobstructed angle of edges in a tree node (degree)
+     */
+    return (tree->zcmax[node] <= topo->zmax) ? 90.0 :
+        atan(BoxDist(tree->midbox[node], topo->x, topo->y) /
+        (tree->zcmax[node] - topo->zmax)) * 180.0 / PI;
+}
+
+void EdgeHorizon(const double *edge, topo_struct *topo)
+{
+    /*
+     * Lower the unobstructed angles of the directions blocked by an edge
+     */
+    const int       XCOMP = 0;
+    const int       YCOMP = 1;
+    const int       ZCOMP = 2;
+    double          edge_vector[2][NUM_EDGE];
+    double          vector[NUM_EDGE];
+    double          h, c;
+    double          x1, y1, z1, x2, y2, z2, xc, yc, zc;
+    double          c1, c2, ce1, ce2, se1, se2, phi1, phi2;
+    int             ind, ind1, ind2;
+
+    x1 = edge[0];
+    y1 = edge[1];
+    z1 = edge[2];
+    x2 = edge[3];
+    y2 = edge[4];
+    z2 = edge[5];
+
+    xc = 0.5 * (x1 + x2);
+    yc = 0.5 * (y1 + y2);
+    zc = 0.5 * (z1 + z2);
+
+    vector[XCOMP] = xc - topo->x;
+    vector[YCOMP] = yc - topo->y;
+    vector[ZCOMP] = zc - topo->zmax;
+    c = sqrt(vector[XCOMP] * vector[XCOMP] + vector[YCOMP] * vector[YCOMP]);
+    /* Unobstructed angle of the edge */
+    h = atan(c / vector[ZCOMP]) * 180.0 / PI;
+    h = (h < 0.0) ? 90.0 : h;
+
+    /* Find out which directions are blocked */
+    edge_vector[0][XCOMP] = x1 - topo->x;
+    edge_vector[0][YCOMP] = y1 - topo->y;
+    edge_vector[0][ZCOMP] = z1 - topo->zmax;
+    edge_vector[1][XCOMP] = x2 - topo->x;
+    edge_vector[1][YCOMP] = y2 - topo->y;
+    edge_vector[1][ZCOMP] = z2 - topo->zmax;
+
+    c1 = sqrt(edge_vector[0][XCOMP] * edge_vector[0][XCOMP] +
+        edge_vector[0][YCOMP] * edge_vector[0][YCOMP]);
+    c2 = sqrt(edge_vector[1][XCOMP] * edge_vector[1][XCOMP] +
+        edge_vector[1][YCOMP] * edge_vector[1][YCOMP]);
+
+    ce1 = edge_vector[0][XCOMP] / c1;
+    se1 = edge_vector[0][YCOMP] / c1;
+    phi1 = acos(ce1) * 180.0 / PI;
+    if (se1 < 0.0)
+    {
+        phi1 = 360.0 - phi1;
+    }
+    phi1 = Mod(360.0 - phi1 + 270.0, 360.0);
+
+    ce2 = edge_vector[1][XCOMP] / c2;
+    se2 = edge_vector[1][YCOMP] / c2;
+    phi2 = acos(ce2) * 180.0 / PI;
+    if (se2 < 0.0)
+    {
+        phi2 = 360.0 - phi2;
+    }
+    phi2 = Mod(360.0 - phi2 + 270.0, 360.0);
+
+    if (fabs(phi1 - phi2) > 180.0)
+    {
+        ind1 = 0;
+        ind2 = (int)floor((phi1 < phi2 ? phi1 : phi2) / 10.0);
+        for (ind = ind1; ind <= ind2; ind++)
+        {
+            if (h < topo->h_phi[ind])
+            {
+                topo->h_phi[ind] = h;
+            }
+        }
+
+        ind1 = (int)floor((phi1 > phi2 ? phi1 : phi2) / 10.0);
+        ind2 = 35;
+        for (ind = ind1; ind <= ind2; ind++)
+        {
+            if (h < topo->h_phi[ind])
+            {
+                topo->h_phi[ind] = h;
+            }
+        }
+    }
+    else
+    {
+        ind1 = (int)floor((phi1 < phi2 ? phi1 : phi2) / 10.0);
+        ind2 = (int)floor((phi1 > phi2 ? phi1 : phi2) / 10.0);
+        for (ind = ind1; ind <= ind2; ind++)
+        {
+            if (h < topo->h_phi[ind])
+            {
+                topo->h_phi[ind] = h;
+            }
+        }
+    }
+}
+
+double SectorMaxHphi(const double *box, const topo_struct *topo)
+{
+    /*
+     * Largest unobstructed angle of the directions (10-degree sectors) that
+     * may be blocked by edges within box. The directions covered by box are
+     * widened by a small margin to allow for round-off errors
+     */
+    double          tol;
+    double          phi0;
+    double          dphi_min = 0.0;
+    double          dphi_max = 0.0;
+    double          hmax = 0.0;
+    int             ind1, ind2;
+    int             ind;
+    int             j;
+
+    tol = 1.0E-6 * (box[1] - box[0] + box[3] - box[2] + 1.0);
+
+    if (topo->x > box[0] - tol && topo->x < box[1] + tol &&
+        topo->y > box[2] - tol && topo->y < box[3] + tol)
+    {
+        /* Box covers all directions */
+        ind1 = 0;
+        ind2 = 35;
+    }
+    else
+    {
+        /* Directions of box corners relative to the direction of box center,
+         * which are within (-180, 180) degrees as box does not contain the
+         * element */
+        phi0 = Azimuth(0.5 * (box[0] + box[1]) - topo->x,
+            0.5 * (box[2] + box[3]) - topo->y);
+
+        for (j = 0; j < 4; j++)
+        {
+            double          dphi;
+
+            dphi = Azimuth(box[j / 2] - topo->x, box[2 + j % 2] - topo->y) -
+                phi0;
+            dphi = Mod(dphi + 180.0, 360.0) - 180.0;
+
+            dphi_min = (dphi < dphi_min) ? dphi : dphi_min;
+            dphi_max = (dphi > dphi_max) ? dphi : dphi_max;
+        }
+
+        ind1 = (int)floor((phi0 + dphi_min - 1.0E-6) / 10.0);
+        ind2 = (int)floor((phi0 + dphi_max + 1.0E-6) / 10.0);
+        if (ind2 - ind1 >= 35)
+        {
+            ind1 = 0;
+            ind2 = 35;
+        }
+    }
+
+    for (ind = ind1; ind <= ind2; ind++)
+    {
+        double          h_phi;
+
+        h_phi = topo->h_phi[(int)Mod(ind, 36.0)];
+        hmax = (h_phi > hmax) ? h_phi : hmax;
+    }
+
+    return hmax;
+}
+
+double Azimuth(double dx, double dy)
+{
+    /*
+     * Direction of vector (dx, dy) as used for unobstructed angles (degree)
+     */
+    return Mod(270.0 - atan2(dy, dx) * 180.0 / PI, 360.0);
+}
+
+double BoxDist(const double *box, double x, double y)
+{
+    /*
+     * Distance from point (x, y) to box
+     */
+    double          dx, dy;
+
+    dx = (x < box[0]) ? box[0] - x : ((x > box[1]) ? x - box[1] : 0.0);
+    dy = (y < box[2]) ? box[2] - y : ((y > box[3]) ? y - box[3] : 0.0);
+
+    return sqrt(dx * dx + dy * dy);
+}
+
+void FreeEdgeTree(edgetree_struct *tree)
+{
+    free(tree->item);
+    free(tree->edge);
+    free(tree->child);
+    free(tree->start);
+    free(tree->end);
+    free(tree->midbox);
+    free(tree->endbox);
+    free(tree->zcmax);
 }
 
 double Mod(double a, double n)
@@ -4,17 +4,7 @@
 
 void Initialize(pihm_struct pihm, N_Vector CV_Y, void **cvode_mem)
 {
-    int             i, j;
-#if defined(_LUMPED_)
-    int             soil_counter[MAX_TYPE];
-    int             lc_counter[MAX_TYPE];
-
-    for (i = 0; i < MAX_TYPE; i++)
-    {
-        soil_counter[i] = 0;
-        lc_counter[i] = 0;
-    }
-#endif
+    uint64_t        cache_key = 0;
 
     PIHMprintf(VL_VERBOSE, "\n\nInitialize data structure\n");
 
@@ -25,6 +15,7 @@ void Initialize(pihm_struct pihm, N_Vector CV_Y, void **cvode_mem)
         PIHMprintf(VL_ERROR, "Error in allocating memory for solver.\n");
         PIHMexit(EXIT_FAILURE);
     }
+    pihm->ctrl.cvode_init = 0;
 
     /*
      * Initialize PIHM structure
@@ -36,6 +27,161 @@ void Initialize(pihm_struct pihm, N_Vector CV_Y, void **cvode_mem)
 #endif
     pihm->river = (river_struct *)malloc(nriver * sizeof(river_struct));
 
+    /* Initialize static model variables (topology, topography, soil, land
+     * cover, and river properties), or load them from the model cache */
+    if (cache_mode)
+    {
+        cache_key = ModelCacheKey(pihm);
+    }
+
+    if (!cache_mode || !ReadModelCache(pihm->filename.cache, cache_key,
+        pihm->elem, pihm->river, &pihm->siteinfo))
+    {
+        InitStatic(pihm);
+
+        if (cache_mode)
+        {
+            WriteModelCache(pihm->filename.cache, cache_key, pihm->elem,
+                pihm->river, &pihm->siteinfo);
+        }
+    }
+
+    /* Initialize element forcing */
+    InitForc(pihm->elem, &pihm->forc, &pihm->cal);
+
+    /* Build element-river adjacency graph */
+    InitGraph(pihm->elem, pihm->river, &pihm->graph);
+
+    /* Initialize structure-of-arrays hydrology kernel state */
+    InitHydro(pihm->elem, pihm->river, &pihm->hydro);
+
+    /* Initialize the fast subsystem of multi-rate integration */
+    if (pihm->ctrl.multirate > 0)
+    {
+        InitMultiRate(&pihm->graph, pihm->ctrl.precond, &pihm->multirate);
+    }
+
+    /* Initialize event coupling */
+    if (pihm->ctrl.event_cpl)
+    {
+        pihm->cpl.ydot = N_VNew(NumStateVar());
+    }
+
+    pihm->rhstime.nrhs = 0;
+    pihm->rhstime.elapsed = 0.0;
+
+#if defined(_DEBUG_)
+    pihm->allocstat.nrhs = 0;
+    pihm->allocstat.nalloc = 0;
+#endif
+
+    /* Initialize linear solver structures */
+    if (pihm->ctrl.lin_solver == KLU_SOLVER)
+    {
+        InitSparseJac(&pihm->graph, &pihm->jac);
+    }
+    else if (pihm->ctrl.precond == BLOCK_JACOBI)
+    {
+        InitPrecond(&pihm->graph, &pihm->prec);
+    }
+
+#if defined(_NOAH_)
+    /* Initialize land surface module (Noah) */
+    InitLsm(pihm->elem, &pihm->ctrl, &pihm->noahtbl, &pihm->cal);
+#endif
+
+#if defined(_CYCLES_)
+    InitCycles(&pihm->agtbl, &pihm->soiltbl, pihm->epctbl, pihm->elem,
+        pihm->river);
+#endif
+
+#if defined(_BGC_)
+    /* Initialize CN (Biome-BGC) module */
+    InitBgc(pihm->elem, &pihm->epctbl, &pihm->cal);
+#endif
+
+    /*
+     * Create hydrological and land surface initial conditions
+     */
+    if (pihm->ctrl.init_type == RELAX)
+    {
+        /* Relaxation mode */
+#if defined(_NOAH_)
+        /* Noah initialization needs air temperature thus forcing is applied */
+        ApplyForc(&pihm->forc, pihm->elem, pihm->ctrl.starttime,
+            pihm->ctrl.rad_mode, &pihm->siteinfo);
+#endif
+
+        RelaxIc(pihm->elem, pihm->river);
+    }
+    else if (pihm->ctrl.init_type == RST_FILE)
+    {
+        /* Hot start (using .ic file) */
+        ReadIc(pihm->filename.ic, pihm->elem, pihm->river);
+    }
+
+    /* Initialize state variables */
+    InitVar(pihm->elem, pihm->river, CV_Y);
+
+#if defined(_CYCLES_)
+# if TEMP_DISABLED
+    /* Initialize Cycles module */
+    if (pihm->ctrl.read_cycles_restart)
+    {
+        ReadCyclesIC(pihm->filename.cyclesic, pihm->elem, pihm->river);
+    }
+# endif
+    FirstDay(&pihm->soiltbl, pihm->elem, pihm->river);
+
+    InitCyclesVar(pihm->elem, pihm->river, CV_Y);
+#endif
+
+#if defined(_BGC_)
+    /* Initialize CN variables */
+    if (pihm->ctrl.read_bgc_restart)
+    {
+        ReadBgcIc(pihm->filename.bgcic, pihm->elem, pihm->river);
+    }
+    else
+    {
+        FirstDay(pihm->elem, pihm->river, &pihm->cninit);
+    }
+
+    InitBgcVar(pihm->elem, pihm->river, CV_Y);
+#endif
+
+    /* Forcing applied before model variables were initialized (e.g., for
+     * Noah relaxation) has been overwritten, and must be applied again at
+     * the first model step */
+    ResetForcUpdate(&pihm->forc);
+
+    /* Calculate model time steps */
+    CalcModelStep(&pihm->ctrl);
+
+#if defined(_DAILY_)
+    InitDailyStruct(pihm->elem);
+#endif
+}
+
+void InitStatic(pihm_struct pihm)
+{
+    /*
+     * Initialize static model variables from input tables. These variables
+     * depend only on the static input files and are stored in the model cache
+     * (see WriteModelCache)
+     */
+    int             i, j;
+#if defined(_LUMPED_)
+    int             soil_counter[MAX_TYPE];
+    int             lc_counter[MAX_TYPE];
+
+    for (i = 0; i < MAX_TYPE; i++)
+    {
+        soil_counter[i] = 0;
+        lc_counter[i] = 0;
+    }
+#endif
+
     for (i = 0; i < nelem; i++)
     {
         pihm->elem[i].attrib.soil_type = pihm->atttbl.soil[i];
@@ -116,9 +262,6 @@ void Initialize(pihm_struct pihm, N_Vector CV_Y, void **cvode_mem)
     /* Initialize element land cover properties */
     InitLc(pihm->elem, &pihm->lctbl, &pihm->cal);
 
-    /* Initialize element forcing */
-    InitForc(pihm->elem, &pihm->forc, &pihm->cal);
-
     /* Initialize river segment properties */
     InitRiver(pihm->river, pihm->elem, &pihm->rivtbl, &pihm->shptbl,
         &pihm->matltbl, &pihm->meshtbl, &pihm->cal);
@@ -131,78 +274,6 @@ void Initialize(pihm_struct pihm, N_Vector CV_Y, void **cvode_mem)
 
     /* Calculate distances between elements */
     InitSurfL(pihm->elem, pihm->river, &pihm->meshtbl);
-
-#if defined(_NOAH_)
-    /* Initialize land surface module (Noah) */
-    InitLsm(pihm->elem, &pihm->ctrl, &pihm->noahtbl, &pihm->cal);
-#endif
-
-#if defined(_CYCLES_)
-    InitCycles(&pihm->agtbl, &pihm->soiltbl, pihm->epctbl, pihm->elem,
-        pihm->river);
-#endif
-
-#if defined(_BGC_)
-    /* Initialize CN (Biome-BGC) module */
-    InitBgc(pihm->elem, &pihm->epctbl, &pihm->cal);
-#endif
-
-    /*
-     * Create hydrological and land surface initial conditions
-     */
-    if (pihm->ctrl.init_type == RELAX)
-    {
-        /* Relaxation mode */
-#if defined(_NOAH_)
-        /* Noah initialization needs air temperature thus forcing is applied */
-        ApplyForc(&pihm->forc, pihm->elem, pihm->ctrl.starttime,
-            pihm->ctrl.rad_mode, &pihm->siteinfo);
-#endif
-
-        RelaxIc(pihm->elem, pihm->river);
-    }
-    else if (pihm->ctrl.init_type == RST_FILE)
-    {
-        /* Hot start (using .ic file) */
-        ReadIc(pihm->filename.ic, pihm->elem, pihm->river);
-    }
-
-    /* Initialize state variables */
-    InitVar(pihm->elem, pihm->river, CV_Y);
-
-#if defined(_CYCLES_)
-# if TEMP_DISABLED
-    /* Initialize Cycles module */
-    if (pihm->ctrl.read_cycles_restart)
-    {
-        ReadCyclesIC(pihm->filename.cyclesic, pihm->elem, pihm->river);
-    }
-# endif
-    FirstDay(&pihm->soiltbl, pihm->elem, pihm->river);
-
-    InitCyclesVar(pihm->elem, pihm->river, CV_Y);
-#endif
-
-#if defined(_BGC_)
-    /* Initialize CN variables */
-    if (pihm->ctrl.read_bgc_restart)
-    {
-        ReadBgcIc(pihm->filename.bgcic, pihm->elem, pihm->river);
-    }
-    else
-    {
-        FirstDay(pihm->elem, pihm->river, &pihm->cninit);
-    }
-
-    InitBgcVar(pihm->elem, pihm->river, CV_Y);
-#endif
-
-    /* Calculate model time steps */
-    CalcModelStep(&pihm->ctrl);
-
-#if defined(_DAILY_)
-    InitDailyStruct(pihm->elem);
-#endif
 }
 
 void CorrElev(elem_struct *elem, river_struct *river)
@@ -1,57 +1,23 @@
 #include "pihm.h"
 
-void LateralFlow(elem_struct *elem, const river_struct *river, int surf_mode)
+void LateralFlow(hydro_elem_struct *elem, const hydro_river_struct *river,
+    int surf_mode)
 {
     int             i;
-    double         *dhbydx;
-    double         *dhbydy;
 
-    dhbydx = (double *)malloc(nelem * sizeof(double));
-    dhbydy = (double *)malloc(nelem * sizeof(double));
-
-    FrictSlope(elem, river, surf_mode, dhbydx, dhbydy);
+    FrictSlope(elem, river, surf_mode, elem->dhbydx, elem->dhbydy);
 
+    /*
+     * Fluxes across element faces. Each face writes to the edges of the two
+     * elements sharing it, which are not shared with other faces
+     */
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
-    for (i = 0; i < nelem; i++)
+    for (i = 0; i < elem->nface; i++)
     {
-        int             j;
-        double          avg_sf;
-        elem_struct    *nabr;
-
-        for (j = 0; j < NUM_EDGE; j++)
-        {
-            if (elem[i].nabr[j] > 0)
-            {
-                nabr = &elem[elem[i].nabr[j] - 1];
-
-                /* Subsurface flow between triangular elements */
-                elem[i].wf.subsurf[j] = SubFlowElemToElem(&elem[i], nabr, j);
-
-                /* Surface flux between triangular elements */
-                avg_sf = 0.5 *
-                    (sqrt(dhbydx[i] * dhbydx[i] + dhbydy[i] * dhbydy[i]) +
-                     sqrt(dhbydx[nabr->ind - 1] * dhbydx[nabr->ind - 1] +
-                     dhbydy[nabr->ind - 1] * dhbydy[nabr->ind - 1]));
-                elem[i].wf.ovlflow[j] =
-                    OvlFlowElemToElem(&elem[i], nabr, j, avg_sf, surf_mode);
-            }
-            else if (elem[i].nabr[j] < 0)
-            {
-                /* Do nothing. River-element interactions are calculated
-                 * in river_flow.c */
-            }
-            else    /* Boundary condition flux */
-            {
-                BoundFluxElem(elem[i].attrib.bc_type[j], j, &elem[i].bc,
-                    &elem[i].ws, &elem[i].topo, &elem[i].soil, &elem[i].wf);
-            }
-        }    /* End of neighbor loop */
-    }    /* End of element loop */
-
-    free(dhbydx);
-    free(dhbydy);
+        LateralFlowFace(elem, i, surf_mode);
+    }
 
 #if defined(_FBR_)
     /*
@@ -62,61 +28,156 @@ void LateralFlow(elem_struct *elem, const river_struct *river, int surf_mode)
 #endif
     for (i = 0; i < nelem; i++)
     {
-        int             j, k;
-        elem_struct    *nabr;
-        double          dist = 0.0;
+        FbrLateralFlowElem(elem, i);
+    }
+#endif
+}
 
-        for (j = 0; j < NUM_EDGE; j++)
-        {
-            if (elem[i].nabr[j] == 0)
-            {
-                elem[i].wf.fbrflow[j] =
-                    FbrBoundFluxElem(elem[i].attrib.fbrbc_type[j], j,
-                        &elem[i].fbr_bc, &elem[i].ws, &elem[i].topo,
-                        &elem[i].geol);
-            }
-            else
-            {
-                if (elem[i].nabr[j] > 0)
-                {
-                    nabr = &elem[elem[i].nabr[j] - 1];
-                    dist = elem[i].topo.nabrdist[j];
-                }
-                else
-                {
-                    nabr =
-                        (river[-elem[i].nabr[j] - 1].leftele == elem[i].ind) ?
-                        &elem[river[-elem[i].nabr[j] - 1].rightele - 1] :
-                        &elem[river[-elem[i].nabr[j] - 1].leftele - 1];
-                    for (k = 0; k < NUM_EDGE; k++)
-                    {
-                        if (nabr->nabr[k] == elem[i].nabr[j])
-                        {
-                            dist = elem[i].topo.nabrdist[j] +
-                                nabr->topo.nabrdist[k];
-                            break;
-                        }
-                    }
-                }
+void LateralFlowFace(hydro_elem_struct *elem, int k, int surf_mode)
+{
+    int             i;
+    int             j;
+    int             nabr;
+    int             jn;
+    double          avg_sf;
+    const double   *dhbydx;
+    const double   *dhbydy;
 
-                if (dist == 0.0)
-                {
-                    PIHMprintf(VL_ERROR,
-                        "Error finding distance between elements.\n");
-                    PIHMexit(EXIT_FAILURE);
-                }
+    i = elem->face_elem[k][0];
+    j = elem->face_edge[k][0];
 
-                /* Groundwater flow modeled by Darcy's Law */
-                elem[i].wf.fbrflow[j] = FbrFlowElemToElem(&elem[i], nabr,
-                    dist, elem[i].topo.edge[j]);
-            }
+    if (elem->face_elem[k][1] < 0)  /* Boundary condition flux */
+    {
+        BoundFluxElem(elem, i, j);
+        return;
+    }
+
+    nabr = elem->face_elem[k][1];
+    jn = elem->face_edge[k][1];
+
+    dhbydx = elem->dhbydx;
+    dhbydy = elem->dhbydy;
+
+    /* Subsurface flow between triangular elements */
+    elem->subsurf[i][j] = SubFlowElemToElem(elem, i, nabr, j);
+    elem->subsurf[nabr][jn] = -elem->subsurf[i][j];
+
+    /* Surface flux between triangular elements */
+    avg_sf = 0.5 *
+        (sqrt(dhbydx[i] * dhbydx[i] + dhbydy[i] * dhbydy[i]) +
+         sqrt(dhbydx[nabr] * dhbydx[nabr] + dhbydy[nabr] * dhbydy[nabr]));
+    elem->ovlflow[i][j] =
+        OvlFlowElemToElem(elem, i, nabr, j, avg_sf, surf_mode);
+
+    if (surf_mode == KINEMATIC)
+    {
+        /* Kinematic wave overland flow is not antisymmetric because the
+         * friction slope is bounded below */
+        elem->ovlflow[nabr][jn] =
+            OvlFlowElemToElem(elem, nabr, i, jn, avg_sf, surf_mode);
+    }
+    else
+    {
+        elem->ovlflow[nabr][jn] = -elem->ovlflow[i][j];
+    }
+}
+
+void SurfFlowFace(hydro_elem_struct *elem, int k, int surf_mode)
+{
+    /*
+     * Same as LateralFlowFace, but only surface flux is calculated
+     */
+    int             i;
+    int             j;
+    int             nabr;
+    int             jn;
+    double          avg_sf;
+    const double   *dhbydx;
+    const double   *dhbydy;
+
+    i = elem->face_elem[k][0];
+    j = elem->face_edge[k][0];
+
+    if (elem->face_elem[k][1] < 0)
+    {
+        /* No surface flux is allowed across model boundaries */
+        elem->ovlflow[i][j] = 0.0;
+        return;
+    }
+
+    nabr = elem->face_elem[k][1];
+    jn = elem->face_edge[k][1];
+
+    dhbydx = elem->dhbydx;
+    dhbydy = elem->dhbydy;
+
+    avg_sf = 0.5 *
+        (sqrt(dhbydx[i] * dhbydx[i] + dhbydy[i] * dhbydy[i]) +
+         sqrt(dhbydx[nabr] * dhbydx[nabr] + dhbydy[nabr] * dhbydy[nabr]));
+    elem->ovlflow[i][j] =
+        OvlFlowElemToElem(elem, i, nabr, j, avg_sf, surf_mode);
+
+    if (surf_mode == KINEMATIC)
+    {
+        elem->ovlflow[nabr][jn] =
+            OvlFlowElemToElem(elem, nabr, i, jn, avg_sf, surf_mode);
+    }
+    else
+    {
+        elem->ovlflow[nabr][jn] = -elem->ovlflow[i][j];
+    }
+}
+
+void SubFlowFace(hydro_elem_struct *elem, int k)
+{
+    /*
+     * Same as LateralFlowFace, but only subsurface flux is calculated
+     */
+    int             i;
+    int             j;
+    int             nabr;
+
+    i = elem->face_elem[k][0];
+    j = elem->face_edge[k][0];
+
+    if (elem->face_elem[k][1] < 0)
+    {
+        BoundFluxElem(elem, i, j);
+        return;
+    }
+
+    nabr = elem->face_elem[k][1];
+
+    elem->subsurf[i][j] = SubFlowElemToElem(elem, i, nabr, j);
+    elem->subsurf[nabr][elem->face_edge[k][1]] = -elem->subsurf[i][j];
+}
+
+#if defined(_FBR_)
+void FbrLateralFlowElem(hydro_elem_struct *elem, int i)
+{
+    int             j;
+
+    for (j = 0; j < NUM_EDGE; j++)
+    {
+        if (elem->fbr_nabr[i][j] == 0)
+        {
+            elem->fbrflow[i][j] = FbrBoundFluxElem(elem, i, j);
+        }
+        else
+        {
+            /* Groundwater flow modeled by Darcy's Law. Neighbors across
+             * river segments are found in InitHydro */
+            elem->fbrflow[i][j] = FbrFlowElemToElem(elem, i,
+                elem->fbr_nabr[i][j] - 1, elem->fbr_dist[i][j],
+                elem->edge[i][j]);
         }
     }
-#endif
 }
+#endif
 
-void FrictSlope(const elem_struct *elem, const river_struct *river,
-    int surf_mode, double *dhbydx, double *dhbydy)
+void FrictSlope(const hydro_elem_struct *elem,
+    const hydro_river_struct *river, int surf_mode, double *dhbydx,
+    double *dhbydy)
 {
     int             i;
 #if defined(_OPENMP)
@@ -125,49 +186,46 @@ void FrictSlope(const elem_struct *elem, const river_struct *river,
     for (i = 0; i < nelem; i++)
     {
         int             j;
+        int             nabr;
         double          surfh[NUM_EDGE];
-        const elem_struct *nabr;
-        const river_struct *rivnabr;
 
         if (surf_mode == DIFF_WAVE)
         {
             for (j = 0; j < NUM_EDGE; j++)
             {
-                if (elem[i].nabr[j] > 0)
+                if (elem->nabr[i][j] > 0)
                 {
-                    nabr = &elem[elem[i].nabr[j] - 1];
-                    surfh[j] = nabr->topo.zmax + nabr->ws.surfh;
+                    nabr = elem->nabr[i][j] - 1;
+                    surfh[j] = elem->zmax[nabr] + elem->surfh[nabr];
                 }
-                else if (elem[i].nabr[j] < 0)
+                else if (elem->nabr[i][j] < 0)
                 {
-                    rivnabr = &river[-elem[i].nabr[j] - 1];
+                    nabr = -elem->nabr[i][j] - 1;
 
-                    if (rivnabr->ws.stage > rivnabr->shp.depth)
+                    if (river->stage[nabr] > river->depth[nabr])
                     {
-                        surfh[j] = rivnabr->topo.zbed + rivnabr->ws.stage;
+                        surfh[j] = river->zbed[nabr] + river->stage[nabr];
                     }
                     else
                     {
-                        surfh[j] = rivnabr->topo.zmax;
+                        surfh[j] = river->zmax[nabr];
                     }
                 }
                 else
                 {
-                    if (elem[i].attrib.bc_type[j] == NO_FLOW)
+                    if (elem->bc_type[i][j] == NO_FLOW)
                     {
-                        surfh[j] = elem[i].topo.zmax + elem[i].ws.surfh;
+                        surfh[j] = elem->zmax[i] + elem->surfh[i];
                     }
                     else
                     {
-                        surfh[j] = elem[i].bc.head[j];
+                        surfh[j] = elem->bc[i].head[j];
                     }
                 }
             }
 
-            dhbydx[i] =
-                DhByDl(elem[i].topo.nabr_y, elem[i].topo.nabr_x, surfh);
-            dhbydy[i] =
-                DhByDl(elem[i].topo.nabr_x, elem[i].topo.nabr_y, surfh);
+            dhbydx[i] = DhByDl(elem->nabr_y[i], elem->nabr_x[i], surfh);
+            dhbydy[i] = DhByDl(elem->nabr_x[i], elem->nabr_y[i], surfh);
         }
     }
 }
@@ -233,34 +291,36 @@ double DhByDl(const double *l1, const double *l2, const double *surfh)
         l2[0] * (l1[2] - l1[1]));
 }
 
-double EffKh(const soil_struct *soil, double gw)
+double EffKh(const hydro_elem_struct *elem, int i)
 {
+    double          gw;
     double          k1, k2;
     double          d1, d2;
 
-    gw = (gw > 0.0) ? gw : 0.0;
+    gw = (elem->gw[i] > 0.0) ? elem->gw[i] : 0.0;
 
-    if (gw > soil->depth - soil->dmac)
+    if (gw > elem->depth[i] - elem->dmac[i])
     {
-        k1 = soil->kmach * soil->areafv + soil->ksath * (1.0 - soil->areafv);
-        k2 = soil->ksath;
+        k1 = elem->kmach[i] * elem->areafv[i] +
+            elem->ksath[i] * (1.0 - elem->areafv[i]);
+        k2 = elem->ksath[i];
 
-        if (gw > soil->depth)
+        if (gw > elem->depth[i])
         {
-            d1 = soil->dmac;
-            d2 = soil->depth - soil->dmac;
+            d1 = elem->dmac[i];
+            d2 = elem->depth[i] - elem->dmac[i];
         }
         else
         {
-            d1 = gw - (soil->depth - soil->dmac);
-            d2 = soil->depth - soil->dmac;
+            d1 = gw - (elem->depth[i] - elem->dmac[i]);
+            d2 = elem->depth[i] - elem->dmac[i];
         }
 
         return (k1 * d1 + k2 * d2) / (d1 + d2);
     }
     else
     {
-        return soil->ksath;
+        return elem->ksath[i];
     }
 }
 
@@ -270,7 +330,7 @@ double OverLandFlow(double avg_h, double grad_h, double avg_sf, double crossa,
     return crossa * pow(avg_h, 0.6666667) * grad_h / (sqrt(avg_sf) * avg_rough);
 }
 
-double SubFlowElemToElem(const elem_struct *elem, const elem_struct *nabr,
+double SubFlowElemToElem(const hydro_elem_struct *elem, int i, int nabr,
     int j)
 {
     double          diff_h;
@@ -283,20 +343,21 @@ double SubFlowElemToElem(const elem_struct *elem, const elem_struct *nabr,
      * Subsurface lateral flux calculation between triangular
      * elements
      */
-    diff_h = (elem->ws.gw + elem->topo.zmin) - (nabr->ws.gw + nabr->topo.zmin);
-    avg_h = AvgH(diff_h, elem->ws.gw, nabr->ws.gw);
-    grad_h = diff_h / elem->topo.nabrdist[j];
+    diff_h = (elem->gw[i] + elem->zmin[i]) -
+        (elem->gw[nabr] + elem->zmin[nabr]);
+    avg_h = AvgH(diff_h, elem->gw[i], elem->gw[nabr]);
+    grad_h = diff_h / elem->nabrdist[i][j];
 
     /* Take into account macropore effect */
-    effk = EffKh(&elem->soil, elem->ws.gw);
-    effk_nabr = EffKh(&nabr->soil, nabr->ws.gw);
+    effk = EffKh(elem, i);
+    effk_nabr = EffKh(elem, nabr);
     avg_ksat = 0.5 * (effk + effk_nabr);
 
     /* Groundwater flow modeled by Darcy's Law */
-    return avg_ksat * grad_h * avg_h * elem->topo.edge[j];
+    return avg_ksat * grad_h * avg_h * elem->edge[i][j];
 }
 
-double OvlFlowElemToElem(const elem_struct *elem, const elem_struct *nabr,
+double OvlFlowElemToElem(const hydro_elem_struct *elem, int i, int nabr,
     int j, double avg_sf, int surf_mode)
 {
     double          diff_h;
@@ -306,10 +367,11 @@ double OvlFlowElemToElem(const elem_struct *elem, const elem_struct *nabr,
     double          crossa;
 
     diff_h = (surf_mode == KINEMATIC) ?
-        elem->topo.zmax - nabr->topo.zmax :
-        (elem->ws.surfh + elem->topo.zmax) - (nabr->ws.surfh + nabr->topo.zmax);
-    avg_h = AvgHsurf(diff_h, elem->ws.surfh, nabr->ws.surfh);
-    grad_h = diff_h / elem->topo.nabrdist[j];
+        elem->zmax[i] - elem->zmax[nabr] :
+        (elem->surfh[i] + elem->zmax[i]) -
+        (elem->surfh[nabr] + elem->zmax[nabr]);
+    avg_h = AvgHsurf(diff_h, elem->surfh[i], elem->surfh[nabr]);
+    grad_h = diff_h / elem->nabrdist[i][j];
     if (surf_mode == KINEMATIC)
     {
         avg_sf = (grad_h > 0.0) ? grad_h : GRADMIN;
@@ -319,15 +381,13 @@ double OvlFlowElemToElem(const elem_struct *elem, const elem_struct *nabr,
         avg_sf = (avg_sf > GRADMIN) ? avg_sf : GRADMIN;
     }
     /* Weighting needed */
-    avg_rough = 0.5 * (elem->lc.rough + nabr->lc.rough);
-    crossa = avg_h * elem->topo.edge[j];
+    avg_rough = 0.5 * (elem->rough[i] + elem->rough[nabr]);
+    crossa = avg_h * elem->edge[i][j];
 
     return OverLandFlow(avg_h, grad_h, avg_sf, crossa, avg_rough);
 }
 
-void BoundFluxElem(int bc_type, int j, const bc_struct *bc,
-    const wstate_struct *ws, const topo_struct *topo, const soil_struct *soil,
-    wflux_struct *wf)
+void BoundFluxElem(hydro_elem_struct *elem, int i, int j)
 {
     double          diff_h;
     double          avg_h;
@@ -336,41 +396,41 @@ void BoundFluxElem(int bc_type, int j, const bc_struct *bc,
     double          grad_h;
 
     /* No flow (natural) boundary condition is default */
-    if (bc_type == NO_FLOW)
+    if (elem->bc_type[i][j] == NO_FLOW)
     {
-        wf->ovlflow[j] = 0.0;
-        wf->subsurf[j] = 0.0;
+        elem->ovlflow[i][j] = 0.0;
+        elem->subsurf[i][j] = 0.0;
     }
     /* Note: ideally different boundary conditions need to be
      * incorporated for surf and subsurf respectively */
-    else if (bc_type > 0)
+    else if (elem->bc_type[i][j] > 0)
     {
         /* Note: the formulation assumes only Dirichlet TS right now */
         /* note the assumption here is no flow for surface */
-        wf->ovlflow[j] = 0.0;
+        elem->ovlflow[i][j] = 0.0;
 
-        diff_h = ws->gw + topo->zmin - bc->head[j];
-        avg_h = AvgH(diff_h, ws->gw, bc->head[j] - topo->zmin);
+        diff_h = elem->gw[i] + elem->zmin[i] - elem->bc[i].head[j];
+        avg_h = AvgH(diff_h, elem->gw[i], elem->bc[i].head[j] - elem->zmin[i]);
         /* Minimum distance from circumcenter to the edge of the triangle
          * on which boundary condition is defined */
-        effk = EffKh(soil, ws->gw);
+        effk = EffKh(elem, i);
         avg_ksat = effk;
-        grad_h = diff_h / topo->nabrdist[j];
-        wf->subsurf[j] = avg_ksat * grad_h * avg_h * topo->edge[j];
+        grad_h = diff_h / elem->nabrdist[i][j];
+        elem->subsurf[i][j] = avg_ksat * grad_h * avg_h * elem->edge[i][j];
     }
     else
     {
         /* Neumann bc (note: md->ele[i].bc[j] value has to be
          * = 2+(index of Neumann boundary ts) */
-        wf->ovlflow[j] = 0.0;
+        elem->ovlflow[i][j] = 0.0;
         /* Negative sign is added so the positive numbers in forcing time series
          * represents source */
-        wf->subsurf[j] = -bc->flux[j];
+        elem->subsurf[i][j] = -elem->bc[i].flux[j];
     }
 }
 
 #if defined(_FBR_)
-double FbrFlowElemToElem(const elem_struct *elem, const elem_struct *nabr,
+double FbrFlowElemToElem(const hydro_elem_struct *elem, int i, int nabr,
     double dist, double edge)
 {
     double          diff_h;
@@ -378,18 +438,17 @@ double FbrFlowElemToElem(const elem_struct *elem, const elem_struct *nabr,
     double          grad_h;
     double          avg_ksat;
 
-    diff_h = (elem->ws.fbr_gw + elem->topo.zbed) -
-        (nabr->ws.fbr_gw + nabr->topo.zbed);
-    avg_h = AvgH(diff_h, elem->ws.fbr_gw, nabr->ws.fbr_gw);
+    diff_h = (elem->fbr_gw[i] + elem->zbed[i]) -
+        (elem->fbr_gw[nabr] + elem->zbed[nabr]);
+    avg_h = AvgH(diff_h, elem->fbr_gw[i], elem->fbr_gw[nabr]);
     grad_h = diff_h / dist;
 
-    avg_ksat = 0.5 * (elem->geol.ksath + nabr->geol.ksath);
+    avg_ksat = 0.5 * (elem->geol_ksath[i] + elem->geol_ksath[nabr]);
 
     return avg_ksat * grad_h * avg_h * edge;
 }
 
-double FbrBoundFluxElem(int bc_type, int j, const bc_struct *bc,
-    const wstate_struct *ws, const topo_struct *topo, const geol_struct *geol)
+double FbrBoundFluxElem(const hydro_elem_struct *elem, int i, int j)
 {
     double          diff_h;
     double          avg_h;
@@ -398,25 +457,26 @@ double FbrBoundFluxElem(int bc_type, int j, const bc_struct *bc,
     double          flux;
 
     /* No flow (natural) boundary condition is default */
-    if (bc_type == NO_FLOW)
+    if (elem->fbrbc_type[i][j] == NO_FLOW)
     {
         flux = 0.0;
     }
-    else if (bc_type > 0)
+    else if (elem->fbrbc_type[i][j] > 0)
     {
         /* Dirichlet boundary conditions */
-        diff_h = ws->fbr_gw + topo->zbed - bc->head[j];
-        avg_h = AvgH(diff_h, ws->fbr_gw, bc->head[j] - topo->zbed);
+        diff_h = elem->fbr_gw[i] + elem->zbed[i] - elem->fbr_bc[i].head[j];
+        avg_h = AvgH(diff_h, elem->fbr_gw[i],
+            elem->fbr_bc[i].head[j] - elem->zbed[i]);
         /* Minimum distance from circumcenter to the edge of the triangle
          * on which boundary condition is defined */
-        effk = geol->ksath;
-        grad_h = diff_h / topo->nabrdist[j];
-        flux = effk * grad_h * avg_h * topo->edge[j];
+        effk = elem->geol_ksath[i];
+        grad_h = diff_h / elem->nabrdist[i][j];
+        flux = effk * grad_h * avg_h * elem->edge[i][j];
     }
     else
     {
         /* Neumann boundary conditions */
-        flux = -bc->flux[j];
+        flux = -elem->fbr_bc[i].flux[j];
     }
 
     return flux;
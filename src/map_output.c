@@ -30,7 +30,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ws.surf;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ws.surf;
                     }
                     n++;
                     break;
@@ -39,7 +40,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ws.unsat;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ws.unsat;
                     }
                     n++;
                     break;
@@ -48,7 +50,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ws.gw;
+                        print->varctrl[n].var[elem[j].ind - 1] = &elem[j].ws.gw;
                     }
                     n++;
                     break;
@@ -57,7 +59,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].ws.stage;
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].ws.stage;
                     }
                     n++;
                     break;
@@ -66,7 +69,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].ws.gw;
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].ws.gw;
                     }
                     n++;
                     break;
@@ -75,7 +79,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ws.sneqv;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ws.sneqv;
                     }
                     n++;
                     break;
@@ -84,7 +89,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ws.cmc;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ws.cmc;
                     }
                     n++;
                     break;
@@ -93,7 +99,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].wf.infil;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].wf.infil;
                     }
                     n++;
                     break;
@@ -102,7 +109,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].wf.rechg;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].wf.rechg;
                     }
                     n++;
                     break;
@@ -111,7 +119,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].wf.ec;
+                        print->varctrl[n].var[elem[j].ind - 1] = &elem[j].wf.ec;
                     }
                     n++;
                     break;
@@ -120,7 +128,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].wf.ett;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].wf.ett;
                     }
                     n++;
                     break;
@@ -129,7 +138,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].wf.edir;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].wf.edir;
                     }
                     n++;
                     break;
@@ -138,7 +148,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].wf.rivflow[0];
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].wf.rivflow[0];
                     }
                     n++;
                     break;
@@ -147,7 +158,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].wf.rivflow[1];
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].wf.rivflow[1];
                     }
                     n++;
                     break;
@@ -156,7 +168,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].wf.rivflow[2];
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].wf.rivflow[2];
                     }
                     n++;
                     break;
@@ -165,7 +178,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].wf.rivflow[3];
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].wf.rivflow[3];
                     }
                     n++;
                     break;
@@ -174,7 +188,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].wf.rivflow[4];
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].wf.rivflow[4];
                     }
                     n++;
                     break;
@@ -183,7 +198,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].wf.rivflow[5];
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].wf.rivflow[5];
                     }
                     n++;
                     break;
@@ -192,7 +208,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].wf.rivflow[6];
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].wf.rivflow[6];
                     }
                     n++;
                     break;
@@ -201,7 +218,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].wf.rivflow[7];
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].wf.rivflow[7];
                     }
                     n++;
                     break;
@@ -210,7 +228,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].wf.rivflow[8];
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].wf.rivflow[8];
                     }
                     n++;
                     break;
@@ -219,7 +238,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].wf.rivflow[9];
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].wf.rivflow[9];
                     }
                     n++;
                     break;
@@ -228,7 +248,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].wf.rivflow[10];
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].wf.rivflow[10];
                     }
                     n++;
                     break;
@@ -240,7 +261,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             HYDROL_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] = &elem[j].wf.subsurf[k];
+                            print->varctrl[n].var[elem[j].ind - 1] =
+                                &elem[j].wf.subsurf[k];
                         }
                         n++;
                     }
@@ -253,7 +275,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             HYDROL_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] = &elem[j].wf.ovlflow[k];
+                            print->varctrl[n].var[elem[j].ind - 1] =
+                                &elem[j].wf.ovlflow[k];
                         }
                         n++;
                     }
@@ -264,7 +287,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].es.t1;
+                        print->varctrl[n].var[elem[j].ind - 1] = &elem[j].es.t1;
                     }
                     n++;
                     break;
@@ -276,7 +299,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             LS_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] = &elem[j].es.stc[k];
+                            print->varctrl[n].var[elem[j].ind - 1] =
+                                &elem[j].es.stc[k];
                         }
                         n++;
                     }
@@ -289,7 +313,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             HYDROL_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] = &elem[j].ws.smc[k];
+                            print->varctrl[n].var[elem[j].ind - 1] =
+                                &elem[j].ws.smc[k];
                         }
                         n++;
                     }
@@ -302,7 +327,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             HYDROL_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] = &elem[j].ws.sh2o[k];
+                            print->varctrl[n].var[elem[j].ind - 1] =
+                                &elem[j].ws.sh2o[k];
                         }
                         n++;
                     }
@@ -312,7 +338,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ps.snowh;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ps.snowh;
                     }
                     n++;
                     break;
@@ -321,7 +348,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ps.albedo;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ps.albedo;
                     }
                     n++;
                     break;
@@ -330,7 +358,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ef.eta;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ef.eta;
                     }
                     n++;
                     break;
@@ -339,7 +368,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ef.sheat;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ef.sheat;
                     }
                     n++;
                     break;
@@ -348,7 +378,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ef.ssoil;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ef.ssoil;
                     }
                     n++;
                     break;
@@ -357,7 +388,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ef.etp;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ef.etp;
                     }
                     n++;
                     break;
@@ -366,7 +398,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ef.esnow;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ef.esnow;
                     }
                     n++;
                     break;
@@ -375,7 +408,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ps.soilw;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ps.soilw;
                     }
                     n++;
                     break;
@@ -384,7 +418,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ws.soilm;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ws.soilm;
                     }
                     n++;
                     break;
@@ -393,7 +428,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ef.soldn;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ef.soldn;
                     }
                     n++;
                     break;
@@ -402,7 +438,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ps.ch;
+                        print->varctrl[n].var[elem[j].ind - 1] = &elem[j].ps.ch;
                     }
                     n++;
                     break;
@@ -512,7 +548,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ps.proj_lai;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ps.proj_lai;
                     }
                     n++;
                     break;
@@ -521,7 +558,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.daily_npp;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.daily_npp;
                     }
                     n++;
                     break;
@@ -530,7 +568,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.daily_nep;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.daily_nep;
                     }
                     n++;
                     break;
@@ -539,7 +578,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.daily_nee;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.daily_nee;
                     }
                     n++;
                     break;
@@ -548,7 +588,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.daily_gpp;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.daily_gpp;
                     }
                     n++;
                     break;
@@ -557,7 +598,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.daily_mr;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.daily_mr;
                     }
                     n++;
                     break;
@@ -566,7 +608,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.daily_gr;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.daily_gr;
                     }
                     n++;
                     break;
@@ -575,7 +618,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.daily_hr;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.daily_hr;
                     }
                     n++;
                     break;
@@ -584,7 +628,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.daily_fire;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.daily_fire;
                     }
                     n++;
                     break;
@@ -593,7 +638,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] =
+                        print->varctrl[n].var[elem[j].ind - 1] =
                             &elem[j].summary.daily_litfallc;
                     }
                     n++;
@@ -603,7 +648,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.vegc;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.vegc;
                     }
                     n++;
                     break;
@@ -612,7 +658,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.agc;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.agc;
                     }
                     n++;
                     break;
@@ -621,7 +668,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.litrc;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.litrc;
                     }
                     n++;
                     break;
@@ -630,7 +678,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.soilc;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.soilc;
                     }
                     n++;
                     break;
@@ -639,7 +688,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].summary.totalc;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].summary.totalc;
                     }
                     n++;
                     break;
@@ -648,7 +698,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ns.sminn;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ns.sminn;
                     }
                     n++;
                     break;
@@ -663,7 +714,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             CN_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] =
+                            print->varctrl[n].var[elem[j].ind - 1] =
                                 &elem[j].crop[k].ccs.shoot;
                         }
                         n++;
@@ -673,7 +724,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             CN_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] =
+                            print->varctrl[n].var[elem[j].ind - 1] =
                                 &elem[j].crop[k].ccs.root;
                         }
                         n++;
@@ -687,7 +738,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             CN_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] =
+                            print->varctrl[n].var[elem[j].ind - 1] =
                                 &elem[j].crop[k].epv.rad_intcp;
                         }
                         n++;
@@ -701,7 +752,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             CN_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] =
+                            print->varctrl[n].var[elem[j].ind - 1] =
                                 &elem[j].crop[k].epv.h2o_stress;
                         }
                         n++;
@@ -715,7 +766,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             CN_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] =
+                            print->varctrl[n].var[elem[j].ind - 1] =
                                 &elem[j].crop[k].epv.n_stress;
                         }
                         n++;
@@ -729,7 +780,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             LS_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] =
+                            print->varctrl[n].var[elem[j].ind - 1] =
                                 &elem[j].crop[k].cwf.transp;
                         }
                         n++;
@@ -743,7 +794,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             LS_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] =
+                            print->varctrl[n].var[elem[j].ind - 1] =
                                 &elem[j].crop[k].cwf.transp_pot;
                         }
                         n++;
@@ -754,7 +805,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         LS_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].wf.eres;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].wf.eres;
                     }
                     n++;
                     break;
@@ -763,7 +815,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].np.no3;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].np.no3;
                     }
                     n++;
                     break;
@@ -772,7 +825,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].ns.streamno3;
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].ns.streamno3;
                     }
                     n++;
                     break;
@@ -781,7 +835,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].np.nh4;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].np.nh4;
                     }
                     n++;
                     break;
@@ -790,7 +845,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] = &river[j].ns.streamnh4;
+                        print->varctrl[n].var[river[j].ind - 1] =
+                            &river[j].ns.streamnh4;
                     }
                     n++;
                     break;
@@ -800,7 +856,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] =
+                        print->varctrl[n].var[elem[j].ind - 1] =
                             &elem[j].nf.no3denitrif;
                     }
                     n++;
@@ -813,7 +869,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             HYDROL_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] =
+                            print->varctrl[n].var[elem[j].ind - 1] =
                                 &elem[j].no3sol.flux[k];
                         }
                         n++;
@@ -827,7 +883,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             HYDROL_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] =
+                            print->varctrl[n].var[elem[j].ind - 1] =
                                 &elem[j].nh4sol.flux[k];
                         }
                         n++;
@@ -838,7 +894,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] =
+                        print->varctrl[n].var[river[j].ind - 1] =
                             &river[j].no3sol.flux[DOWN_CHANL2CHANL];
                     }
                     n++;
@@ -848,7 +904,7 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nriver, &print->varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->varctrl[n].var[j] =
+                        print->varctrl[n].var[river[j].ind - 1] =
                             &river[j].nh4sol.flux[DOWN_CHANL2CHANL];
                     }
                     n++;
@@ -858,7 +914,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         CN_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ps.proj_lai;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ps.proj_lai;
                     }
                     n++;
                     break;
@@ -869,7 +926,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ws.fbr_unsat;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ws.fbr_unsat;
                     }
                     n++;
                     break;
@@ -878,7 +936,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].ws.fbr_gw;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].ws.fbr_gw;
                     }
                     n++;
                     break;
@@ -887,7 +946,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].wf.fbr_infil;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].wf.fbr_infil;
                     }
                     n++;
                     break;
@@ -896,7 +956,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         HYDROL_STEP, nelem, &print->varctrl[n]);
                     for (j = 0; j < nelem; j++)
                     {
-                        print->varctrl[n].var[j] = &elem[j].wf.fbr_rechg;
+                        print->varctrl[n].var[elem[j].ind - 1] =
+                            &elem[j].wf.fbr_rechg;
                     }
                     n++;
                     break;
@@ -908,7 +969,8 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                             HYDROL_STEP, nelem, &print->varctrl[n]);
                         for (j = 0; j < nelem; j++)
                         {
-                            print->varctrl[n].var[j] = &elem[j].wf.fbrflow[k];
+                            print->varctrl[n].var[elem[j].ind - 1] =
+                                &elem[j].wf.fbrflow[k];
                         }
                         n++;
                     }
@@ -1009,14 +1071,14 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         &print->tp_varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->tp_varctrl[n].var[j] =
-                            &river[j].ws.stage;
-                        print->tp_varctrl[n].x[j] = river[j].topo.x;
-                        print->tp_varctrl[n].y[j] = river[j].topo.y;
-                        print->tp_varctrl[n].zmax[j] =
-                            river[j].topo.zmax;
-                        print->tp_varctrl[n].zmin[j] =
-                            river[j].topo.zmin;
+                        int             ind;
+
+                        ind = river[j].ind - 1;
+                        print->tp_varctrl[n].var[ind] = &river[j].ws.stage;
+                        print->tp_varctrl[n].x[ind] = river[j].topo.x;
+                        print->tp_varctrl[n].y[ind] = river[j].topo.y;
+                        print->tp_varctrl[n].zmax[ind] = river[j].topo.zmax;
+                        print->tp_varctrl[n].zmin[ind] = river[j].topo.zmin;
                     }
                     n++;
                     break;
@@ -1026,11 +1088,14 @@ void MapOutput(const int *prtvrbl, const int *tpprtvrbl,
                         &print->tp_varctrl[n]);
                     for (j = 0; j < nriver; j++)
                     {
-                        print->tp_varctrl[n].var[j] = &river[j].ws.gw;
-                        print->tp_varctrl[n].x[j] = river[j].topo.x;
-                        print->tp_varctrl[n].y[j] = river[j].topo.y;
-                        print->tp_varctrl[n].zmax[j] = river[j].topo.zmax;
-                        print->tp_varctrl[n].zmin[j] = river[j].topo.zmin;
+                        int             ind;
+
+                        ind = river[j].ind - 1;
+                        print->tp_varctrl[n].var[ind] = &river[j].ws.gw;
+                        print->tp_varctrl[n].x[ind] = river[j].topo.x;
+                        print->tp_varctrl[n].y[ind] = river[j].topo.y;
+                        print->tp_varctrl[n].zmax[ind] = river[j].topo.zmax;
+                        print->tp_varctrl[n].zmin[ind] = river[j].topo.zmin;
                     }
                     n++;
                     break;
@@ -1069,6 +1134,10 @@ void InitPrtVarCtrl(const char *outputdir, const char *ext, int intvl,
     varctrl->var = (const double **)malloc(nvar * sizeof(double *));
     varctrl->buffer = (double *)calloc(nvar, sizeof(double));
     varctrl->counter = 0;
+    varctrl->reduce = NO_REDUCE;
+    varctrl->nsrc = nvar;
+    varctrl->weight = NULL;
+    varctrl->id = NULL;
 }
 
 void InitTecPrtVarCtrl(const char *outputdir, const char *ext, int intvl,
@@ -1094,4 +1163,187 @@ void InitTecPrtVarCtrl(const char *outputdir, const char *ext, int intvl,
     varctrl->var = (const double **)malloc(nvar * sizeof(double *));
     varctrl->buffer = (double *)calloc(nvar, sizeof(double));
     varctrl->counter = 0;
+    varctrl->reduce = NO_REDUCE;
+}
+
+void MapReducer(const reducetbl_struct *reducetbl, const elem_struct *elem,
+    const river_struct *river, const char *outputdir, print_struct *print)
+{
+    /*
+     * Replace full-field outputs of reduced variables with reduced outputs,
+     * which are evaluated when output variables are updated. Outputs of
+     * element variables are weighted by element areas
+     */
+    varctrl_struct *varctrl;
+    double         *area;
+    int            *nused;
+    size_t          prefix;
+    int             i, j, k;
+    int             n = 0;
+    const char     *opstr[] = {"", "mean", "sum", "min", "max", ""};
+
+    PIHMprintf(VL_VERBOSE, "Initializing reduced outputs\n");
+
+    varctrl = (varctrl_struct *)malloc(MAXPRINT * sizeof(varctrl_struct));
+    nused = (int *)calloc(reducetbl->nreducer, sizeof(int));
+
+    /* Element areas in the order of element ids */
+    area = (double *)malloc(nelem * sizeof(double));
+    for (i = 0; i < nelem; i++)
+    {
+        area[elem[i].ind - 1] = elem[i].topo.area;
+    }
+
+    /* Variable names are file names without output directory and project
+     * name */
+    prefix = strlen(outputdir) + strlen(project) + 1;
+
+    for (i = 0; i < print->nprint; i++)
+    {
+        const varctrl_struct *base;
+        const void     *var0;
+        int             location;
+        int             nred = 0;
+
+        base = &print->varctrl[i];
+
+        var0 = (const void *)base->var[0];
+        location = (var0 >= (const void *)river &&
+            var0 < (const void *)(river + nriver)) ? RIVERVAR : ELEMVAR;
+
+        for (k = 0; k < reducetbl->nreducer; k++)
+        {
+            varctrl_struct *red;
+            int             grp;
+            int             nsrc;
+            double          wsum = 0.0;
+
+            if (strcasecmp(reducetbl->var[k], base->name + prefix) != 0)
+            {
+                continue;
+            }
+
+            grp = reducetbl->group[k];
+            if (reducetbl->grptype[grp] != ALLVAR &&
+                reducetbl->grptype[grp] != location)
+            {
+                PIHMprintf(VL_ERROR, "Error: Output group %s does not match "
+                    "the location of output variable %s.\n",
+                    reducetbl->grpname[grp], reducetbl->var[k]);
+                PIHMexit(EXIT_FAILURE);
+            }
+
+            if (n >= MAXPRINT)
+            {
+                PIHMprintf(VL_ERROR, "Error: Too many output files. ");
+                PIHMprintf(VL_ERROR,
+                    "The maximum number of output files is %d.\n", MAXPRINT);
+                PIHMexit(EXIT_FAILURE);
+            }
+
+            red = &varctrl[n];
+            if (reducetbl->op[k] == REDUCE_SELECT)
+            {
+                sprintf(red->name, "%s.%s", base->name,
+                    reducetbl->grpname[grp]);
+            }
+            else
+            {
+                sprintf(red->name, "%s.%s.%s", base->name,
+                    reducetbl->grpname[grp], opstr[reducetbl->op[k]]);
+            }
+            red->intvl = base->intvl;
+            red->intr = location;
+            red->upd_intvl = base->upd_intvl;
+            red->reduce = reducetbl->op[k];
+            red->counter = 0;
+
+            nsrc = (reducetbl->grptype[grp] == ALLVAR) ?
+                base->nvar : reducetbl->nmember[grp];
+            red->nsrc = nsrc;
+            red->var = (const double **)malloc(nsrc * sizeof(double *));
+            red->id = (int *)malloc(nsrc * sizeof(int));
+            red->weight = (double *)malloc(nsrc * sizeof(double));
+
+            for (j = 0; j < nsrc; j++)
+            {
+                int             id;
+
+                id = (reducetbl->grptype[grp] == ALLVAR) ?
+                    j + 1 : reducetbl->member[grp][j];
+                if (id < 1 || id > base->nvar)
+                {
+                    PIHMprintf(VL_ERROR, "Error: Member %d of output group "
+                        "%s does not exist.\n", id, reducetbl->grpname[grp]);
+                    PIHMexit(EXIT_FAILURE);
+                }
+
+                red->var[j] = base->var[id - 1];
+                red->id[j] = id;
+                red->weight[j] =
+                    (location == ELEMVAR && base->nvar == nelem) ?
+                    area[id - 1] : 1.0;
+                wsum += red->weight[j];
+            }
+
+            if (red->reduce == REDUCE_MEAN)
+            {
+                for (j = 0; j < nsrc; j++)
+                {
+                    red->weight[j] /= wsum;
+                }
+            }
+
+            /* Reducers other than SELECT have one output */
+            red->nvar = (red->reduce == REDUCE_SELECT) ? nsrc : 1;
+            red->buffer = (double *)calloc(red->nvar, sizeof(double));
+            if (red->reduce != REDUCE_SELECT)
+            {
+                free(red->id);
+                red->id = NULL;
+            }
+
+            nused[k]++;
+            nred++;
+            n++;
+        }
+
+        if (nred > 0)
+        {
+            /* Full-field output is not written */
+            free(print->varctrl[i].var);
+            free(print->varctrl[i].buffer);
+        }
+        else
+        {
+            if (n >= MAXPRINT)
+            {
+                PIHMprintf(VL_ERROR, "Error: Too many output files. ");
+                PIHMprintf(VL_ERROR,
+                    "The maximum number of output files is %d.\n", MAXPRINT);
+                PIHMexit(EXIT_FAILURE);
+            }
+            varctrl[n] = print->varctrl[i];
+            n++;
+        }
+    }
+
+    for (k = 0; k < reducetbl->nreducer; k++)
+    {
+        if (nused[k] == 0)
+        {
+            PIHMprintf(VL_ERROR, "Error: Output variable %s of output "
+                "reducer is not found.\n", reducetbl->var[k]);
+            PIHMprintf(VL_ERROR, "Reduced variables should be turned on in "
+                "the .para file (or module control files).\n");
+            PIHMexit(EXIT_FAILURE);
+        }
+    }
+
+    memcpy(print->varctrl, varctrl, n * sizeof(varctrl_struct));
+    print->nprint = n;
+
+    free(varctrl);
+    free(nused);
+    free(area);
 }
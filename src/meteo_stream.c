@@ -0,0 +1,384 @@
+#include "pihm.h"
+
+void ReadMeteoStream(const char *filename, int window, forc_struct *forc)
+{
+    /*
+     * Open meteorological forcing file for streaming. Only the positions of
+     * the time series in the file are read here. Records are read into two
+     * buffers of each series when needed: one is used to interpolate forcing
+     * at model time, and the other one is filled ahead by a background
+     * thread
+     */
+    metstream_struct *ms;
+    char            cmdstr[MAXSTRING];
+    int             i;
+    int             match;
+    int             index;
+    int             lno = 0;
+
+    ms = (metstream_struct *)malloc(sizeof(metstream_struct));
+
+    strcpy(ms->filename, filename);
+    ms->file = fopen(filename, "r");
+    CheckFile(ms->file, filename);
+    PIHMprintf(VL_VERBOSE, " Reading %s (%d records in memory)\n", filename,
+        window);
+
+    ms->window = window;
+    ms->init = 0;
+    ms->prcp = 1.0;
+    ms->sfctmp = 0.0;
+
+    FindLine(ms->file, "BOF", &lno, filename);
+
+    forc->nmeteo = CountOccurr(ms->file, "METEO_TS");
+
+    FindLine(ms->file, "BOF", &lno, filename);
+    if (forc->nmeteo > 0)
+    {
+        forc->meteo =
+            (tsdata_struct *)malloc(forc->nmeteo * sizeof(tsdata_struct));
+
+        ms->start = (long int *)malloc(forc->nmeteo * sizeof(long int));
+        ms->pos = (long int *)malloc(forc->nmeteo * sizeof(long int));
+        ms->next_length = (int *)malloc(forc->nmeteo * sizeof(int));
+        ms->next_ftime = (int **)malloc(forc->nmeteo * sizeof(int *));
+        ms->next_data = (double **)malloc(forc->nmeteo * sizeof(double *));
+        ms->rewind = (int *)malloc(forc->nmeteo * sizeof(int));
+        ms->pending = (int *)malloc(forc->nmeteo * sizeof(int));
+
+        NextLine(ms->file, cmdstr, &lno);
+        for (i = 0; i < forc->nmeteo; i++)
+        {
+            match = sscanf(cmdstr, "%*s %d %*s %lf",
+                &index, &forc->meteo[i].zlvl_wind);
+            if (match != 2 || i != index - 1)
+            {
+                PIHMprintf(VL_ERROR,
+                    "Error reading the %dth meteorological forcing"
+                    " time series.\n", i + 1);
+                PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                    filename, lno);
+                PIHMexit(EXIT_FAILURE);
+            }
+            /* Skip header lines */
+            NextLine(ms->file, cmdstr, &lno);
+            NextLine(ms->file, cmdstr, &lno);
+
+            ms->start[i] = ftell(ms->file);
+            ms->pos[i] = ms->start[i];
+            CountLine(ms->file, cmdstr, 1, "METEO_TS");
+
+            /* Allocate buffers */
+            forc->meteo[i].length = 0;
+            forc->meteo[i].cursor = 0;
+            forc->meteo[i].ftime = (int *)malloc(window * sizeof(int));
+            forc->meteo[i].data =
+                (double *)malloc(window * NUM_METEO_VAR * sizeof(double));
+
+            ms->next_length[i] = 0;
+            ms->next_ftime[i] = (int *)malloc(window * sizeof(int));
+            ms->next_data[i] =
+                (double *)malloc(window * NUM_METEO_VAR * sizeof(double));
+
+            ms->rewind[i] = -1;
+            ms->pending[i] = 0;
+        }
+    }
+
+    /* The stream is set after it has been read, so that the reader thread of
+     * a stream is running whenever forc->metstream is set */
+    forc->metstream = ms;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    ms->quit = 0;
+    pthread_mutex_init(&ms->mutex, NULL);
+    pthread_cond_init(&ms->cond, NULL);
+    if (pthread_create(&ms->thread, NULL, MeteoStreamThread, forc) != 0)
+    {
+        forc->metstream = NULL;
+        PIHMprintf(VL_ERROR,
+            "Error creating meteorological forcing reader thread.\n");
+        PIHMexit(EXIT_FAILURE);
+    }
+#endif
+}
+
+void UpdMeteoStream(forc_struct *forc, int t)
+{
+    /*
+     * Make sure the forcing buffer of each series covers model time t
+     */
+    metstream_struct *ms;
+    int             k;
+
+    ms = forc->metstream;
+
+    if (!ms->init)
+    {
+        /* Fill all buffers at model start time */
+        for (k = 0; k < forc->nmeteo; k++)
+        {
+            ms->rewind[k] = t;
+            RequestMeteoBuf(forc, k);
+        }
+        ms->init = 1;
+    }
+
+    for (k = 0; k < forc->nmeteo; k++)
+    {
+        tsdata_struct  *ts;
+
+        ts = &forc->meteo[k];
+
+        if (ts->length > 0 && t < ts->ftime[0])
+        {
+            /* Model time goes back (e.g., in spin-up mode) */
+            WaitMeteoBuf(ms, k);
+            ms->rewind[k] = t;
+            ts->length = 0;
+            ts->cursor = 0;
+            RequestMeteoBuf(forc, k);
+        }
+
+        while (ts->length == 0 || t > ts->ftime[ts->length - 1])
+        {
+            int            *ftime;
+            double         *data;
+            int             length;
+
+            WaitMeteoBuf(ms, k);
+
+            if (ms->next_length[k] <= ((ts->length > 0) ? 1 : 0))
+            {
+                /* End of series. IntrplForc will report the error */
+                break;
+            }
+
+            /* Swap buffers */
+            ftime = ts->ftime;
+            data = ts->data;
+            length = ts->length;
+            ts->ftime = ms->next_ftime[k];
+            ts->data = ms->next_data[k];
+            ts->length = ms->next_length[k];
+            ts->cursor = 0;
+            ms->next_ftime[k] = ftime;
+            ms->next_data[k] = data;
+            ms->next_length[k] = length;
+
+            /* Prefetch the following records */
+            RequestMeteoBuf(forc, k);
+        }
+    }
+}
+
+void FillMeteoBuf(forc_struct *forc, int k)
+{
+    /*
+     * Fill the prefetch buffer of series k. The buffer starts with the last
+     * record of the current buffer so that forcing can be interpolated
+     * between the two buffers. When rewinding, records are read from the
+     * beginning of the series until the buffer covers the requested time
+     */
+    metstream_struct *ms;
+    char            cmdstr[MAXSTRING];
+    int            *ftime;
+    double         *data;
+    int             n = 0;
+    int             lno = 0;
+
+    ms = forc->metstream;
+    ftime = ms->next_ftime[k];
+    data = ms->next_data[k];
+
+    if (ms->rewind[k] >= 0)
+    {
+        ms->pos[k] = ms->start[k];
+    }
+    else if (forc->meteo[k].length > 0)
+    {
+        ftime[0] = forc->meteo[k].ftime[forc->meteo[k].length - 1];
+        memcpy(data, forc->meteo[k].data +
+            (forc->meteo[k].length - 1) * NUM_METEO_VAR,
+            NUM_METEO_VAR * sizeof(double));
+        n = 1;
+    }
+
+    fseek(ms->file, ms->pos[k], SEEK_SET);
+
+    while (n < ms->window)
+    {
+        long int        pos;
+
+        pos = ftell(ms->file);
+        NextLine(ms->file, cmdstr, &lno);
+
+        if (strcasecmp(cmdstr, "EOF") == 0 ||
+            strncasecmp(cmdstr, "METEO_TS", strlen("METEO_TS")) == 0)
+        {
+            /* End of series */
+            fseek(ms->file, pos, SEEK_SET);
+            break;
+        }
+
+        if (!ReadTS(cmdstr, &ftime[n], &data[n * NUM_METEO_VAR],
+            NUM_METEO_VAR))
+        {
+            PIHMprintf(VL_ERROR, "Error reading meteorological forcing.");
+            PIHMprintf(VL_ERROR, "Error in the %dth time series in %s.\n",
+                k + 1, ms->filename);
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        /* Apply climate scenarios */
+        data[n * NUM_METEO_VAR + PRCP_TS] *= ms->prcp;
+        data[n * NUM_METEO_VAR + SFCTMP_TS] += ms->sfctmp;
+
+        n++;
+
+        if (n == ms->window && ms->rewind[k] >= 0 &&
+            ftime[n - 1] < ms->rewind[k])
+        {
+            /* Buffer does not reach the requested time yet. Keep the last
+             * record and continue reading */
+            ftime[0] = ftime[n - 1];
+            memcpy(data, data + (n - 1) * NUM_METEO_VAR,
+                NUM_METEO_VAR * sizeof(double));
+            n = 1;
+        }
+    }
+
+    ms->pos[k] = ftell(ms->file);
+    ms->next_length[k] = n;
+    ms->rewind[k] = -1;
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+void *MeteoStreamThread(void *arg)
+{
+    /*
+     * Background reader that fills prefetch buffers upon request
+     */
+    forc_struct    *forc;
+    metstream_struct *ms;
+    int             k;
+
+    forc = (forc_struct *)arg;
+    ms = forc->metstream;
+
+    pthread_mutex_lock(&ms->mutex);
+    while (!ms->quit)
+    {
+        for (k = 0; k < forc->nmeteo; k++)
+        {
+            if (ms->pending[k])
+            {
+                break;
+            }
+        }
+
+        if (k < forc->nmeteo)
+        {
+            pthread_mutex_unlock(&ms->mutex);
+            FillMeteoBuf(forc, k);
+            pthread_mutex_lock(&ms->mutex);
+
+            ms->pending[k] = 0;
+            pthread_cond_broadcast(&ms->cond);
+        }
+        else
+        {
+            pthread_cond_wait(&ms->cond, &ms->mutex);
+        }
+    }
+    pthread_mutex_unlock(&ms->mutex);
+
+    return NULL;
+}
+#endif
+
+void RequestMeteoBuf(forc_struct *forc, int k)
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    metstream_struct *ms;
+
+    ms = forc->metstream;
+
+    pthread_mutex_lock(&ms->mutex);
+    ms->pending[k] = 1;
+    pthread_cond_broadcast(&ms->cond);
+    pthread_mutex_unlock(&ms->mutex);
+#else
+    /* Without POSIX threads, buffers are filled synchronously */
+    FillMeteoBuf(forc, k);
+#endif
+}
+
+void WaitMeteoBuf(metstream_struct *ms, int k)
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&ms->mutex);
+    while (ms->pending[k])
+    {
+        pthread_cond_wait(&ms->cond, &ms->mutex);
+    }
+    pthread_mutex_unlock(&ms->mutex);
+#else
+    /* Buffers are filled synchronously */
+    (void)ms;
+    (void)k;
+#endif
+}
+
+void FreeMeteoStream(forc_struct *forc)
+{
+    metstream_struct *ms;
+    int             i;
+
+    ms = forc->metstream;
+
+    StopMeteoStream(ms);
+
+    if (forc->nmeteo > 0)
+    {
+        for (i = 0; i < forc->nmeteo; i++)
+        {
+            free(forc->meteo[i].ftime);
+            free(forc->meteo[i].data);
+            free(forc->meteo[i].value);
+            free(ms->next_ftime[i]);
+            free(ms->next_data[i]);
+        }
+        free(forc->meteo);
+
+        free(ms->start);
+        free(ms->pos);
+        free(ms->next_length);
+        free(ms->next_ftime);
+        free(ms->next_data);
+        free(ms->rewind);
+        free(ms->pending);
+    }
+
+    fclose(ms->file);
+    free(ms);
+}
+
+void StopMeteoStream(metstream_struct *ms)
+{
+    /*
+     * Stop the background reader
+     */
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&ms->mutex);
+    ms->quit = 1;
+    pthread_cond_broadcast(&ms->cond);
+    pthread_mutex_unlock(&ms->mutex);
+    pthread_join(ms->thread, NULL);
+    pthread_mutex_destroy(&ms->mutex);
+    pthread_cond_destroy(&ms->cond);
+#else
+    (void)ms;
+#endif
+}
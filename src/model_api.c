@@ -0,0 +1,618 @@
+#include "pihm.h"
+
+/* Global variables. The model code references settings and model dimensions
+ * of the current model through global variables, which are set from the
+ * context of a model instance whenever the instance is called. The model
+ * code is not reentrant: only one instance can be active at a time */
+int             verbose_mode;
+int             debug_mode;
+int             append_mode;
+int             corr_mode;
+int             spinup_mode;
+int             tecplot;
+int             benchmark;
+int             convert_mode;
+int             cache_mode;
+char            project[MAXSTRING];
+int             nelem;
+int             nriver;
+#if defined(_OPENMP)
+int             nthreads = 1;    /* Default value */
+#endif
+#if defined(_BGC_)
+int             first_balance;
+#endif
+
+/* Library calls are serialized, and the number of OpenMP threads of the
+ * caller is restored when a call returns */
+#if !defined(_WIN32) && !defined(_WIN64)
+pthread_mutex_t api_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+#if defined(_OPENMP)
+int             caller_nthreads;
+#endif
+
+void DefaultCtx(ctx_struct *ctx)
+{
+    memset(ctx, 0, sizeof(ctx_struct));
+
+    ctx->verbose_mode = VL_NORMAL;
+#if defined(_OPENMP)
+    ctx->nthreads = omp_get_max_threads();
+#endif
+}
+
+void SetGlobalCtx(const ctx_struct *ctx)
+{
+    verbose_mode = ctx->verbose_mode;
+    debug_mode = ctx->debug_mode;
+    append_mode = ctx->append_mode;
+    corr_mode = ctx->corr_mode;
+    spinup_mode = ctx->spinup_mode;
+    tecplot = ctx->tecplot;
+    benchmark = ctx->benchmark;
+    convert_mode = ctx->convert_mode;
+    cache_mode = ctx->cache_mode;
+    strcpy(project, ctx->project);
+    nelem = ctx->nelem;
+    nriver = ctx->nriver;
+#if defined(_OPENMP)
+    nthreads = ctx->nthreads;
+#endif
+#if defined(_BGC_)
+    first_balance = ctx->first_balance;
+#endif
+}
+
+void GetGlobalCtx(ctx_struct *ctx)
+{
+    ctx->verbose_mode = verbose_mode;
+    ctx->debug_mode = debug_mode;
+    ctx->append_mode = append_mode;
+    ctx->corr_mode = corr_mode;
+    ctx->spinup_mode = spinup_mode;
+    ctx->tecplot = tecplot;
+    ctx->benchmark = benchmark;
+    ctx->convert_mode = convert_mode;
+    ctx->cache_mode = cache_mode;
+    strcpy(ctx->project, project);
+    ctx->nelem = nelem;
+    ctx->nriver = nriver;
+#if defined(_OPENMP)
+    ctx->nthreads = nthreads;
+#endif
+#if defined(_BGC_)
+    ctx->first_balance = first_balance;
+#endif
+}
+
+void EnterModel(const ctx_struct *ctx, jmp_buf *env)
+{
+    /*
+     * Make a model instance the active instance for the duration of a library
+     * call. Errors in the call return to env
+     */
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&api_mutex);
+    exit_thread = pthread_self();
+#endif
+    exit_env = env;
+
+    SetGlobalCtx(ctx);
+
+#if defined(_OPENMP)
+    caller_nthreads = omp_get_max_threads();
+    omp_set_num_threads(nthreads);
+#endif
+}
+
+void LeaveModel(ctx_struct *ctx)
+{
+    GetGlobalCtx(ctx);
+
+#if defined(_OPENMP)
+    omp_set_num_threads(caller_nthreads);
+#endif
+
+    exit_env = NULL;
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_unlock(&api_mutex);
+#endif
+}
+
+model_struct PIHMcreate(const ctx_struct *ctx, const char *outputdir,
+    model_struct base)
+{
+    /*
+     * Create a model instance: read input files and initialize model
+     * structures. When a base model is given, input tables and forcing of the
+     * base model are shared instead of read, and the base model must not be
+     * destroyed before the new model. An empty output directory name selects
+     * the default output directory. Returns NULL if the model cannot be
+     * created, in which case memory allocated and files opened for the model
+     * are released
+     */
+    model_struct    model;
+    pihm_struct     pihm;
+    jmp_buf         env;
+
+    if (ctx->convert_mode)
+    {
+        PIHMprintf(VL_ERROR, "Error: Forcing conversion is not supported by "
+            "the library interface.\n");
+        return NULL;
+    }
+
+    model = (model_struct)malloc(sizeof(*model));
+
+    model->ctx = *ctx;
+    strcpy(model->outputdir, outputdir);
+    model->base = base;
+    model->nshare = 0;
+    model->output = 0;
+    model->init = 0;
+    model->failed = 0;
+    model->pihm = NULL;
+    model->CV_Y = NULL;
+    model->cvode_mem = NULL;
+
+    if (base != NULL)
+    {
+        /* Models sharing input tables have the same model grids */
+        model->ctx.nelem = base->ctx.nelem;
+        model->ctx.nriver = base->ctx.nriver;
+    }
+
+    EnterModel(&model->ctx, &env);
+    if (setjmp(env) != 0)
+    {
+        /* Model structures are partially initialized, and cannot be freed by
+         * FreeMem. Background threads and solver memory are released here,
+         * and tracked memory and files are released by StopTracking */
+        if (model->pihm != NULL)
+        {
+            FreeFailedModel(model->pihm);
+        }
+        if (model->CV_Y != NULL)
+        {
+            N_VDestroy(model->CV_Y);
+        }
+        if (model->cvode_mem != NULL)
+        {
+            CVodeFree(&model->cvode_mem);
+        }
+        StopTracking(1);
+
+        LeaveModel(&model->ctx);
+        free(model);
+
+        return NULL;
+    }
+
+    StartTracking();
+
+    /* Allocate memory for model data structure. Pointers are initialized to
+     * NULL so that a partially created model can be released */
+    pihm = (pihm_struct)calloc(1, sizeof(*pihm));
+    model->pihm = pihm;
+
+    /* Read PIHM input files */
+    ReadAlloc((base != NULL) ? base->pihm : NULL, pihm);
+
+    /* Reorder model grids for memory locality. Shared input tables have
+     * been reordered by the base model */
+    if (base == NULL && pihm->ctrl.reorder != NO_REORDER)
+    {
+        ReorderMesh(pihm->ctrl.reorder, &pihm->meshtbl, &pihm->atttbl,
+            &pihm->rivtbl);
+    }
+
+    /* Initialize CVode state variables */
+    model->CV_Y = N_VNew(NumStateVar());
+    if (model->CV_Y == NULL)
+    {
+        PIHMprintf(VL_ERROR, "Error creating CVODE state variable vector.\n");
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    FirstTouch(model->CV_Y);
+
+    /* Initialize PIHM structure */
+    Initialize(pihm, model->CV_Y, &model->cvode_mem);
+
+    if (base != NULL)
+    {
+        base->nshare++;
+    }
+
+    StopTracking(0);
+
+    LeaveModel(&model->ctx);
+
+    return model;
+}
+
+int PIHMinit(model_struct model)
+{
+    /*
+     * Create output files and set solver parameters before the model is
+     * advanced. Returns EXIT_SUCCESS, or EXIT_FAILURE if an error occurs, in
+     * which case memory allocated and files opened for output are released
+     */
+    pihm_struct     pihm;
+    jmp_buf         env;
+
+    if (model->init || model->failed)
+    {
+        PIHMprintf(VL_ERROR, "Error: Model has already been initialized.\n");
+        return EXIT_FAILURE;
+    }
+
+    EnterModel(&model->ctx, &env);
+    if (setjmp(env) != 0)
+    {
+        /* Output structures are partially initialized. The output writer
+         * thread is stopped, and tracked memory and files are released by
+         * StopTracking. Errors in the cleanup terminate the process */
+        exit_env = NULL;
+        if (model->output)
+        {
+            model->output = 0;
+            FreeOutputWriter(&model->pihm->print.writer);
+        }
+        StopTracking(1);
+
+        model->failed = 1;
+        LeaveModel(&model->ctx);
+        return EXIT_FAILURE;
+    }
+
+    StartTracking();
+
+    pihm = model->pihm;
+
+    /* Create output directory */
+    CreateOutputDir(model->outputdir);
+
+    /* Create output structures */
+#if defined(_CYCLES_)
+    MapOutput(pihm->ctrl.prtvrbl, pihm->ctrl.tpprtvrbl, pihm->epctbl,
+        pihm->elem, pihm->river, &pihm->meshtbl, model->outputdir,
+        &pihm->print);
+#else
+    MapOutput(pihm->ctrl.prtvrbl, pihm->ctrl.tpprtvrbl, pihm->elem, pihm->river,
+        &pihm->meshtbl, model->outputdir, &pihm->print);
+#endif
+
+    /* Replace full-field outputs with reduced outputs */
+    if (pihm->reducetbl.nreducer > 0)
+    {
+        MapReducer(&pihm->reducetbl, pihm->elem, pihm->river,
+            model->outputdir, &pihm->print);
+    }
+
+    /* Backup input files */
+#if !defined(_MSC_VER)
+    if (!append_mode)
+    {
+        BackupInput(model->outputdir, &pihm->filename);
+    }
+#endif
+
+    InitOutputFile(&pihm->print, model->outputdir, pihm->ctrl.waterbal,
+        pihm->ctrl.ascii, pihm->ctrl.output_format);
+
+    /* Binary and txt output files are written by a background thread */
+    InitOutputWriter(&pihm->print, pihm->ctrl.ascii, pihm->ctrl.output_flush);
+    model->output = 1;
+    if (pihm->ctrl.output_format == CONTAINER_OUTPUT)
+    {
+        InitOutputContainer(&pihm->print, pihm->river, model->outputdir);
+    }
+
+    PIHMprintf(VL_VERBOSE, "\n\nSolving ODE system ... \n\n");
+
+    /* Set solver parameters */
+    SetCVodeParam(pihm, model->cvode_mem, model->CV_Y);
+
+#if defined(_BGC_)
+    first_balance = 1;
+#endif
+
+    pihm->ctrl.cstep = 0;
+
+#if defined(_OPENMP)
+    model->start = omp_get_wtime();
+#else
+    model->start = clock();
+#endif
+    model->ptime = model->start;
+
+    model->init = 1;
+
+    StopTracking(0);
+
+    LeaveModel(&model->ctx);
+
+    return EXIT_SUCCESS;
+}
+
+int PIHMadvance(model_struct model, int t, int *tout)
+{
+    /*
+     * Advance the model by model steps until model time reaches t or the end
+     * of simulation, and store model time in tout (if not NULL). In spin-up
+     * and benchmark modes, the whole simulation is run at the first call.
+     * Returns EXIT_SUCCESS, or EXIT_FAILURE if an error occurs, after which
+     * the model cannot be advanced further
+     */
+    pihm_struct     pihm;
+    ctrl_struct    *ctrl;
+    double          cputime, cputime_dt;    /* Time cpu duration */
+    jmp_buf         env;
+
+    if (!model->init || model->failed)
+    {
+        PIHMprintf(VL_ERROR, "Error: Model must be initialized before it is "
+            "advanced.\n");
+        return EXIT_FAILURE;
+    }
+
+    EnterModel(&model->ctx, &env);
+    if (setjmp(env) != 0)
+    {
+        model->failed = 1;
+        LeaveModel(&model->ctx);
+        return EXIT_FAILURE;
+    }
+
+    pihm = model->pihm;
+    ctrl = &pihm->ctrl;
+
+    if (benchmark > 0)
+    {
+        /* Time RHS evaluations without integrating the model */
+        BenchmarkRhs(pihm, model->cvode_mem, model->CV_Y, benchmark);
+        ctrl->cstep = ctrl->nstep;
+    }
+    else if (spinup_mode)
+    {
+        Spinup(pihm, model->CV_Y, model->cvode_mem);
+
+        /* In spin-up mode, initial conditions are always printed */
+        PrintInit(pihm->elem, pihm->river, model->outputdir,
+            ctrl->endtime, ctrl->starttime,
+            ctrl->endtime, ctrl->prtvrbl[IC_CTRL]);
+#if defined(_BGC_)
+        WriteBgcIc(model->outputdir, pihm->elem, pihm->river);
+#endif
+    }
+    else
+    {
+        for (; ctrl->cstep < ctrl->nstep && ctrl->tout[ctrl->cstep] < t;
+            ctrl->cstep++)
+        {
+            RunTime(model->start, &model->ptime, &cputime, &cputime_dt);
+
+            PIHM(pihm, model->cvode_mem, model->CV_Y, cputime);
+
+            /* Print CVODE performance and statistics */
+            if (debug_mode)
+            {
+                PrintPerf(model->cvode_mem, ctrl->tout[ctrl->cstep + 1],
+                    ctrl->starttime, cputime_dt, cputime,
+                    pihm->stepctrl.maxstep, &pihm->print.perf0,
+                    pihm->print.cvodeperf_file);
+            }
+
+            /* Write init files */
+            if (ctrl->write_ic)
+            {
+                PrintInit(pihm->elem, pihm->river, model->outputdir,
+                    ctrl->tout[ctrl->cstep + 1], ctrl->starttime,
+                    ctrl->endtime, ctrl->prtvrbl[IC_CTRL]);
+            }
+        }
+
+        if (ctrl->cstep >= ctrl->nstep)
+        {
+#if defined(_BGC_)
+            if (ctrl->write_bgc_restart)
+            {
+                WriteBgcIc(model->outputdir, pihm->elem, pihm->river);
+            }
+#endif
+
+# if TEMP_DISABLED
+#if defined(_CYCLES_)
+            if (ctrl->write_cycles_restart)
+            {
+                WriteCyclesIC(pihm->filename.cyclesic, pihm->elem,
+                    pihm->river);
+            }
+# endif
+#endif
+        }
+    }
+
+    if (ctrl->cstep >= ctrl->nstep)
+    {
+        if (debug_mode)
+        {
+            PrintCVodeFinalStats(ctrl->lin_solver, model->cvode_mem);
+        }
+
+        if (ctrl->multirate > 0)
+        {
+            PIHMprintf(VL_NORMAL, "Multi-rate water balance error %lg m3 "
+                "(total outlet discharge %lg m3).\n", pihm->multirate.wb_error,
+                pihm->multirate.discharge);
+        }
+
+#if defined(_DEBUG_)
+        /* The RHS evaluation is the hot path of the model and should not
+         * allocate */
+        PIHMprintf(VL_NORMAL, "%.2lf heap allocations per RHS evaluation "
+            "(%ld RHS evaluations).\n", (pihm->allocstat.nrhs > 0) ?
+            (double)pihm->allocstat.nalloc / (double)pihm->allocstat.nrhs :
+            0.0, pihm->allocstat.nrhs);
+#endif
+    }
+
+    LeaveModel(&model->ctx);
+
+    if (tout != NULL)
+    {
+        *tout = ctrl->tout[ctrl->cstep];
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int PIHMgetstate(model_struct model, int var, double *value)
+{
+    /*
+     * Copy a model state variable into value, in the element (river segment)
+     * order of the input files. Variables are identified by their output
+     * control indices (e.g., SURF_CTRL). Returns the number of values, or
+     * -1 if the variable is not a model state
+     */
+    const elem_struct *elem;
+    const river_struct *river;
+    int             i;
+    int             n = 0;
+
+    if (!model->init)
+    {
+        PIHMprintf(VL_ERROR, "Error: Model must be initialized before its "
+            "states are accessed.\n");
+        return -1;
+    }
+
+    elem = model->pihm->elem;
+    river = model->pihm->river;
+
+    switch (var)
+    {
+        case SURF_CTRL:
+            for (i = 0; i < model->ctx.nelem; i++)
+            {
+                value[elem[i].ind - 1] = elem[i].ws.surf;
+            }
+            n = model->ctx.nelem;
+            break;
+        case UNSAT_CTRL:
+            for (i = 0; i < model->ctx.nelem; i++)
+            {
+                value[elem[i].ind - 1] = elem[i].ws.unsat;
+            }
+            n = model->ctx.nelem;
+            break;
+        case GW_CTRL:
+            for (i = 0; i < model->ctx.nelem; i++)
+            {
+                value[elem[i].ind - 1] = elem[i].ws.gw;
+            }
+            n = model->ctx.nelem;
+            break;
+        case RIVSTG_CTRL:
+            for (i = 0; i < model->ctx.nriver; i++)
+            {
+                value[river[i].ind - 1] = river[i].ws.stage;
+            }
+            n = model->ctx.nriver;
+            break;
+        case RIVGW_CTRL:
+            for (i = 0; i < model->ctx.nriver; i++)
+            {
+                value[river[i].ind - 1] = river[i].ws.gw;
+            }
+            n = model->ctx.nriver;
+            break;
+        case SNOW_CTRL:
+            for (i = 0; i < model->ctx.nelem; i++)
+            {
+                value[elem[i].ind - 1] = elem[i].ws.sneqv;
+            }
+            n = model->ctx.nelem;
+            break;
+        case CMC_CTRL:
+            for (i = 0; i < model->ctx.nelem; i++)
+            {
+                value[elem[i].ind - 1] = elem[i].ws.cmc;
+            }
+            n = model->ctx.nelem;
+            break;
+#if defined(_FBR_)
+        case FBRUNSAT_CTRL:
+            for (i = 0; i < model->ctx.nelem; i++)
+            {
+                value[elem[i].ind - 1] = elem[i].ws.fbr_unsat;
+            }
+            n = model->ctx.nelem;
+            break;
+        case FBRGW_CTRL:
+            for (i = 0; i < model->ctx.nelem; i++)
+            {
+                value[elem[i].ind - 1] = elem[i].ws.fbr_gw;
+            }
+            n = model->ctx.nelem;
+            break;
+#endif
+        default:
+            PIHMprintf(VL_ERROR,
+                "Error: Output variable %d is not a model state.\n", var);
+            return -1;
+    }
+
+    return n;
+}
+
+int PIHMdestroy(model_struct model)
+{
+    /*
+     * Write buffered output, close output files, and free a model instance.
+     * Returns EXIT_SUCCESS, or EXIT_FAILURE if the model cannot be destroyed
+     */
+    jmp_buf         env;
+
+    if (model->nshare > 0)
+    {
+        PIHMprintf(VL_ERROR, "Error: Model inputs are shared with %d other "
+            "model(s).\n", model->nshare);
+        return EXIT_FAILURE;
+    }
+
+    EnterModel(&model->ctx, &env);
+    if (setjmp(env) != 0)
+    {
+        LeaveModel(&model->ctx);
+        return EXIT_FAILURE;
+    }
+
+    if (model->output)
+    {
+        model->output = 0;
+        FreeOutput(model->pihm->ctrl.waterbal, model->pihm->ctrl.ascii,
+            &model->pihm->print);
+    }
+
+    /* Free memory */
+    N_VDestroy(model->CV_Y);
+
+    /* Free integrator memory */
+    CVodeFree(&model->cvode_mem);
+    FreeMem(model->pihm);
+    free(model->pihm);
+
+    LeaveModel(&model->ctx);
+
+    if (model->base != NULL)
+    {
+        model->base->nshare--;
+    }
+
+    free(model);
+
+    return EXIT_SUCCESS;
+}
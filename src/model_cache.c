@@ -0,0 +1,320 @@
+#include "pihm.h"
+
+uint64_t ModelCacheKey(const pihm_struct pihm)
+{
+    /*
+     * Hash of the input files and options that determine the static model
+     * variables (see InitStatic). Control parameters other than grid
+     * reordering do not change the static variables, and are not hashed
+     */
+    uint64_t        key = 14695981039346656037ULL;
+    int             i;
+    int32_t         option[3];
+
+    key = HashFile(pihm->filename.riv, key);
+    key = HashFile(pihm->filename.mesh, key);
+    key = HashFile(pihm->filename.att, key);
+    key = HashFile(pihm->filename.soil, key);
+    key = HashFile(pihm->filename.lc, key);
+    key = HashFile(pihm->filename.calib, key);
+#if defined(_FBR_)
+    key = HashFile(pihm->filename.geol, key);
+    key = HashFile(pihm->filename.bedrock, key);
+#endif
+#if defined(_NOAH_)
+    key = HashFile(pihm->filename.lsm, key);
+#endif
+
+    option[0] = pihm->ctrl.reorder;
+    option[1] = corr_mode;
+
+    /* Model configuration */
+    option[2] = 0;
+#if defined(_FBR_)
+    option[2] |= 1;
+#endif
+#if defined(_NOAH_)
+    option[2] |= 2;
+#endif
+#if defined(_CYCLES_)
+    option[2] |= 4;
+#endif
+#if defined(_BGC_)
+    option[2] |= 8;
+#endif
+#if defined(_LUMPED_)
+    option[2] |= 16;
+#endif
+
+    for (i = 0; i < 3; i++)
+    {
+        key = (key ^ (uint64_t)(uint32_t)option[i]) * 1099511628211ULL;
+    }
+
+    return key;
+}
+
+uint64_t HashFile(const char *filename, uint64_t hash)
+{
+    /*
+     * FNV-1a style hash of the contents of a file, eight bytes at a time
+     */
+    FILE           *fp;
+    unsigned char   buffer[65536];
+    size_t          size;
+    size_t          i;
+    uint64_t        word;
+
+    fp = fopen(filename, "rb");
+    CheckFile(fp, filename);
+
+    while ((size = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+    {
+        for (i = 0; i + 8 <= size; i += 8)
+        {
+            memcpy(&word, buffer + i, 8);
+            hash = (hash ^ word) * 1099511628211ULL;
+        }
+
+        for (; i < size; i++)
+        {
+            hash = (hash ^ buffer[i]) * 1099511628211ULL;
+        }
+
+        /* Separate chunks so that file boundaries affect the hash */
+        hash = (hash ^ (uint64_t)size) * 1099511628211ULL;
+    }
+
+    fclose(fp);
+
+    return hash;
+}
+
+int ReadModelCache(const char *filename, uint64_t key, elem_struct *elem,
+    river_struct *river, siteinfo_struct *siteinfo)
+{
+    /*
+     * Read static model variables from the model cache file in one read.
+     * Returns 0 if the cache file does not exist or does not match the input
+     * files, in which case static variables should be initialized from the
+     * input files
+     */
+    FILE           *fp;
+    long int        size;
+    char           *buffer;
+    cachehdr_struct hdr;
+    const elemcache_struct *elemc;
+    const rivcache_struct *rivc;
+    int             nrec;
+    int             i;
+
+    fp = fopen(filename, "rb");
+    if (fp == NULL)
+    {
+        return 0;
+    }
+
+#if defined(_LUMPED_)
+    nrec = nelem + 1;
+#else
+    nrec = nelem;
+#endif
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    if (size != (long int)(sizeof(cachehdr_struct) +
+        nrec * sizeof(elemcache_struct) + nriver * sizeof(rivcache_struct)))
+    {
+        PIHMprintf(VL_VERBOSE, " Model cache %s is out of date.\n", filename);
+        fclose(fp);
+        return 0;
+    }
+
+    buffer = (char *)malloc(size);
+    if ((long int)fread(buffer, 1, size, fp) != size)
+    {
+        PIHMprintf(VL_ERROR, "Error reading %s.\n", filename);
+        PIHMexit(EXIT_FAILURE);
+    }
+    fclose(fp);
+
+    memcpy(&hdr, buffer, sizeof(cachehdr_struct));
+    if (strncmp(hdr.magic, CACHE_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != CACHE_VERSION || hdr.key != key ||
+        hdr.nelem != nrec || hdr.nriver != nriver ||
+        hdr.elem_size != (int32_t)sizeof(elemcache_struct) ||
+        hdr.river_size != (int32_t)sizeof(rivcache_struct))
+    {
+        PIHMprintf(VL_VERBOSE, " Model cache %s is out of date.\n", filename);
+        free(buffer);
+        return 0;
+    }
+
+    PIHMprintf(VL_VERBOSE, " Reading %s\n", filename);
+
+    siteinfo->zmax = hdr.zmax;
+    siteinfo->zmin = hdr.zmin;
+    siteinfo->area = hdr.area;
+
+    elemc = (const elemcache_struct *)(buffer + sizeof(cachehdr_struct));
+    rivc = (const rivcache_struct *)(elemc + nrec);
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nrec; i++)
+    {
+        int             j;
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            elem[i].node[j] = elemc[i].node[j];
+            elem[i].nabr[j] = elemc[i].nabr[j];
+        }
+        elem[i].ind = elemc[i].ind;
+        elem[i].attrib = elemc[i].attrib;
+        elem[i].topo = elemc[i].topo;
+        elem[i].soil = elemc[i].soil;
+        elem[i].lc = elemc[i].lc;
+#if defined(_FBR_)
+        elem[i].geol = elemc[i].geol;
+#endif
+        elem[i].ps.rzd = elemc[i].rzd;
+#if !defined(_CYCLES_)
+        elem[i].epc.rsmin = elemc[i].rsmin;
+        elem[i].epc.rgl = elemc[i].rgl;
+        elem[i].epc.hs = elemc[i].hs;
+        elem[i].epc.rsmax = elemc[i].rsmax;
+        elem[i].epc.topt = elemc[i].topt;
+#endif
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        river[i].ind = rivc[i].ind;
+        river[i].leftele = rivc[i].leftele;
+        river[i].rightele = rivc[i].rightele;
+        river[i].fromnode = rivc[i].fromnode;
+        river[i].tonode = rivc[i].tonode;
+        river[i].down = rivc[i].down;
+        river[i].attrib = rivc[i].attrib;
+        river[i].topo = rivc[i].topo;
+        river[i].shp = rivc[i].shp;
+        river[i].matl = rivc[i].matl;
+    }
+
+    free(buffer);
+
+    return 1;
+}
+
+void WriteModelCache(const char *filename, uint64_t key,
+    const elem_struct *elem, const river_struct *river,
+    const siteinfo_struct *siteinfo)
+{
+    /*
+     * Write static model variables to the model cache file. The file is
+     * written to a temporary file first, and then renamed, so that model runs
+     * reading the old file are not affected
+     */
+    char            tmpfn[MAXSTRING];
+    FILE           *fp;
+    cachehdr_struct hdr;
+    elemcache_struct *elemc;
+    rivcache_struct *rivc;
+    int             nrec;
+    int             error;
+    int             i;
+
+#if defined(_LUMPED_)
+    nrec = nelem + 1;
+#else
+    nrec = nelem;
+#endif
+
+    sprintf(tmpfn, "%s.tmp", filename);
+
+    fp = fopen(tmpfn, "wb");
+    if (fp == NULL)
+    {
+        /* Model runs do not depend on the cache */
+        PIHMprintf(VL_NORMAL, "Warning: Cannot write model cache %s.\n",
+            filename);
+        return;
+    }
+    PIHMprintf(VL_VERBOSE, " Writing %s\n", filename);
+
+    memset(&hdr, 0, sizeof(cachehdr_struct));
+    strncpy(hdr.magic, CACHE_MAGIC, sizeof(hdr.magic));
+    hdr.version = CACHE_VERSION;
+    hdr.key = key;
+    hdr.nelem = nrec;
+    hdr.nriver = nriver;
+    hdr.elem_size = (int32_t)sizeof(elemcache_struct);
+    hdr.river_size = (int32_t)sizeof(rivcache_struct);
+    hdr.zmax = siteinfo->zmax;
+    hdr.zmin = siteinfo->zmin;
+    hdr.area = siteinfo->area;
+
+    /* Records are zeroed so that padding bytes are written as zeros */
+    elemc = (elemcache_struct *)calloc(nrec, sizeof(elemcache_struct));
+    rivc = (rivcache_struct *)calloc(nriver, sizeof(rivcache_struct));
+
+    for (i = 0; i < nrec; i++)
+    {
+        int             j;
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            elemc[i].node[j] = elem[i].node[j];
+            elemc[i].nabr[j] = elem[i].nabr[j];
+        }
+        elemc[i].ind = elem[i].ind;
+        elemc[i].attrib = elem[i].attrib;
+        elemc[i].topo = elem[i].topo;
+        elemc[i].soil = elem[i].soil;
+        elemc[i].lc = elem[i].lc;
+#if defined(_FBR_)
+        elemc[i].geol = elem[i].geol;
+#endif
+        elemc[i].rzd = elem[i].ps.rzd;
+#if !defined(_CYCLES_)
+        elemc[i].rsmin = elem[i].epc.rsmin;
+        elemc[i].rgl = elem[i].epc.rgl;
+        elemc[i].hs = elem[i].epc.hs;
+        elemc[i].rsmax = elem[i].epc.rsmax;
+        elemc[i].topt = elem[i].epc.topt;
+#endif
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        rivc[i].ind = river[i].ind;
+        rivc[i].leftele = river[i].leftele;
+        rivc[i].rightele = river[i].rightele;
+        rivc[i].fromnode = river[i].fromnode;
+        rivc[i].tonode = river[i].tonode;
+        rivc[i].down = river[i].down;
+        rivc[i].attrib = river[i].attrib;
+        rivc[i].topo = river[i].topo;
+        rivc[i].shp = river[i].shp;
+        rivc[i].matl = river[i].matl;
+    }
+
+    fwrite(&hdr, sizeof(cachehdr_struct), 1, fp);
+    fwrite(elemc, sizeof(elemcache_struct), nrec, fp);
+    fwrite(rivc, sizeof(rivcache_struct), nriver, fp);
+
+    free(elemc);
+    free(rivc);
+
+    error = ferror(fp);
+    if (fclose(fp) != 0 || error || rename(tmpfn, filename) != 0)
+    {
+        PIHMprintf(VL_NORMAL, "Warning: Cannot write model cache %s.\n",
+            filename);
+        remove(tmpfn);
+    }
+}
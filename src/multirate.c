@@ -0,0 +1,902 @@
+#include "pihm.h"
+
+void InitMultiRate(const graph_struct *graph, int precond,
+    multirate_struct *mr)
+{
+    /*
+     * Multi-rate integration splits the ODE system into a fast subsystem
+     * (surface water and river stage) and a slow subsystem (unsaturated
+     * zone, groundwater, river bed aquifer, and fractured bedrock). The fast
+     * subsystem is solved by its own CVODE instance at every model step, and
+     * the slow subsystem is solved by the model CVODE instance at the end of
+     * every slow step of several model steps
+     */
+    mr->nfast = 3 * nelem + 2 * nriver + 1;
+
+    mr->cvode_mem = CVodeCreate(CV_BDF, CV_NEWTON);
+    if (mr->cvode_mem == NULL)
+    {
+        PIHMprintf(VL_ERROR, "Error in allocating memory for solver.\n");
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    mr->y = N_VNew(mr->nfast);
+    if (mr->y == NULL)
+    {
+        PIHMprintf(VL_ERROR, "Error creating CVODE state variable vector.\n");
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    mr->y0 = (double *)malloc(NumStateVar() * sizeof(double));
+    mr->acc0 = (double *)malloc(mr->nfast * sizeof(double));
+    mr->xrate = (double *)malloc(mr->nfast * sizeof(double));
+
+    mr->ncolor = 0;
+    if (precond == BLOCK_JACOBI)
+    {
+        int            *color;
+        int            *counter;
+        int             i;
+
+        /*
+         * Surface water and river stage of all nodes in one color are
+         * perturbed at a time to approximate the diagonal of the Jacobian of
+         * the fast subsystem. As in the block-Jacobi preconditioner, nodes
+         * sharing a color must not be within two edges of each other
+         */
+        color = (int *)malloc(graph->nnode * sizeof(int));
+        mr->ncolor = ColorGraph(graph, 2, color);
+
+        mr->colorptr = (int *)calloc(mr->ncolor + 1, sizeof(int));
+        mr->colornode = (int *)malloc(graph->nnode * sizeof(int));
+        counter = (int *)malloc(mr->ncolor * sizeof(int));
+
+        for (i = 0; i < graph->nnode; i++)
+        {
+            mr->colorptr[color[i] + 1]++;
+        }
+        for (i = 0; i < mr->ncolor; i++)
+        {
+            mr->colorptr[i + 1] += mr->colorptr[i];
+            counter[i] = mr->colorptr[i];
+        }
+        for (i = 0; i < graph->nnode; i++)
+        {
+            mr->colornode[counter[color[i]]++] = i;
+        }
+
+        free(color);
+        free(counter);
+
+        mr->jac = (double *)calloc(graph->nnode, sizeof(double));
+        mr->pdiag = (double *)malloc(graph->nnode * sizeof(double));
+    }
+
+    mr->kend = 0;
+    mr->wb_error = 0.0;
+    mr->discharge = 0.0;
+    mr->reset = 0;
+}
+
+void SetFastCVodeParam(pihm_struct pihm, N_Vector CV_Y)
+{
+    /*
+     * Initialize the fast subsystem from model state variables. Exchange
+     * with the slow subsystem is accumulated from zero
+     */
+    multirate_struct *mr;
+    double         *y;
+    double         *yf;
+    int             cv_flag;
+    int             i;
+
+    mr = &pihm->multirate;
+    y = NV_DATA(CV_Y);
+    yf = NV_DATA(mr->y);
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        yf[FAST_SURF(i)] = y[SURF(i)];
+        yf[FAST_UNSAT(i)] = 0.0;
+        yf[FAST_GW(i)] = 0.0;
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        yf[FAST_RIVSTG(i)] = y[RIVSTG(i)];
+        yf[FAST_RIVGW(i)] = 0.0;
+    }
+
+    yf[FAST_DISCHARGE] = 0.0;
+
+    for (i = 0; i < mr->nfast; i++)
+    {
+        mr->acc0[i] = 0.0;
+        mr->xrate[i] = 0.0;
+    }
+
+    if (mr->reset)
+    {
+        cv_flag = CVodeReInit(mr->cvode_mem, 0.0, mr->y);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+    }
+    else
+    {
+        cv_flag = CVodeInit(mr->cvode_mem, FastOde, 0.0, mr->y);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+        mr->reset = 1;
+    }
+
+    cv_flag = CVodeSStolerances(mr->cvode_mem, (realtype)pihm->ctrl.reltol,
+        (realtype)pihm->ctrl.abstol);
+    if (!CheckCVodeFlag(cv_flag))
+    {
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    cv_flag = CVodeSetUserData(mr->cvode_mem, pihm);
+    if (!CheckCVodeFlag(cv_flag))
+    {
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    cv_flag = CVodeSetInitStep(mr->cvode_mem, (realtype)pihm->ctrl.initstep);
+    if (!CheckCVodeFlag(cv_flag))
+    {
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    cv_flag = CVodeSetStabLimDet(mr->cvode_mem, TRUE);
+    if (!CheckCVodeFlag(cv_flag))
+    {
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    cv_flag = CVodeSetMaxStep(mr->cvode_mem, (realtype)pihm->stepctrl.maxstep);
+    if (!CheckCVodeFlag(cv_flag))
+    {
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    cv_flag = CVodeSetMaxNumSteps(mr->cvode_mem, pihm->ctrl.stepsize * 10);
+    if (!CheckCVodeFlag(cv_flag))
+    {
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    if (mr->ncolor > 0)
+    {
+        cv_flag = CVSpgmr(mr->cvode_mem, PREC_LEFT, 0);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        cv_flag = CVSpilsSetPreconditioner(mr->cvode_mem, FastPrecSetup,
+            FastPrecSolve);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+    }
+    else
+    {
+        cv_flag = CVSpgmr(mr->cvode_mem, PREC_NONE, 0);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+    }
+}
+
+int FastPrecSetup(realtype t, N_Vector CV_Y, N_Vector fy, booleantype jok,
+    booleantype *jcurPtr, realtype gamma, void *pihm_data, N_Vector tmp1,
+    N_Vector tmp2, N_Vector tmp3)
+{
+    /*
+     * Jacobi preconditioner of the fast subsystem. Surface water of element i
+     * and river stage of river segment i are the (i)th and (nelem + i)th
+     * state variables of the fast subsystem, i.e., the state variables of
+     * graph nodes. Accumulated exchange does not affect the RHS and is not
+     * preconditioned
+     */
+    int             i;
+    int             failed = 0;
+    pihm_struct     pihm;
+    multirate_struct *mr;
+
+    pihm = (pihm_struct)pihm_data;
+    mr = &pihm->multirate;
+
+    if (jok)
+    {
+        /* Reuse saved Jacobian diagonal */
+        *jcurPtr = FALSE;
+    }
+    else
+    {
+        int             c;
+        double         *y;
+        double         *f0;
+        double         *ytmp;
+        double         *ftmp;
+        double         *inc;
+        double          srur;
+
+        y = NV_DATA(CV_Y);
+        f0 = NV_DATA(fy);
+        ytmp = NV_DATA(tmp1);
+        ftmp = NV_DATA(tmp2);
+        inc = NV_DATA(tmp3);
+
+        srur = sqrt(UNIT_ROUNDOFF);
+
+        N_VScale(1.0, CV_Y, tmp1);
+
+        for (c = 0; c < mr->ncolor; c++)
+        {
+            for (i = mr->colorptr[c]; i < mr->colorptr[c + 1]; i++)
+            {
+                int             node;
+
+                node = mr->colornode[i];
+                inc[node] = srur * ((fabs(y[node]) > pihm->ctrl.abstol) ?
+                    fabs(y[node]) : pihm->ctrl.abstol);
+                ytmp[node] = y[node] + inc[node];
+            }
+
+            FastOde(t, tmp1, tmp2, pihm);
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+            for (i = mr->colorptr[c]; i < mr->colorptr[c + 1]; i++)
+            {
+                int             node;
+
+                node = mr->colornode[i];
+                mr->jac[node] = (ftmp[node] - f0[node]) / inc[node];
+                ytmp[node] = y[node];
+            }
+        }
+
+        /* Restore model fluxes at the unperturbed state */
+        FastOde(t, CV_Y, tmp2, pihm);
+
+        *jcurPtr = TRUE;
+    }
+
+    /* Form P = I - gamma * J */
+#if defined(_OPENMP)
+# pragma omp parallel for reduction(+:failed)
+#endif
+    for (i = 0; i < nelem + nriver; i++)
+    {
+        mr->pdiag[i] = 1.0 - gamma * mr->jac[i];
+        failed += (mr->pdiag[i] == 0.0);
+    }
+
+    /* A positive return value tells CVODE the failure is recoverable */
+    return (failed > 0) ? 1 : 0;
+}
+
+int FastPrecSolve(realtype t, N_Vector CV_Y, N_Vector fy, N_Vector r,
+    N_Vector z, realtype gamma, realtype delta, int lr, void *pihm_data,
+    N_Vector tmp)
+{
+    int             i;
+    double         *zdata;
+    const multirate_struct *mr;
+
+    /* The diagonal of P is formed by FastPrecSetup */
+    (void)t;
+    (void)CV_Y;
+    (void)fy;
+    (void)gamma;
+    (void)delta;
+    (void)lr;
+    (void)tmp;
+
+    mr = &((pihm_struct)pihm_data)->multirate;
+
+    N_VScale(1.0, r, z);
+
+    zdata = NV_DATA(z);
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem + nriver; i++)
+    {
+        zdata[i] /= mr->pdiag[i];
+    }
+
+    return 0;
+}
+
+void SolveMultiRate(pihm_struct pihm, int *t, double cputime,
+    void *cvode_mem, N_Vector CV_Y)
+{
+    multirate_struct *mr;
+    ctrl_struct    *ctrl;
+    double         *y;
+    double         *yf;
+    int             i;
+
+    mr = &pihm->multirate;
+    ctrl = &pihm->ctrl;
+    y = NV_DATA(CV_Y);
+    yf = NV_DATA(mr->y);
+
+    if (ctrl->cstep % ctrl->multirate == 0)
+    {
+        /* Beginning of slow step. Slow state variables are frozen in the
+         * fast subsystem until the end of slow step */
+        mr->kend = ctrl->cstep + ctrl->multirate;
+        mr->kend = (mr->kend < ctrl->nstep) ? mr->kend : ctrl->nstep;
+
+        memcpy(mr->y0, y, NumStateVar() * sizeof(double));
+
+        mr->strg0 = MultiRateStorage(&pihm->hydro.elem, &pihm->hydro.river,
+            y);
+        mr->netin = 0.0;
+        mr->discharge0 = yf[FAST_DISCHARGE];
+    }
+
+    /* Precipitation and evapotranspiration are constant over model steps */
+    for (i = 0; i < nelem; i++)
+    {
+        mr->netin += (pihm->hydro.elem.pcpdrp[i] - pihm->hydro.elem.edir[i] -
+            pihm->hydro.elem.ett[i]) * pihm->hydro.elem.area[i] *
+            (double)(ctrl->tout[ctrl->cstep + 1] - ctrl->tout[ctrl->cstep]);
+    }
+
+    /*
+     * Advance the fast subsystem over the model step
+     */
+    SolveCVode(ctrl->starttime, t, ctrl->tout[ctrl->cstep + 1],
+        ctrl->tout[ctrl->cstep + 1], cputime, &pihm->stepctrl, mr->cvode_mem,
+        mr->y);
+
+    if (ctrl->cstep + 1 == mr->kend)
+    {
+        realtype        solvert;
+        realtype        tout;
+        realtype        hlast;
+        double          dt;
+        int             cv_flag;
+
+        /*
+         * Advance the slow subsystem over the slow step. Exchange accumulated
+         * by the fast subsystem over the slow step is applied at a constant
+         * rate, so that water leaving one subsystem enters the other
+         */
+        dt = (double)(ctrl->tout[mr->kend] -
+            ctrl->tout[(mr->kend - 1) / ctrl->multirate * ctrl->multirate]);
+
+        for (i = FAST_UNSAT(0); i < FAST_DISCHARGE; i++)
+        {
+            mr->xrate[i] = (yf[i] - mr->acc0[i]) / dt;
+            mr->acc0[i] = yf[i];
+        }
+
+        /* The slow subsystem is restarted at every slow step. Otherwise the
+         * solver history mixes exchange rates of different slow steps, and
+         * water is not conserved */
+        cv_flag = CVodeReInit(cvode_mem, (realtype)(ctrl->tout[mr->kend] -
+            ctrl->starttime - dt), CV_Y);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        tout = (realtype)(ctrl->tout[mr->kend] - ctrl->starttime);
+
+        cv_flag = CVodeSetStopTime(cvode_mem, tout);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        cv_flag = CVode(cvode_mem, tout, CV_Y, &solvert, CV_NORMAL);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        /* Restart the next slow step with the last internal step */
+        CVodeGetLastStep(cvode_mem, &hlast);
+        CVodeSetInitStep(cvode_mem, hlast);
+    }
+
+    /* Subsurface flux of elements across river edges includes flux to river
+     * channels (fast subsystem) and flux to aquifers beneath river segments
+     * (slow subsystem) */
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        MultiRateRiverEdge(&pihm->hydro.elem, &pihm->hydro.river, i);
+    }
+
+    /*
+     * Copy fast state variables to model state variables
+     */
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        y[SURF(i)] = yf[FAST_SURF(i)];
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        y[RIVSTG(i)] = yf[FAST_RIVSTG(i)];
+    }
+
+    if (ctrl->cstep + 1 == mr->kend)
+    {
+        double          error;
+
+        /*
+         * Conservation check. Change of water storage over the slow step
+         * should be balanced by precipitation, evapotranspiration, and
+         * outlet discharge
+         */
+        error = MultiRateStorage(&pihm->hydro.elem, &pihm->hydro.river, y) -
+            mr->strg0 - mr->netin + (yf[FAST_DISCHARGE] - mr->discharge0);
+
+        mr->wb_error += error;
+        mr->discharge += yf[FAST_DISCHARGE] - mr->discharge0;
+
+        PIHMprintf(VL_VERBOSE, " Multi-rate water balance error %lg m3\n",
+            error);
+    }
+}
+
+double MultiRateStorage(const hydro_elem_struct *elem,
+    const hydro_river_struct *river, const double *y)
+{
+    int             i;
+    double          strg = 0.0;
+
+    for (i = 0; i < nelem; i++)
+    {
+        strg += (y[SURF(i)] + (y[UNSAT(i)] + y[GW(i)]) * elem->porosity[i]) *
+            elem->area[i];
+#if defined(_FBR_)
+        strg += (y[FBRUNSAT(i)] + y[FBRGW(i)]) * elem->geol_porosity[i] *
+            elem->area[i];
+#endif
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        strg += (y[RIVSTG(i)] + y[RIVGW(i)] * river->porosity[i]) *
+            river->area[i];
+    }
+
+    return strg;
+}
+
+void MultiRateRiverEdge(hydro_elem_struct *elem,
+    const hydro_river_struct *river, int i)
+{
+    int             j;
+
+    for (j = 0; j < NUM_EDGE; j++)
+    {
+        if (river->leftele[i] > 0 &&
+            elem->nabr[river->leftele[i] - 1][j] == -(i + 1))
+        {
+            elem->subsurf[river->leftele[i] - 1][j] =
+                -(river->rivflow[i][LEFT_AQUIF2CHANL] +
+                river->rivflow[i][LEFT_AQUIF2AQUIF]);
+        }
+
+        if (river->rightele[i] > 0 &&
+            elem->nabr[river->rightele[i] - 1][j] == -(i + 1))
+        {
+            elem->subsurf[river->rightele[i] - 1][j] =
+                -(river->rivflow[i][RIGHT_AQUIF2CHANL] +
+                river->rivflow[i][RIGHT_AQUIF2AQUIF]);
+        }
+    }
+}
+
+int FastOde(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
+{
+    /*
+     * RHS of the fast subsystem. Slow state variables are frozen at the
+     * beginning of slow step. Fluxes between the two subsystems and
+     * evapotranspiration from slow state variables are accumulated in the
+     * last components of the fast subsystem
+     */
+    int             i;
+    double         *y;
+    double         *dy;
+    const double   *y0;
+    pihm_struct     pihm;
+    hydro_elem_struct *elem;
+    hydro_river_struct *river;
+
+    y = NV_DATA(CV_Y);
+    dy = NV_DATA(CV_Ydot);
+    pihm = (pihm_struct)pihm_data;
+    elem = &pihm->hydro.elem;
+    river = &pihm->hydro.river;
+    y0 = pihm->multirate.y0;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        elem->surf[i] = (y[FAST_SURF(i)] >= 0.0) ? y[FAST_SURF(i)] : 0.0;
+        elem->unsat[i] = (y0[UNSAT(i)] >= 0.0) ? y0[UNSAT(i)] : 0.0;
+        elem->gw[i] = (y0[GW(i)] >= 0.0) ? y0[GW(i)] : 0.0;
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        river->stage[i] =
+            (y[FAST_RIVSTG(i)] >= 0.0) ? y[FAST_RIVSTG(i)] : 0.0;
+        river->gw[i] = (y0[RIVGW(i)] >= 0.0) ? y0[RIVGW(i)] : 0.0;
+
+        river->rivflow[i][UP_CHANL2CHANL] = 0.0;
+    }
+
+    FastHydrol(elem, river, &pihm->ctrl);
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        FastElemRhs(elem, i, (double)t, dy);
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        FastRiverRhs(river, i, (double)t, dy);
+    }
+
+    /* Outlet discharge is accumulated for the conservation check */
+    dy[FAST_DISCHARGE] = 0.0;
+    for (i = 0; i < nriver; i++)
+    {
+        dy[FAST_DISCHARGE] += (river->down[i] < 0) ?
+            river->rivflow[i][DOWN_CHANL2CHANL] : 0.0;
+    }
+
+    return 0;
+}
+
+int SlowOde(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
+{
+    /*
+     * RHS of the slow subsystem. Surface water and river stage are constant
+     * in the slow subsystem
+     */
+    int             i;
+    double         *y;
+    double         *dy;
+    pihm_struct     pihm;
+    hydro_elem_struct *elem;
+    hydro_river_struct *river;
+
+    y = NV_DATA(CV_Y);
+    dy = NV_DATA(CV_Ydot);
+    pihm = (pihm_struct)pihm_data;
+    elem = &pihm->hydro.elem;
+    river = &pihm->hydro.river;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        elem->unsat[i] = (y[UNSAT(i)] >= 0.0) ? y[UNSAT(i)] : 0.0;
+        elem->gw[i] = (y[GW(i)] >= 0.0) ? y[GW(i)] : 0.0;
+#if defined(_FBR_)
+        elem->fbr_unsat[i] = (y[FBRUNSAT(i)] >= 0.0) ? y[FBRUNSAT(i)] : 0.0;
+        elem->fbr_gw[i] = (y[FBRGW(i)] >= 0.0) ? y[FBRGW(i)] : 0.0;
+#endif
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        river->gw[i] = (y[RIVGW(i)] >= 0.0) ? y[RIVGW(i)] : 0.0;
+
+        river->rivflow[i][UP_AQUIF2AQUIF] = 0.0;
+    }
+
+    SlowHydrol(elem, river, pihm->multirate.xrate);
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        SlowElemRhs(elem, i, (double)t, pihm->multirate.xrate, dy);
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        SlowRiverRhs(river, i, (double)t, pihm->multirate.xrate, dy);
+    }
+
+    return 0;
+}
+
+void FastHydrol(hydro_elem_struct *elem, hydro_river_struct *river,
+    const ctrl_struct *ctrl)
+{
+    /*
+     * Same as Hydrol, but only fluxes of surface water and river channels,
+     * and evapotranspiration, are calculated
+     */
+    int             i;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        /* Calculate actual surface water depth */
+        elem->surfh[i] = SurfH(elem->surf[i]);
+    }
+
+    /* Determine which layers does ET extract water from */
+    EtExtract(elem);
+
+    FrictSlope(elem, river, ctrl->surf_mode, elem->dhbydx, elem->dhbydy);
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < elem->nface; i++)
+    {
+        SurfFlowFace(elem, i, ctrl->surf_mode);
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        elem->infil[i] = Infil(elem, i, (double)ctrl->stepsize);
+#if defined(_NOAH_)
+        elem->infil[i] *= elem->fcr[i];
+#endif
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        RiverSegFastFlow(elem, river, i, ctrl->riv_mode);
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        int             k;
+
+        for (k = river->up_start[i]; k < river->up_start[i + 1]; k++)
+        {
+            river->rivflow[i][UP_CHANL2CHANL] -=
+                river->rivflow[river->up[k]][DOWN_CHANL2CHANL];
+        }
+    }
+}
+
+void SlowHydrol(hydro_elem_struct *elem, hydro_river_struct *river,
+    const double *xrate)
+{
+    /*
+     * Same as Hydrol, but only fluxes between slow state variables are
+     * calculated
+     */
+    int             i;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < elem->nface; i++)
+    {
+        SubFlowFace(elem, i);
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+#if defined(_FBR_)
+        FbrLateralFlowElem(elem, i);
+#endif
+
+        /* Near saturation, water entering the unsaturated zone recharges
+         * groundwater directly */
+        elem->rechg[i] = (elem->gw[i] > elem->depth[i] - elem->dinf[i]) ?
+            xrate[FAST_UNSAT(i)] * elem->porosity[i] : Recharge(elem, i);
+
+#if defined(_FBR_)
+        elem->fbr_infil[i] = FbrInfil(elem, i);
+        elem->fbr_rechg[i] = FbrRecharge(elem, i);
+#endif
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        RiverSegSlowFlow(elem, river, i);
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        int             k;
+
+        for (k = river->up_start[i]; k < river->up_start[i + 1]; k++)
+        {
+            river->rivflow[i][UP_AQUIF2AQUIF] -=
+                river->rivflow[river->up[k]][DOWN_AQUIF2AQUIF];
+        }
+    }
+}
+
+void FastElemRhs(const hydro_elem_struct *elem, int i, double t, double *dy)
+{
+    int             j;
+
+    dy[FAST_SURF(i)] = elem->pcpdrp[i] - elem->infil[i] - elem->edir_surf[i];
+    dy[FAST_UNSAT(i)] = elem->infil[i] - elem->edir_unsat[i] -
+        elem->ett_unsat[i];
+    dy[FAST_GW(i)] = -elem->edir_gw[i] - elem->ett_gw[i];
+
+    for (j = 0; j < NUM_EDGE; j++)
+    {
+        dy[FAST_SURF(i)] -= elem->ovlflow[i][j] / elem->area[i];
+
+        /* Subsurface flux to river channels is accumulated for groundwater */
+        if (elem->nabr[i][j] < 0)
+        {
+            dy[FAST_GW(i)] -= elem->subsurf[i][j] / elem->area[i];
+        }
+    }
+
+    dy[FAST_UNSAT(i)] /= elem->porosity[i];
+    dy[FAST_GW(i)] /= elem->porosity[i];
+
+    /* Check NAN errors for dy */
+    CheckDy(dy[FAST_SURF(i)], "element", "surface water", i + 1, t);
+}
+
+void FastRiverRhs(const hydro_river_struct *river, int i, double t,
+    double *dy)
+{
+    int             j;
+
+    dy[FAST_RIVSTG(i)] = 0.0;
+    for (j = 0; j <= 6; j++)
+    {
+        dy[FAST_RIVSTG(i)] -= river->rivflow[i][j] / river->area[i];
+    }
+
+    /* Channel flux to and from elements and channel leakage are accumulated
+     * for the aquifers */
+    dy[FAST_RIVGW(i)] = river->rivflow[i][CHANL_LKG] /
+        (river->porosity[i] * river->area[i]);
+
+    CheckDy(dy[FAST_RIVSTG(i)], "river", "stage", i + 1, t);
+}
+
+void SlowElemRhs(const hydro_elem_struct *elem, int i, double t,
+    const double *xrate, double *dy)
+{
+    int             j;
+
+    dy[SURF(i)] = 0.0;
+    dy[UNSAT(i)] = -elem->rechg[i];
+    dy[GW(i)] = elem->rechg[i];
+
+#if defined(_FBR_)
+    dy[GW(i)] -= elem->fbr_infil[i];
+
+    dy[FBRUNSAT(i)] = elem->fbr_infil[i] - elem->fbr_rechg[i];
+    dy[FBRGW(i)] = elem->fbr_rechg[i];
+#endif
+
+    for (j = 0; j < NUM_EDGE; j++)
+    {
+        dy[GW(i)] -= elem->subsurf[i][j] / elem->area[i];
+#if defined(_FBR_)
+        dy[FBRGW(i)] -= elem->fbrflow[i][j] / elem->area[i];
+#endif
+    }
+
+    dy[UNSAT(i)] = dy[UNSAT(i)] / elem->porosity[i] + xrate[FAST_UNSAT(i)];
+    dy[GW(i)] = dy[GW(i)] / elem->porosity[i] + xrate[FAST_GW(i)];
+#if defined(_FBR_)
+    dy[FBRUNSAT(i)] /= elem->geol_porosity[i];
+    dy[FBRGW(i)] /= elem->geol_porosity[i];
+#endif
+
+    /* Check NAN errors for dy */
+    CheckDy(dy[UNSAT(i)], "element", "unsat water", i + 1, t);
+    CheckDy(dy[GW(i)], "element", "groundwater", i + 1, t);
+#if defined(_FBR_)
+    CheckDy(dy[FBRUNSAT(i)], "element", "fbr unsat", i + 1, t);
+    CheckDy(dy[FBRGW(i)], "element", "fbr groundwater", i + 1, t);
+#endif
+}
+
+void SlowRiverRhs(const hydro_river_struct *river, int i, double t,
+    const double *xrate, double *dy)
+{
+    dy[RIVSTG(i)] = 0.0;
+
+    dy[RIVGW(i)] = -(river->rivflow[i][LEFT_AQUIF2AQUIF] +
+        river->rivflow[i][RIGHT_AQUIF2AQUIF] +
+        river->rivflow[i][DOWN_AQUIF2AQUIF] +
+        river->rivflow[i][UP_AQUIF2AQUIF]) /
+        (river->porosity[i] * river->area[i]) + xrate[FAST_RIVGW(i)];
+
+    CheckDy(dy[RIVGW(i)], "river", "groundwater", i + 1, t);
+}
+
+void FreeMultiRate(multirate_struct *mr)
+{
+    if (mr->ncolor > 0)
+    {
+        free(mr->colorptr);
+        free(mr->colornode);
+        free(mr->jac);
+        free(mr->pdiag);
+    }
+
+    N_VDestroy(mr->y);
+    CVodeFree(&mr->cvode_mem);
+
+    free(mr->y0);
+    free(mr->acc0);
+    free(mr->xrate);
+}
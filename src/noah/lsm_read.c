@@ -145,6 +145,20 @@ void ReadRad(const char *filename, forc_struct *forc)
     char            cmdstr[MAXSTRING];
     int             lno = 0;
 
+    if (ReadBinTs(filename, 2, &forc->nrad, &forc->rad, &forc->rad_map))
+    {
+        if (forc->nrad != forc->nmeteo)
+        {
+            PIHMprintf(VL_ERROR,
+                "The number of radiation forcing time series should be the "
+                "same as the number of meteorological forcing time series.\n");
+            PIHMprintf(VL_ERROR, "Error in %s.bin.\n", filename);
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        return;
+    }
+
     rad_file = fopen(filename, "r");
     CheckFile(rad_file, filename);
     PIHMprintf(VL_VERBOSE, " Reading %s\n", filename);
@@ -195,14 +209,15 @@ void ReadRad(const char *filename, forc_struct *forc)
         NextLine(rad_file, cmdstr, &lno);
         NextLine(rad_file, cmdstr, &lno);
 
+        forc->rad[i].cursor = 0;
         forc->rad[i].ftime = (int *)malloc(forc->rad[i].length * sizeof(int));
         forc->rad[i].data =
-            (double **)malloc(forc->rad[i].length * sizeof(double *));
+            (double *)malloc(forc->rad[i].length * 2 * sizeof(double));
         for (j = 0; j < forc->rad[i].length; j++)
         {
-            forc->rad[i].data[j] = (double *)malloc(2 * sizeof(double));
             NextLine(rad_file, cmdstr, &lno);
-            ReadTS(cmdstr, &forc->rad[i].ftime[j], &forc->rad[i].data[j][0], 2);
+            ReadTS(cmdstr, &forc->rad[i].ftime[j], &forc->rad[i].data[j * 2],
+                2);
         }
     }
 
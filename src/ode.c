@@ -1,16 +1,57 @@
 #include "pihm.h"
 
+#if defined(_FUSED_RHS_) && (defined(_BGC_) || defined(_CYCLES_))
+# error "The fused RHS kernel does not support nitrogen transport."
+#endif
+
 int ODE(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
 {
+#if !defined(_FUSED_RHS_)
     int             i;
+#endif
     double         *y;
     double         *dy;
     pihm_struct     pihm;
+    hydro_elem_struct *elem;
+    hydro_river_struct *river;
+#if defined(_OPENMP)
+    double          start_omp = 0.0;
+#else
+    clock_t         start = 0;
+#endif
+#if defined(_DEBUG_)
+    long int        nalloc;
+
+    nalloc = AllocCount();
+#endif
+
+    if (((pihm_struct)pihm_data)->ctrl.multirate > 0)
+    {
+        /* Slow subsystem of multi-rate integration */
+        return SlowOde(t, CV_Y, CV_Ydot, pihm_data);
+    }
+
+    if (benchmark > 0)
+    {
+#if defined(_OPENMP)
+        start_omp = omp_get_wtime();
+#else
+        start = clock();
+#endif
+    }
 
     y = NV_DATA(CV_Y);
     dy = NV_DATA(CV_Ydot);
     pihm = (pihm_struct)pihm_data;
+    elem = &pihm->hydro.elem;
+    river = &pihm->hydro.river;
 
+#if defined(_FUSED_RHS_)
+    /*
+     * Fused RHS kernel
+     */
+    FusedRhs((double)t, y, dy, elem, river, &pihm->ctrl);
+#else
     /*
      * Initialization of RHS of ODEs
      */
@@ -24,27 +65,23 @@ int ODE(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
 #endif
     for (i = 0; i < nelem; i++)
     {
-        elem_struct    *elem;
-
-        elem = &pihm->elem[i];
-
-        elem->ws.surf = (y[SURF(i)] >= 0.0) ? y[SURF(i)] : 0.0;
-        elem->ws.unsat = (y[UNSAT(i)] >= 0.0) ? y[UNSAT(i)] : 0.0;
-        elem->ws.gw = (y[GW(i)] >= 0.0) ? y[GW(i)] : 0.0;
+        elem->surf[i] = (y[SURF(i)] >= 0.0) ? y[SURF(i)] : 0.0;
+        elem->unsat[i] = (y[UNSAT(i)] >= 0.0) ? y[UNSAT(i)] : 0.0;
+        elem->gw[i] = (y[GW(i)] >= 0.0) ? y[GW(i)] : 0.0;
 
 #if defined(_FBR_)
-        elem->ws.fbr_unsat = (y[FBRUNSAT(i)] >= 0.0) ? y[FBRUNSAT(i)] : 0.0;
-        elem->ws.fbr_gw = (y[FBRGW(i)] >= 0.0) ? y[FBRGW(i)] : 0.0;
+        elem->fbr_unsat[i] = (y[FBRUNSAT(i)] >= 0.0) ? y[FBRUNSAT(i)] : 0.0;
+        elem->fbr_gw[i] = (y[FBRGW(i)] >= 0.0) ? y[FBRGW(i)] : 0.0;
 #endif
 
 #if defined(_BGC_) && !defined(_LUMPED_)
-        elem->ns.surfn = (y[SURFN(i)] >= 0.0) ? y[SURFN(i)] : 0.0;
-        elem->ns.sminn = (y[SMINN(i)] >= 0.0) ? y[SMINN(i)] : 0.0;
+        pihm->elem[i].ns.surfn = (y[SURFN(i)] >= 0.0) ? y[SURFN(i)] : 0.0;
+        pihm->elem[i].ns.sminn = (y[SMINN(i)] >= 0.0) ? y[SMINN(i)] : 0.0;
 #endif
 
 #if defined(_CYCLES_)
-        elem->np.no3 = (y[NO3(i)] >= 0.0) ? y[NO3(i)] : 0.0;
-        elem->np.nh4 = (y[NH4(i)] >= 0.0) ? y[NH4(i)] : 0.0;
+        pihm->elem[i].np.no3 = (y[NO3(i)] >= 0.0) ? y[NO3(i)] : 0.0;
+        pihm->elem[i].np.nh4 = (y[NH4(i)] >= 0.0) ? y[NH4(i)] : 0.0;
 #endif
     }
 
@@ -58,25 +95,28 @@ int ODE(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
 #endif
     for (i = 0; i < nriver; i++)
     {
-        river_struct   *river;
-        river = &pihm->river[i];
-
-        river->ws.stage = (y[RIVSTG(i)] >= 0.0) ? y[RIVSTG(i)] : 0.0;
-        river->ws.gw = (y[RIVGW(i)] >= 0.0) ? y[RIVGW(i)] : 0.0;
+        river->stage[i] = (y[RIVSTG(i)] >= 0.0) ? y[RIVSTG(i)] : 0.0;
+        river->gw[i] = (y[RIVGW(i)] >= 0.0) ? y[RIVGW(i)] : 0.0;
 
 #if defined(_BGC_) && !defined(_LUMPED_) && !defined(_LEACHING_)
-        river->ns.streamn = (y[STREAMN(i)] >= 0.0) ? y[STREAMN(i)] : 0.0;
-        river->ns.sminn = (y[RIVBEDN(i)] >= 0.0) ? y[RIVBEDN(i)] : 0.0;
+        pihm->river[i].ns.streamn =
+            (y[STREAMN(i)] >= 0.0) ? y[STREAMN(i)] : 0.0;
+        pihm->river[i].ns.sminn = (y[RIVBEDN(i)] >= 0.0) ? y[RIVBEDN(i)] : 0.0;
 #endif
 
-        river->wf.rivflow[UP_CHANL2CHANL] = 0.0;
-        river->wf.rivflow[UP_AQUIF2AQUIF] = 0.0;
+        river->rivflow[i][UP_CHANL2CHANL] = 0.0;
+        river->rivflow[i][UP_AQUIF2AQUIF] = 0.0;
     }
 
     /*
      * PIHM Hydrology fluxes
      */
-    Hydrol(pihm->elem, pihm->river, &pihm->ctrl);
+    Hydrol(elem, river, &pihm->ctrl);
+
+#if defined(_BGC_) || defined(_CYCLES_)
+    /* Nitrogen transport uses water states and fluxes in model structures */
+    HydroToElem(&pihm->hydro, pihm->elem, pihm->river);
+#endif
 
 #if defined(_BGC_)
     /*
@@ -107,78 +147,37 @@ int ODE(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
 #endif
     for (i = 0; i < nelem; i++)
     {
+#if (defined(_BGC_) && !defined(_LUMPED_)) || defined(_CYCLES_)
         int             j;
-        elem_struct    *elem;
-
-        elem = &pihm->elem[i];
-
-        /*
-         * Vertical water fluxes for surface and subsurface
-         */
-        dy[SURF(i)] += elem->wf.pcpdrp - elem->wf.infil - elem->wf.edir_surf;
-        dy[UNSAT(i)] += elem->wf.infil - elem->wf.rechg - elem->wf.edir_unsat -
-            elem->wf.ett_unsat;
-        dy[GW(i)] += elem->wf.rechg - elem->wf.edir_gw - elem->wf.ett_gw;
-
-#if defined(_FBR_)
-        /*
-         * Vertical water fluxes for fractured bedrock
-         */
-        dy[GW(i)] -= elem->wf.fbr_infil;
-
-        dy[FBRUNSAT(i)] += elem->wf.fbr_infil - elem->wf.fbr_rechg;
-        dy[FBRGW(i)] += elem->wf.fbr_rechg;
 #endif
 
         /*
-         * Horizontal water fluxes
+         * Water fluxes
          */
-        for (j = 0; j < NUM_EDGE; j++)
-        {
-            dy[SURF(i)] -= elem->wf.ovlflow[j] / elem->topo.area;
-            dy[GW(i)] -= elem->wf.subsurf[j] / elem->topo.area;
-#if defined(_FBR_)
-            dy[FBRGW(i)] -= elem->wf.fbrflow[j] / elem->topo.area;
-#endif
-        }
-
-        dy[UNSAT(i)] /= elem->soil.porosity;
-        dy[GW(i)] /= elem->soil.porosity;
-#if defined(_FBR_)
-        dy[FBRUNSAT(i)] /= elem->geol.porosity;
-        dy[FBRGW(i)] /= elem->geol.porosity;
-#endif
-
-        /* Check NAN errors for dy */
-        CheckDy(dy[SURF(i)], "element", "surface water", i + 1, (double)t);
-        CheckDy(dy[UNSAT(i)], "element", "unsat water", i + 1, (double)t);
-        CheckDy(dy[GW(i)], "element", "groundwater", i + 1, (double)t);
-#if defined(_FBR_)
-        CheckDy(dy[FBRUNSAT(i)], "element", "fbr unsat", i + 1, (double)t);
-        CheckDy(dy[FBRGW(i)], "element", "fbr groundwater", i + 1, (double)t);
-#endif
+        ElemRhs(elem, i, (double)t, dy);
 
 #if defined(_BGC_) && !defined(_LUMPED_)
 # if !defined(_LEACHING_)
         /*
          * BGC N transport fluxes
          */
-        dy[SURFN(i)] +=
-            (elem->nf.ndep_to_sminn + elem->nf.nfix_to_sminn) / DAYINSEC -
-            elem->nsol.infilflux;
-        dy[SMINN(i)] += elem->nsol.infilflux + elem->nsol.snksrc;
+        dy[SURFN(i)] += (pihm->elem[i].nf.ndep_to_sminn +
+            pihm->elem[i].nf.nfix_to_sminn) / DAYINSEC -
+            pihm->elem[i].nsol.infilflux;
+        dy[SMINN(i)] += pihm->elem[i].nsol.infilflux +
+            pihm->elem[i].nsol.snksrc;
 # else
-        dy[SMINN(i)] +=
-            (elem->nf.ndep_to_sminn + elem->nf.nfix_to_sminn) / DAYINSEC +
-            elem->nsol.snksrc;
+        dy[SMINN(i)] += (pihm->elem[i].nf.ndep_to_sminn +
+            pihm->elem[i].nf.nfix_to_sminn) / DAYINSEC +
+            pihm->elem[i].nsol.snksrc;
 # endif
 
         for (j = 0; j < NUM_EDGE; j++)
         {
 # if !defined(_LEACHING_)
-            dy[SURFN(i)] -= elem->nsol.ovlflux[j] / elem->topo.area;
+            dy[SURFN(i)] -= pihm->elem[i].nsol.ovlflux[j] / elem->area[i];
 # endif
-            dy[SMINN(i)] -= elem->nsol.subflux[j] / elem->topo.area;
+            dy[SMINN(i)] -= pihm->elem[i].nsol.subflux[j] / elem->area[i];
         }
 
         /* Check NAN errors for dy */
@@ -190,13 +189,13 @@ int ODE(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
         /*
          * Cycles NO3 and NH4 transport fluxes
          */
-        dy[NO3(i)] += elem->no3sol.snksrc / DAYINSEC;
-        dy[NH4(i)] += elem->nh4sol.snksrc / DAYINSEC;
+        dy[NO3(i)] += pihm->elem[i].no3sol.snksrc / DAYINSEC;
+        dy[NH4(i)] += pihm->elem[i].nh4sol.snksrc / DAYINSEC;
 
         for (j = 0; j < NUM_EDGE; j++)
         {
-            dy[NO3(i)] -= elem->no3sol.flux[j] / elem->topo.area;
-            dy[NH4(i)] -= elem->nh4sol.flux[j] / elem->topo.area;
+            dy[NO3(i)] -= pihm->elem[i].no3sol.flux[j] / elem->area[i];
+            dy[NH4(i)] -= pihm->elem[i].nh4sol.flux[j] / elem->area[i];
         }
 
         /* Check NAN errors for dy */
@@ -206,13 +205,9 @@ int ODE(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
     }
 
 #if defined(_BGC_) && defined(_LUMPED_)
-    elem_struct    *elem;
-
-    elem = &pihm->elem[LUMPED];
-
-    dy[LUMPED_SMINN] +=
-        (elem->nf.ndep_to_sminn + elem->nf.nfix_to_sminn) / DAYINSEC +
-        elem->nsol.snksrc;
+    dy[LUMPED_SMINN] += (pihm->elem[LUMPED].nf.ndep_to_sminn +
+        pihm->elem[LUMPED].nf.nfix_to_sminn) / DAYINSEC +
+        pihm->elem[LUMPED].nsol.snksrc;
 
     /* Check NAN errors for dy */
     CheckDy(dy[LUMPED_SMINN], "lumped", "soil mineral N", LUMPED + 1,
@@ -227,42 +222,29 @@ int ODE(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
 #endif
     for (i = 0; i < nriver; i++)
     {
+#if (defined(_BGC_) && !defined(_LUMPED_) && !defined(_LEACHING_)) || \
+    defined(_CYCLES_)
         int             j;
-        river_struct   *river;
-
-        river = &(pihm->river[i]);
-
-        for (j = 0; j <= 6; j++)
-        {
-            /* Note the limitation due to
-             * d(v) / dt = a * dy / dt + y * da / dt
-             * for cs other than rectangle */
-            dy[RIVSTG(i)] -= river->wf.rivflow[j] / river->topo.area;
-        }
-
-        dy[RIVGW(i)] += -river->wf.rivflow[LEFT_AQUIF2AQUIF] -
-            river->wf.rivflow[RIGHT_AQUIF2AQUIF] -
-            river->wf.rivflow[DOWN_AQUIF2AQUIF] -
-            river->wf.rivflow[UP_AQUIF2AQUIF] + river->wf.rivflow[CHANL_LKG];
-
-        dy[RIVGW(i)] /= river->matl.porosity * river->topo.area;
+#endif
 
-        /* Check NAN errors for dy */
-        CheckDy(dy[RIVSTG(i)], "river", "stage", i + 1, (double)t);
-        CheckDy(dy[RIVGW(i)], "river", "groundwater", i + 1, (double)t);
+        /*
+         * Water fluxes
+         */
+        RiverRhs(river, i, (double)t, dy);
 
 #if defined(_BGC_) && !defined(_LUMPED_) && !defined(_LEACHING_)
         for (j = 0; j <= 6; j++)
         {
-            dy[STREAMN(i)] -= river->nsol.flux[j] / river->topo.area;
+            dy[STREAMN(i)] -= pihm->river[i].nsol.flux[j] / river->area[i];
         }
 
-        dy[RIVBEDN(i)] += -river->nsol.flux[LEFT_AQUIF2AQUIF] -
-            river->nsol.flux[RIGHT_AQUIF2AQUIF] -
-            river->nsol.flux[DOWN_AQUIF2AQUIF] -
-            river->nsol.flux[UP_AQUIF2AQUIF] + river->nsol.flux[CHANL_LKG];
+        dy[RIVBEDN(i)] += -pihm->river[i].nsol.flux[LEFT_AQUIF2AQUIF] -
+            pihm->river[i].nsol.flux[RIGHT_AQUIF2AQUIF] -
+            pihm->river[i].nsol.flux[DOWN_AQUIF2AQUIF] -
+            pihm->river[i].nsol.flux[UP_AQUIF2AQUIF] +
+            pihm->river[i].nsol.flux[CHANL_LKG];
 
-        dy[RIVBEDN(i)] /= river->topo.area;
+        dy[RIVBEDN(i)] /= river->area[i];
 
         /* Check NAN errors for dy */
         CheckDy(dy[STREAMN(i)], "river", "stream N", i + 1, (double)t);
@@ -272,33 +254,126 @@ int ODE(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
 #if defined(_CYCLES_)
         for (j = 0; j <= 6; j++)
         {
-            dy[STREAMNO3(i)] -= river->no3sol.flux[j] / river->topo.area;
-            dy[STREAMNH4(i)] -= river->nh4sol.flux[j] / river->topo.area;
+            dy[STREAMNO3(i)] -= pihm->river[i].no3sol.flux[j] / river->area[i];
+            dy[STREAMNH4(i)] -= pihm->river[i].nh4sol.flux[j] / river->area[i];
         }
 
-        dy[RIVBEDNO3(i)] += -river->no3sol.flux[LEFT_AQUIF2AQUIF] -
-            river->no3sol.flux[RIGHT_AQUIF2AQUIF] -
-            river->no3sol.flux[DOWN_AQUIF2AQUIF] -
-            river->no3sol.flux[UP_AQUIF2AQUIF] + river->no3sol.flux[CHANL_LKG];
-        dy[RIVBEDNH4(i)] += -river->nh4sol.flux[LEFT_AQUIF2AQUIF] -
-            river->nh4sol.flux[RIGHT_AQUIF2AQUIF] -
-            river->nh4sol.flux[DOWN_AQUIF2AQUIF] -
-            river->nh4sol.flux[UP_AQUIF2AQUIF] + river->nh4sol.flux[CHANL_LKG];
+        dy[RIVBEDNO3(i)] += -pihm->river[i].no3sol.flux[LEFT_AQUIF2AQUIF] -
+            pihm->river[i].no3sol.flux[RIGHT_AQUIF2AQUIF] -
+            pihm->river[i].no3sol.flux[DOWN_AQUIF2AQUIF] -
+            pihm->river[i].no3sol.flux[UP_AQUIF2AQUIF] +
+            pihm->river[i].no3sol.flux[CHANL_LKG];
+        dy[RIVBEDNH4(i)] += -pihm->river[i].nh4sol.flux[LEFT_AQUIF2AQUIF] -
+            pihm->river[i].nh4sol.flux[RIGHT_AQUIF2AQUIF] -
+            pihm->river[i].nh4sol.flux[DOWN_AQUIF2AQUIF] -
+            pihm->river[i].nh4sol.flux[UP_AQUIF2AQUIF] +
+            pihm->river[i].nh4sol.flux[CHANL_LKG];
 
-        dy[RIVBEDNO3(i)] /= river->topo.area;
-        dy[RIVBEDNH4(i)] /= river->topo.area;
+        dy[RIVBEDNO3(i)] /= river->area[i];
+        dy[RIVBEDNH4(i)] /= river->area[i];
 
         /* Check NAN errors for dy */
         CheckDy(dy[STREAMNO3(i)], "river", "stream NO3", i + 1, (double)t);
         CheckDy(dy[RIVBEDNO3(i)], "river", "bed NO3", i + 1, (double)t);
         CheckDy(dy[STREAMNH4(i)], "river", "stream NH4", i + 1, (double)t);
         CheckDy(dy[RIVBEDNH4(i)], "river", "bed NH4", i + 1, (double)t);
+#endif
+    }
+#endif
+
+#if defined(_DEBUG_)
+    pihm->allocstat.nrhs++;
+    pihm->allocstat.nalloc += AllocCount() - nalloc;
+#endif
+
+    if (benchmark > 0)
+    {
+        pihm->rhstime.nrhs++;
+#if defined(_OPENMP)
+        pihm->rhstime.elapsed += omp_get_wtime() - start_omp;
+#else
+        pihm->rhstime.elapsed += ((double)(clock() - start)) / CLOCKS_PER_SEC;
 #endif
     }
 
     return 0;
 }
 
+void ElemRhs(const hydro_elem_struct *elem, int i, double t, double *dy)
+{
+    int             j;
+
+    /*
+     * Vertical water fluxes for surface and subsurface
+     */
+    dy[SURF(i)] += elem->pcpdrp[i] - elem->infil[i] - elem->edir_surf[i];
+    dy[UNSAT(i)] += elem->infil[i] - elem->rechg[i] - elem->edir_unsat[i] -
+        elem->ett_unsat[i];
+    dy[GW(i)] += elem->rechg[i] - elem->edir_gw[i] - elem->ett_gw[i];
+
+#if defined(_FBR_)
+    /*
+     * Vertical water fluxes for fractured bedrock
+     */
+    dy[GW(i)] -= elem->fbr_infil[i];
+
+    dy[FBRUNSAT(i)] += elem->fbr_infil[i] - elem->fbr_rechg[i];
+    dy[FBRGW(i)] += elem->fbr_rechg[i];
+#endif
+
+    /*
+     * Horizontal water fluxes
+     */
+    for (j = 0; j < NUM_EDGE; j++)
+    {
+        dy[SURF(i)] -= elem->ovlflow[i][j] / elem->area[i];
+        dy[GW(i)] -= elem->subsurf[i][j] / elem->area[i];
+#if defined(_FBR_)
+        dy[FBRGW(i)] -= elem->fbrflow[i][j] / elem->area[i];
+#endif
+    }
+
+    dy[UNSAT(i)] /= elem->porosity[i];
+    dy[GW(i)] /= elem->porosity[i];
+#if defined(_FBR_)
+    dy[FBRUNSAT(i)] /= elem->geol_porosity[i];
+    dy[FBRGW(i)] /= elem->geol_porosity[i];
+#endif
+
+    /* Check NAN errors for dy */
+    CheckDy(dy[SURF(i)], "element", "surface water", i + 1, t);
+    CheckDy(dy[UNSAT(i)], "element", "unsat water", i + 1, t);
+    CheckDy(dy[GW(i)], "element", "groundwater", i + 1, t);
+#if defined(_FBR_)
+    CheckDy(dy[FBRUNSAT(i)], "element", "fbr unsat", i + 1, t);
+    CheckDy(dy[FBRGW(i)], "element", "fbr groundwater", i + 1, t);
+#endif
+}
+
+void RiverRhs(const hydro_river_struct *river, int i, double t, double *dy)
+{
+    int             j;
+
+    for (j = 0; j <= 6; j++)
+    {
+        /* Note the limitation due to
+         * d(v) / dt = a * dy / dt + y * da / dt
+         * for cs other than rectangle */
+        dy[RIVSTG(i)] -= river->rivflow[i][j] / river->area[i];
+    }
+
+    dy[RIVGW(i)] += -river->rivflow[i][LEFT_AQUIF2AQUIF] -
+        river->rivflow[i][RIGHT_AQUIF2AQUIF] -
+        river->rivflow[i][DOWN_AQUIF2AQUIF] -
+        river->rivflow[i][UP_AQUIF2AQUIF] + river->rivflow[i][CHANL_LKG];
+
+    dy[RIVGW(i)] /= river->porosity[i] * river->area[i];
+
+    /* Check NAN errors for dy */
+    CheckDy(dy[RIVSTG(i)], "river", "stage", i + 1, t);
+    CheckDy(dy[RIVGW(i)], "river", "groundwater", i + 1, t);
+}
+
 void CheckDy(double dy, const char *type, const char *varname, int ind,
     double t)
 {
@@ -340,15 +415,15 @@ int NumStateVar(void)
 void SetCVodeParam(pihm_struct pihm, void *cvode_mem, N_Vector CV_Y)
 {
     int             cv_flag;
-    static int      reset;
 #if defined(_BGC_) || defined(_CYCLES_)
     N_Vector        abstol;
     const double    SMINN_TOL = 1.0E-5;
 #endif
 
-    pihm->ctrl.maxstep = pihm->ctrl.stepsize;
+    InitStepCtrl(&pihm->ctrl, &pihm->stepctrl);
+    pihm->cpl.tevent = pihm->ctrl.starttime;
 
-    if (reset)
+    if (pihm->ctrl.cvode_init)
     {
         /* When model spins-up and recycles forcing, use CVodeReInit to reset
          * solver time, which does not allocates memory */
@@ -365,7 +440,7 @@ void SetCVodeParam(pihm_struct pihm, void *cvode_mem, N_Vector CV_Y)
         {
             PIHMexit(EXIT_FAILURE);
         }
-        reset = 1;
+        pihm->ctrl.cvode_init = 1;
     }
 
 #if defined(_BGC_) || defined(_CYCLES_)
@@ -411,69 +486,225 @@ void SetCVodeParam(pihm_struct pihm, void *cvode_mem, N_Vector CV_Y)
         PIHMexit(EXIT_FAILURE);
     }
 
-    cv_flag = CVodeSetMaxStep(cvode_mem, (realtype)pihm->ctrl.maxstep);
+    /* In multi-rate integration, the model CVODE instance solves the slow
+     * subsystem over slow steps */
+    cv_flag = CVodeSetMaxStep(cvode_mem, (pihm->ctrl.multirate > 0) ?
+        (realtype)(pihm->ctrl.multirate * pihm->ctrl.stepsize) :
+        (realtype)pihm->stepctrl.maxstep);
     if (!CheckCVodeFlag(cv_flag))
     {
         PIHMexit(EXIT_FAILURE);
     }
 
-    cv_flag = CVodeSetMaxNumSteps(cvode_mem, pihm->ctrl.stepsize * 10);
+    cv_flag = CVodeSetMaxNumSteps(cvode_mem, (pihm->ctrl.multirate > 0) ?
+        pihm->ctrl.multirate * pihm->ctrl.stepsize * 10 :
+        pihm->ctrl.stepsize * 10);
     if (!CheckCVodeFlag(cv_flag))
     {
         PIHMexit(EXIT_FAILURE);
     }
 
-    cv_flag = CVSpgmr(cvode_mem, PREC_NONE, 0);
-    if (!CheckCVodeFlag(cv_flag))
+    if (pihm->ctrl.multirate > 0)
     {
-        PIHMexit(EXIT_FAILURE);
+        SetFastCVodeParam(pihm, CV_Y);
+    }
+
+#if defined(_KLU_)
+    if (pihm->ctrl.lin_solver == KLU_SOLVER)
+    {
+        cv_flag = CVKLU(cvode_mem, NumStateVar(), pihm->jac.nnz, CSR_MAT);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        cv_flag = CVSlsSetSparseJacFn(cvode_mem, SparseJac);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        return;
+    }
+#endif
+
+    if (pihm->ctrl.precond == BLOCK_JACOBI)
+    {
+        cv_flag = CVSpgmr(cvode_mem, PREC_LEFT, 0);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        cv_flag = CVSpilsSetPreconditioner(cvode_mem, PrecSetup, PrecSolve);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+    }
+    else
+    {
+        cv_flag = CVSpgmr(cvode_mem, PREC_NONE, 0);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
     }
 }
 
+void FirstTouch(N_Vector y)
+{
+    int             i;
+
+    /* Initialize a newly allocated state vector using the same OpenMP
+     * partition of elements (river segments) as the RHS evaluation, so that
+     * memory pages are placed on the NUMA node of the threads using them */
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        NV_Ith(y, SURF(i)) = 0.0;
+        NV_Ith(y, UNSAT(i)) = 0.0;
+        NV_Ith(y, GW(i)) = 0.0;
+#if defined(_FBR_)
+        NV_Ith(y, FBRUNSAT(i)) = 0.0;
+        NV_Ith(y, FBRGW(i)) = 0.0;
+#endif
+#if defined(_BGC_) && !defined(_LUMPED_)
+        NV_Ith(y, SURFN(i)) = 0.0;
+        NV_Ith(y, SMINN(i)) = 0.0;
+#endif
+#if defined(_CYCLES_)
+        NV_Ith(y, NO3(i)) = 0.0;
+        NV_Ith(y, NH4(i)) = 0.0;
+#endif
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        NV_Ith(y, RIVSTG(i)) = 0.0;
+        NV_Ith(y, RIVGW(i)) = 0.0;
+#if defined(_BGC_) && !defined(_LUMPED_)
+        NV_Ith(y, STREAMN(i)) = 0.0;
+        NV_Ith(y, RIVBEDN(i)) = 0.0;
+#endif
+#if defined(_CYCLES_)
+        NV_Ith(y, STREAMNO3(i)) = 0.0;
+        NV_Ith(y, RIVBEDNO3(i)) = 0.0;
+        NV_Ith(y, STREAMNH4(i)) = 0.0;
+        NV_Ith(y, RIVBEDNH4(i)) = 0.0;
+#endif
+    }
+
+#if defined(_BGC_) && defined(_LUMPED_)
+    NV_Ith(y, LUMPED_SMINN) = 0.0;
+#endif
+}
+
 void SetAbsTol(double hydrol_tol, double sminn_tol, N_Vector abstol)
 {
     int             i;
 
-    /* Set absolute errors for hydrologic state variables */
+#if !defined(_BGC_) && !defined(_CYCLES_)
+    /* No nitrogen state variables without BGC or Cycles */
+    (void)sminn_tol;
+#endif
+
+    /* Set absolute errors for hydrologic state variables and nitrogen state
+     * variables */
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
-    for (i = 0; i < 3 * nelem + 2 * nriver; i++)
+    for (i = 0; i < nelem; i++)
     {
-        NV_Ith(abstol, i) = (realtype)hydrol_tol;
+        NV_Ith(abstol, SURF(i)) = (realtype)hydrol_tol;
+        NV_Ith(abstol, UNSAT(i)) = (realtype)hydrol_tol;
+        NV_Ith(abstol, GW(i)) = (realtype)hydrol_tol;
+#if defined(_BGC_) && !defined(_LUMPED_)
+        NV_Ith(abstol, SURFN(i)) = (realtype)sminn_tol;
+        NV_Ith(abstol, SMINN(i)) = (realtype)sminn_tol;
+#endif
+#if defined(_CYCLES_)
+        NV_Ith(abstol, NO3(i)) = (realtype)sminn_tol;
+        NV_Ith(abstol, NH4(i)) = (realtype)sminn_tol;
+#endif
     }
 
-    /* Set absolute errors for nitrogen state variables */
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
-    for (i = 3 * nelem + 2 * nriver; i < NumStateVar(); i++)
+    for (i = 0; i < nriver; i++)
     {
-        NV_Ith(abstol, i) = (realtype)sminn_tol;
+        NV_Ith(abstol, RIVSTG(i)) = (realtype)hydrol_tol;
+        NV_Ith(abstol, RIVGW(i)) = (realtype)hydrol_tol;
+#if defined(_BGC_) && !defined(_LUMPED_)
+        NV_Ith(abstol, STREAMN(i)) = (realtype)sminn_tol;
+        NV_Ith(abstol, RIVBEDN(i)) = (realtype)sminn_tol;
+#endif
+#if defined(_CYCLES_)
+        NV_Ith(abstol, STREAMNO3(i)) = (realtype)sminn_tol;
+        NV_Ith(abstol, RIVBEDNO3(i)) = (realtype)sminn_tol;
+        NV_Ith(abstol, STREAMNH4(i)) = (realtype)sminn_tol;
+        NV_Ith(abstol, RIVBEDNH4(i)) = (realtype)sminn_tol;
+#endif
     }
+
+#if defined(_BGC_) && defined(_LUMPED_)
+    NV_Ith(abstol, LUMPED_SMINN) = (realtype)sminn_tol;
+#endif
 }
 
-void SolveCVode(int starttime, int *t, int nextptr, double cputime,
-    void *cvode_mem, N_Vector CV_Y)
+void SolveCVode(int starttime, int *t, int nextptr, int tstop,
+    double cputime, stepctrl_struct *stepctrl, void *cvode_mem, N_Vector CV_Y)
 {
     realtype        solvert;
     realtype        tout;
+    realtype        twin;
+    double          dt;
     pihm_t_struct   pihm_time;
     int             cv_flag;
 
     tout = (realtype)(nextptr - starttime);
 
-    cv_flag = CVodeSetStopTime(cvode_mem, tout);
+    /* The solver does not step past the stop time. When the stop time is
+     * after the end of model step, the solution at the end of model step is
+     * interpolated */
+    cv_flag = CVodeSetStopTime(cvode_mem, (realtype)(tstop - starttime));
     if (!CheckCVodeFlag(cv_flag))
     {
         PIHMexit(EXIT_FAILURE);
     }
 
-    cv_flag = CVode(cvode_mem, tout, CV_Y, &solvert, CV_NORMAL);
-    if (!CheckCVodeFlag(cv_flag))
+    twin = (realtype)(*t - starttime);
+
+    /* Advance the solver over sample windows of a few max steps, and adjust
+     * the max step with solver statistics of each window. Windows end
+     * between internal steps, so the step controller reacts within model
+     * steps without interrupting the integration */
+    do
     {
-        PIHMexit(EXIT_FAILURE);
-    }
+        cv_flag = CVodeSetMaxStep(cvode_mem, (realtype)stepctrl->maxstep);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        dt = STEPCTRL_WINDOW * stepctrl->maxstep;
+        dt = (twin + dt < tout) ? dt : tout - twin;
+        twin += (realtype)dt;
+
+        cv_flag = CVode(cvode_mem, twin, CV_Y, &solvert, CV_NORMAL);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        StepCtrl(cvode_mem, dt, stepctrl);
+    } while (twin < tout);
 
     *t = (int)round(solvert) + starttime;
 
@@ -496,65 +727,3 @@ void SolveCVode(int starttime, int *t, int nextptr, double cputime,
             " Step = %s (cputime %f)\n", pihm_time.str, cputime);
     }
 }
-
-void AdjCVodeMaxStep(void *cvode_mem, ctrl_struct *ctrl)
-{
-    /* Variable CVODE max step (to reduce oscillations) */
-    long int        nst;
-    long int        ncfn;
-    long int        nni;
-    static long int nst0;
-    static long int ncfn0;
-    static long int nni0;
-    int             cv_flag;
-    double          nsteps;
-    double          nfails;
-    double          niters;
-
-    cv_flag = CVodeGetNumSteps(cvode_mem, &nst);
-    if (!CheckCVodeFlag(cv_flag))
-    {
-        PIHMexit(EXIT_FAILURE);
-    }
-
-    cv_flag = CVodeGetNumNonlinSolvConvFails(cvode_mem, &ncfn);
-    if (!CheckCVodeFlag(cv_flag))
-    {
-        PIHMexit(EXIT_FAILURE);
-    }
-
-    cv_flag = CVodeGetNumNonlinSolvIters(cvode_mem, &nni);
-    if (!CheckCVodeFlag(cv_flag))
-    {
-        PIHMexit(EXIT_FAILURE);
-    }
-
-    nsteps = (double)(nst - nst0);
-    nfails = (double)(ncfn - ncfn0) / nsteps;
-    niters = (double)(nni - nni0) / nsteps;
-
-    if (nfails > ctrl->nncfn || niters >= ctrl->nnimax)
-    {
-        ctrl->maxstep /= ctrl->decr;
-    }
-
-    if (nfails == 0.0 && niters <= ctrl->nnimin)
-    {
-        ctrl->maxstep *= ctrl->incr;
-    }
-
-    ctrl->maxstep = (ctrl->maxstep < ctrl->stepsize) ?
-        ctrl->maxstep : ctrl->stepsize;
-    ctrl->maxstep = (ctrl->maxstep > ctrl->stmin) ?
-        ctrl->maxstep : ctrl->stmin;
-
-    cv_flag = CVodeSetMaxStep(cvode_mem, (realtype)ctrl->maxstep);
-    if (!CheckCVodeFlag(cv_flag))
-    {
-        PIHMexit(EXIT_FAILURE);
-    }
-
-    nst0 = nst;
-    ncfn0 = ncfn;
-    nni0 = nni;
-}
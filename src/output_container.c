@@ -0,0 +1,787 @@
+#include "pihm.h"
+
+void InitOutputContainer(print_struct *print, const river_struct *river,
+    const char *outputdir)
+{
+    /*
+     * Open the output container file, which replaces the .dat files of all
+     * output variables. The file starts with a header describing output
+     * variables, followed by chunks of up to OUTPUT_CHUNK_NT records of up
+     * to OUTPUT_CHUNK_NS elements (river segments), and ends with an index
+     * of all chunks. All numbers in the file are little-endian, so that files
+     * do not depend on the platform
+     */
+    outcont_struct *cont;
+    char            fn[MAXSTRING];
+    unsigned char  *hdr;
+    size_t          hdr_size;
+    size_t          prefix;
+    size_t          pos;
+    int             i, j;
+
+    cont = (outcont_struct *)malloc(sizeof(outcont_struct));
+
+    cont->nvar = print->nprint;
+    cont->nitem = (int *)malloc(cont->nvar * sizeof(int));
+    cont->nrec = (int *)malloc(cont->nvar * sizeof(int));
+    cont->nbuf = (int *)malloc(cont->nvar * sizeof(int));
+    cont->time = (double **)malloc(cont->nvar * sizeof(double *));
+    cont->data = (double **)malloc(cont->nvar * sizeof(double *));
+
+    hdr_size = CONTAINER_HDR_SIZE;
+    for (i = 0; i < cont->nvar; i++)
+    {
+        hdr_size += CONTAINER_VAR_SIZE +
+            print->varctrl[i].nvar * sizeof(int32_t);
+    }
+    hdr = (unsigned char *)calloc(hdr_size, 1);
+
+    /* Build file header */
+    memcpy(hdr, CONTAINER_MAGIC, strlen(CONTAINER_MAGIC));
+    PackInt32(CONTAINER_VERSION, hdr + 8);
+    PackInt32(cont->nvar, hdr + 12);
+    PackInt32(OUTPUT_CHUNK_NT, hdr + 16);
+    PackInt32(OUTPUT_CHUNK_NS, hdr + 20);
+    PackInt32(SHUFFLE_FILTER, hdr + 24);
+    PackInt32(CONTAINER_VAR_SIZE, hdr + 28);
+    pos = CONTAINER_HDR_SIZE;
+
+    /* Variable names are file names without output directory and project
+     * name */
+    prefix = strlen(outputdir) + strlen(project) + 1;
+
+    for (i = 0; i < cont->nvar; i++)
+    {
+        const varctrl_struct *varctrl;
+        const void     *var0;
+        char           *name;
+        char           *unit;
+        int             location;
+
+        varctrl = &print->varctrl[i];
+
+        /* Name and unit are NUL-padded */
+        name = (char *)hdr + pos;
+        unit = (char *)hdr + pos + CONTAINER_NAME_LEN;
+        strncpy(name, varctrl->name + prefix, CONTAINER_NAME_LEN - 1);
+
+        /* Output variables point to either element or river variables */
+        var0 = (const void *)varctrl->var[0];
+        location = (var0 >= (const void *)river &&
+            var0 < (const void *)(river + nriver)) ? RIVERVAR : ELEMVAR;
+
+        /* Area-weighted sums of element variables are in the unit of the
+         * variable multiplied by m2 */
+        if (varctrl->reduce == REDUCE_SUM && location == ELEMVAR)
+        {
+            snprintf(unit, CONTAINER_UNIT_LEN, "%s m2", OutputUnit(name));
+        }
+        else
+        {
+            strncpy(unit, OutputUnit(name), CONTAINER_UNIT_LEN - 1);
+        }
+
+        PackInt32(location, hdr + pos + 96);
+        PackInt32(varctrl->nvar, hdr + pos + 100);
+        PackInt32(varctrl->intvl, hdr + pos + 104);
+        PackInt32(varctrl->upd_intvl, hdr + pos + 108);
+        pos += CONTAINER_VAR_SIZE;
+
+        /* Outputs are in the order of element (river segment) ids */
+        for (j = 0; j < varctrl->nvar; j++)
+        {
+            PackInt32((varctrl->id != NULL) ? varctrl->id[j] : j + 1,
+                hdr + pos);
+            pos += sizeof(int32_t);
+        }
+
+        cont->nitem[i] = varctrl->nvar;
+        cont->nrec[i] = 0;
+        cont->nbuf[i] = 0;
+        cont->time[i] = (double *)malloc(OUTPUT_CHUNK_NT * sizeof(double));
+        cont->data[i] = (double *)malloc((size_t)varctrl->nvar *
+            OUTPUT_CHUNK_NT * sizeof(double));
+    }
+
+    cont->nchunk = 0;
+    cont->maxchunk = 1024;
+    cont->index =
+        (chunkidx_struct *)malloc(cont->maxchunk * sizeof(chunkidx_struct));
+
+    cont->raw = (unsigned char *)malloc((OUTPUT_CHUNK_NS + 1) *
+        OUTPUT_CHUNK_NT * sizeof(double));
+    cont->shuffled = (unsigned char *)malloc((OUTPUT_CHUNK_NS + 1) *
+        OUTPUT_CHUNK_NT * sizeof(double));
+    cont->packed = (unsigned char *)malloc((OUTPUT_CHUNK_NS + 1) *
+        OUTPUT_CHUNK_NT * sizeof(double));
+
+    sprintf(fn, "%s%s.pcf", outputdir, project);
+
+    cont->file = (append_mode) ? fopen(fn, "r+b") : NULL;
+    if (cont->file != NULL)
+    {
+        /* Append to existing container file, overwriting its index */
+        ReadContainerIndex(fn, hdr, hdr_size, cont);
+    }
+    else
+    {
+        cont->file = fopen(fn, "wb");
+        CheckFile(cont->file, fn);
+        if (fwrite(hdr, 1, hdr_size, cont->file) != hdr_size)
+        {
+            PIHMprintf(VL_ERROR, "Error writing %s.\n", fn);
+            PIHMexit(EXIT_FAILURE);
+        }
+    }
+
+    free(hdr);
+
+    print->writer.container = cont;
+}
+
+void ReadContainerIndex(const char *fn, const unsigned char *hdr,
+    size_t hdr_size, outcont_struct *cont)
+{
+    /*
+     * Read chunk index of an existing container file to append to. The file
+     * header must match the current output variables. If the file has no
+     * valid index, e.g., because the model exited before closing it, the
+     * index is rebuilt from the chunk headers
+     */
+    unsigned char  *old_hdr;
+    unsigned char   buf[CONTAINER_IDX_SIZE];
+    long int        fsize;
+    long int        end;
+    int             i;
+
+    old_hdr = (unsigned char *)malloc(hdr_size);
+
+    if (fread(old_hdr, 1, hdr_size, cont->file) != hdr_size ||
+        memcmp(old_hdr, hdr, hdr_size) != 0)
+    {
+        PIHMprintf(VL_ERROR, "Error appending to %s.\n", fn);
+        PIHMprintf(VL_ERROR,
+            "The file does not match the output variables of this run.\n");
+        PIHMexit(EXIT_FAILURE);
+    }
+    free(old_hdr);
+
+    fseek(cont->file, 0L, SEEK_END);
+    fsize = ftell(cont->file);
+
+    /* Trailer: index position, number of chunks, and magic string */
+    end = -1;
+    if (fsize >= (long int)hdr_size + CONTAINER_TRL_SIZE &&
+        fseek(cont->file, -CONTAINER_TRL_SIZE, SEEK_END) == 0 &&
+        fread(buf, 1, CONTAINER_TRL_SIZE, cont->file) == CONTAINER_TRL_SIZE &&
+        memcmp(buf + 16, CONTAINER_IDX_MAGIC, strlen(CONTAINER_IDX_MAGIC)) ==
+        0)
+    {
+        end = (long int)UnpackInt64(buf);
+        cont->nchunk = (int)UnpackInt64(buf + 8);
+        if (end < (long int)hdr_size || cont->nchunk < 0 ||
+            end + (long int)cont->nchunk * CONTAINER_IDX_SIZE +
+            CONTAINER_TRL_SIZE != fsize)
+        {
+            end = -1;
+        }
+    }
+
+    if (end >= 0)
+    {
+        while (cont->maxchunk < cont->nchunk)
+        {
+            cont->maxchunk *= 2;
+        }
+        cont->index = (chunkidx_struct *)realloc(cont->index,
+            cont->maxchunk * sizeof(chunkidx_struct));
+
+        fseek(cont->file, end, SEEK_SET);
+        for (i = 0; i < cont->nchunk; i++)
+        {
+            if (fread(buf, 1, CONTAINER_IDX_SIZE, cont->file) !=
+                CONTAINER_IDX_SIZE)
+            {
+                PIHMprintf(VL_ERROR, "Error reading chunk index of %s.\n", fn);
+                PIHMexit(EXIT_FAILURE);
+            }
+            UnpackChunkIdx(buf, &cont->index[i]);
+        }
+    }
+    else
+    {
+        PIHMprintf(VL_NORMAL, "Chunk index of %s is not found. "
+            "Rebuilding it from chunk headers.\n", fn);
+
+        cont->nchunk = 0;
+        end = (long int)hdr_size;
+        fseek(cont->file, end, SEEK_SET);
+
+        /* Chunks are read until the end of file, or until a header that
+         * is incomplete or does not describe the chunk that follows */
+        while (fread(buf, 1, CONTAINER_IDX_SIZE, cont->file) ==
+            CONTAINER_IDX_SIZE)
+        {
+            chunkidx_struct idx;
+
+            UnpackChunkIdx(buf, &idx);
+
+            if (idx.offset != end + CONTAINER_IDX_SIZE ||
+                idx.var < 0 || idx.var >= cont->nvar ||
+                idx.nrec < 1 || idx.nrec > OUTPUT_CHUNK_NT ||
+                idx.item0 < 0 || idx.nitem < 1 ||
+                idx.item0 + idx.nitem > cont->nitem[idx.var] ||
+                idx.size < 1 || (size_t)idx.size > (size_t)idx.nrec *
+                (idx.nitem + 1) * sizeof(double) ||
+                idx.offset + idx.size > fsize)
+            {
+                break;
+            }
+
+            if (cont->nchunk == cont->maxchunk)
+            {
+                cont->maxchunk *= 2;
+                cont->index = (chunkidx_struct *)realloc(cont->index,
+                    cont->maxchunk * sizeof(chunkidx_struct));
+            }
+            cont->index[cont->nchunk] = idx;
+            cont->nchunk++;
+
+            end = (long int)(idx.offset + idx.size);
+            fseek(cont->file, end, SEEK_SET);
+        }
+
+        /* Records of a variable are split into chunks of elements (river
+         * segments), which are written one after another. Records of the
+         * last chunks are discarded if not all their chunks were written */
+        if (cont->nchunk > 0)
+        {
+            const chunkidx_struct *last;
+
+            last = &cont->index[cont->nchunk - 1];
+            if (last->item0 + last->nitem < cont->nitem[last->var])
+            {
+                int             var;
+                int             rec0;
+
+                var = last->var;
+                rec0 = last->rec0;
+                while (cont->nchunk > 0 &&
+                    cont->index[cont->nchunk - 1].var == var &&
+                    cont->index[cont->nchunk - 1].rec0 == rec0)
+                {
+                    cont->nchunk--;
+                    end = (long int)cont->index[cont->nchunk].offset -
+                        CONTAINER_IDX_SIZE;
+                }
+            }
+        }
+
+        /* Remove the incomplete end of file, which would otherwise remain
+         * after the new trailer if the new output is short */
+        fflush(cont->file);
+#if defined(_WIN32) || defined(_WIN64)
+        if (_chsize(_fileno(cont->file), end) != 0)
+#else
+        if (ftruncate(fileno(cont->file), (off_t)end) != 0)
+#endif
+        {
+            PIHMprintf(VL_ERROR, "Error appending to %s.\n", fn);
+            PIHMexit(EXIT_FAILURE);
+        }
+    }
+
+    for (i = 0; i < cont->nchunk; i++)
+    {
+        int             var;
+
+        var = cont->index[i].var;
+        cont->nrec[var] = (cont->index[i].rec0 + cont->index[i].nrec >
+            cont->nrec[var]) ? cont->index[i].rec0 + cont->index[i].nrec :
+            cont->nrec[var];
+    }
+
+    /* New chunks overwrite the old index */
+    fseek(cont->file, end, SEEK_SET);
+}
+
+void AddContainerRecords(outcont_struct *cont, int var, const char *data,
+    size_t size)
+{
+    /*
+     * Add binary output records (time followed by values of all elements or
+     * river segments) of an output variable to the container. Records are
+     * buffered until a chunk is complete
+     */
+    size_t          rec_size;
+    size_t          pos;
+
+    rec_size = (cont->nitem[var] + 1) * sizeof(double);
+
+    for (pos = 0; pos + rec_size <= size; pos += rec_size)
+    {
+        const char     *rec;
+        int             j;
+
+        rec = data + pos;
+
+        memcpy(&cont->time[var][cont->nbuf[var]], rec, sizeof(double));
+        for (j = 0; j < cont->nitem[var]; j++)
+        {
+            memcpy(&cont->data[var][(size_t)j * OUTPUT_CHUNK_NT +
+                cont->nbuf[var]], rec + (j + 1) * sizeof(double),
+                sizeof(double));
+        }
+        cont->nbuf[var]++;
+
+        if (cont->nbuf[var] == OUTPUT_CHUNK_NT)
+        {
+            WriteContainerChunks(cont, var);
+        }
+    }
+}
+
+void WriteContainerChunks(outcont_struct *cont, int var)
+{
+    /*
+     * Write buffered records of an output variable as chunks. Each chunk
+     * contains the record times followed by the time series of each element
+     * (river segment), and is byte-shuffled and compressed
+     */
+    int             nt;
+    int             item0;
+
+    nt = cont->nbuf[var];
+    if (nt == 0)
+    {
+        return;
+    }
+
+    for (item0 = 0; item0 < cont->nitem[var]; item0 += OUTPUT_CHUNK_NS)
+    {
+        chunkidx_struct *idx;
+        unsigned char   buf[CONTAINER_IDX_SIZE];
+        const unsigned char *out;
+        int             ns;
+        int             nraw;
+        int             size;
+        int             k, l;
+
+        ns = (cont->nitem[var] - item0 < OUTPUT_CHUNK_NS) ?
+            cont->nitem[var] - item0 : OUTPUT_CHUNK_NS;
+
+        for (l = 0; l < nt; l++)
+        {
+            PackDouble(cont->time[var][l], cont->raw + l * sizeof(double));
+        }
+        for (k = 0; k < ns; k++)
+        {
+            for (l = 0; l < nt; l++)
+            {
+                PackDouble(cont->data[var][(size_t)(item0 + k) *
+                    OUTPUT_CHUNK_NT + l],
+                    cont->raw + ((k + 1) * nt + l) * sizeof(double));
+            }
+        }
+        nraw = nt * (ns + 1);
+
+        ShuffleBytes(cont->raw, nraw, sizeof(double), cont->shuffled);
+
+        /* Chunks that do not compress are stored uncompressed */
+        size = LzCompress(cont->shuffled, nraw * (int)sizeof(double),
+            cont->packed, nraw * (int)sizeof(double));
+        if (size == 0)
+        {
+            size = nraw * (int)sizeof(double);
+            out = cont->shuffled;
+        }
+        else
+        {
+            out = cont->packed;
+        }
+
+        if (cont->nchunk == cont->maxchunk)
+        {
+            cont->maxchunk *= 2;
+            cont->index = (chunkidx_struct *)realloc(cont->index,
+                cont->maxchunk * sizeof(chunkidx_struct));
+        }
+        idx = &cont->index[cont->nchunk];
+        idx->var = var;
+        idx->rec0 = cont->nrec[var];
+        idx->nrec = nt;
+        idx->item0 = item0;
+        idx->nitem = ns;
+        idx->t0 = (int32_t)cont->time[var][0];
+        idx->t1 = (int32_t)cont->time[var][nt - 1];
+        idx->size = size;
+        idx->offset = (int64_t)ftell(cont->file) + CONTAINER_IDX_SIZE;
+
+        PackChunkIdx(idx, buf);
+
+        if (fwrite(buf, 1, CONTAINER_IDX_SIZE, cont->file) !=
+            CONTAINER_IDX_SIZE ||
+            fwrite(out, 1, size, cont->file) != (size_t)size)
+        {
+            PIHMprintf(VL_ERROR, "Error writing output container.\n");
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        cont->nchunk++;
+    }
+
+    cont->nrec[var] += nt;
+    cont->nbuf[var] = 0;
+}
+
+void PackInt32(int32_t value, unsigned char *buf)
+{
+    /*
+     * Store a number in little-endian byte order
+     */
+    uint32_t        u;
+    int             k;
+
+    u = (uint32_t)value;
+    for (k = 0; k < 4; k++)
+    {
+        buf[k] = (unsigned char)(u >> (8 * k));
+    }
+}
+
+void PackInt64(int64_t value, unsigned char *buf)
+{
+    uint64_t        u;
+    int             k;
+
+    u = (uint64_t)value;
+    for (k = 0; k < 8; k++)
+    {
+        buf[k] = (unsigned char)(u >> (8 * k));
+    }
+}
+
+void PackDouble(double value, unsigned char *buf)
+{
+    /*
+     * Store an IEEE 754 double in little-endian byte order
+     */
+    uint64_t        u;
+    int             k;
+
+    memcpy(&u, &value, sizeof(double));
+    for (k = 0; k < 8; k++)
+    {
+        buf[k] = (unsigned char)(u >> (8 * k));
+    }
+}
+
+int32_t UnpackInt32(const unsigned char *buf)
+{
+    uint32_t        u = 0;
+    int             k;
+
+    for (k = 0; k < 4; k++)
+    {
+        u |= (uint32_t)buf[k] << (8 * k);
+    }
+
+    return (int32_t)u;
+}
+
+int64_t UnpackInt64(const unsigned char *buf)
+{
+    uint64_t        u = 0;
+    int             k;
+
+    for (k = 0; k < 8; k++)
+    {
+        u |= (uint64_t)buf[k] << (8 * k);
+    }
+
+    return (int64_t)u;
+}
+
+void PackChunkIdx(const chunkidx_struct *idx, unsigned char *buf)
+{
+    /*
+     * Store a chunk header as CONTAINER_IDX_SIZE bytes
+     */
+    PackInt32(idx->var, buf);
+    PackInt32(idx->rec0, buf + 4);
+    PackInt32(idx->nrec, buf + 8);
+    PackInt32(idx->item0, buf + 12);
+    PackInt32(idx->nitem, buf + 16);
+    PackInt32(idx->t0, buf + 20);
+    PackInt32(idx->t1, buf + 24);
+    PackInt32(idx->size, buf + 28);
+    PackInt64(idx->offset, buf + 32);
+}
+
+void UnpackChunkIdx(const unsigned char *buf, chunkidx_struct *idx)
+{
+    idx->var = UnpackInt32(buf);
+    idx->rec0 = UnpackInt32(buf + 4);
+    idx->nrec = UnpackInt32(buf + 8);
+    idx->item0 = UnpackInt32(buf + 12);
+    idx->nitem = UnpackInt32(buf + 16);
+    idx->t0 = UnpackInt32(buf + 20);
+    idx->t1 = UnpackInt32(buf + 24);
+    idx->size = UnpackInt32(buf + 28);
+    idx->offset = UnpackInt64(buf + 32);
+}
+
+void ShuffleBytes(const unsigned char *src, int n, int size,
+    unsigned char *dst)
+{
+    /*
+     * Byte shuffle: the kth bytes of all n values are stored together, so
+     * that sign and exponent bytes of similar values form long runs
+     */
+    int             i, k;
+
+    for (k = 0; k < size; k++)
+    {
+        for (i = 0; i < n; i++)
+        {
+            dst[(size_t)k * n + i] = src[(size_t)i * size + k];
+        }
+    }
+}
+
+int LzCompress(const unsigned char *src, int n, unsigned char *dst, int cap)
+{
+    /*
+     * Greedy LZ77 compression in the LZ4 block format. Returns compressed
+     * size, or 0 if compressed data would not be smaller than cap bytes
+     */
+    const int       MINMATCH = 4;
+    const int       LASTLITERALS = 5;
+    const int       MFLIMIT = 12;
+    int             htab[1 << LZ_HASH_BITS];
+    int             ip = 0;
+    int             anchor = 0;
+    int             op = 0;
+    int             litlen;
+    int             i;
+
+    for (i = 0; i < (1 << LZ_HASH_BITS); i++)
+    {
+        htab[i] = -1;
+    }
+
+    while (ip < n - MFLIMIT)
+    {
+        uint32_t        seq, ref_seq;
+        uint32_t        h;
+        int             ref;
+        int             len;
+        int             token;
+        int             ml;
+
+        memcpy(&seq, src + ip, sizeof(uint32_t));
+        h = (seq * 2654435761U) >> (32 - LZ_HASH_BITS);
+        ref = htab[h];
+        htab[h] = ip;
+
+        if (ref < 0 || ip - ref > 65535)
+        {
+            ip++;
+            continue;
+        }
+        memcpy(&ref_seq, src + ref, sizeof(uint32_t));
+        if (ref_seq != seq)
+        {
+            ip++;
+            continue;
+        }
+
+        len = MINMATCH;
+        while (ip + len < n - LASTLITERALS && src[ref + len] == src[ip + len])
+        {
+            len++;
+        }
+
+        /* Sequence: token, literal length, literals, offset, match length */
+        litlen = ip - anchor;
+        if (op + 1 + litlen / 255 + 1 + litlen + 2 +
+            (len - MINMATCH) / 255 + 1 > cap)
+        {
+            return 0;
+        }
+
+        token = op++;
+        if (litlen >= 15)
+        {
+            int             l;
+
+            dst[token] = 15 << 4;
+            for (l = litlen - 15; l >= 255; l -= 255)
+            {
+                dst[op++] = 255;
+            }
+            dst[op++] = (unsigned char)l;
+        }
+        else
+        {
+            dst[token] = (unsigned char)(litlen << 4);
+        }
+        memcpy(dst + op, src + anchor, litlen);
+        op += litlen;
+
+        dst[op++] = (unsigned char)((ip - ref) & 0xff);
+        dst[op++] = (unsigned char)((ip - ref) >> 8);
+
+        ml = len - MINMATCH;
+        if (ml >= 15)
+        {
+            dst[token] |= 15;
+            for (ml -= 15; ml >= 255; ml -= 255)
+            {
+                dst[op++] = 255;
+            }
+            dst[op++] = (unsigned char)ml;
+        }
+        else
+        {
+            dst[token] |= (unsigned char)ml;
+        }
+
+        ip += len;
+        anchor = ip;
+    }
+
+    /* Last literals */
+    litlen = n - anchor;
+    if (op + 1 + litlen / 255 + 1 + litlen >= cap)
+    {
+        return 0;
+    }
+    if (litlen >= 15)
+    {
+        int             l;
+
+        dst[op++] = 15 << 4;
+        for (l = litlen - 15; l >= 255; l -= 255)
+        {
+            dst[op++] = 255;
+        }
+        dst[op++] = (unsigned char)l;
+    }
+    else
+    {
+        dst[op++] = (unsigned char)(litlen << 4);
+    }
+    memcpy(dst + op, src + anchor, litlen);
+    op += litlen;
+
+    return op;
+}
+
+void CloseOutputContainer(outcont_struct *cont)
+{
+    /*
+     * Write remaining records and the chunk index, and close the container
+     */
+    unsigned char  *buf;
+    unsigned char  *trailer;
+    size_t          size;
+    int             error;
+    int             i;
+
+    for (i = 0; i < cont->nvar; i++)
+    {
+        WriteContainerChunks(cont, i);
+    }
+
+    /* Chunk index followed by the trailer: index position, number of
+     * chunks, and magic string */
+    size = (size_t)cont->nchunk * CONTAINER_IDX_SIZE + CONTAINER_TRL_SIZE;
+    buf = (unsigned char *)calloc(size, 1);
+    for (i = 0; i < cont->nchunk; i++)
+    {
+        PackChunkIdx(&cont->index[i], buf + (size_t)i * CONTAINER_IDX_SIZE);
+    }
+    trailer = buf + (size_t)cont->nchunk * CONTAINER_IDX_SIZE;
+    PackInt64((int64_t)ftell(cont->file), trailer);
+    PackInt64(cont->nchunk, trailer + 8);
+    memcpy(trailer + 16, CONTAINER_IDX_MAGIC, strlen(CONTAINER_IDX_MAGIC));
+
+    fwrite(buf, 1, size, cont->file);
+    free(buf);
+
+    error = ferror(cont->file);
+    if (fclose(cont->file) != 0 || error)
+    {
+        PIHMprintf(VL_ERROR, "Error writing output container.\n");
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < cont->nvar; i++)
+    {
+        free(cont->time[i]);
+        free(cont->data[i]);
+    }
+    free(cont->nitem);
+    free(cont->nrec);
+    free(cont->nbuf);
+    free(cont->time);
+    free(cont->data);
+    free(cont->index);
+    free(cont->raw);
+    free(cont->shuffled);
+    free(cont->packed);
+    free(cont);
+}
+
+const char *OutputUnit(const char *name)
+{
+    /*
+     * Unit of an output variable. Layer and flux direction numbers at the end
+     * of variable names, and names of reduced outputs, are ignored
+     */
+    const char     *vrbl[] = {
+        "surf", "unsat", "gw", "stage", "rivgw", "snow", "is",
+        "infil", "recharge", "ec", "ett", "edir", "rivflx", "subflx",
+        "surfflx", "t1", "stc", "smc", "swc", "snowh", "albedo", "le", "sh",
+        "g", "etp", "esnow", "rootw", "soilm", "solar", "ch", "lai", "npp",
+        "nep", "nee", "gpp", "mr", "gr", "hr", "fire", "litfallc", "vegc",
+        "agc", "litrc", "soilc", "totalc", "sminn", "eres", "NO3", "NH4",
+        "NO3denitrif", "NO3leach", "NH4leach", "rivNO3leach", "rivNH4leach",
+        "fbrunsat", "fbrgw", "fbrinfil", "fbrrechg", "fbrflow"
+    };
+    const char     *unit[] = {
+        "m", "m", "m", "m", "m", "m", "m",
+        "m s-1", "m s-1", "m s-1", "m s-1", "m s-1", "m3 s-1", "m3 s-1",
+        "m3 s-1", "K", "K", "m3 m-3", "m3 m-3", "m", "-", "W m-2", "W m-2",
+        "W m-2", "W m-2", "W m-2", "-", "m", "W m-2", "m s-1", "m2 m-2",
+        "kgC m-2 day-1", "kgC m-2 day-1", "kgC m-2 day-1", "kgC m-2 day-1",
+        "kgC m-2 day-1", "kgC m-2 day-1", "kgC m-2 day-1", "kgC m-2 day-1",
+        "kgC m-2 day-1", "kgC m-2", "kgC m-2", "kgC m-2", "kgC m-2",
+        "kgC m-2", "kgN m-2", "m s-1", "kg m-2", "kg m-2", "kg m-2 day-1",
+        "kg s-1", "kg s-1", "kg s-1", "kg s-1", "m", "m", "m s-1", "m s-1",
+        "m3 s-1"
+    };
+    size_t          base;
+    size_t          len;
+    size_t          i;
+
+    /* Strip reduced output names, and layer and flux direction numbers */
+    base = strcspn(name, ".");
+    len = base;
+    while (len > 0 && isdigit((unsigned char)name[len - 1]))
+    {
+        len--;
+    }
+
+    for (i = 0; i < sizeof(vrbl) / sizeof(vrbl[0]); i++)
+    {
+        if ((strlen(vrbl[i]) == base && strncmp(name, vrbl[i], base) == 0) ||
+            (strlen(vrbl[i]) == len && strncmp(name, vrbl[i], len) == 0))
+        {
+            return unit[i];
+        }
+    }
+
+    return "";
+}
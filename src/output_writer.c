@@ -0,0 +1,356 @@
+#include "pihm.h"
+
+/* Output writers that have not been freed. Their buffered output is written
+ * at exit, so that output of completed model steps is not lost when the
+ * model exits before the end of simulation (e.g., after a solver failure) */
+outwriter_struct *open_writers = NULL;
+int             exit_flush = 0;
+#if !defined(_WIN32) && !defined(_WIN64)
+pthread_mutex_t open_writers_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+void InitOutputWriter(print_struct *print, int ascii, int flush_intvl)
+{
+    /*
+     * Initialize the writer of binary and txt output files. Output records
+     * are buffered in memory, and buffers are handed off to a background
+     * thread that writes them to disk every flush_intvl model steps, so
+     * that the model does not wait for disk writes
+     */
+    outwriter_struct *writer;
+    int             i, k;
+
+    writer = &print->writer;
+
+    writer->nfile = (ascii) ? 2 * print->nprint : print->nprint;
+    writer->file = (FILE **)malloc(writer->nfile * sizeof(FILE *));
+    for (i = 0; i < print->nprint; i++)
+    {
+        writer->file[i] = print->varctrl[i].datfile;
+        if (ascii)
+        {
+            writer->file[print->nprint + i] = print->varctrl[i].txtfile;
+        }
+    }
+
+    for (k = 0; k < 2; k++)
+    {
+        writer->data[k] = (char **)malloc(writer->nfile * sizeof(char *));
+        writer->size[k] = (size_t *)malloc(writer->nfile * sizeof(size_t));
+        writer->cap[k] = (size_t *)malloc(writer->nfile * sizeof(size_t));
+        for (i = 0; i < writer->nfile; i++)
+        {
+            writer->data[k][i] = NULL;
+            writer->size[k][i] = 0;
+            writer->cap[k][i] = 0;
+        }
+    }
+
+    writer->fill = 0;
+    writer->flush_intvl = flush_intvl;
+    writer->nstep = 0;
+    writer->container = NULL;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    writer->busy = 0;
+    writer->quit = 0;
+    pthread_mutex_init(&writer->mutex, NULL);
+    pthread_cond_init(&writer->cond, NULL);
+    if (pthread_create(&writer->thread, NULL, OutputWriterThread, writer) !=
+        0)
+    {
+        PIHMprintf(VL_ERROR, "Error creating output writer thread.\n");
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    pthread_mutex_lock(&open_writers_mutex);
+#endif
+    if (!exit_flush)
+    {
+        atexit(FlushOpenWriters);
+        exit_flush = 1;
+    }
+    writer->next = open_writers;
+    open_writers = writer;
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_unlock(&open_writers_mutex);
+#endif
+}
+
+void AppendOutput(outwriter_struct *writer, int i, const void *ptr,
+    size_t size)
+{
+    /*
+     * Append output to the buffer of the ith output file. Buffers of
+     * different files can be appended to concurrently
+     */
+    char          **data;
+    size_t         *cap;
+    size_t         *used;
+
+    data = &writer->data[writer->fill][i];
+    cap = &writer->cap[writer->fill][i];
+    used = &writer->size[writer->fill][i];
+
+    if (*used + size > *cap)
+    {
+        *cap = (*cap > 0) ? *cap : 4096;
+        while (*used + size > *cap)
+        {
+            *cap *= 2;
+        }
+        *data = (char *)realloc(*data, *cap);
+    }
+
+    memcpy(*data + *used, ptr, size);
+    *used += size;
+}
+
+void PrintfOutput(outwriter_struct *writer, int i, const char *format, ...)
+{
+    /*
+     * Append formatted output to the buffer of the ith output file
+     */
+    char            str[MAXSTRING];
+    va_list         va;
+    int             len;
+
+    va_start(va, format);
+    len = vsnprintf(str, MAXSTRING, format, va);
+    va_end(va);
+
+    if (len >= MAXSTRING)
+    {
+        char           *longstr;
+
+        longstr = (char *)malloc(len + 1);
+        va_start(va, format);
+        vsnprintf(longstr, len + 1, format, va);
+        va_end(va);
+        AppendOutput(writer, i, longstr, len);
+        free(longstr);
+    }
+    else if (len > 0)
+    {
+        AppendOutput(writer, i, str, len);
+    }
+}
+
+void FlushOutput(outwriter_struct *writer, int final)
+{
+    /*
+     * Hand off buffered output to the writer thread when the flush interval
+     * is reached. Output is not handed off if the previous buffers are still
+     * being written, unless too much output has been buffered. Buffers are
+     * always handed off, and written, at the end of simulation
+     */
+    size_t          nbytes = 0;
+    int             i;
+
+    writer->nstep++;
+
+    for (i = 0; i < writer->nfile; i++)
+    {
+        nbytes += writer->size[writer->fill][i];
+    }
+
+    if (!final && (nbytes < OUTPUT_BUFSIZE) &&
+        (writer->flush_intvl == 0 || writer->nstep < writer->flush_intvl))
+    {
+        return;
+    }
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&writer->mutex);
+    if (writer->busy && !final && nbytes < OUTPUT_BUFSIZE)
+    {
+        /* Try again at the next model step */
+        pthread_mutex_unlock(&writer->mutex);
+        return;
+    }
+
+    while (writer->busy)
+    {
+        pthread_cond_wait(&writer->cond, &writer->mutex);
+    }
+
+    if (nbytes > 0)
+    {
+        writer->fill = 1 - writer->fill;
+        writer->busy = 1;
+        pthread_cond_broadcast(&writer->cond);
+    }
+    writer->nstep = 0;
+
+    if (final)
+    {
+        while (writer->busy)
+        {
+            pthread_cond_wait(&writer->cond, &writer->mutex);
+        }
+    }
+    pthread_mutex_unlock(&writer->mutex);
+#else
+    /* Without POSIX threads, output is written synchronously */
+    WriteOutputBuf(writer, writer->fill);
+    writer->nstep = 0;
+#endif
+}
+
+void WriteOutputBuf(outwriter_struct *writer, int k)
+{
+    /*
+     * Write the kth buffer set to output files, with one write for each file
+     */
+    int             i;
+
+    for (i = 0; i < writer->nfile; i++)
+    {
+        if (writer->size[k][i] > 0 && writer->file[i] == NULL)
+        {
+            /* Binary output is written to the output container */
+            AddContainerRecords(writer->container, i, writer->data[k][i],
+                writer->size[k][i]);
+            writer->size[k][i] = 0;
+        }
+        else if (writer->size[k][i] > 0)
+        {
+            if (fwrite(writer->data[k][i], 1, writer->size[k][i],
+                writer->file[i]) != writer->size[k][i] ||
+                fflush(writer->file[i]) != 0)
+            {
+                PIHMprintf(VL_ERROR, "Error writing output files.\n");
+                PIHMexit(EXIT_FAILURE);
+            }
+
+            writer->size[k][i] = 0;
+        }
+    }
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+void *OutputWriterThread(void *arg)
+{
+    /*
+     * Background writer that writes buffers upon hand-off
+     */
+    outwriter_struct *writer;
+
+    writer = (outwriter_struct *)arg;
+
+    pthread_mutex_lock(&writer->mutex);
+    while (!writer->quit)
+    {
+        if (writer->busy)
+        {
+            int             k;
+
+            /* The model fills the other buffer set, and does not switch
+             * buffer sets while busy */
+            k = 1 - writer->fill;
+
+            pthread_mutex_unlock(&writer->mutex);
+            WriteOutputBuf(writer, k);
+            pthread_mutex_lock(&writer->mutex);
+
+            writer->busy = 0;
+            pthread_cond_broadcast(&writer->cond);
+        }
+        else
+        {
+            pthread_cond_wait(&writer->cond, &writer->mutex);
+        }
+    }
+    pthread_mutex_unlock(&writer->mutex);
+
+    return NULL;
+}
+#endif
+
+void FlushOpenWriters(void)
+{
+    /*
+     * Write remaining output of open writers at exit
+     */
+    outwriter_struct *writer;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&open_writers_mutex);
+#endif
+    writer = open_writers;
+    open_writers = NULL;
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_unlock(&open_writers_mutex);
+#endif
+
+    for (; writer != NULL; writer = writer->next)
+    {
+#if !defined(_WIN32) && !defined(_WIN64)
+        if (pthread_equal(pthread_self(), writer->thread))
+        {
+            /* Exiting after an error writing output of this writer */
+            continue;
+        }
+#endif
+        CloseOutputWriter(writer);
+    }
+}
+
+void CloseOutputWriter(outwriter_struct *writer)
+{
+    /*
+     * Write remaining output, stop the writer thread, and close the output
+     * container
+     */
+    FlushOutput(writer, 1);
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&writer->mutex);
+    writer->quit = 1;
+    pthread_cond_broadcast(&writer->cond);
+    pthread_mutex_unlock(&writer->mutex);
+    pthread_join(writer->thread, NULL);
+    pthread_mutex_destroy(&writer->mutex);
+    pthread_cond_destroy(&writer->cond);
+#endif
+
+    if (writer->container != NULL)
+    {
+        CloseOutputContainer(writer->container);
+    }
+}
+
+void FreeOutputWriter(outwriter_struct *writer)
+{
+    outwriter_struct **ptr;
+    int             i, k;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&open_writers_mutex);
+#endif
+    for (ptr = &open_writers; *ptr != NULL; ptr = &(*ptr)->next)
+    {
+        if (*ptr == writer)
+        {
+            *ptr = writer->next;
+            break;
+        }
+    }
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_unlock(&open_writers_mutex);
+#endif
+
+    CloseOutputWriter(writer);
+
+    for (k = 0; k < 2; k++)
+    {
+        for (i = 0; i < writer->nfile; i++)
+        {
+            free(writer->data[k][i]);
+        }
+        free(writer->data[k]);
+        free(writer->size[k]);
+        free(writer->cap[k]);
+    }
+    free(writer->file);
+}
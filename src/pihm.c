@@ -7,7 +7,7 @@ void PIHM(pihm_struct pihm, void *cvode_mem, N_Vector CV_Y, double cputime)
     t = pihm->ctrl.tout[pihm->ctrl.cstep];
 
     /* Apply boundary conditions */
-    ApplyBc(&pihm->forc, pihm->elem, pihm->river, t);
+    ApplyBc(&pihm->forc, pihm->river, t);
 
     /*
      * Apply forcing and simulate land surface processes
@@ -22,6 +22,9 @@ void PIHM(pihm_struct pihm, void *cvode_mem, N_Vector CV_Y, double cputime)
         ApplyForc(&pihm->forc, pihm->elem, t);
 #endif
 
+        /* Anticipate stiff periods from precipitation intensity */
+        StepCtrlForc(pihm->elem, &pihm->stepctrl);
+
 #if defined(_NOAH_)
         /* Calculate surface energy balance */
         Noah(pihm->elem, (double)pihm->ctrl.etstep);
@@ -35,11 +38,44 @@ void PIHM(pihm_struct pihm, void *cvode_mem, N_Vector CV_Y, double cputime)
         UpdPrintVar(pihm->print.tp_varctrl, pihm->print.ntpprint, LS_STEP);
     }
 
+    /* Copy hydrology step inputs to the hydrology kernel. With event
+     * coupling, inputs are only copied at coupling events, so that the solver
+     * can step over model steps between events */
+    if (!pihm->ctrl.event_cpl || t >= pihm->cpl.tevent)
+    {
+        ElemToHydro(pihm->elem, pihm->river, &pihm->hydro);
+
+        if (pihm->ctrl.event_cpl)
+        {
+            pihm->cpl.tevent = NextCplEvent(&pihm->ctrl, &pihm->forc, t);
+        }
+    }
+
     /*
      * Solve PIHM hydrology ODE using CVode
      */
-    SolveCVode(pihm->ctrl.starttime, &t, pihm->ctrl.tout[pihm->ctrl.cstep + 1],
-        cputime, cvode_mem, CV_Y);
+    if (pihm->ctrl.multirate > 0)
+    {
+        SolveMultiRate(pihm, &t, cputime, cvode_mem, CV_Y);
+    }
+    else
+    {
+        SolveCVode(pihm->ctrl.starttime, &t,
+            pihm->ctrl.tout[pihm->ctrl.cstep + 1], (pihm->ctrl.event_cpl) ?
+            pihm->cpl.tevent : pihm->ctrl.tout[pihm->ctrl.cstep + 1],
+            cputime, &pihm->stepctrl, cvode_mem, CV_Y);
+
+        if (pihm->ctrl.event_cpl && t < pihm->cpl.tevent)
+        {
+            /* The solver has stepped past the end of model step, and states
+             * are interpolated. Evaluate fluxes at the interpolated states */
+            ODE((realtype)(t - pihm->ctrl.starttime), CV_Y, pihm->cpl.ydot,
+                pihm);
+        }
+    }
+
+    /* Copy hydrology kernel states and fluxes back to model structures */
+    HydroToElem(&pihm->hydro, pihm->elem, pihm->river);
 
     /* Use mass balance to calculate model fluxes or variables */
     Summary(pihm->elem, pihm->river, CV_Y, (double)pihm->ctrl.stepsize);
@@ -88,13 +124,13 @@ void PIHM(pihm_struct pihm, void *cvode_mem, N_Vector CV_Y, double cputime)
     /* Print water balance */
     if (pihm->ctrl.waterbal)
     {
-        PrintWaterBal(pihm->print.watbal_file, t, pihm->ctrl.starttime,
-            pihm->ctrl.stepsize, pihm->elem, pihm->river);
+        PrintWaterBal(t, pihm->ctrl.starttime, pihm->ctrl.stepsize,
+            pihm->elem, pihm->river, &pihm->print);
     }
 
     /* Print binary and txt output files */
     PrintData(pihm->print.varctrl, pihm->print.nprint, t,
-        t - pihm->ctrl.starttime, pihm->ctrl.ascii);
+        t - pihm->ctrl.starttime, pihm->ctrl.ascii, &pihm->print.writer);
 
     /* Print tecplot output files */
     if (tecplot)
@@ -0,0 +1,251 @@
+#include "pihm.h"
+
+void InitPrecond(const graph_struct *graph, prec_struct *prec)
+{
+    int             i;
+    int            *counter;
+
+    PIHMprintf(VL_VERBOSE, "Initialize block-Jacobi preconditioner.\n");
+
+    /*
+     * Lateral fluxes depend on the friction slopes of neighbors, thus nodes
+     * sharing a color must not be within two edges of each other so that
+     * perturbing all nodes of one color at a time gives exact difference
+     * quotients of the diagonal blocks
+     */
+    prec->color = (int *)malloc(graph->nnode * sizeof(int));
+    prec->ncolor = ColorGraph(graph, 2, prec->color);
+
+    /* Group nodes by color */
+    prec->colorptr = (int *)calloc(prec->ncolor + 1, sizeof(int));
+    prec->colornode = (int *)malloc(graph->nnode * sizeof(int));
+    counter = (int *)malloc(prec->ncolor * sizeof(int));
+
+    for (i = 0; i < graph->nnode; i++)
+    {
+        prec->colorptr[prec->color[i] + 1]++;
+    }
+    for (i = 0; i < prec->ncolor; i++)
+    {
+        prec->colorptr[i + 1] += prec->colorptr[i];
+        counter[i] = prec->colorptr[i];
+    }
+    for (i = 0; i < graph->nnode; i++)
+    {
+        prec->colornode[counter[prec->color[i]]++] = i;
+    }
+
+    free(counter);
+
+    PIHMprintf(VL_VERBOSE, " %d colors are used for %d elements and %d river "
+        "segments.\n", prec->ncolor, nelem, nriver);
+
+    /* Allocate diagonal blocks */
+    prec->jac = (DlsMat *)malloc(graph->nnode * sizeof(DlsMat));
+    prec->p = (DlsMat *)malloc(graph->nnode * sizeof(DlsMat));
+    prec->pivot = (long int **)malloc(graph->nnode * sizeof(long int *));
+
+    for (i = 0; i < graph->nnode; i++)
+    {
+        prec->jac[i] = NewDenseMat(graph->nsv[i], graph->nsv[i]);
+        prec->p[i] = NewDenseMat(graph->nsv[i], graph->nsv[i]);
+        prec->pivot[i] = NewLintArray(graph->nsv[i]);
+        SetToZero(prec->jac[i]);
+    }
+}
+
+int PrecSetup(realtype t, N_Vector CV_Y, N_Vector fy, booleantype jok,
+    booleantype *jcurPtr, realtype gamma, void *pihm_data, N_Vector tmp1,
+    N_Vector tmp2, N_Vector tmp3)
+{
+    int             i;
+    int             failed = 0;
+    pihm_struct     pihm;
+    const graph_struct *graph;
+    prec_struct    *prec;
+
+    pihm = (pihm_struct)pihm_data;
+    graph = &pihm->graph;
+    prec = &pihm->prec;
+
+    if (jok)
+    {
+        /* Reuse saved Jacobian blocks */
+        *jcurPtr = FALSE;
+    }
+    else
+    {
+        int             c, k;
+        double         *y;
+        double         *f0;
+        double         *ytmp;
+        double         *ftmp;
+        double         *inc;
+        double          srur;
+
+        y = NV_DATA(CV_Y);
+        f0 = NV_DATA(fy);
+        ytmp = NV_DATA(tmp1);
+        ftmp = NV_DATA(tmp2);
+        inc = NV_DATA(tmp3);
+
+        srur = sqrt(UNIT_ROUNDOFF);
+
+        N_VScale(1.0, CV_Y, tmp1);
+
+        /*
+         * Difference quotient approximation of the diagonal blocks. One state
+         * component of all nodes in one color is perturbed at a time
+         */
+        for (c = 0; c < prec->ncolor; c++)
+        {
+            for (k = 0; k < MAXNSV; k++)
+            {
+                int             nperturb = 0;
+
+                for (i = prec->colorptr[c]; i < prec->colorptr[c + 1]; i++)
+                {
+                    int             node;
+                    int             ind;
+
+                    node = prec->colornode[i];
+                    if (k < graph->nsv[node])
+                    {
+                        ind = graph->sv[node][k];
+                        inc[ind] = srur *
+                            ((fabs(y[ind]) > pihm->ctrl.abstol) ?
+                            fabs(y[ind]) : pihm->ctrl.abstol);
+                        ytmp[ind] = y[ind] + inc[ind];
+                        nperturb++;
+                    }
+                }
+
+                if (nperturb == 0)
+                {
+                    continue;
+                }
+
+                ODE(t, tmp1, tmp2, pihm);
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+                for (i = prec->colorptr[c]; i < prec->colorptr[c + 1]; i++)
+                {
+                    int             m;
+                    int             node;
+                    int             ind;
+
+                    node = prec->colornode[i];
+                    if (k < graph->nsv[node])
+                    {
+                        ind = graph->sv[node][k];
+                        for (m = 0; m < graph->nsv[node]; m++)
+                        {
+                            DENSE_ELEM(prec->jac[node], m, k) =
+                                (ftmp[graph->sv[node][m]] -
+                                f0[graph->sv[node][m]]) / inc[ind];
+                        }
+                        ytmp[ind] = y[ind];
+                    }
+                }
+            }
+        }
+
+        /* Restore model fluxes at the unperturbed state, which are used for
+         * output */
+        ODE(t, CV_Y, tmp2, pihm);
+
+        *jcurPtr = TRUE;
+    }
+
+    /* Form and factor P = I - gamma * J for each block */
+#if defined(_OPENMP)
+# pragma omp parallel for reduction(+:failed)
+#endif
+    for (i = 0; i < graph->nnode; i++)
+    {
+        DenseCopy(prec->jac[i], prec->p[i]);
+        DenseScale(-gamma, prec->p[i]);
+        AddIdentity(prec->p[i]);
+
+        if (DenseGETRF(prec->p[i], prec->pivot[i]) != 0)
+        {
+            failed++;
+        }
+    }
+
+    /* A positive return value tells CVODE the failure is recoverable */
+    return (failed > 0) ? 1 : 0;
+}
+
+int PrecSolve(realtype t, N_Vector CV_Y, N_Vector fy, N_Vector r, N_Vector z,
+    realtype gamma, realtype delta, int lr, void *pihm_data, N_Vector tmp)
+{
+    int             i;
+    double         *zdata;
+    pihm_struct     pihm;
+    const graph_struct *graph;
+    prec_struct    *prec;
+
+    /* P is formed and factored by PrecSetup, so only r is needed here */
+    (void)t;
+    (void)CV_Y;
+    (void)fy;
+    (void)gamma;
+    (void)delta;
+    (void)lr;
+    (void)tmp;
+
+    pihm = (pihm_struct)pihm_data;
+    graph = &pihm->graph;
+    prec = &pihm->prec;
+
+    /* State variables not attached to graph nodes (e.g., lumped soil mineral
+     * N) are not preconditioned */
+    N_VScale(1.0, r, z);
+
+    zdata = NV_DATA(z);
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < graph->nnode; i++)
+    {
+        int             m;
+        double          b[MAXNSV];
+
+        for (m = 0; m < graph->nsv[i]; m++)
+        {
+            b[m] = zdata[graph->sv[i][m]];
+        }
+
+        DenseGETRS(prec->p[i], prec->pivot[i], b);
+
+        for (m = 0; m < graph->nsv[i]; m++)
+        {
+            zdata[graph->sv[i][m]] = b[m];
+        }
+    }
+
+    return 0;
+}
+
+void FreePrecond(int nnode, prec_struct *prec)
+{
+    int             i;
+
+    for (i = 0; i < nnode; i++)
+    {
+        DestroyMat(prec->jac[i]);
+        DestroyMat(prec->p[i]);
+        DestroyArray(prec->pivot[i]);
+    }
+
+    free(prec->color);
+    free(prec->colorptr);
+    free(prec->colornode);
+    free(prec->jac);
+    free(prec->p);
+    free(prec->pivot);
+}
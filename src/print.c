@@ -71,7 +71,7 @@ void StartupScreen(void)
 }
 
 void InitOutputFile(print_struct *print, const char *outputdir, int watbal,
-    int ascii)
+    int ascii, int format)
 {
     char            ascii_fn[MAXSTRING];
     char            dat_fn[MAXSTRING];
@@ -90,6 +90,8 @@ void InitOutputFile(print_struct *print, const char *outputdir, int watbal,
     }
 
     /* Initialize water balance file*/
+    print->wb_strg_prev = 0.0;
+    print->wb_error = 0.0;
     if (watbal)
     {
         sprintf(watbal_fn, "%s%s.watbal.plt", outputdir, project);
@@ -98,6 +100,7 @@ void InitOutputFile(print_struct *print, const char *outputdir, int watbal,
     }
 
     /* Initialize cvode output files */
+    memset(&print->perf0, 0, sizeof(perfstat_struct));
     if (debug_mode)
     {
         sprintf(perf_fn, "%s%s.cvode.log", outputdir, project);
@@ -115,9 +118,17 @@ void InitOutputFile(print_struct *print, const char *outputdir, int watbal,
      */
     for (i = 0; i < print->nprint; i++)
     {
-        sprintf(dat_fn, "%s.dat", print->varctrl[i].name);
-        print->varctrl[i].datfile = fopen(dat_fn, mode);
-        CheckFile(print->varctrl[i].datfile, dat_fn);
+        /* Binary output may be written to the output container instead */
+        if (format == DAT_OUTPUT)
+        {
+            sprintf(dat_fn, "%s.dat", print->varctrl[i].name);
+            print->varctrl[i].datfile = fopen(dat_fn, mode);
+            CheckFile(print->varctrl[i].datfile, dat_fn);
+        }
+        else
+        {
+            print->varctrl[i].datfile = NULL;
+        }
 
         if (ascii)
         {
@@ -180,9 +191,45 @@ void UpdPrintVar(varctrl_struct *varctrl, int nprint, int module_step)
 
         if (varctrl[i].upd_intvl == module_step)
         {
-            for (j = 0; j < varctrl[i].nvar; j++)
+            double          outval;
+
+            /* Reduced outputs are evaluated before averaging over output
+             * intervals */
+            switch (varctrl[i].reduce)
             {
-                varctrl[i].buffer[j] += *varctrl[i].var[j];
+                case REDUCE_MEAN:
+                case REDUCE_SUM:
+                    outval = 0.0;
+                    for (j = 0; j < varctrl[i].nsrc; j++)
+                    {
+                        outval += varctrl[i].weight[j] * *varctrl[i].var[j];
+                    }
+                    varctrl[i].buffer[0] += outval;
+                    break;
+                case REDUCE_MIN:
+                    outval = *varctrl[i].var[0];
+                    for (j = 1; j < varctrl[i].nsrc; j++)
+                    {
+                        outval = (*varctrl[i].var[j] < outval) ?
+                            *varctrl[i].var[j] : outval;
+                    }
+                    varctrl[i].buffer[0] += outval;
+                    break;
+                case REDUCE_MAX:
+                    outval = *varctrl[i].var[0];
+                    for (j = 1; j < varctrl[i].nsrc; j++)
+                    {
+                        outval = (*varctrl[i].var[j] > outval) ?
+                            *varctrl[i].var[j] : outval;
+                    }
+                    varctrl[i].buffer[0] += outval;
+                    break;
+                default:
+                    for (j = 0; j < varctrl[i].nvar; j++)
+                    {
+                        varctrl[i].buffer[j] += *varctrl[i].var[j];
+                    }
+                    break;
             }
 
             varctrl[i].counter++;
@@ -190,7 +237,8 @@ void UpdPrintVar(varctrl_struct *varctrl, int nprint, int module_step)
     }
 }
 
-void PrintData(varctrl_struct *varctrl, int nprint, int t, int lapse, int ascii)
+void PrintData(varctrl_struct *varctrl, int nprint, int t, int lapse, int ascii,
+    outwriter_struct *writer)
 {
     int             i;
     pihm_t_struct   pihm_time;
@@ -210,26 +258,25 @@ void PrintData(varctrl_struct *varctrl, int nprint, int t, int lapse, int ascii)
         {
             if (ascii)
             {
-                fprintf(varctrl[i].txtfile, "\"%s\"", pihm_time.str);
+                PrintfOutput(writer, nprint + i, "\"%s\"", pihm_time.str);
                 for (j = 0; j < varctrl[i].nvar; j++)
                 {
                     if (varctrl[i].counter > 0)
                     {
-                        fprintf(varctrl[i].txtfile, "\t%lf",
+                        PrintfOutput(writer, nprint + i, "\t%lf",
                             varctrl[i].buffer[j] / (double)varctrl[i].counter);
                     }
                     else
                     {
-                        fprintf(varctrl[i].txtfile, "\t%lf",
+                        PrintfOutput(writer, nprint + i, "\t%lf",
                             varctrl[i].buffer[j]);
                     }
                 }
-                fprintf(varctrl[i].txtfile, "\n");
-                fflush(varctrl[i].txtfile);
+                PrintfOutput(writer, nprint + i, "\n");
             }
 
             outtime = (double)t;
-            fwrite(&outtime, sizeof(double), 1, varctrl[i].datfile);
+            AppendOutput(writer, i, &outtime, sizeof(double));
             for (j = 0; j < varctrl[i].nvar; j++)
             {
                 if (varctrl[i].counter > 0)
@@ -240,14 +287,16 @@ void PrintData(varctrl_struct *varctrl, int nprint, int t, int lapse, int ascii)
                 {
                     outval = varctrl[i].buffer[j];
                 }
-                fwrite(&outval, sizeof(double), 1, varctrl[i].datfile);
+                AppendOutput(writer, i, &outval, sizeof(double));
 
                 varctrl[i].buffer[j] = 0.0;
             }
             varctrl[i].counter = 0;
-            fflush(varctrl[i].datfile);
         }
     }
+
+    /* Output files are written by the output writer */
+    FlushOutput(writer, 0);
 }
 
 void PrintInit(const elem_struct *elem, const river_struct *river,
@@ -262,6 +311,8 @@ void PrintInit(const elem_struct *elem, const river_struct *river,
         FILE           *init_file;
         char            fn[MAXSTRING];
         int             i;
+        ic_struct      *ic;
+        river_ic_struct *river_ic;
 
         sprintf(fn, "%s/restart/%s.%s.ic", outputdir, project,
             pihm_time.strshort);
@@ -269,46 +320,60 @@ void PrintInit(const elem_struct *elem, const river_struct *river,
         init_file = fopen(fn, "wb");
         CheckFile(init_file, fn);
 
+        ic = (ic_struct *)malloc(nelem * sizeof(ic_struct));
+        river_ic = (river_ic_struct *)malloc(nriver * sizeof(river_ic_struct));
+
+        /* Restart files are written in the order of element and river ids in
+         * the input files, which may differ from the model order */
         for (i = 0; i < nelem; i++)
         {
-            fwrite(&elem[i].ws.cmc, sizeof(double), 1, init_file);
-            fwrite(&elem[i].ws.sneqv, sizeof(double), 1, init_file);
-            fwrite(&elem[i].ws.surf, sizeof(double), 1, init_file);
-            fwrite(&elem[i].ws.unsat, sizeof(double), 1, init_file);
-            fwrite(&elem[i].ws.gw, sizeof(double), 1, init_file);
+            ic_struct      *ici;
+
+            ici = &ic[elem[i].ind - 1];
+
+            ici->cmc = elem[i].ws.cmc;
+            ici->sneqv = elem[i].ws.sneqv;
+            ici->surf = elem[i].ws.surf;
+            ici->unsat = elem[i].ws.unsat;
+            ici->gw = elem[i].ws.gw;
 #if defined(_FBR_)
-            fwrite(&elem[i].ws.fbr_unsat, sizeof(double), 1, init_file);
-            fwrite(&elem[i].ws.fbr_gw, sizeof(double), 1, init_file);
+            ici->fbr_unsat = elem[i].ws.fbr_unsat;
+            ici->fbr_gw = elem[i].ws.fbr_gw;
 #endif
 #if defined(_NOAH_)
-            fwrite(&elem[i].es.t1, sizeof(double), 1, init_file);
-            fwrite(&elem[i].ps.snowh, sizeof(double), 1, init_file);
+            ici->t1 = elem[i].es.t1;
+            ici->snowh = elem[i].ps.snowh;
 
             int             j;
 
             for (j = 0; j < MAXLYR; j++)
             {
-                fwrite(&elem[i].es.stc[j], sizeof(double), 1, init_file);
-            }
-            for (j = 0; j < MAXLYR; j++)
-            {
-                fwrite(&elem[i].ws.smc[j], sizeof(double), 1, init_file);
-            }
-            for (j = 0; j < MAXLYR; j++)
-            {
-                fwrite(&elem[i].ws.sh2o[j], sizeof(double), 1, init_file);
+                ici->stc[j] = elem[i].es.stc[j];
+                ici->smc[j] = elem[i].ws.smc[j];
+                ici->sh2o[j] = elem[i].ws.sh2o[j];
             }
 #endif
         }
 
         for (i = 0; i < nriver; i++)
         {
-            fwrite(&river[i].ws.stage, sizeof(double), 1, init_file);
-            fwrite(&river[i].ws.gw, sizeof(double), 1, init_file);
+            river_ic[river[i].ind - 1].stage = river[i].ws.stage;
+            river_ic[river[i].ind - 1].gw = river[i].ws.gw;
+        }
+
+        if (fwrite(ic, sizeof(ic_struct), nelem, init_file) !=
+            (size_t)nelem ||
+            fwrite(river_ic, sizeof(river_ic_struct), nriver, init_file) !=
+            (size_t)nriver)
+        {
+            PIHMprintf(VL_ERROR, "Error writing %s.\n", fn);
+            PIHMexit(EXIT_FAILURE);
         }
 
-        fflush(init_file);
         fclose(init_file);
+
+        free(ic);
+        free(river_ic);
     }
 }
 
@@ -415,10 +480,8 @@ void PrintDataTecplot(varctrl_struct *varctrl, int nprint, int t, int lapse)
 }
 
 void PrintPerf(void *cvode_mem, int t, int starttime, double cputime_dt,
-    double cputime, double maxstep, FILE *perf_file)
+    double cputime, double maxstep, perfstat_struct *perf0, FILE *perf_file)
 {
-    static double   dt;
-    static long int nst0, nfe0, nni0, ncfn0, netf0;
     long int        nst, nfe, nni, ncfn, netf;
     int             cv_flag;
 
@@ -455,31 +518,26 @@ void PrintPerf(void *cvode_mem, int t, int starttime, double cputime_dt,
     fprintf(perf_file, "%-8d%-8.3f%-16.3f%-8.2f",
         t - starttime, cputime_dt, cputime, maxstep);
     fprintf(perf_file, "%-8ld%-8ld%-8ld%-8ld%-8ld\n",
-        nst - nst0, nni - nni0, nfe - nfe0, netf - netf0, ncfn - ncfn0);
+        nst - perf0->nst, nni - perf0->nni, nfe - perf0->nfe,
+        netf - perf0->netf, ncfn - perf0->ncfn);
     fflush(perf_file);
 
-    dt = 0.0;
-
-    nst0 = nst;
-    nni0 = nni;
-    nfe0 = nfe;
-    netf0 = netf;
-    ncfn0 = ncfn;
-
-    dt += cputime_dt;
+    perf0->nst = nst;
+    perf0->nni = nni;
+    perf0->nfe = nfe;
+    perf0->netf = netf;
+    perf0->ncfn = ncfn;
 }
 
-void PrintWaterBal(FILE *watbal_file, int t, int tstart, int dt,
-    const elem_struct *elem, const river_struct *river)
+void PrintWaterBal(int t, int tstart, int dt, const elem_struct *elem,
+    const river_struct *river, print_struct *print)
 {
     int             i;
     double          tot_src = 0.0, tot_snk = 0.0, tot_strg = 0.0;
-    static double   tot_strg_prev = 0.0;
-    static double   error = 0.0;
 
     if (t == tstart + dt)
     {
-        fprintf(watbal_file, "%s\n", WB_HEADER);
+        fprintf(print->watbal_file, "%s\n", WB_HEADER);
     }
 
     for (i = 0; i < nelem; i++)
@@ -513,20 +571,21 @@ void PrintWaterBal(FILE *watbal_file, int t, int tstart, int dt,
         }
     }
 
-    if (tot_strg_prev != 0.0)
+    if (print->wb_strg_prev != 0.0)
     {
-        error += tot_src - tot_snk - (tot_strg - tot_strg_prev);
+        print->wb_error += tot_src - tot_snk - (tot_strg - print->wb_strg_prev);
 
-        fprintf(watbal_file, "%d %lg %lg %lg %lg %lg\n", t - tstart,
-            tot_src, tot_snk, tot_strg - tot_strg_prev,
-            tot_src - tot_snk - (tot_strg - tot_strg_prev), error);
-        fflush(watbal_file);
+        fprintf(print->watbal_file, "%d %lg %lg %lg %lg %lg\n", t - tstart,
+            tot_src, tot_snk, tot_strg - print->wb_strg_prev,
+            tot_src - tot_snk - (tot_strg - print->wb_strg_prev),
+            print->wb_error);
+        fflush(print->watbal_file);
     }
 
-    tot_strg_prev = tot_strg;
+    print->wb_strg_prev = tot_strg;
 }
 
-void PrintCVodeFinalStats(void *cvode_mem)
+void PrintCVodeFinalStats(int lin_solver, void *cvode_mem)
 {
     int             cv_flag;
     long int        nst;
@@ -573,6 +632,57 @@ void PrintCVodeFinalStats(void *cvode_mem)
         "num of nonlin solv conv fails = %-6ld "
         "num of err test fails = %-6ld\n",
         nni, ncfn, netf);
+
+    /* Linear solver statistics are kept by the attached linear solver
+     * module */
+    if (lin_solver == KLU_SOLVER)
+    {
+        long int        nje;
+
+        cv_flag = CVSlsGetNumJacEvals(cvode_mem, &nje);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        PIHMprintf(VL_NORMAL, "num of Jacobian evals = %-6ld\n", nje);
+    }
+    else
+    {
+        long int        nli;
+        long int        nfeLS;
+        long int        npe;
+        long int        nps;
+
+        cv_flag = CVSpilsGetNumLinIters(cvode_mem, &nli);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        cv_flag = CVSpilsGetNumRhsEvals(cvode_mem, &nfeLS);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        cv_flag = CVSpilsGetNumPrecEvals(cvode_mem, &npe);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        cv_flag = CVSpilsGetNumPrecSolves(cvode_mem, &nps);
+        if (!CheckCVodeFlag(cv_flag))
+        {
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        PIHMprintf(VL_NORMAL,
+            "num of lin iters = %-6ld num of lin solv rhs evals = %-6ld "
+            "num of prec evals = %-6ld num of prec solves = %-6ld\n",
+            nli, nfeLS, npe, nps);
+    }
 }
 
 int PrintNow(int intvl, int lapse, const pihm_t_struct *pihm_time)
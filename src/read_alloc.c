@@ -1,7 +1,13 @@
 #include "pihm.h"
 
-void ReadAlloc(pihm_struct pihm)
+void ReadAlloc(pihm_struct base, pihm_struct pihm)
 {
+    /*
+     * Read input files. When a base model is given, input tables and forcing
+     * of the base model, which are not modified by the model, are shared
+     * instead of read. Only control, calibration, and module parameter files
+     * are read
+     */
     char            proj[MAXSTRING];
     char           *token;
 
@@ -31,6 +37,7 @@ void ReadAlloc(pihm_struct pihm)
     sprintf(pihm->filename.calib,    "input/%s/%s.calib",    proj, project);
     sprintf(pihm->filename.ic,       "input/%s/%s.ic",       proj, project);
     sprintf(pihm->filename.tecplot,  "input/%s/%s.tecplot",  proj, proj);
+    sprintf(pihm->filename.cache,    "input/%s/%s.cache",    proj, proj);
 #if defined(_FBR_)
     sprintf(pihm->filename.geol,     "input/%s/%s.geol",     proj, proj);
     sprintf(pihm->filename.bedrock,  "input/%s/%s.bedrock",  proj, proj);
@@ -50,33 +57,54 @@ void ReadAlloc(pihm_struct pihm)
     sprintf(pihm->filename.bgcic,    "input/%s/%s.bgcic",    proj, proj);
 #endif
 
-    /* Read river input file */
-    ReadRiver(pihm->filename.riv, &pihm->rivtbl, &pihm->shptbl, &pihm->matltbl,
-        &pihm->forc);
+    if (snprintf(pihm->filename.output, MAXSTRING, "input/%s/%s.output",
+        proj, proj) >= MAXSTRING)
+    {
+        PIHMprintf(VL_ERROR, "Error: Project name %s is too long.\n", proj);
+        PIHMexit(EXIT_FAILURE);
+    }
 
-    /* Read mesh structure input file */
-    ReadMesh(pihm->filename.mesh, &pihm->meshtbl);
+    if (base != NULL && strcmp(pihm->filename.mesh, base->filename.mesh) != 0)
+    {
+        PIHMprintf(VL_ERROR, "Error: Models sharing inputs must read input "
+            "files from the same input directory.\n");
+        PIHMexit(EXIT_FAILURE);
+    }
 
-    /* Read attribute table input file */
-    ReadAtt(pihm->filename.att, &pihm->atttbl);
+    pihm->shared = (base != NULL);
 
-    /* Read soil input file */
-    ReadSoil(pihm->filename.soil, &pihm->soiltbl);
+    if (pihm->shared)
+    {
+        /* Share river, mesh, attribute, soil, and land cover tables */
+        pihm->rivtbl = base->rivtbl;
+        pihm->shptbl = base->shptbl;
+        pihm->matltbl = base->matltbl;
+        pihm->meshtbl = base->meshtbl;
+        pihm->atttbl = base->atttbl;
+        pihm->soiltbl = base->soiltbl;
+        pihm->lctbl = base->lctbl;
+#if defined(_FBR_)
+        pihm->geoltbl = base->geoltbl;
+#endif
+    }
+    else
+    {
+        /* Read river input file */
+        ReadRiver(pihm->filename.riv, &pihm->rivtbl, &pihm->shptbl,
+            &pihm->matltbl, &pihm->forc);
 
-    /* Read land cover input file */
-    ReadLc(pihm->filename.lc, &pihm->lctbl);
+        /* Read mesh structure input file */
+        ReadMesh(pihm->filename.mesh, &pihm->meshtbl);
 
-    /* Read meteorological forcing input file */
-    ReadForc(pihm->filename.meteo, &pihm->forc);
+        /* Read attribute table input file */
+        ReadAtt(pihm->filename.att, &pihm->atttbl);
 
-    /* Read LAI input file */
-    ReadLai(pihm->filename.lai, &pihm->forc, &pihm->atttbl);
+        /* Read soil input file */
+        ReadSoil(pihm->filename.soil, &pihm->soiltbl);
 
-    /* Read source and sink input file */
-    pihm->forc.nsource = 0;
-#if NOT_YET_IMPLEMENTED
-    ReadSS ();
-#endif
+        /* Read land cover input file */
+        ReadLc(pihm->filename.lc, &pihm->lctbl);
+    }
 
     /* Read model control file */
     ReadPara(pihm->filename.para, &pihm->ctrl);
@@ -84,30 +112,93 @@ void ReadAlloc(pihm_struct pihm)
     /* Read calibration input file */
     ReadCalib(pihm->filename.calib, &pihm->cal);
 
+    /* Meteorological forcing of the base model is shared unless it is
+     * streamed, or modified by climate scenarios of either model */
+    pihm->forc.meteo_shared = (pihm->shared &&
+        base->forc.metstream == NULL &&
+        base->cal.prcp == 1.0 && base->cal.sfctmp == 0.0 &&
+        pihm->cal.prcp == 1.0 && pihm->cal.sfctmp == 0.0);
+
+    if (pihm->shared)
+    {
+        /* Share boundary condition, LAI, and radiation forcing */
+        ShareForc(&base->forc, &pihm->forc);
+    }
+    else
+    {
+        pihm->forc.shared = 0;
+    }
+
+    if (!pihm->forc.meteo_shared)
+    {
+        /* Read meteorological forcing input file */
+        ReadForc(pihm->filename.meteo,
+            (convert_mode) ? 0 : pihm->ctrl.meteo_window, &pihm->forc);
+    }
+
+    if (!pihm->shared)
+    {
+        /* Read LAI input file */
+        ReadLai(pihm->filename.lai, &pihm->forc, &pihm->atttbl);
+    }
+
+    /* Read source and sink input file */
+    pihm->forc.nsource = 0;
+#if NOT_YET_IMPLEMENTED
+    ReadSS ();
+#endif
+
     if (tecplot)
     {
         ReadTecplot(pihm->filename.tecplot, &pihm->ctrl);
     }
 
+    /* Read output reducer control file, which is optional */
+    if (PIHMaccess(pihm->filename.output, F_OK) != -1)
+    {
+        ReadOutput(pihm->filename.output, &pihm->reducetbl);
+    }
+    else
+    {
+        pihm->reducetbl.ngroup = 0;
+        pihm->reducetbl.nreducer = 0;
+    }
+
 #if defined(_FBR_)
-    /* Read geology input file */
-    ReadGeol (pihm->filename.geol, &pihm->geoltbl);
+    if (pihm->shared)
+    {
+        /* Bedrock output controls are read from the shared bedrock control
+         * file */
+        pihm->ctrl.prtvrbl[FBRUNSAT_CTRL] = base->ctrl.prtvrbl[FBRUNSAT_CTRL];
+        pihm->ctrl.prtvrbl[FBRGW_CTRL] = base->ctrl.prtvrbl[FBRGW_CTRL];
+        pihm->ctrl.prtvrbl[FBRINFIL_CTRL] = base->ctrl.prtvrbl[FBRINFIL_CTRL];
+        pihm->ctrl.prtvrbl[FBRRECHG_CTRL] = base->ctrl.prtvrbl[FBRRECHG_CTRL];
+        pihm->ctrl.prtvrbl[FBRFLOW_CTRL] = base->ctrl.prtvrbl[FBRFLOW_CTRL];
+    }
+    else
+    {
+        /* Read geology input file */
+        ReadGeol (pihm->filename.geol, &pihm->geoltbl);
 
-    /* Read bedrock control file */
-    ReadBedrock(pihm->filename.bedrock, &pihm->atttbl, &pihm->meshtbl,
-        &pihm->ctrl);
+        /* Read bedrock control file */
+        ReadBedrock(pihm->filename.bedrock, &pihm->atttbl, &pihm->meshtbl,
+            &pihm->ctrl);
+    }
 #endif
 
     /* Read boundary condition input file
      * Boundary conditions might be needed by fbr thus should be read in after
      * reading bedrock input */
-    ReadBc(pihm->filename.bc, &pihm->forc, &pihm->atttbl);
+    if (!pihm->shared)
+    {
+        ReadBc(pihm->filename.bc, &pihm->forc, &pihm->atttbl);
+    }
 
 #if defined(_NOAH_)
     /* Read LSM input file */
     ReadLsm(pihm->filename.lsm, &pihm->siteinfo, &pihm->ctrl, &pihm->noahtbl);
 
-    if (pihm->ctrl.rad_mode == TOPO_SOL)
+    if (pihm->ctrl.rad_mode == TOPO_SOL && !pihm->shared)
     {
         /* Read radiation input file */
         ReadRad(pihm->filename.rad, &pihm->forc);
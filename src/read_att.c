@@ -3,15 +3,11 @@
 void ReadAtt(const char *filename, atttbl_struct *atttbl)
 {
     int             i;
-    FILE           *att_file;   /* Pointer to .att file */
-    char            cmdstr[MAXSTRING];
-    int             match;
-    int             index;
-    int             lno = 0;
+    txtfile_struct  txt;
+    int             n = 0;
+    int             bad;
 
-    att_file = fopen(filename, "r");
-    CheckFile(att_file, filename);
-    PIHMprintf(VL_VERBOSE, " Reading %s\n", filename);
+    ReadTextFile(filename, &txt);
 
     atttbl->soil = (int *)malloc(nelem * sizeof(int));
     atttbl->geol = (int *)malloc(nelem * sizeof(int));
@@ -25,23 +21,49 @@ void ReadAtt(const char *filename, atttbl_struct *atttbl)
     atttbl->lai = (int *)malloc(nelem * sizeof(int));
     atttbl->source = (int *)malloc(nelem * sizeof(int));
 
-    NextLine(att_file, cmdstr, &lno);
+    /* Skip header line */
+    n++;
+
+    /* Records are parsed in parallel. The first bad record is reported */
+    bad = nelem;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
     for (i = 0; i < nelem; i++)
     {
-        NextLine(att_file, cmdstr, &lno);
-        match = sscanf(cmdstr, "%d %d %d %d %d %d %d %d %d %d",
-            &index,
-            &atttbl->soil[i], &atttbl->geol[i], &atttbl->lc[i],
-            &atttbl->meteo[i], &atttbl->lai[i], &atttbl->source[i],
-            &atttbl->bc[i][0], &atttbl->bc[i][1], &atttbl->bc[i][2]);
-        if (match != 10)
+        const char     *str;
+        int             index;
+
+        str = TextLine(&txt, n + i);
+        if (!ScanInt(&str, &index) ||
+            !ScanInt(&str, &atttbl->soil[i]) ||
+            !ScanInt(&str, &atttbl->geol[i]) ||
+            !ScanInt(&str, &atttbl->lc[i]) ||
+            !ScanInt(&str, &atttbl->meteo[i]) ||
+            !ScanInt(&str, &atttbl->lai[i]) ||
+            !ScanInt(&str, &atttbl->source[i]) ||
+            !ScanInt(&str, &atttbl->bc[i][0]) ||
+            !ScanInt(&str, &atttbl->bc[i][1]) ||
+            !ScanInt(&str, &atttbl->bc[i][2]))
         {
-            PIHMprintf(VL_ERROR,
-                "Error reading attribute of the %dth element.\n", i + 1);
-            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
-            PIHMexit(EXIT_FAILURE);
+#if defined(_OPENMP)
+# pragma omp critical
+#endif
+            {
+                bad = (i < bad) ? i : bad;
+            }
         }
     }
 
-    fclose(att_file);
+    if (bad < nelem)
+    {
+        PIHMprintf(VL_ERROR,
+            "Error reading attribute of the %dth element.\n", bad + 1);
+        PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename,
+            TextLno(&txt, n + bad));
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    FreeTextFile(&txt);
 }
@@ -4,12 +4,12 @@ void ReadBc(const char *filename, forc_struct *forc,
     const atttbl_struct *atttbl)
 {
     int             i, j;
-    FILE           *bc_file;    /* Pointer to .ibc file */
+    txtfile_struct  txt;
     int             read_bc = 0;
-    char            cmdstr[MAXSTRING];
     int             match;
     int             index;
-    int             lno = 0;
+    int             n = 0;
+    int             bad;
 
     for (i = 0; i < nelem; i++)
     {
@@ -32,71 +32,48 @@ void ReadBc(const char *filename, forc_struct *forc,
 
     forc->nbc = 0;
 
-    if (read_bc)
+    if (read_bc &&
+        !ReadBinTs(filename, 1, &forc->nbc, &forc->bc, &forc->bc_map))
     {
-        bc_file = fopen(filename, "r");
-        CheckFile(bc_file, filename);
-        PIHMprintf(VL_VERBOSE, " Reading %s\n", filename);
+        ReadTextFile(filename, &txt);
 
-        FindLine(bc_file, "BOF", &lno, filename);
+        forc->nbc = CountTextOccurr(&txt, "BC_TS");
 
-        forc->nbc = CountOccurr(bc_file, "BC_TS");
-
-        FindLine(bc_file, "BOF", &lno, filename);
         if (forc->nbc > 0)
         {
             forc->bc =
                 (tsdata_struct *)malloc(forc->nbc * sizeof(tsdata_struct));
 
-            NextLine(bc_file, cmdstr, &lno);
             for (i = 0; i < forc->nbc; i++)
             {
-                match = sscanf(cmdstr, "%*s %d", &index);
+                match = sscanf(TextLine(&txt, n), "%*s %d", &index);
                 if (match != 1 || i != index - 1)
                 {
                     PIHMprintf(VL_ERROR,
                         "Error reading the %dth boundary condition "
                         "time series.\n", i + 1);
                     PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
-                        filename, lno);
+                        filename, TextLno(&txt, n));
                     PIHMexit(EXIT_FAILURE);
                 }
                 /* Skip header lines */
-                NextLine(bc_file, cmdstr, &lno);
-                NextLine(bc_file, cmdstr, &lno);
-                forc->bc[i].length = CountLine(bc_file, cmdstr, 1, "BC_TS");
-            }
+                n += 3;
 
-            /* Rewind and read */
-            FindLine(bc_file, "BOF", &lno, filename);
-            for (i = 0; i < forc->nbc; i++)
-            {
-                /* Skip header lines */
-                NextLine(bc_file, cmdstr, &lno);
-                NextLine(bc_file, cmdstr, &lno);
-                NextLine(bc_file, cmdstr, &lno);
+                forc->bc[i].length = CountTextLine(&txt, n, 1, "BC_TS");
 
-                forc->bc[i].ftime =
-                    (int *)malloc(forc->bc[i].length * sizeof(int));
-                forc->bc[i].data =
-                    (double **)malloc(forc->bc[i].length * sizeof(double *));
-                for (j = 0; j < forc->bc[i].length; j++)
+                bad = ReadTextTs(&txt, n, 1, &forc->bc[i]);
+                if (bad >= 0)
                 {
-                    forc->bc[i].data[j] = (double *)malloc(sizeof(double));
-                    NextLine(bc_file, cmdstr, &lno);
-                    if (!ReadTS(cmdstr, &forc->bc[i].ftime[j],
-                        &forc->bc[i].data[j][0], 1))
-                    {
-                        PIHMprintf(VL_ERROR,
-                            "Error reading boundary condition.");
-                        PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
-                            filename, lno);
-                        PIHMexit(EXIT_FAILURE);
-                    }
+                    PIHMprintf(VL_ERROR,
+                        "Error reading boundary condition.");
+                    PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                        filename, TextLno(&txt, bad));
+                    PIHMexit(EXIT_FAILURE);
                 }
+                n += forc->bc[i].length;
             }
         }
 
-        fclose(bc_file);
+        FreeTextFile(&txt);
     }
 }
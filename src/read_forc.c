@@ -1,32 +1,41 @@
 #include "pihm.h"
 
-void ReadForc(const char *filename, forc_struct *forc)
+void ReadForc(const char *filename, int window, forc_struct *forc)
 {
-    FILE           *meteo_file;
-    char            cmdstr[MAXSTRING];
-    int             i, j;
+    txtfile_struct  txt;
+    int             i;
     int             match;
     int             index;
-    int             lno = 0;
+    int             n = 0;
+    int             bad;
 
-    meteo_file = fopen(filename, "r");
-    CheckFile(meteo_file, filename);
-    PIHMprintf(VL_VERBOSE, " Reading %s\n", filename);
+    forc->metstream = NULL;
 
-    FindLine(meteo_file, "BOF", &lno, filename);
+    if (ReadBinTs(filename, NUM_METEO_VAR, &forc->nmeteo, &forc->meteo,
+        &forc->meteo_map))
+    {
+        return;
+    }
+
+    if (window > 0)
+    {
+        /* Stream meteorological forcing during simulation */
+        ReadMeteoStream(filename, window, forc);
+        return;
+    }
 
-    forc->nmeteo = CountOccurr(meteo_file, "METEO_TS");
+    ReadTextFile(filename, &txt);
+
+    forc->nmeteo = CountTextOccurr(&txt, "METEO_TS");
 
-    FindLine(meteo_file, "BOF", &lno, filename);
     if (forc->nmeteo > 0)
     {
         forc->meteo =
             (tsdata_struct *)malloc(forc->nmeteo * sizeof(tsdata_struct));
 
-        NextLine(meteo_file, cmdstr, &lno);
         for (i = 0; i < forc->nmeteo; i++)
         {
-            match = sscanf(cmdstr, "%*s %d %*s %lf",
+            match = sscanf(TextLine(&txt, n), "%*s %d %*s %lf",
                 &index, &forc->meteo[i].zlvl_wind);
             if (match != 2 || i != index - 1)
             {
@@ -34,46 +43,86 @@ void ReadForc(const char *filename, forc_struct *forc)
                     "Error reading the %dth meteorological forcing"
                     " time series.\n", i + 1);
                 PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
-                    filename, lno);
+                    filename, TextLno(&txt, n));
                 PIHMexit(EXIT_FAILURE);
             }
             /* Skip header lines */
-            NextLine(meteo_file, cmdstr, &lno);
-            NextLine(meteo_file, cmdstr, &lno);
-            forc->meteo[i].length =
-                CountLine(meteo_file, cmdstr, 1, "METEO_TS");
-        }
+            n += 3;
 
-        /* Rewind and read */
-        FindLine(meteo_file, "BOF", &lno, filename);
-        for (i = 0; i < forc->nmeteo; i++)
-        {
-            /* Skip header lines */
-            NextLine(meteo_file, cmdstr, &lno);
-            NextLine(meteo_file, cmdstr, &lno);
-            NextLine(meteo_file, cmdstr, &lno);
-
-            forc->meteo[i].ftime =
-                (int *)malloc(forc->meteo[i].length * sizeof(int));
-            forc->meteo[i].data =
-                (double **)malloc(forc->meteo[i].length * sizeof(double *));
-            for (j = 0; j < forc->meteo[i].length; j++)
+            forc->meteo[i].length = CountTextLine(&txt, n, 1, "METEO_TS");
+
+            bad = ReadTextTs(&txt, n, NUM_METEO_VAR, &forc->meteo[i]);
+            if (bad >= 0)
             {
-                forc->meteo[i].data[j] =
-                    (double *)malloc(NUM_METEO_VAR * sizeof(double));
-                NextLine(meteo_file, cmdstr, &lno);
-                if (!ReadTS(cmdstr, &forc->meteo[i].ftime[j],
-                    &forc->meteo[i].data[j][0], NUM_METEO_VAR))
-                {
-                    PIHMprintf(VL_ERROR,
-                        "Error reading meteorological forcing.");
-                    PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
-                        filename, lno);
-                    PIHMexit(EXIT_FAILURE);
-                }
+                PIHMprintf(VL_ERROR,
+                    "Error reading meteorological forcing.");
+                PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                    filename, TextLno(&txt, bad));
+                PIHMexit(EXIT_FAILURE);
             }
+            n += forc->meteo[i].length;
         }
     }
 
-    fclose(meteo_file);
+    FreeTextFile(&txt);
+}
+
+void ShareForc(const forc_struct *base, forc_struct *forc)
+{
+    /*
+     * Share forcing time series of another model. Time series structures are
+     * copied so that forcing values at model time, cursors, and maps to model
+     * grids are owned by each model, while forcing times and values at
+     * forcing times are used in place
+     */
+    forc->shared = 1;
+
+    forc->nriverbc = base->nriverbc;
+    forc->riverbc = ShareTs(base->nriverbc, base->riverbc);
+
+    forc->nbc = base->nbc;
+    forc->bc = ShareTs(base->nbc, base->bc);
+    forc->bc_map.addr = NULL;
+
+    forc->nlai = base->nlai;
+    forc->lai = ShareTs(base->nlai, base->lai);
+    forc->lai_map.addr = NULL;
+
+#if defined(_NOAH_)
+    forc->nrad = base->nrad;
+    forc->rad = ShareTs(base->nrad, base->rad);
+    forc->rad_map.addr = NULL;
+#endif
+
+    if (forc->meteo_shared)
+    {
+        forc->nmeteo = base->nmeteo;
+        forc->meteo = ShareTs(base->nmeteo, base->meteo);
+        forc->meteo_map.addr = NULL;
+        forc->metstream = NULL;
+    }
+}
+
+tsdata_struct *ShareTs(int nts, const tsdata_struct *base)
+{
+    tsdata_struct  *ts;
+    int             i;
+
+    if (nts <= 0)
+    {
+        return NULL;
+    }
+
+    ts = (tsdata_struct *)malloc(nts * sizeof(tsdata_struct));
+
+    for (i = 0; i < nts; i++)
+    {
+        ts[i] = base[i];
+        ts[i].cursor = 0;
+        ts[i].value = NULL;
+        ts[i].grid = NULL;
+        ts[i].bcvar = NULL;
+    }
+
+    return ts;
 }
@@ -8,6 +8,23 @@ int ReadTS(const char *cmdstr, int *ftime, double *data, int nvrbl)
     int             bytes_consumed = 0;
     int             i;
     int             success = 1;
+    const char     *str;
+
+    /* Use the numeric tokenizer for time in "YYYY-MM-DD hh:mm" format. It is
+     * faster than scanf, and can be used in parallel */
+    str = cmdstr;
+    if (ScanTime(&str, ftime))
+    {
+        for (i = 0; i < nvrbl; i++)
+        {
+            if (!ScanDouble(&str, &data[i]))
+            {
+                success = 0;
+            }
+        }
+
+        return success;
+    }
 
     match = sscanf(cmdstr + bytes_consumed, "%s %s%n", ts1, ts2, &bytes_now);
     bytes_consumed += bytes_now;
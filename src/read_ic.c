@@ -5,6 +5,8 @@ void ReadIc(const char *filename, elem_struct *elem, river_struct *river)
     FILE           *ic_file;
     int             i;
     int             size;
+    ic_struct      *ic;
+    river_ic_struct *river_ic;
 
     ic_file = fopen(filename, "rb");
     CheckFile(ic_file, filename);
@@ -25,15 +27,31 @@ void ReadIc(const char *filename, elem_struct *elem, river_struct *river)
 
     fseek(ic_file, 0L, SEEK_SET);
 
+    ic = (ic_struct *)malloc(nelem * sizeof(ic_struct));
+    river_ic = (river_ic_struct *)malloc(nriver * sizeof(river_ic_struct));
+
+    if (fread(ic, sizeof(ic_struct), nelem, ic_file) != (size_t)nelem ||
+        fread(river_ic, sizeof(river_ic_struct), nriver, ic_file) !=
+        (size_t)nriver)
+    {
+        PIHMprintf(VL_ERROR, "Error reading %s.\n", filename);
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    fclose(ic_file);
+
+    /* Initial conditions are stored in the order of element and river ids
+     * in the input files, which may differ from the model order */
     for (i = 0; i < nelem; i++)
     {
-        fread(&elem[i].ic, sizeof(ic_struct), 1, ic_file);
+        elem[i].ic = ic[elem[i].ind - 1];
     }
 
     for (i = 0; i < nriver; i++)
     {
-        fread(&river[i].ic, sizeof(river_ic_struct), 1, ic_file);
+        river[i].ic = river_ic[river[i].ind - 1];
     }
 
-    fclose(ic_file);
+    free(ic);
+    free(river_ic);
 }
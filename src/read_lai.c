@@ -3,12 +3,12 @@
 void ReadLai(const char *filename, forc_struct *forc,
     const atttbl_struct *atttbl)
 {
-    char            cmdstr[MAXSTRING];
     int             read_lai = 0;
-    FILE           *lai_file;
-    int             i, j;
+    txtfile_struct  txt;
+    int             i;
     int             index;
-    int             lno = 0;
+    int             n = 0;
+    int             bad;
 
     for (i = 0; i < nelem; i++)
     {
@@ -21,71 +21,48 @@ void ReadLai(const char *filename, forc_struct *forc,
 
     forc->nlai = 0;
 
-    if (read_lai)
+    if (read_lai &&
+        !ReadBinTs(filename, 1, &forc->nlai, &forc->lai, &forc->lai_map))
     {
-        lai_file = fopen(filename, "r");
-        CheckFile(lai_file, filename);
-        PIHMprintf(VL_VERBOSE, " Reading %s\n", filename);
+        ReadTextFile(filename, &txt);
 
-        /* Start reading lai_file */
-        FindLine(lai_file, "BOF", &lno, filename);
+        forc->nlai = CountTextOccurr(&txt, "LAI_TS");
 
-        forc->nlai = CountOccurr(lai_file, "LAI_TS");
-
-        FindLine(lai_file, "BOF", &lno, filename);
         if (forc->nlai > 0)
         {
             forc->lai =
                 (tsdata_struct *)malloc(forc->nlai * sizeof(tsdata_struct));
 
-            NextLine(lai_file, cmdstr, &lno);
             for (i = 0; i < forc->nlai; i++)
             {
-                ReadKeyword(cmdstr, "LAI_TS", &index, 'i', filename, lno);
+                ReadKeyword(TextLine(&txt, n), "LAI_TS", &index, 'i',
+                    filename, TextLno(&txt, n));
 
                 if (i != index - 1)
                 {
                     PIHMprintf(VL_ERROR,
                         "Error reading the %dth LAI time series.\n", i + 1);
                     PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
-                        filename, lno);
+                        filename, TextLno(&txt, n));
                     PIHMexit(EXIT_FAILURE);
                 }
                 /* Skip header lines */
-                NextLine(lai_file, cmdstr, &lno);
-                NextLine(lai_file, cmdstr, &lno);
-                forc->lai[i].length = CountLine(lai_file, cmdstr, 1, "LAI_TS");
-            }
+                n += 3;
 
-            /* Rewind and read */
-            FindLine(lai_file, "BOF", &lno, filename);
-            for (i = 0; i < forc->nlai; i++)
-            {
-                /* Skip header lines */
-                NextLine(lai_file, cmdstr, &lno);
-                NextLine(lai_file, cmdstr, &lno);
-                NextLine(lai_file, cmdstr, &lno);
+                forc->lai[i].length = CountTextLine(&txt, n, 1, "LAI_TS");
 
-                forc->lai[i].ftime =
-                    (int *)malloc(forc->lai[i].length * sizeof(int));
-                forc->lai[i].data =
-                    (double **)malloc(forc->lai[i].length * sizeof(double *));
-                for (j = 0; j < forc->lai[i].length; j++)
+                bad = ReadTextTs(&txt, n, 1, &forc->lai[i]);
+                if (bad >= 0)
                 {
-                    forc->lai[i].data[j] = (double *)malloc(sizeof(double));
-                    NextLine(lai_file, cmdstr, &lno);
-                    if (!ReadTS(cmdstr, &forc->lai[i].ftime[j],
-                        &forc->lai[i].data[j][0], 1))
-                    {
-                        PIHMprintf(VL_ERROR, "Error reading LAI forcing.");
-                        PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
-                            filename, lno);
-                        PIHMexit(EXIT_FAILURE);
-                    }
+                    PIHMprintf(VL_ERROR, "Error reading LAI forcing.");
+                    PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                        filename, TextLno(&txt, bad));
+                    PIHMexit(EXIT_FAILURE);
                 }
+                n += forc->lai[i].length;
             }
         }
 
-        fclose(lai_file);
+        FreeTextFile(&txt);
     }
 }
@@ -2,77 +2,124 @@
 
 void ReadMesh(const char *filename, meshtbl_struct *meshtbl)
 {
-    FILE           *mesh_file;
+    txtfile_struct  txt;
     int             i;
-    char            cmdstr[MAXSTRING];
-    int             match;
-    int             index;
-    int             lno = 0;
+    int             n = 0;
+    int             bad;
 
-    mesh_file = fopen(filename, "r");
-    CheckFile(mesh_file, filename);
-    PIHMprintf(VL_VERBOSE, " Reading %s\n", filename);
+    ReadTextFile(filename, &txt);
 
     /*
      * Read element mesh block
      */
-    NextLine(mesh_file, cmdstr, &lno);
-    ReadKeyword(cmdstr, "NUMELE", &nelem, 'i', filename, lno);
+    ReadKeyword(TextLine(&txt, n), "NUMELE", &nelem, 'i', filename,
+        TextLno(&txt, n));
+    n++;
 
+    meshtbl->ind = (int *)malloc(nelem * sizeof(int));
     meshtbl->node = (int **)malloc(nelem * sizeof(int *));
     meshtbl->nabr = (int **)malloc(nelem * sizeof(int *));
 
     /* Skip header line */
-    NextLine(mesh_file, cmdstr, &lno);
+    n++;
 
+    /* Records are parsed in parallel. The first bad record is reported */
+    bad = nelem;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
     for (i = 0; i < nelem; i++)
     {
+        const char     *str;
+        int             index;
+
         meshtbl->node[i] = (int *)malloc(NUM_EDGE * sizeof(int));
         meshtbl->nabr[i] = (int *)malloc(NUM_EDGE * sizeof(int));
 
-        NextLine(mesh_file, cmdstr, &lno);
-        match = sscanf(cmdstr, "%d %d %d %d %d %d %d",
-            &index,
-            &meshtbl->node[i][0], &meshtbl->node[i][1], &meshtbl->node[i][2],
-            &meshtbl->nabr[i][0], &meshtbl->nabr[i][1], &meshtbl->nabr[i][2]);
-        if (match != 7 || i != index - 1)
+        str = TextLine(&txt, n + i);
+        if (!ScanInt(&str, &index) ||
+            !ScanInt(&str, &meshtbl->node[i][0]) ||
+            !ScanInt(&str, &meshtbl->node[i][1]) ||
+            !ScanInt(&str, &meshtbl->node[i][2]) ||
+            !ScanInt(&str, &meshtbl->nabr[i][0]) ||
+            !ScanInt(&str, &meshtbl->nabr[i][1]) ||
+            !ScanInt(&str, &meshtbl->nabr[i][2]) ||
+            i != index - 1)
+        {
+#if defined(_OPENMP)
+# pragma omp critical
+#endif
+            {
+                bad = (i < bad) ? i : bad;
+            }
+        }
+        else
         {
-            PIHMprintf(VL_ERROR,
-                "Error reading mesh description of the %dth element.\n", i + 1);
-            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
-            PIHMexit(EXIT_FAILURE);
+            meshtbl->ind[i] = index;
         }
     }
 
+    if (bad < nelem)
+    {
+        PIHMprintf(VL_ERROR,
+            "Error reading mesh description of the %dth element.\n", bad + 1);
+        PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename,
+            TextLno(&txt, n + bad));
+        PIHMexit(EXIT_FAILURE);
+    }
+    n += nelem;
+
     /*
      * Read node block
      */
-    NextLine(mesh_file, cmdstr, &lno);
-    ReadKeyword(cmdstr, "NUMNODE", &meshtbl->numnode, 'i', filename, lno);
+    ReadKeyword(TextLine(&txt, n), "NUMNODE", &meshtbl->numnode, 'i',
+        filename, TextLno(&txt, n));
+    n++;
 
     /* Skip header line */
-    NextLine(mesh_file, cmdstr, &lno);
+    n++;
 
     meshtbl->x = (double *)malloc(meshtbl->numnode * sizeof(double));
     meshtbl->y = (double *)malloc(meshtbl->numnode * sizeof(double));
     meshtbl->zmin = (double *)malloc(meshtbl->numnode * sizeof(double));
     meshtbl->zmax = (double *)malloc(meshtbl->numnode * sizeof(double));
 
+    bad = meshtbl->numnode;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
     for (i = 0; i < meshtbl->numnode; i++)
     {
-        NextLine(mesh_file, cmdstr, &lno);
-        match = sscanf(cmdstr, "%d %lf %lf %lf %lf",
-            &index,
-            &meshtbl->x[i], &meshtbl->y[i],
-            &meshtbl->zmin[i], &meshtbl->zmax[i]);
-        if (match != 5 || i != index - 1)
+        const char     *str;
+        int             index;
+
+        str = TextLine(&txt, n + i);
+        if (!ScanInt(&str, &index) ||
+            !ScanDouble(&str, &meshtbl->x[i]) ||
+            !ScanDouble(&str, &meshtbl->y[i]) ||
+            !ScanDouble(&str, &meshtbl->zmin[i]) ||
+            !ScanDouble(&str, &meshtbl->zmax[i]) ||
+            i != index - 1)
         {
-            PIHMprintf(VL_ERROR,
-                "Error reading description of the %dth node!\n", i + 1);
-            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
-            PIHMexit(EXIT_FAILURE);
+#if defined(_OPENMP)
+# pragma omp critical
+#endif
+            {
+                bad = (i < bad) ? i : bad;
+            }
         }
     }
 
-    fclose(mesh_file);
+    if (bad < meshtbl->numnode)
+    {
+        PIHMprintf(VL_ERROR,
+            "Error reading description of the %dth node!\n", bad + 1);
+        PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename,
+            TextLno(&txt, n + bad));
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    FreeTextFile(&txt);
 }
@@ -0,0 +1,217 @@
+#include "pihm.h"
+
+void ReadOutput(const char *filename, reducetbl_struct *reducetbl)
+{
+    /*
+     * Read output reducer control file. Element (river segment) groups are
+     * defined first, each followed by the ids of its members. Each reducer
+     * reduces an output variable over a group
+     */
+    txtfile_struct  txt;
+    char            typestr[MAXSTRING];
+    char            opstr[MAXSTRING];
+    int             i, j;
+    int             n = 0;
+
+    ReadTextFile(filename, &txt);
+
+    /*
+     * Read element (river segment) groups
+     */
+    ReadKeyword(TextLine(&txt, n), "NUMGROUP", &reducetbl->ngroup, 'i',
+        filename, TextLno(&txt, n));
+    n++;
+
+    reducetbl->grpname =
+        (char (*)[MAXSTRING])malloc(reducetbl->ngroup * MAXSTRING);
+    reducetbl->grptype = (int *)malloc(reducetbl->ngroup * sizeof(int));
+    reducetbl->nmember = (int *)malloc(reducetbl->ngroup * sizeof(int));
+    reducetbl->member = (int **)malloc(reducetbl->ngroup * sizeof(int *));
+
+    for (i = 0; i < reducetbl->ngroup; i++)
+    {
+        const char     *str;
+        int             pos;
+        int             match;
+
+        str = TextLine(&txt, n);
+        match = sscanf(str, "%s %s %s%n", opstr, reducetbl->grpname[i],
+            typestr, &pos);
+        if (match != 3 || strcasecmp(opstr, "GROUP") != 0)
+        {
+            PIHMprintf(VL_ERROR, "Error reading the %dth output group.\n",
+                i + 1);
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                filename, TextLno(&txt, n));
+            PIHMexit(EXIT_FAILURE);
+        }
+        str += pos;
+
+        for (j = 0; j < i; j++)
+        {
+            if (strcmp(reducetbl->grpname[i], reducetbl->grpname[j]) == 0)
+            {
+                PIHMprintf(VL_ERROR, "Error: Output group %s is defined "
+                    "more than once.\n", reducetbl->grpname[i]);
+                PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                    filename, TextLno(&txt, n));
+                PIHMexit(EXIT_FAILURE);
+            }
+        }
+
+        if (strcasecmp(typestr, "ALL") == 0)
+        {
+            reducetbl->grptype[i] = ALLVAR;
+            reducetbl->nmember[i] = 0;
+            reducetbl->member[i] = NULL;
+            n++;
+            continue;
+        }
+        else if (strcasecmp(typestr, "ELEM") == 0)
+        {
+            reducetbl->grptype[i] = ELEMVAR;
+        }
+        else if (strcasecmp(typestr, "RIVER") == 0)
+        {
+            reducetbl->grptype[i] = RIVERVAR;
+        }
+        else
+        {
+            PIHMprintf(VL_ERROR, "Error: Unknown output group type %s.\n",
+                typestr);
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                filename, TextLno(&txt, n));
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        if (!ScanInt(&str, &reducetbl->nmember[i]) ||
+            reducetbl->nmember[i] < 1)
+        {
+            PIHMprintf(VL_ERROR, "Error reading the number of members of "
+                "output group %s.\n", reducetbl->grpname[i]);
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                filename, TextLno(&txt, n));
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        reducetbl->member[i] =
+            (int *)malloc(reducetbl->nmember[i] * sizeof(int));
+
+        /* Member ids may span multiple lines */
+        j = 0;
+        while (j < reducetbl->nmember[i])
+        {
+            while (isspace((unsigned char)*str))
+            {
+                str++;
+            }
+
+            if (ScanInt(&str, &reducetbl->member[i][j]))
+            {
+                j++;
+            }
+            else if (*str == '\0')
+            {
+                n++;
+                if (n >= txt.nline)
+                {
+                    PIHMprintf(VL_ERROR, "Error: Unexpected end of file "
+                        "reading members of output group %s.\n",
+                        reducetbl->grpname[i]);
+                    PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                        filename, TextLno(&txt, n));
+                    PIHMexit(EXIT_FAILURE);
+                }
+                str = TextLine(&txt, n);
+            }
+            else
+            {
+                PIHMprintf(VL_ERROR, "Error reading members of output group "
+                    "%s.\n", reducetbl->grpname[i]);
+                PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                    filename, TextLno(&txt, n));
+                PIHMexit(EXIT_FAILURE);
+            }
+        }
+        n++;
+    }
+
+    /*
+     * Read reducers
+     */
+    ReadKeyword(TextLine(&txt, n), "NUMREDUCER", &reducetbl->nreducer, 'i',
+        filename, TextLno(&txt, n));
+    n++;
+
+    reducetbl->var =
+        (char (*)[MAXSTRING])malloc(reducetbl->nreducer * MAXSTRING);
+    reducetbl->group = (int *)malloc(reducetbl->nreducer * sizeof(int));
+    reducetbl->op = (int *)malloc(reducetbl->nreducer * sizeof(int));
+
+    for (i = 0; i < reducetbl->nreducer; i++)
+    {
+        char            grpstr[MAXSTRING];
+        int             match;
+
+        match = sscanf(TextLine(&txt, n), "%s %s %s", reducetbl->var[i],
+            grpstr, opstr);
+        if (match != 3)
+        {
+            PIHMprintf(VL_ERROR, "Error reading the %dth output reducer.\n",
+                i + 1);
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                filename, TextLno(&txt, n));
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        reducetbl->group[i] = -1;
+        for (j = 0; j < reducetbl->ngroup; j++)
+        {
+            if (strcmp(grpstr, reducetbl->grpname[j]) == 0)
+            {
+                reducetbl->group[i] = j;
+                break;
+            }
+        }
+        if (reducetbl->group[i] < 0)
+        {
+            PIHMprintf(VL_ERROR, "Error: Output group %s is not defined.\n",
+                grpstr);
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                filename, TextLno(&txt, n));
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        if (strcasecmp(opstr, "MEAN") == 0)
+        {
+            reducetbl->op[i] = REDUCE_MEAN;
+        }
+        else if (strcasecmp(opstr, "SUM") == 0)
+        {
+            reducetbl->op[i] = REDUCE_SUM;
+        }
+        else if (strcasecmp(opstr, "MIN") == 0)
+        {
+            reducetbl->op[i] = REDUCE_MIN;
+        }
+        else if (strcasecmp(opstr, "MAX") == 0)
+        {
+            reducetbl->op[i] = REDUCE_MAX;
+        }
+        else if (strcasecmp(opstr, "SELECT") == 0)
+        {
+            reducetbl->op[i] = REDUCE_SELECT;
+        }
+        else
+        {
+            PIHMprintf(VL_ERROR, "Error: Unknown output reducer %s.\n",
+                opstr);
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                filename, TextLno(&txt, n));
+            PIHMexit(EXIT_FAILURE);
+        }
+        n++;
+    }
+
+    FreeTextFile(&txt);
+}
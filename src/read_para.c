@@ -21,6 +21,9 @@ void ReadPara(const char *filename, ctrl_struct *ctrl)
     /* Read through parameter file to find parameters */
     NextLine(para_file, cmdstr, &lno);
     ReadKeyword(cmdstr, "SIMULATION_MODE", &spinup_mode, 'i', filename, lno);
+    /* Spinup cycles may be accelerated */
+    ctrl->spinup_acc = (spinup_mode == ACC_SPINUP_MODE);
+    spinup_mode = (spinup_mode > 0) ? SPINUP_MODE : 0;
 
     NextLine(para_file, cmdstr, &lno);
     ReadKeyword(cmdstr, "INIT_MODE", &ctrl->init_type, 'i', filename, lno);
@@ -107,7 +110,154 @@ void ReadPara(const char *filename, ctrl_struct *ctrl)
     NextLine(para_file, cmdstr, &lno);
     ReadKeyword(cmdstr, "MIN_MAXSTEP", &ctrl->stmin, 'd', filename, lno);
 
+    /* Optional keywords. When missing, the model runs as before they were
+     * introduced */
     NextLine(para_file, cmdstr, &lno);
+    ctrl->lin_solver = SPGMR_SOLVER;
+    if (MatchToken(cmdstr, "LIN_SOLVER"))
+    {
+        ReadKeyword(cmdstr, "LIN_SOLVER", &ctrl->lin_solver, 'i', filename,
+            lno);
+        if (ctrl->lin_solver < SPGMR_SOLVER || ctrl->lin_solver > KLU_SOLVER)
+        {
+            PIHMprintf(VL_ERROR,
+                "Error: Linear solver type %d is not defined.\n",
+                ctrl->lin_solver);
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
+            PIHMexit(EXIT_FAILURE);
+        }
+#if !defined(_KLU_)
+        if (ctrl->lin_solver == KLU_SOLVER)
+        {
+            PIHMprintf(VL_ERROR, "Error: KLU solver is not available. "
+                "Please compile with KLU=on.\n");
+            PIHMexit(EXIT_FAILURE);
+        }
+#endif
+        NextLine(para_file, cmdstr, &lno);
+    }
+
+    ctrl->precond = NO_PRECOND;
+    if (MatchToken(cmdstr, "PRECOND"))
+    {
+        ReadKeyword(cmdstr, "PRECOND", &ctrl->precond, 'i', filename, lno);
+        ctrl->precond = (ctrl->precond > NO_PRECOND) ?
+            BLOCK_JACOBI : NO_PRECOND;
+        NextLine(para_file, cmdstr, &lno);
+    }
+
+    ctrl->multirate = 0;
+    if (MatchToken(cmdstr, "MULTIRATE"))
+    {
+        ReadKeyword(cmdstr, "MULTIRATE", &ctrl->multirate, 'i', filename,
+            lno);
+        if (ctrl->multirate < 0)
+        {
+            PIHMprintf(VL_ERROR, "Error: Number of model steps per slow step "
+                "should be non-negative.\n");
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
+            PIHMexit(EXIT_FAILURE);
+        }
+#if defined(_BGC_) || defined(_CYCLES_)
+        if (ctrl->multirate > 0)
+        {
+            PIHMprintf(VL_ERROR, "Error: Multi-rate integration is not "
+                "available for this model.\n");
+            PIHMexit(EXIT_FAILURE);
+        }
+#endif
+        NextLine(para_file, cmdstr, &lno);
+    }
+
+    ctrl->event_cpl = 0;
+    if (MatchToken(cmdstr, "EVENT_COUPLING"))
+    {
+        ReadKeyword(cmdstr, "EVENT_COUPLING", &ctrl->event_cpl, 'i',
+            filename, lno);
+        if (ctrl->event_cpl != 0 && ctrl->event_cpl != 1)
+        {
+            PIHMprintf(VL_ERROR,
+                "Error: Event coupling flag should be 0 or 1.\n");
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
+            PIHMexit(EXIT_FAILURE);
+        }
+        if (ctrl->event_cpl && ctrl->multirate > 0)
+        {
+            PIHMprintf(VL_ERROR, "Error: Event coupling is not available for "
+                "multi-rate integration.\n");
+            PIHMexit(EXIT_FAILURE);
+        }
+        NextLine(para_file, cmdstr, &lno);
+    }
+
+    ctrl->reorder = NO_REORDER;
+    if (MatchToken(cmdstr, "REORDER"))
+    {
+        ReadKeyword(cmdstr, "REORDER", &ctrl->reorder, 'i', filename, lno);
+        if (ctrl->reorder < NO_REORDER || ctrl->reorder > HILBERT_REORDER)
+        {
+            PIHMprintf(VL_ERROR,
+                "Error: Reordering type %d is not defined.\n", ctrl->reorder);
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
+            PIHMexit(EXIT_FAILURE);
+        }
+#if defined(_LUMPED_) || defined(_CYCLES_)
+        if (ctrl->reorder != NO_REORDER)
+        {
+            PIHMprintf(VL_ERROR, "Error: Model grid reordering is not "
+                "available for this model.\n");
+            PIHMexit(EXIT_FAILURE);
+        }
+#endif
+        NextLine(para_file, cmdstr, &lno);
+    }
+
+    ctrl->meteo_window = 0;
+    if (MatchToken(cmdstr, "METEO_WINDOW"))
+    {
+        ReadKeyword(cmdstr, "METEO_WINDOW", &ctrl->meteo_window, 'i',
+            filename, lno);
+        if (ctrl->meteo_window < 0 || ctrl->meteo_window == 1)
+        {
+            PIHMprintf(VL_ERROR, "Error: Meteorological forcing window "
+                "should be 0 or larger than 1.\n");
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
+            PIHMexit(EXIT_FAILURE);
+        }
+        NextLine(para_file, cmdstr, &lno);
+    }
+
+    ctrl->output_flush = 1;
+    if (MatchToken(cmdstr, "OUTPUT_FLUSH"))
+    {
+        ReadKeyword(cmdstr, "OUTPUT_FLUSH", &ctrl->output_flush, 'i',
+            filename, lno);
+        if (ctrl->output_flush < 0)
+        {
+            PIHMprintf(VL_ERROR, "Error: Output flush interval should be "
+                "non-negative.\n");
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
+            PIHMexit(EXIT_FAILURE);
+        }
+        NextLine(para_file, cmdstr, &lno);
+    }
+
+    ctrl->output_format = DAT_OUTPUT;
+    if (MatchToken(cmdstr, "OUTPUT_FORMAT"))
+    {
+        ReadKeyword(cmdstr, "OUTPUT_FORMAT", &ctrl->output_format, 'i',
+            filename, lno);
+        if (ctrl->output_format != DAT_OUTPUT &&
+            ctrl->output_format != CONTAINER_OUTPUT)
+        {
+            PIHMprintf(VL_ERROR, "Error: Output format %d is not defined.\n",
+                ctrl->output_format);
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
+            PIHMexit(EXIT_FAILURE);
+        }
+        NextLine(para_file, cmdstr, &lno);
+    }
+
     ctrl->prtvrbl[SURF_CTRL] = ReadPrtCtrl(cmdstr, "SURF", filename, lno);
 
     NextLine(para_file, cmdstr, &lno);
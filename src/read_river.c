@@ -3,26 +3,25 @@
 void ReadRiver(const char *filename, rivtbl_struct *rivtbl,
     shptbl_struct *shptbl, matltbl_struct *matltbl, forc_struct *forc)
 {
-    int             i, j;
-    FILE           *riv_file;
-    char            cmdstr[MAXSTRING];
+    int             i;
+    txtfile_struct  txt;
     int             match;
     int             index;
-    int             lno = 0;
+    int             n = 0;
+    int             bad;
 
-    riv_file = fopen(filename, "r");
-    CheckFile(riv_file, filename);
-    PIHMprintf(VL_VERBOSE, " Reading %s\n", filename);
+    ReadTextFile(filename, &txt);
 
     /*
      * Read river segment block
      */
     /* Read number of river segments */
-    FindLine(riv_file, "BOF", &lno, filename);
-    NextLine(riv_file, cmdstr, &lno);
-    ReadKeyword(cmdstr, "NUMRIV", &nriver, 'i', filename, lno);
+    ReadKeyword(TextLine(&txt, n), "NUMRIV", &nriver, 'i', filename,
+        TextLno(&txt, n));
+    n++;
 
     /* Allocate */
+    rivtbl->ind = (int *)malloc(nriver * sizeof(int));
     rivtbl->fromnode = (int *)malloc(nriver * sizeof(int));
     rivtbl->tonode = (int *)malloc(nriver * sizeof(int));
     rivtbl->down = (int *)malloc(nriver * sizeof(int));
@@ -34,31 +33,62 @@ void ReadRiver(const char *filename, rivtbl_struct *rivtbl,
     rivtbl->rsvr = (int *)malloc(nriver * sizeof(int));
 
     /* Skip header line */
-    NextLine(riv_file, cmdstr, &lno);
+    n++;
 
-    /* Read river segment information */
+    /* Read river segment information. Records are parsed in parallel, and
+     * the first bad record is reported */
+    bad = nriver;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
     for (i = 0; i < nriver; i++)
     {
-        NextLine(riv_file, cmdstr, &lno);
-        match = sscanf(cmdstr, "%d %d %d %d %d %d %d %d %d %d",
-            &index,
-            &rivtbl->fromnode[i], &rivtbl->tonode[i], &rivtbl->down[i],
-            &rivtbl->leftele[i], &rivtbl->rightele[i], &rivtbl->shp[i],
-            &rivtbl->matl[i], &rivtbl->bc[i], &rivtbl->rsvr[i]);
-        if (match != 10 || i != index - 1)
+        const char     *str;
+        int             ind;
+
+        str = TextLine(&txt, n + i);
+        if (!ScanInt(&str, &ind) ||
+            !ScanInt(&str, &rivtbl->fromnode[i]) ||
+            !ScanInt(&str, &rivtbl->tonode[i]) ||
+            !ScanInt(&str, &rivtbl->down[i]) ||
+            !ScanInt(&str, &rivtbl->leftele[i]) ||
+            !ScanInt(&str, &rivtbl->rightele[i]) ||
+            !ScanInt(&str, &rivtbl->shp[i]) ||
+            !ScanInt(&str, &rivtbl->matl[i]) ||
+            !ScanInt(&str, &rivtbl->bc[i]) ||
+            !ScanInt(&str, &rivtbl->rsvr[i]) ||
+            i != ind - 1)
         {
-            PIHMprintf(VL_ERROR,
-                "Error reading river attribute for the %dth segment.\n", i + 1);
-            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
-            PIHMexit(EXIT_FAILURE);
+#if defined(_OPENMP)
+# pragma omp critical
+#endif
+            {
+                bad = (i < bad) ? i : bad;
+            }
+        }
+        else
+        {
+            rivtbl->ind[i] = ind;
         }
     }
 
+    if (bad < nriver)
+    {
+        PIHMprintf(VL_ERROR,
+            "Error reading river attribute for the %dth segment.\n", bad + 1);
+        PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename,
+            TextLno(&txt, n + bad));
+        PIHMexit(EXIT_FAILURE);
+    }
+    n += nriver;
+
     /*
      * Read river shape information
      */
-    NextLine(riv_file, cmdstr, &lno);
-    ReadKeyword(cmdstr, "SHAPE", &shptbl->number, 'i', filename, lno);
+    ReadKeyword(TextLine(&txt, n), "SHAPE", &shptbl->number, 'i', filename,
+        TextLno(&txt, n));
+    n++;
 
     /* Allocate */
     shptbl->depth = (double *)malloc(shptbl->number * sizeof(double));
@@ -66,12 +96,11 @@ void ReadRiver(const char *filename, rivtbl_struct *rivtbl,
     shptbl->coeff = (double *)malloc(shptbl->number * sizeof(double));
 
     /* Skip header line */
-    NextLine(riv_file, cmdstr, &lno);
+    n++;
 
     for (i = 0; i < shptbl->number; i++)
     {
-        NextLine(riv_file, cmdstr, &lno);
-        match = sscanf(cmdstr, "%d %lf %d %lf",
+        match = sscanf(TextLine(&txt, n), "%d %lf %d %lf",
             &index,
             &shptbl->depth[i], &shptbl->intrpl_ord[i], &shptbl->coeff[i]);
         if (match != 4 || i != index - 1)
@@ -79,16 +108,19 @@ void ReadRiver(const char *filename, rivtbl_struct *rivtbl,
             PIHMprintf(VL_ERROR,
                 "Error reading river shape description for the %dth shape.\n",
                 i + 1);
-            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename,
+                TextLno(&txt, n));
             PIHMexit(EXIT_FAILURE);
         }
+        n++;
     }
 
     /*
      * Read river material information
      */
-    NextLine(riv_file, cmdstr, &lno);
-    ReadKeyword(cmdstr, "MATERIAL", &matltbl->number, 'i', filename, lno);
+    ReadKeyword(TextLine(&txt, n), "MATERIAL", &matltbl->number, 'i',
+        filename, TextLno(&txt, n));
+    n++;
 
     /* Allocate */
     matltbl->rough = (double *)malloc(matltbl->number * sizeof(double));
@@ -98,80 +130,64 @@ void ReadRiver(const char *filename, rivtbl_struct *rivtbl,
     matltbl->bedthick = (double *)malloc(matltbl->number * sizeof(double));
 
     /* Skip header line */
-    NextLine(riv_file, cmdstr, &lno);
+    n++;
 
     for (i = 0; i < matltbl->number; i++)
     {
-        NextLine(riv_file, cmdstr, &lno);
-        match = sscanf(cmdstr, "%d %lf %lf %lf %lf %lf",
+        match = sscanf(TextLine(&txt, n), "%d %lf %lf %lf %lf %lf",
             &index, &matltbl->rough[i], &matltbl->cwr[i],
             &matltbl->ksath[i], &matltbl->ksatv[i], &matltbl->bedthick[i]);
         if (match != 6 || i != index - 1)
         {
             PIHMprintf(VL_ERROR,
                 "Error reading description of the %dth material.\n", i + 1);
-            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
+            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename,
+                TextLno(&txt, n));
             PIHMexit(EXIT_FAILURE);
         }
+        n++;
     }
 
     /*
      * Read river boundary condition block
      */
-    NextLine(riv_file, cmdstr, &lno);
-    ReadKeyword(cmdstr, "BC", &forc->nriverbc, 'i', filename, lno);
+    ReadKeyword(TextLine(&txt, n), "BC", &forc->nriverbc, 'i', filename,
+        TextLno(&txt, n));
+    n++;
 
     if (forc->nriverbc > 0)
     {
         forc->riverbc =
             (tsdata_struct *)malloc(forc->nriverbc * sizeof(tsdata_struct));
 
-        NextLine(riv_file, cmdstr, &lno);
         for (i = 0; i < forc->nriverbc; i++)
         {
-            match = sscanf(cmdstr, "%*s %d", &index);
+            match = sscanf(TextLine(&txt, n), "%*s %d", &index);
             if (match != 1 || i != index - 1)
             {
                 PIHMprintf(VL_ERROR,
                     "Error reading description "
                     "of the %dth river boundary condition.\n", i);
                 PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
-                    filename, lno);
+                    filename, TextLno(&txt, n));
                 PIHMexit(EXIT_FAILURE);
             }
-            NextLine(riv_file, cmdstr, &lno);
-            NextLine(riv_file, cmdstr, &lno);
-            forc->riverbc[i].length =
-                CountLine(riv_file, cmdstr, 2, "RIV_TS", "RES");
-        }
+            /* Skip header lines */
+            n += 3;
 
-        FindLine(riv_file, "BOF", &lno, filename);
-        FindLine(riv_file, "BC", &lno, filename);
+            forc->riverbc[i].length =
+                CountTextLine(&txt, n, 2, "RIV_TS", "RES");
 
-        for (i = 0; i < forc->nriverbc; i++)
-        {
-            NextLine(riv_file, cmdstr, &lno);
-            NextLine(riv_file, cmdstr, &lno);
-            NextLine(riv_file, cmdstr, &lno);
-
-            forc->riverbc[i].data =
-                (double **)malloc((forc->riverbc[i].length) * sizeof(double *));
-            forc->riverbc[i].ftime =
-                (int *)malloc((forc->riverbc[i].length) * sizeof(int));
-            for (j = 0; j < forc->riverbc[i].length; j++)
+            bad = ReadTextTs(&txt, n, 1, &forc->riverbc[i]);
+            if (bad >= 0)
             {
-                forc->riverbc[i].data[j] = (double *)malloc(sizeof(double));
-                NextLine(riv_file, cmdstr, &lno);
-                if (!ReadTS(cmdstr, &forc->riverbc[i].ftime[j],
-                        &forc->riverbc[i].data[j][0], 1))
-                {
-                    PIHMprintf(VL_ERROR,
-                        "Error reading river boundary condition.\n");
-                    PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
-                        filename, lno);
-                    PIHMexit(EXIT_FAILURE);
-                }
+                PIHMprintf(VL_ERROR,
+                    "Error reading river boundary condition.\n");
+                PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n",
+                    filename, TextLno(&txt, bad));
+                PIHMexit(EXIT_FAILURE);
             }
+            n += forc->riverbc[i].length;
         }
     }
 
@@ -179,5 +195,5 @@ void ReadRiver(const char *filename, rivtbl_struct *rivtbl,
     /* Read Reservoir information */
 #endif
 
-    fclose(riv_file);
+    FreeTextFile(&txt);
 }
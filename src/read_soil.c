@@ -2,24 +2,20 @@
 
 void ReadSoil(const char *filename, soiltbl_struct *soiltbl)
 {
-    FILE           *soil_file;
+    txtfile_struct  txt;
     int             i;
-    char            cmdstr[MAXSTRING];
-    int             match;
-    int             index;
-    int             texture;
     const int       TOPSOIL = 1;
     const int       SUBSOIL = 0;
     int             ptf_used = 0;
-    int             lno = 0;
+    int             n = 0;
+    int             bad;
 
-    soil_file = fopen(filename, "r");
-    CheckFile(soil_file, filename);
-    PIHMprintf(VL_VERBOSE, " Reading %s\n", filename);
+    ReadTextFile(filename, &txt);
 
     /* Start reading soil file */
-    NextLine(soil_file, cmdstr, &lno);
-    ReadKeyword(cmdstr, "NUMSOIL", &soiltbl->number, 'i', filename, lno);
+    ReadKeyword(TextLine(&txt, n), "NUMSOIL", &soiltbl->number, 'i', filename,
+        TextLno(&txt, n));
+    n++;
 
     soiltbl->silt = (double *)malloc(soiltbl->number * sizeof(double));
     soiltbl->clay = (double *)malloc(soiltbl->number * sizeof(double));
@@ -40,27 +36,46 @@ void ReadSoil(const char *filename, soiltbl_struct *soiltbl)
     soiltbl->smcwlt = (double *)malloc(soiltbl->number * sizeof(double));
 
     /* Skip header line */
-    NextLine(soil_file, cmdstr, &lno);
+    n++;
 
+    /* Records are parsed in parallel. The first bad record is reported */
+    bad = soiltbl->number;
+
+#if defined(_OPENMP)
+# pragma omp parallel for reduction(||:ptf_used)
+#endif
     for (i = 0; i < soiltbl->number; i++)
     {
-        NextLine(soil_file, cmdstr, &lno);
-        match = sscanf(cmdstr,
-            "%d %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
-            &index, &soiltbl->silt[i], &soiltbl->clay[i], &soiltbl->om[i],
-            &soiltbl->bd[i],
-            &soiltbl->kinfv[i], &soiltbl->ksatv[i], &soiltbl->ksath[i],
-            &soiltbl->smcmax[i], &soiltbl->smcmin[i],
-            &soiltbl->alpha[i], &soiltbl->beta[i],
-            &soiltbl->areafh[i], &soiltbl->areafv[i],
-            &soiltbl->dmac[i], &soiltbl->qtz[i]);
-
-        if (match != 16 || i != index - 1)
+        const char     *str;
+        int             index;
+        int             texture;
+
+        str = TextLine(&txt, n + i);
+        if (!ScanInt(&str, &index) ||
+            !ScanDouble(&str, &soiltbl->silt[i]) ||
+            !ScanDouble(&str, &soiltbl->clay[i]) ||
+            !ScanDouble(&str, &soiltbl->om[i]) ||
+            !ScanDouble(&str, &soiltbl->bd[i]) ||
+            !ScanDouble(&str, &soiltbl->kinfv[i]) ||
+            !ScanDouble(&str, &soiltbl->ksatv[i]) ||
+            !ScanDouble(&str, &soiltbl->ksath[i]) ||
+            !ScanDouble(&str, &soiltbl->smcmax[i]) ||
+            !ScanDouble(&str, &soiltbl->smcmin[i]) ||
+            !ScanDouble(&str, &soiltbl->alpha[i]) ||
+            !ScanDouble(&str, &soiltbl->beta[i]) ||
+            !ScanDouble(&str, &soiltbl->areafh[i]) ||
+            !ScanDouble(&str, &soiltbl->areafv[i]) ||
+            !ScanDouble(&str, &soiltbl->dmac[i]) ||
+            !ScanDouble(&str, &soiltbl->qtz[i]) ||
+            i != index - 1)
         {
-            PIHMprintf(VL_ERROR,
-                "Error reading properties of the %dth soil type.\n", i + 1);
-            PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename, lno);
-            PIHMexit(EXIT_FAILURE);
+#if defined(_OPENMP)
+# pragma omp critical
+#endif
+            {
+                bad = (i < bad) ? i : bad;
+            }
+            continue;
         }
 
         /* Fill in missing organic matter and bulk density values */
@@ -122,14 +137,26 @@ void ReadSoil(const char *filename, soiltbl_struct *soiltbl)
             soiltbl->smcmin[i], soiltbl->alpha[i], soiltbl->beta[i]);
     }
 
-    NextLine(soil_file, cmdstr, &lno);
-    ReadKeyword(cmdstr, "DINF", &soiltbl->dinf, 'd', filename, lno);
+    if (bad < soiltbl->number)
+    {
+        PIHMprintf(VL_ERROR,
+            "Error reading properties of the %dth soil type.\n", bad + 1);
+        PIHMprintf(VL_ERROR, "Error in %s near Line %d.\n", filename,
+            TextLno(&txt, n + bad));
+        PIHMexit(EXIT_FAILURE);
+    }
+    n += soiltbl->number;
+
+    ReadKeyword(TextLine(&txt, n), "DINF", &soiltbl->dinf, 'd', filename,
+        TextLno(&txt, n));
+    n++;
 
-    NextLine(soil_file, cmdstr, &lno);
-    ReadKeyword(cmdstr, "KMACV_RO", &soiltbl->kmacv_ro, 'd', filename, lno);
+    ReadKeyword(TextLine(&txt, n), "KMACV_RO", &soiltbl->kmacv_ro, 'd',
+        filename, TextLno(&txt, n));
+    n++;
 
-    NextLine(soil_file, cmdstr, &lno);
-    ReadKeyword(cmdstr, "KMACH_RO", &soiltbl->kmach_ro, 'd', filename, lno);
+    ReadKeyword(TextLine(&txt, n), "KMACH_RO", &soiltbl->kmach_ro, 'd',
+        filename, TextLno(&txt, n));
 
     if (ptf_used)
     {
@@ -148,5 +175,5 @@ void ReadSoil(const char *filename, soiltbl_struct *soiltbl)
         }
     }
 
-    fclose(soil_file);
+    FreeTextFile(&txt);
 }
@@ -0,0 +1,486 @@
+#include "pihm.h"
+
+void ReadTextFile(const char *filename, txtfile_struct *txt)
+{
+    /*
+     * Read a text input file into memory and index its readable (non-blank,
+     * non-comment) lines in one pass, so that records can be located without
+     * rewinding the file and parsed in parallel. Line numbers are kept for
+     * error messages
+     */
+    FILE           *fp;
+    long int        size;
+    char           *ptr;
+    char           *end;
+    int             nalloc;
+    int             lno = 0;
+
+    fp = fopen(filename, "rb");
+    CheckFile(fp, filename);
+    PIHMprintf(VL_VERBOSE, " Reading %s\n", filename);
+
+    strcpy(txt->filename, filename);
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    size = (size > 0) ? size : 0;
+
+    txt->buffer = (char *)malloc(size + 1);
+    if ((long int)fread(txt->buffer, 1, size, fp) != size)
+    {
+        PIHMprintf(VL_ERROR, "Error reading %s.\n", filename);
+        PIHMexit(EXIT_FAILURE);
+    }
+    txt->buffer[size] = '\0';
+    fclose(fp);
+
+    nalloc = 1024;
+    txt->nline = 0;
+    txt->line = (char **)malloc(nalloc * sizeof(char *));
+    txt->lno = (int *)malloc(nalloc * sizeof(int));
+
+    ptr = txt->buffer;
+    end = txt->buffer + size;
+    while (ptr < end)
+    {
+        char           *eol;
+        char           *ch;
+
+        eol = (char *)memchr(ptr, '\n', end - ptr);
+        eol = (eol == NULL) ? end : eol;
+        *eol = '\0';
+        lno++;
+
+        /* Skip UTF-8 BOM */
+        if (strncmp(ptr, "\357\273\277", 3) == 0)
+        {
+            ptr += 3;
+        }
+
+        for (ch = ptr; *ch == ' ' || *ch == '\t'; ch++)
+        {
+        }
+
+        if (*ch != '#' && *ch != '\r' && *ch != '\0')
+        {
+            if (txt->nline == nalloc)
+            {
+                nalloc *= 2;
+                txt->line = (char **)realloc(txt->line,
+                    nalloc * sizeof(char *));
+                txt->lno = (int *)realloc(txt->lno, nalloc * sizeof(int));
+            }
+
+            txt->line[txt->nline] = ptr;
+            txt->lno[txt->nline] = lno;
+            txt->nline++;
+        }
+
+        ptr = eol + 1;
+    }
+}
+
+void FreeTextFile(txtfile_struct *txt)
+{
+    free(txt->buffer);
+    free(txt->line);
+    free(txt->lno);
+}
+
+const char *TextLine(const txtfile_struct *txt, int n)
+{
+    /*
+     * Return the nth readable line, or "EOF" after the last line (see
+     * NextLine)
+     */
+    return (n < txt->nline) ? txt->line[n] : "EOF";
+}
+
+int TextLno(const txtfile_struct *txt, int n)
+{
+    /*
+     * Return the line number of the nth readable line in the file
+     */
+    if (n < txt->nline)
+    {
+        return txt->lno[n];
+    }
+    else
+    {
+        return (txt->nline > 0) ? txt->lno[txt->nline - 1] : 0;
+    }
+}
+
+int MatchToken(const char *cmdstr, const char *token)
+{
+    /*
+     * Check if the first word of cmdstr is token (case insensitive)
+     */
+    size_t          len;
+
+    while (*cmdstr == ' ' || *cmdstr == '\t')
+    {
+        cmdstr++;
+    }
+
+    len = strlen(token);
+
+    return strncasecmp(cmdstr, token, len) == 0 &&
+        (cmdstr[len] == '\0' || isspace((unsigned char)cmdstr[len]));
+}
+
+int CountTextLine(const txtfile_struct *txt, int n, int num_arg, ...)
+{
+    /*
+     * Count number of readable lines from the nth line to where one of the
+     * tokens occurs (see CountLine)
+     */
+    va_list         valist;
+    int             count;
+    int             success = 0;
+    int             i;
+
+    for (count = 0; n + count < txt->nline; count++)
+    {
+        va_start(valist, num_arg);
+        for (i = 0; i < num_arg; i++)
+        {
+            if (MatchToken(txt->line[n + count], va_arg(valist, char *)))
+            {
+                success = 1;
+            }
+        }
+        va_end(valist);
+
+        if (success)
+        {
+            break;
+        }
+    }
+
+    return count;
+}
+
+int CountTextOccurr(const txtfile_struct *txt, const char *token)
+{
+    int             count = 0;
+    int             n;
+
+    for (n = 0; n < txt->nline; n++)
+    {
+        if (MatchToken(txt->line[n], token))
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+int FindTextLine(const txtfile_struct *txt, int n, const char *token)
+{
+    /*
+     * Find the first line from the nth line that starts with token (see
+     * FindLine)
+     */
+    for (; n < txt->nline; n++)
+    {
+        if (MatchToken(txt->line[n], token))
+        {
+            return n;
+        }
+    }
+
+    PIHMprintf(VL_ERROR, "Cannot find required keyword %s.\n", token);
+    PIHMprintf(VL_ERROR, "Error reading %s.\n", txt->filename);
+    PIHMexit(EXIT_FAILURE);
+
+    return -1;
+}
+
+int ReadTextTs(const txtfile_struct *txt, int first, int nvrbl,
+    tsdata_struct *ts)
+{
+    /*
+     * Read ts->length time series records starting from the first line in
+     * parallel. Returns the index of the first line that cannot be read, or
+     * -1 on success
+     */
+    int             j;
+    int             bad;
+
+    ts->cursor = 0;
+    ts->ftime = (int *)malloc(ts->length * sizeof(int));
+    ts->data = (double *)malloc(ts->length * nvrbl * sizeof(double));
+
+    bad = ts->length;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (j = 0; j < ts->length; j++)
+    {
+        if (!ReadTS(TextLine(txt, first + j), &ts->ftime[j],
+            &ts->data[j * nvrbl], nvrbl))
+        {
+#if defined(_OPENMP)
+# pragma omp critical
+#endif
+            {
+                bad = (j < bad) ? j : bad;
+            }
+        }
+    }
+
+    return (bad < ts->length) ? first + bad : -1;
+}
+
+int ScanInt(const char **str, int *value)
+{
+    /*
+     * Read an integer from *str and move *str past it. Returns 0 if *str
+     * does not start with an integer (see "%d" of scanf)
+     */
+    const char     *ptr;
+    long long int   x = 0;
+    int             sign = 1;
+
+    ptr = *str;
+    while (isspace((unsigned char)*ptr))
+    {
+        ptr++;
+    }
+
+    if (*ptr == '-' || *ptr == '+')
+    {
+        sign = (*ptr == '-') ? -1 : 1;
+        ptr++;
+    }
+
+    if (!isdigit((unsigned char)*ptr))
+    {
+        return 0;
+    }
+
+    while (isdigit((unsigned char)*ptr))
+    {
+        x = 10 * x + (*ptr - '0');
+        ptr++;
+    }
+
+    *value = (int)(sign * x);
+    *str = ptr;
+
+    return 1;
+}
+
+int ScanDouble(const char **str, double *value)
+{
+    /*
+     * Read a floating point number from *str and move *str past it. Returns
+     * 0 if *str does not start with a number (see "%lf" of scanf).
+     * Decimal numbers with at most 15 significant digits and small exponents
+     * are converted exactly using one multiplication or division, which
+     * gives the same correctly rounded result as strtod. Other numbers are
+     * converted using strtod
+     */
+    const double    POW10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+        1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char     *ptr;
+    const char     *start;
+    unsigned long long int mantissa = 0;
+    int             ndigit = 0;
+    int             exp10 = 0;
+    int             negative = 0;
+    int             any = 0;
+    int             exact = 1;
+    double          x;
+
+    ptr = *str;
+    while (isspace((unsigned char)*ptr))
+    {
+        ptr++;
+    }
+    start = ptr;
+
+    if (*ptr == '-' || *ptr == '+')
+    {
+        negative = (*ptr == '-');
+        ptr++;
+    }
+
+    /* Integer part */
+    for (; isdigit((unsigned char)*ptr); ptr++)
+    {
+        any = 1;
+        if (ndigit < 15)
+        {
+            mantissa = 10 * mantissa + (*ptr - '0');
+            ndigit += (mantissa > 0);
+        }
+        else
+        {
+            exact = 0;
+        }
+    }
+
+    /* Fraction part */
+    if (*ptr == '.')
+    {
+        for (ptr++; isdigit((unsigned char)*ptr); ptr++)
+        {
+            any = 1;
+            if (ndigit < 15)
+            {
+                mantissa = 10 * mantissa + (*ptr - '0');
+                ndigit += (mantissa > 0);
+                exp10--;
+            }
+            else
+            {
+                exact = 0;
+            }
+        }
+    }
+
+    /* Exponent part */
+    if (any && (*ptr == 'e' || *ptr == 'E'))
+    {
+        const char     *exp_ptr;
+        int             exp_sign = 1;
+        int             exp_value = 0;
+
+        exp_ptr = ptr + 1;
+        if (*exp_ptr == '-' || *exp_ptr == '+')
+        {
+            exp_sign = (*exp_ptr == '-') ? -1 : 1;
+            exp_ptr++;
+        }
+
+        if (isdigit((unsigned char)*exp_ptr))
+        {
+            for (; isdigit((unsigned char)*exp_ptr); exp_ptr++)
+            {
+                exp_value = (exp_value < 10000) ?
+                    10 * exp_value + (*exp_ptr - '0') : exp_value;
+            }
+            exp10 += exp_sign * exp_value;
+            ptr = exp_ptr;
+        }
+    }
+
+    /* Hexadecimal numbers, infinity, NaN, etc. */
+    if (!any || isalpha((unsigned char)*ptr) || *ptr == '.')
+    {
+        exact = 0;
+    }
+
+    if (exact && exp10 >= -22 && exp10 <= 22)
+    {
+        x = (double)mantissa;
+        x = (exp10 < 0) ? x / POW10[-exp10] : x * POW10[exp10];
+        *value = negative ? -x : x;
+    }
+    else
+    {
+        char           *endptr;
+
+        *value = strtod(start, &endptr);
+        if (endptr == start)
+        {
+            return 0;
+        }
+        ptr = endptr;
+    }
+
+    *str = ptr;
+
+    return 1;
+}
+
+int ScanTime(const char **str, int *t)
+{
+    /*
+     * Read time in "YYYY-MM-DD hh:mm" format from *str and move *str past
+     * it. Returns 0 if *str does not start with time in this format. Gives
+     * the same result as StrTime
+     */
+    const char     *ptr;
+    int             field[5];
+    const int       WIDTH[5] = {4, 2, 2, 2, 2};
+    const char      SEP[5] = {'-', '-', ' ', ':', '\0'};
+    int             year, month, day;
+    int             era, yoe, doy, doe;
+    int             i, k;
+
+    ptr = *str;
+    while (isspace((unsigned char)*ptr))
+    {
+        ptr++;
+    }
+
+    for (k = 0; k < 5; k++)
+    {
+        field[k] = 0;
+        for (i = 0; i < WIDTH[k]; i++)
+        {
+            if (!isdigit((unsigned char)*ptr))
+            {
+                return 0;
+            }
+            field[k] = 10 * field[k] + (*ptr - '0');
+            ptr++;
+        }
+
+        if (SEP[k] == ' ')
+        {
+            if (*ptr != ' ' && *ptr != '\t')
+            {
+                return 0;
+            }
+            while (*ptr == ' ' || *ptr == '\t')
+            {
+                ptr++;
+            }
+        }
+        else if (SEP[k] != '\0')
+        {
+            if (*ptr != SEP[k])
+            {
+                return 0;
+            }
+            ptr++;
+        }
+    }
+
+    if (*ptr != '\0' && !isspace((unsigned char)*ptr))
+    {
+        return 0;
+    }
+
+    /* Days since 1970-01-01 in proleptic Gregorian calendar. Months out of
+     * range are carried to years as in timegm */
+    year = field[0] + (field[1] - 1) / 12;
+    month = (field[1] - 1) % 12 + 1;
+    if (month < 1)
+    {
+        month += 12;
+        year--;
+    }
+    day = field[2];
+
+    year -= (month <= 2);
+    era = ((year >= 0) ? year : year - 399) / 400;
+    yoe = year - era * 400;
+    doy = (153 * (month + ((month > 2) ? -3 : 9)) + 2) / 5 + day - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    *t = (era * 146097 + doe - 719468) * 86400 + field[3] * 3600 +
+        field[4] * 60;
+    *str = ptr;
+
+    return 1;
+}
@@ -0,0 +1,385 @@
+#include "pihm.h"
+
+void ReorderMesh(int reorder, meshtbl_struct *meshtbl, atttbl_struct *atttbl,
+    rivtbl_struct *rivtbl)
+{
+    /*
+     * Reorder elements and river segments to improve memory locality of the
+     * hydrology kernel and to reduce the bandwidth of the Jacobian. Input
+     * tables are permuted in place before model structures are initialized.
+     * Element and river ids in the input files are kept in meshtbl->ind and
+     * rivtbl->ind, which are used to write output and restart files in the
+     * original order
+     */
+    int             i, j;
+    int            *elem_order;    /* original index of each element */
+    int            *elem_rank;     /* new index of each original element */
+    int            *river_order;   /* original index of each segment */
+    int            *river_rank;    /* new index of each original segment */
+
+    PIHMprintf(VL_VERBOSE, "\nReorder model grids using %s.\n",
+        (reorder == RCM_REORDER) ? "reverse Cuthill-McKee" : "Hilbert curve");
+
+    elem_order = (int *)malloc(nelem * sizeof(int));
+    elem_rank = (int *)malloc(nelem * sizeof(int));
+    river_order = (int *)malloc(nriver * sizeof(int));
+    river_rank = (int *)malloc(nriver * sizeof(int));
+
+    if (reorder == RCM_REORDER)
+    {
+        RcmOrder(meshtbl, elem_order);
+    }
+    else
+    {
+        HilbertOrder(meshtbl, elem_order);
+    }
+
+    for (i = 0; i < nelem; i++)
+    {
+        elem_rank[elem_order[i]] = i;
+    }
+
+    RiverOrder(rivtbl, elem_rank, river_order);
+
+    for (i = 0; i < nriver; i++)
+    {
+        river_rank[river_order[i]] = i;
+    }
+
+    /*
+     * Renumber element and river references
+     */
+    for (i = 0; i < nelem; i++)
+    {
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            if (meshtbl->nabr[i][j] > 0)
+            {
+                meshtbl->nabr[i][j] = elem_rank[meshtbl->nabr[i][j] - 1] + 1;
+            }
+        }
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        if (rivtbl->leftele[i] > 0)
+        {
+            rivtbl->leftele[i] = elem_rank[rivtbl->leftele[i] - 1] + 1;
+        }
+        if (rivtbl->rightele[i] > 0)
+        {
+            rivtbl->rightele[i] = elem_rank[rivtbl->rightele[i] - 1] + 1;
+        }
+        if (rivtbl->down[i] > 0)
+        {
+            rivtbl->down[i] = river_rank[rivtbl->down[i] - 1] + 1;
+        }
+    }
+
+    /*
+     * Permute element tables
+     */
+    PermuteInt(elem_order, nelem, meshtbl->ind);
+    PermuteIntRow(elem_order, nelem, meshtbl->node);
+    PermuteIntRow(elem_order, nelem, meshtbl->nabr);
+
+    PermuteInt(elem_order, nelem, atttbl->soil);
+    PermuteInt(elem_order, nelem, atttbl->geol);
+    PermuteInt(elem_order, nelem, atttbl->lc);
+    PermuteIntRow(elem_order, nelem, atttbl->bc);
+#if defined(_FBR_)
+    PermuteIntRow(elem_order, nelem, atttbl->fbr_bc);
+#endif
+    PermuteInt(elem_order, nelem, atttbl->meteo);
+    PermuteInt(elem_order, nelem, atttbl->lai);
+    PermuteInt(elem_order, nelem, atttbl->source);
+
+    /*
+     * Permute river table
+     */
+    PermuteInt(river_order, nriver, rivtbl->ind);
+    PermuteInt(river_order, nriver, rivtbl->fromnode);
+    PermuteInt(river_order, nriver, rivtbl->tonode);
+    PermuteInt(river_order, nriver, rivtbl->down);
+    PermuteInt(river_order, nriver, rivtbl->leftele);
+    PermuteInt(river_order, nriver, rivtbl->rightele);
+    PermuteInt(river_order, nriver, rivtbl->shp);
+    PermuteInt(river_order, nriver, rivtbl->matl);
+    PermuteInt(river_order, nriver, rivtbl->bc);
+    PermuteInt(river_order, nriver, rivtbl->rsvr);
+
+    free(elem_order);
+    free(elem_rank);
+    free(river_order);
+    free(river_rank);
+}
+
+void RcmOrder(const meshtbl_struct *meshtbl, int *order)
+{
+    /*
+     * Reverse Cuthill-McKee ordering of the element adjacency graph. Each
+     * connected component is traversed breadth first starting from an
+     * element with the minimum degree, visiting neighbors in the order of
+     * increasing degree
+     */
+    int             i, j, k;
+    int             n;
+    int             head;
+    int            *degree;
+    int            *visited;
+
+    degree = (int *)calloc(nelem, sizeof(int));
+    visited = (int *)calloc(nelem, sizeof(int));
+
+    for (i = 0; i < nelem; i++)
+    {
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            degree[i] += (meshtbl->nabr[i][j] > 0) ? 1 : 0;
+        }
+    }
+
+    n = 0;
+    while (n < nelem)
+    {
+        int             start = -1;
+
+        for (i = 0; i < nelem; i++)
+        {
+            if (!visited[i] && (start < 0 || degree[i] < degree[start]))
+            {
+                start = i;
+            }
+        }
+
+        order[n++] = start;
+        visited[start] = 1;
+
+        for (head = n - 1; head < n; head++)
+        {
+            int             first = n;
+
+            for (j = 0; j < NUM_EDGE; j++)
+            {
+                int             nabr;
+
+                nabr = meshtbl->nabr[order[head]][j] - 1;
+
+                if (nabr >= 0 && !visited[nabr])
+                {
+                    order[n++] = nabr;
+                    visited[nabr] = 1;
+                }
+            }
+
+            /* Sort newly visited elements by degree (stable) */
+            for (k = first + 1; k < n; k++)
+            {
+                int             m;
+                int             ind;
+
+                ind = order[k];
+                for (m = k; m > first && degree[order[m - 1]] > degree[ind];
+                    m--)
+                {
+                    order[m] = order[m - 1];
+                }
+                order[m] = ind;
+            }
+        }
+    }
+
+    /* Reverse */
+    for (i = 0; i < nelem / 2; i++)
+    {
+        k = order[i];
+        order[i] = order[nelem - 1 - i];
+        order[nelem - 1 - i] = k;
+    }
+
+    free(degree);
+    free(visited);
+}
+
+void HilbertOrder(const meshtbl_struct *meshtbl, int *order)
+{
+    /*
+     * Order elements along a Hilbert curve through element centroids
+     */
+    int             i, j;
+    int           (*key)[2];
+    double         *x;
+    double         *y;
+    double          xmin = 0.0, ymin = 0.0;
+    double          range = 0.0;
+
+    key = (int (*)[2])malloc(nelem * sizeof(*key));
+    x = (double *)malloc(nelem * sizeof(double));
+    y = (double *)malloc(nelem * sizeof(double));
+
+    for (i = 0; i < nelem; i++)
+    {
+        x[i] = 0.0;
+        y[i] = 0.0;
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            x[i] += meshtbl->x[meshtbl->node[i][j] - 1] / (double)NUM_EDGE;
+            y[i] += meshtbl->y[meshtbl->node[i][j] - 1] / (double)NUM_EDGE;
+        }
+
+        xmin = (i == 0 || x[i] < xmin) ? x[i] : xmin;
+        ymin = (i == 0 || y[i] < ymin) ? y[i] : ymin;
+    }
+
+    for (i = 0; i < nelem; i++)
+    {
+        range = (x[i] - xmin > range) ? x[i] - xmin : range;
+        range = (y[i] - ymin > range) ? y[i] - ymin : range;
+    }
+
+    for (i = 0; i < nelem; i++)
+    {
+        int             ix, iy;
+
+        ix = (range > 0.0) ?
+            (int)((x[i] - xmin) / range * (double)(HILBERT_SIZE - 1)) : 0;
+        iy = (range > 0.0) ?
+            (int)((y[i] - ymin) / range * (double)(HILBERT_SIZE - 1)) : 0;
+
+        key[i][0] = HilbertInd(ix, iy);
+        key[i][1] = i;
+    }
+
+    qsort(key, nelem, sizeof(*key), CompareIntPair);
+
+    for (i = 0; i < nelem; i++)
+    {
+        order[i] = key[i][1];
+    }
+
+    free(key);
+    free(x);
+    free(y);
+}
+
+int HilbertInd(int x, int y)
+{
+    /*
+     * Distance along the Hilbert curve filling a HILBERT_SIZE by
+     * HILBERT_SIZE grid
+     */
+    int             s;
+    int             d = 0;
+
+    for (s = HILBERT_SIZE / 2; s > 0; s /= 2)
+    {
+        int             rx, ry;
+
+        rx = ((x & s) > 0) ? 1 : 0;
+        ry = ((y & s) > 0) ? 1 : 0;
+        d += s * s * ((3 * rx) ^ ry);
+
+        /* Rotate quadrant */
+        if (ry == 0)
+        {
+            int             temp;
+
+            if (rx == 1)
+            {
+                x = HILBERT_SIZE - 1 - x;
+                y = HILBERT_SIZE - 1 - y;
+            }
+
+            temp = x;
+            x = y;
+            y = temp;
+        }
+    }
+
+    return d;
+}
+
+void RiverOrder(const rivtbl_struct *rivtbl, const int *elem_rank,
+    int *order)
+{
+    /*
+     * Order river segments by the lowest new index of their bank elements so
+     * that segments are close to their neighbors in memory
+     */
+    int             i;
+    int           (*key)[2];
+
+    key = (int (*)[2])malloc(nriver * sizeof(*key));
+
+    for (i = 0; i < nriver; i++)
+    {
+        key[i][0] = nelem;
+        if (rivtbl->leftele[i] > 0 &&
+            elem_rank[rivtbl->leftele[i] - 1] < key[i][0])
+        {
+            key[i][0] = elem_rank[rivtbl->leftele[i] - 1];
+        }
+        if (rivtbl->rightele[i] > 0 &&
+            elem_rank[rivtbl->rightele[i] - 1] < key[i][0])
+        {
+            key[i][0] = elem_rank[rivtbl->rightele[i] - 1];
+        }
+        key[i][1] = i;
+    }
+
+    qsort(key, nriver, sizeof(*key), CompareIntPair);
+
+    for (i = 0; i < nriver; i++)
+    {
+        order[i] = key[i][1];
+    }
+
+    free(key);
+}
+
+int CompareIntPair(const void *a, const void *b)
+{
+    const int      *pa = (const int *)a;
+    const int      *pb = (const int *)b;
+
+    if (pa[0] != pb[0])
+    {
+        return (pa[0] < pb[0]) ? -1 : 1;
+    }
+
+    return (pa[1] < pb[1]) ? -1 : ((pa[1] > pb[1]) ? 1 : 0);
+}
+
+void PermuteInt(const int *order, int n, int *var)
+{
+    int             i;
+    int            *temp;
+
+    temp = (int *)malloc(n * sizeof(int));
+
+    for (i = 0; i < n; i++)
+    {
+        temp[i] = var[order[i]];
+    }
+
+    memcpy(var, temp, n * sizeof(int));
+
+    free(temp);
+}
+
+void PermuteIntRow(const int *order, int n, int **var)
+{
+    int             i;
+    int           **temp;
+
+    temp = (int **)malloc(n * sizeof(int *));
+
+    for (i = 0; i < n; i++)
+    {
+        temp[i] = var[order[i]];
+    }
+
+    memcpy(var, temp, n * sizeof(int *));
+
+    free(temp);
+}
@@ -1,6 +1,7 @@
 #include "pihm.h"
 
-void RiverFlow(elem_struct *elem, river_struct *river, int riv_mode)
+void RiverFlow(hydro_elem_struct *elem, hydro_river_struct *river,
+    int riv_mode)
 {
     int             i;
 
@@ -9,160 +10,308 @@ void RiverFlow(elem_struct *elem, river_struct *river, int riv_mode)
 #endif
     for (i = 0; i < nriver; i++)
     {
-        river_struct   *down;
-        elem_struct    *left;
-        elem_struct    *right;
-        double          effk_nabr;
-        double          effk;
+        RiverSegFlow(elem, river, i, riv_mode);
+    }
 
-        if (river[i].down > 0)
-        {
-            /*
-             * Boundary conditions
-             *
-             * When a downstream segment is present, boundary conditions are
-             * always applied to the upstream node
-             */
-            if (river[i].attrib.riverbc_type != 0)
-            {
-                river[i].wf.rivflow[UP_CHANL2CHANL] +=
-                    BoundFluxRiver(river[i].attrib.riverbc_type, &river[i].ws,
-                    &river[i].topo, &river[i].shp, &river[i].matl,
-                    &river[i].bc);
-            }
+    /*
+     * Accumulate to get in-flow for down segments
+     */
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        AccumUpstreamFlux(river, i);
+    }
+}
 
-            down = &river[river[i].down - 1];
-
-            /*
-             * Channel flow between river-river segments
-             */
-            river[i].wf.rivflow[DOWN_CHANL2CHANL] =
-                ChanFlowRiverToRiver(&river[i], down, riv_mode);
-
-            /*
-             * Subsurface flow between river-river segments
-             */
-            left = &elem[river[i].leftele - 1];
-            right = &elem[river[i].rightele - 1];
-            effk = 0.5 *
-                (EffKh(&left->soil, left->ws.gw) +
-                EffKh(&right->soil, right->ws.gw));
-            left = &elem[down->leftele - 1];
-            right = &elem[down->rightele - 1];
-            effk_nabr = 0.5 *
-                (EffKh(&left->soil, left->ws.gw) +
-                EffKh(&right->soil, right->ws.gw));
-
-            river[i].wf.rivflow[DOWN_AQUIF2AQUIF] =
-                SubFlowRiverToRiver(&river[i], effk, down, effk_nabr);
-        }
-        else
+void RiverSegFlow(hydro_elem_struct *elem, hydro_river_struct *river, int i,
+    int riv_mode)
+{
+    int             down;
+    double          effk_nabr;
+    double          effk;
+
+    if (river->down[i] > 0)
+    {
+        /*
+         * Boundary conditions
+         *
+         * When a downstream segment is present, boundary conditions are
+         * always applied to the upstream node
+         */
+        if (river->riverbc_type[i] != 0)
         {
-            /*
-             * Outlet flux
-             */
-            river[i].wf.rivflow[DOWN_CHANL2CHANL] =
-                OutletFlux(river[i].down, &river[i].ws, &river[i].topo,
-                &river[i].shp, &river[i].matl, &river[i].bc);
-            /* Note: boundary condition for subsurface element can be changed.
-             * Assumption: no flow condition */
-            river[i].wf.rivflow[DOWN_AQUIF2AQUIF] = 0.0;
+            river->rivflow[i][UP_CHANL2CHANL] += BoundFluxRiver(river, i);
         }
 
+        down = river->down[i] - 1;
+
         /*
-         * Flux between river segments and triangular elements
+         * Channel flow between river-river segments
          */
-        left = &elem[river[i].leftele - 1];
-        right = &elem[river[i].rightele - 1];
-
-        RiverToElem(&river[i], left, right);
+        river->rivflow[i][DOWN_CHANL2CHANL] =
+            ChanFlowRiverToRiver(river, i, down, riv_mode);
 
         /*
-         * Flux between river channel and subsurface
+         * Subsurface flow between river-river segments
          */
-        river[i].wf.rivflow[CHANL_LKG] =
-            ChanLeak(&river[i].ws, &river[i].topo, &river[i].shp,
-            &river[i].matl);
+        effk = 0.5 *
+            (EffKh(elem, river->leftele[i] - 1) +
+            EffKh(elem, river->rightele[i] - 1));
+        effk_nabr = 0.5 *
+            (EffKh(elem, river->leftele[down] - 1) +
+            EffKh(elem, river->rightele[down] - 1));
+
+        river->rivflow[i][DOWN_AQUIF2AQUIF] =
+            SubFlowRiverToRiver(river, i, effk, down, effk_nabr);
+    }
+    else
+    {
+        /*
+         * Outlet flux
+         */
+        river->rivflow[i][DOWN_CHANL2CHANL] = OutletFlux(river, i);
+        /* Note: boundary condition for subsurface element can be changed.
+         * Assumption: no flow condition */
+        river->rivflow[i][DOWN_AQUIF2AQUIF] = 0.0;
     }
 
     /*
-     * Accumulate to get in-flow for down segments
-     *
-     * NOTE: Upstream flux summation must be calculated outside OMP to avoid
-     * different threads accessing the same variable at the same time
+     * Flux between river segments and triangular elements
      */
-    for (i = 0; i < nriver; i++)
+    RiverToElem(river, i, elem);
+
+    /*
+     * Flux between river channel and subsurface
+     */
+    river->rivflow[i][CHANL_LKG] = ChanLeak(river, i);
+}
+
+void RiverSegFastFlow(hydro_elem_struct *elem, hydro_river_struct *river,
+    int i, int riv_mode)
+{
+    /*
+     * Same as RiverSegFlow, but only fluxes to and from river channels are
+     * calculated. Subsurface flux of elements across river edges only
+     * includes flux to river channels
+     */
+    int             left, right;
+    int             j;
+
+    if (river->down[i] > 0)
     {
-        river_struct   *down;
+        if (river->riverbc_type[i] != 0)
+        {
+            river->rivflow[i][UP_CHANL2CHANL] += BoundFluxRiver(river, i);
+        }
 
-        if (river[i].down > 0)
+        river->rivflow[i][DOWN_CHANL2CHANL] =
+            ChanFlowRiverToRiver(river, i, river->down[i] - 1, riv_mode);
+    }
+    else
+    {
+        river->rivflow[i][DOWN_CHANL2CHANL] = OutletFlux(river, i);
+    }
+
+    left = river->leftele[i] - 1;
+    right = river->rightele[i] - 1;
+
+    if (river->leftele[i] > 0)
+    {
+        river->rivflow[i][LEFT_SURF2CHANL] =
+            OvlFlowElemToRiver(elem, left, river, i);
+        river->rivflow[i][LEFT_AQUIF2CHANL] =
+            ChanFlowElemToRiver(elem, left, EffKh(elem, left), river, i,
+            river->dist_left[i]);
+
+        for (j = 0; j < NUM_EDGE; j++)
         {
-            down = &river[river[i].down - 1];
+            if (elem->nabr[left][j] == -(i + 1))
+            {
+                elem->ovlflow[left][j] = -river->rivflow[i][LEFT_SURF2CHANL];
+                elem->subsurf[left][j] = -river->rivflow[i][LEFT_AQUIF2CHANL];
+                break;
+            }
+        }
+    }
+
+    if (river->rightele[i] > 0)
+    {
+        river->rivflow[i][RIGHT_SURF2CHANL] =
+            OvlFlowElemToRiver(elem, right, river, i);
+        river->rivflow[i][RIGHT_AQUIF2CHANL] =
+            ChanFlowElemToRiver(elem, right, EffKh(elem, right), river, i,
+            river->dist_right[i]);
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            if (elem->nabr[right][j] == -(i + 1))
+            {
+                elem->ovlflow[right][j] =
+                    -river->rivflow[i][RIGHT_SURF2CHANL];
+                elem->subsurf[right][j] =
+                    -river->rivflow[i][RIGHT_AQUIF2CHANL];
+                break;
+            }
+        }
+    }
+
+    river->rivflow[i][CHANL_LKG] = ChanLeak(river, i);
+}
+
+void RiverSegSlowFlow(hydro_elem_struct *elem, hydro_river_struct *river,
+    int i)
+{
+    /*
+     * Same as RiverSegFlow, but only fluxes between aquifers are calculated.
+     * Subsurface flux of elements across river edges only includes flux to
+     * aquifers beneath river segments
+     */
+    int             left, right;
+    int             down;
+    double          effk_left, effk_right;
+    int             j;
+
+    if (river->down[i] > 0)
+    {
+        down = river->down[i] - 1;
+
+        river->rivflow[i][DOWN_AQUIF2AQUIF] = SubFlowRiverToRiver(river, i,
+            0.5 * (EffKh(elem, river->leftele[i] - 1) +
+            EffKh(elem, river->rightele[i] - 1)), down,
+            0.5 * (EffKh(elem, river->leftele[down] - 1) +
+            EffKh(elem, river->rightele[down] - 1)));
+    }
+    else
+    {
+        river->rivflow[i][DOWN_AQUIF2AQUIF] = 0.0;
+    }
 
-            down->wf.rivflow[UP_CHANL2CHANL] -=
-                river[i].wf.rivflow[DOWN_CHANL2CHANL];
+    left = river->leftele[i] - 1;
+    right = river->rightele[i] - 1;
 
-            down->wf.rivflow[UP_AQUIF2AQUIF] -=
-                river[i].wf.rivflow[DOWN_AQUIF2AQUIF];
+    effk_left = EffKh(elem, left);
+    effk_right = EffKh(elem, right);
+
+    if (river->leftele[i] > 0)
+    {
+        river->rivflow[i][LEFT_AQUIF2AQUIF] =
+            SubFlowElemToRiver(elem, left, effk_left, river, i,
+            0.5 * (effk_left + effk_right), river->dist_left[i]);
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            if (elem->nabr[left][j] == -(i + 1))
+            {
+                elem->subsurf[left][j] = -river->rivflow[i][LEFT_AQUIF2AQUIF];
+                break;
+            }
+        }
+    }
+
+    if (river->rightele[i] > 0)
+    {
+        river->rivflow[i][RIGHT_AQUIF2AQUIF] =
+            SubFlowElemToRiver(elem, right, effk_right, river, i,
+            0.5 * (effk_left + effk_right), river->dist_right[i]);
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            if (elem->nabr[right][j] == -(i + 1))
+            {
+                elem->subsurf[right][j] =
+                    -river->rivflow[i][RIGHT_AQUIF2AQUIF];
+                break;
+            }
         }
     }
 }
 
-void RiverToElem(river_struct *river, elem_struct *left, elem_struct *right)
+void AccumUpstreamFlux(hydro_river_struct *river, int i)
 {
+    int             k;
+
+    /*
+     * Gather in-flow from upstream segments. Each segment only writes to its
+     * own upstream fluxes so segments can be processed in parallel
+     */
+    for (k = river->up_start[i]; k < river->up_start[i + 1]; k++)
+    {
+        int             up;
+
+        up = river->up[k];
+
+        river->rivflow[i][UP_CHANL2CHANL] -=
+            river->rivflow[up][DOWN_CHANL2CHANL];
+
+        river->rivflow[i][UP_AQUIF2AQUIF] -=
+            river->rivflow[up][DOWN_AQUIF2AQUIF];
+    }
+}
+
+void RiverToElem(hydro_river_struct *river, int i, hydro_elem_struct *elem)
+{
+    int             left, right;
     double          effk_left, effk_right;
     int             j;
 
+    left = river->leftele[i] - 1;
+    right = river->rightele[i] - 1;
+
     /* Lateral surface flux calculation between river-triangular element */
-    if (river->leftele > 0)
+    if (river->leftele[i] > 0)
     {
-        river->wf.rivflow[LEFT_SURF2CHANL] = OvlFlowElemToRiver(left, river);
+        river->rivflow[i][LEFT_SURF2CHANL] =
+            OvlFlowElemToRiver(elem, left, river, i);
     }
-    if (river->rightele > 0)
+    if (river->rightele[i] > 0)
     {
-        river->wf.rivflow[RIGHT_SURF2CHANL] = OvlFlowElemToRiver(right, river);
+        river->rivflow[i][RIGHT_SURF2CHANL] =
+            OvlFlowElemToRiver(elem, right, river, i);
     }
 
-    effk_left = EffKh(&left->soil, left->ws.gw);
-    effk_right = EffKh(&right->soil, right->ws.gw);
+    effk_left = EffKh(elem, left);
+    effk_right = EffKh(elem, right);
 
     /* Lateral subsurface flux calculation between river-triangular element */
-    if (river->leftele > 0)
+    if (river->leftele[i] > 0)
     {
-        river->wf.rivflow[LEFT_AQUIF2CHANL] =
-            ChanFlowElemToRiver(left, effk_left, river, river->topo.dist_left);
+        river->rivflow[i][LEFT_AQUIF2CHANL] =
+            ChanFlowElemToRiver(elem, left, effk_left, river, i,
+            river->dist_left[i]);
     }
-    if (river->rightele > 0)
+    if (river->rightele[i] > 0)
     {
-        river->wf.rivflow[RIGHT_AQUIF2CHANL] =
-            ChanFlowElemToRiver(right, effk_right, river,
-            river->topo.dist_right);
+        river->rivflow[i][RIGHT_AQUIF2CHANL] =
+            ChanFlowElemToRiver(elem, right, effk_right, river, i,
+            river->dist_right[i]);
     }
 
     /* Lateral flux between rectangular element (beneath river) and triangular
      * element */
-    if (river->leftele > 0)
+    if (river->leftele[i] > 0)
     {
-        river->wf.rivflow[LEFT_AQUIF2AQUIF] =
-            SubFlowElemToRiver(left, effk_left, river,
-            0.5 * (effk_left + effk_right), river->topo.dist_left);
+        river->rivflow[i][LEFT_AQUIF2AQUIF] =
+            SubFlowElemToRiver(elem, left, effk_left, river, i,
+            0.5 * (effk_left + effk_right), river->dist_left[i]);
     }
-    if (river->rightele > 0)
+    if (river->rightele[i] > 0)
     {
-        river->wf.rivflow[RIGHT_AQUIF2AQUIF] =
-            SubFlowElemToRiver(right, effk_right, river,
-            0.5 * (effk_left + effk_right), river->topo.dist_right);
+        river->rivflow[i][RIGHT_AQUIF2AQUIF] =
+            SubFlowElemToRiver(elem, right, effk_right, river, i,
+            0.5 * (effk_left + effk_right), river->dist_right[i]);
     }
 
     /* Replace flux term */
     /* Left */
     for (j = 0; j < NUM_EDGE; j++)
     {
-        if (left->nabr[j] == -river->ind)
+        if (elem->nabr[left][j] == -(i + 1))
         {
-            left->wf.ovlflow[j] = -river->wf.rivflow[LEFT_SURF2CHANL];
-            left->wf.subsurf[j] = -(river->wf.rivflow[LEFT_AQUIF2CHANL] +
-                river->wf.rivflow[LEFT_AQUIF2AQUIF]);
+            elem->ovlflow[left][j] = -river->rivflow[i][LEFT_SURF2CHANL];
+            elem->subsurf[left][j] = -(river->rivflow[i][LEFT_AQUIF2CHANL] +
+                river->rivflow[i][LEFT_AQUIF2AQUIF]);
             break;
         }
     }
@@ -170,28 +319,29 @@ void RiverToElem(river_struct *river, elem_struct *left, elem_struct *right)
     /* Right */
     for (j = 0; j < NUM_EDGE; j++)
     {
-        if (right->nabr[j] == -river->ind)
+        if (elem->nabr[right][j] == -(i + 1))
         {
-            right->wf.ovlflow[j] = -river->wf.rivflow[RIGHT_SURF2CHANL];
-            right->wf.subsurf[j] = -(river->wf.rivflow[RIGHT_AQUIF2CHANL] +
-                river->wf.rivflow[RIGHT_AQUIF2AQUIF]);
+            elem->ovlflow[right][j] = -river->rivflow[i][RIGHT_SURF2CHANL];
+            elem->subsurf[right][j] = -(river->rivflow[i][RIGHT_AQUIF2CHANL] +
+                river->rivflow[i][RIGHT_AQUIF2AQUIF]);
             break;
         }
     }
 }
 
-double OvlFlowElemToRiver(const elem_struct *elem, const river_struct *river)
+double OvlFlowElemToRiver(const hydro_elem_struct *elem, int ie,
+    const hydro_river_struct *river, int i)
 {
     double          zbank;
     double          flux;
     double          elem_h;
     double          rivseg_h;
 
-    zbank = (river->topo.zmax > elem->topo.zmax) ?
-        river->topo.zmax : elem->topo.zmax;
+    zbank = (river->zmax[i] > elem->zmax[ie]) ?
+        river->zmax[i] : elem->zmax[ie];
 
-    elem_h = elem->topo.zmax + elem->ws.surfh;
-    rivseg_h = river->topo.zbed + river->ws.stage;
+    elem_h = elem->zmax[ie] + elem->surfh[ie];
+    rivseg_h = river->zbed[i] + river->stage[i];
 
     /*
      * Panday and Hyakorn 2004 AWR Eqs. (23) and (24)
@@ -201,8 +351,8 @@ double OvlFlowElemToRiver(const elem_struct *elem, const river_struct *river)
         if (elem_h > zbank)
         {
             /* Submerged weir */
-            flux = river->matl.cwr * 2.0 * sqrt(2.0 * GRAV) *
-                river->shp.length * sqrt(rivseg_h - elem_h) *
+            flux = river->cwr[i] * 2.0 * sqrt(2.0 * GRAV) *
+                river->length[i] * sqrt(rivseg_h - elem_h) *
                 (rivseg_h - zbank) / 3.0;
         }
         else
@@ -210,8 +360,8 @@ double OvlFlowElemToRiver(const elem_struct *elem, const river_struct *river)
             if (zbank < rivseg_h)
             {
                 /* Free-flowing weir */
-                flux = river->matl.cwr * 2.0 * sqrt(2.0 * GRAV) *
-                    river->shp.length * sqrt(rivseg_h - zbank) *
+                flux = river->cwr[i] * 2.0 * sqrt(2.0 * GRAV) *
+                    river->length[i] * sqrt(rivseg_h - zbank) *
                     (rivseg_h - zbank) / 3.0;
             }
             else
@@ -220,13 +370,13 @@ double OvlFlowElemToRiver(const elem_struct *elem, const river_struct *river)
             }
         }
     }
-    else if (elem->ws.surfh > DEPRSTG)
+    else if (elem->surfh[ie] > DEPRSTG)
     {
         if (rivseg_h > zbank)
         {
             /* Submerged weir */
-            flux = -river->matl.cwr * 2.0 * sqrt(2.0 * GRAV) *
-                river->shp.length * sqrt(elem_h - rivseg_h) *
+            flux = -river->cwr[i] * 2.0 * sqrt(2.0 * GRAV) *
+                river->length[i] * sqrt(elem_h - rivseg_h) *
                 (elem_h - zbank) / 3.0;
         }
         else
@@ -234,8 +384,8 @@ double OvlFlowElemToRiver(const elem_struct *elem, const river_struct *river)
             if (zbank < elem_h)
             {
                 /* Free-flowing weir */
-                flux = -river->matl.cwr * 2.0 * sqrt(2.0 * GRAV) *
-                    river->shp.length * sqrt(elem_h - zbank) *
+                flux = -river->cwr[i] * 2.0 * sqrt(2.0 * GRAV) *
+                    river->length[i] * sqrt(elem_h - zbank) *
                     (elem_h - zbank) / 3.0;
             }
             else
@@ -252,7 +402,7 @@ double OvlFlowElemToRiver(const elem_struct *elem, const river_struct *river)
     return flux;
 }
 
-double ChanFlowRiverToRiver(const river_struct *river, const river_struct *down,
+double ChanFlowRiverToRiver(const hydro_river_struct *river, int i, int down,
     int riv_mode)
 {
     double          total_h;
@@ -270,35 +420,34 @@ double ChanFlowRiverToRiver(const river_struct *river, const river_struct *down,
     double          avg_crossa;
     double          avg_h;
 
-    total_h = river->ws.stage + river->topo.zbed;
+    total_h = river->stage[i] + river->zbed[i];
     perim =
-        RiverPerim(river->shp.intrpl_ord, river->ws.stage, river->shp.coeff);
+        RiverPerim(river->intrpl_ord[i], river->stage[i], river->coeff[i]);
 
-    total_h_down = down->ws.stage + down->topo.zbed;
-    perim_down =
-        RiverPerim(down->shp.intrpl_ord, down->ws.stage, down->shp.coeff);
+    total_h_down = river->stage[down] + river->zbed[down];
+    perim_down = RiverPerim(river->intrpl_ord[down], river->stage[down],
+        river->coeff[down]);
 
     avg_perim = (perim + perim_down) / 2.0;
-    avg_rough = (river->matl.rough + down->matl.rough) / 2.0;
-    distance = 0.5 * (river->shp.length + down->shp.length);
+    avg_rough = (river->rough[i] + river->rough[down]) / 2.0;
+    distance = 0.5 * (river->length[i] + river->length[down]);
 
     diff_h = (riv_mode == KINEMATIC) ?
-        (river->topo.zbed - down->topo.zbed) : (total_h - total_h_down);
+        (river->zbed[i] - river->zbed[down]) : (total_h - total_h_down);
     grad_h = diff_h / distance;
     avg_sf = (grad_h > 0.0) ? grad_h : RIVGRADMIN;
-    crossa =
-        RiverCroSectArea(river->shp.intrpl_ord, river->ws.stage,
-            river->shp.coeff);
-    crossa_down =
-        RiverCroSectArea(down->shp.intrpl_ord, down->ws.stage, down->shp.coeff);
+    crossa = RiverCroSectArea(river->intrpl_ord[i], river->stage[i],
+        river->coeff[i]);
+    crossa_down = RiverCroSectArea(river->intrpl_ord[down], river->stage[down],
+        river->coeff[down]);
     avg_crossa = 0.5 * (crossa + crossa_down);
     avg_h = (avg_perim == 0.0) ? 0.0 : (avg_crossa / avg_perim);
 
     return OverLandFlow(avg_h, grad_h, avg_sf, crossa, avg_rough);
 }
 
-double SubFlowRiverToRiver(const river_struct *river, double effk,
-    const river_struct *down, double effk_nabr)
+double SubFlowRiverToRiver(const hydro_river_struct *river, int i, double effk,
+    int down, double effk_nabr)
 {
     double          total_h;
     double          total_h_down;
@@ -311,14 +460,14 @@ double SubFlowRiverToRiver(const river_struct *river, double effk,
     double          avg_ksat;
 
     /* Lateral flux calculation between element beneath river (ebr) * and ebr */
-    total_h = river->ws.gw + river->topo.zmin;
-    total_h_down = down->ws.gw + down->topo.zmin;
-    avg_wid = (river->shp.width + down->shp.width) / 2.0;
+    total_h = river->gw[i] + river->zmin[i];
+    total_h_down = river->gw[down] + river->zmin[down];
+    avg_wid = (river->width[i] + river->width[down]) / 2.0;
     diff_h = total_h - total_h_down;
-    avg_h = AvgH(diff_h, river->ws.gw, down->ws.gw);
-    distance = 0.5 * (river->shp.length + down->shp.length);
+    avg_h = AvgH(diff_h, river->gw[i], river->gw[down]);
+    distance = 0.5 * (river->length[i] + river->length[down]);
     grad_h = diff_h / distance;
-    aquifer_depth = river->topo.zbed - river->topo.zmin;
+    aquifer_depth = river->zbed[i] - river->zmin[i];
 #if defined(_ARITH_)
     avg_ksat = 0.5 * (effk + effk_nabr);
 #else
@@ -328,9 +477,7 @@ double SubFlowRiverToRiver(const river_struct *river, double effk,
     return avg_ksat * grad_h * avg_h * avg_wid;
 }
 
-double OutletFlux(int down, const river_wstate_struct *ws,
-    const river_topo_struct *topo, const shp_struct *shp,
-    const matl_struct *matl, const river_bc_struct *bc)
+double OutletFlux(const hydro_river_struct *river, int i)
 {
     double          total_h;
     double          total_h_down;
@@ -341,55 +488,61 @@ double OutletFlux(int down, const river_wstate_struct *ws,
     double          crossa;
     double          discharge = 0.0;
 
-    switch (down)
+    switch (river->down[i])
     {
         case DIRICHLET:
             /* Dirichlet boundary condition */
-            total_h = ws->stage + topo->zbed;
-            total_h_down = bc->head;
-            distance = 0.5 * shp->length;
+            total_h = river->stage[i] + river->zbed[i];
+            total_h_down = river->bc[i].head;
+            distance = 0.5 * river->length[i];
             grad_h = (total_h - total_h_down) / distance;
-            avg_h = AvgH(grad_h, ws->stage,
-                ((bc->head - (topo->node_zmax - shp->depth) > 0.0) ?
-                bc->head - (topo->node_zmax - shp->depth) : 0.0));
-            avg_perim = RiverPerim(shp->intrpl_ord, ws->stage, shp->coeff);
-            crossa = RiverCroSectArea(shp->intrpl_ord, ws->stage, shp->coeff);
+            avg_h = AvgH(grad_h, river->stage[i],
+                ((river->bc[i].head -
+                (river->node_zmax[i] - river->depth[i]) > 0.0) ?
+                river->bc[i].head - (river->node_zmax[i] - river->depth[i]) :
+                0.0));
+            avg_perim = RiverPerim(river->intrpl_ord[i], river->stage[i],
+                river->coeff[i]);
+            crossa = RiverCroSectArea(river->intrpl_ord[i], river->stage[i],
+                river->coeff[i]);
             avg_h = (avg_perim == 0.0) ? 0.0 : (crossa / avg_perim);
             discharge =
-                OverLandFlow(avg_h, grad_h, grad_h, crossa, matl->rough);
+                OverLandFlow(avg_h, grad_h, grad_h, crossa, river->rough[i]);
             break;
         case NEUMANN:
             /* Neumann boundary condition */
-            discharge = -bc->flux;
+            discharge = -river->bc[i].flux;
             break;
         case ZERO_DPTH_GRAD:
             /* Zero-depth-gradient boundary conditions */
-            distance = 0.5 * shp->length;
-            grad_h = (topo->zbed - (topo->node_zmax - shp->depth)) / distance;
-            avg_h = ws->stage;
-            avg_perim = RiverPerim(shp->intrpl_ord, ws->stage, shp->coeff);
-            crossa = RiverCroSectArea(shp->intrpl_ord, ws->stage, shp->coeff);
+            distance = 0.5 * river->length[i];
+            grad_h = (river->zbed[i] -
+                (river->node_zmax[i] - river->depth[i])) / distance;
+            avg_h = river->stage[i];
+            avg_perim = RiverPerim(river->intrpl_ord[i], river->stage[i],
+                river->coeff[i]);
+            crossa = RiverCroSectArea(river->intrpl_ord[i], river->stage[i],
+                river->coeff[i]);
             discharge = sqrt(grad_h) * crossa * ((avg_perim > 0.0) ?
-                pow(crossa / avg_perim, 2.0 / 3.0) : 0.0) / matl->rough;
+                pow(crossa / avg_perim, 2.0 / 3.0) : 0.0) / river->rough[i];
             break;
         case CRIT_DPTH:
             /* Critical depth boundary conditions */
-            crossa = RiverCroSectArea(shp->intrpl_ord, ws->stage, shp->coeff);
-            discharge = crossa * sqrt(GRAV * ws->stage);
+            crossa = RiverCroSectArea(river->intrpl_ord[i], river->stage[i],
+                river->coeff[i]);
+            discharge = crossa * sqrt(GRAV * river->stage[i]);
             break;
         default:
             PIHMprintf(VL_ERROR,
                 "Error: River routing boundary condition type (%d) "
-                "is not recognized.\n", down);
+                "is not recognized.\n", river->down[i]);
             PIHMexit(EXIT_FAILURE);
     }
 
     return discharge;
 }
 
-double BoundFluxRiver(int riverbc_type, const river_wstate_struct *ws,
-    const river_topo_struct *topo, const shp_struct *shp,
-    const matl_struct *matl, const river_bc_struct *bc)
+double BoundFluxRiver(const hydro_river_struct *river, int i)
 {
     double          total_h;
     double          total_h_down;
@@ -400,65 +553,68 @@ double BoundFluxRiver(int riverbc_type, const river_wstate_struct *ws,
     double          crossa;
     double          flux = 0.0;
 
-    if (riverbc_type > 0)
+    if (river->riverbc_type[i] > 0)
     {
         /* Dirichlet boundary condition */
-        total_h = ws->stage + topo->zbed;
-        total_h_down = bc->head;
-        distance = 0.5 * shp->length;
+        total_h = river->stage[i] + river->zbed[i];
+        total_h_down = river->bc[i].head;
+        distance = 0.5 * river->length[i];
         grad_h = (total_h - total_h_down) / distance;
-        avg_h = AvgH(grad_h, ws->stage,
-            ((bc->head - topo->zbed > 0.0) ? (bc->head - topo->zbed) : 0.0));
-        avg_perim = RiverPerim(shp->intrpl_ord, ws->stage, shp->coeff);
-        crossa = RiverCroSectArea(shp->intrpl_ord, ws->stage, shp->coeff);
+        avg_h = AvgH(grad_h, river->stage[i],
+            ((river->bc[i].head - river->zbed[i] > 0.0) ?
+            (river->bc[i].head - river->zbed[i]) : 0.0));
+        avg_perim = RiverPerim(river->intrpl_ord[i], river->stage[i],
+            river->coeff[i]);
+        crossa = RiverCroSectArea(river->intrpl_ord[i], river->stage[i],
+            river->coeff[i]);
         avg_h = (avg_perim == 0.0) ? 0.0 : (crossa / avg_perim);
         flux =
-            OverLandFlow(avg_h, grad_h, grad_h, crossa, matl->rough);
+            OverLandFlow(avg_h, grad_h, grad_h, crossa, river->rough[i]);
     }
-    else if (riverbc_type < 0)
+    else if (river->riverbc_type[i] < 0)
     {
         /* Neumann boundary condition */
-        flux = -bc->flux;
+        flux = -river->bc[i].flux;
     }
 
     return flux;
 }
 
-double ChanFlowElemToRiver(const elem_struct *elem, double effk,
-    const river_struct *river, double distance)
+double ChanFlowElemToRiver(const hydro_elem_struct *elem, int ie, double effk,
+    const hydro_river_struct *river, int i, double distance)
 {
     double          diff_h;
     double          avg_h;
     double          grad_h;
     double          avg_ksat;
 
-    diff_h = (river->ws.stage + river->topo.zbed) -
-        (elem->ws.gw + elem->topo.zmin);
+    diff_h = (river->stage[i] + river->zbed[i]) -
+        (elem->gw[ie] + elem->zmin[ie]);
 
     /* This is head in neighboring cell representation */
-    if (elem->topo.zmin > river->topo.zbed)
+    if (elem->zmin[ie] > river->zbed[i])
     {
-        avg_h = elem->ws.gw;
+        avg_h = elem->gw[ie];
     }
-    else if (elem->topo.zmin + elem->ws.gw > river->topo.zbed)
+    else if (elem->zmin[ie] + elem->gw[ie] > river->zbed[i])
     {
-        avg_h = elem->topo.zmin + elem->ws.gw - river->topo.zbed;
+        avg_h = elem->zmin[ie] + elem->gw[ie] - river->zbed[i];
     }
     else
     {
         avg_h = 0.0;
     }
-    avg_h = AvgH(diff_h, river->ws.stage, avg_h);
+    avg_h = AvgH(diff_h, river->stage[i], avg_h);
 
     grad_h = diff_h / distance;
 
-    avg_ksat = 0.5 * (effk + river->matl.ksath);
+    avg_ksat = 0.5 * (effk + river->ksath[i]);
 
-    return  river->shp.length * avg_ksat * grad_h * avg_h;
+    return  river->length[i] * avg_ksat * grad_h * avg_h;
 }
 
-double SubFlowElemToRiver(const elem_struct *elem, double effk,
-    const river_struct *river, double effk_riv, double distance)
+double SubFlowElemToRiver(const hydro_elem_struct *elem, int ie, double effk,
+    const hydro_river_struct *river, int i, double effk_riv, double distance)
 {
     double          diff_h;
     double          avg_h;
@@ -466,24 +622,24 @@ double SubFlowElemToRiver(const elem_struct *elem, double effk,
     double          avg_ksat;
     double          grad_h;
 
-    diff_h = (river->ws.gw + river->topo.zmin) -
-        (elem->ws.gw + elem->topo.zmin);
+    diff_h = (river->gw[i] + river->zmin[i]) -
+        (elem->gw[ie] + elem->zmin[ie]);
 
     /* This is head in neighboring cell represention */
-    if (elem->topo.zmin > river->topo.zbed)
+    if (elem->zmin[ie] > river->zbed[i])
     {
         avg_h = 0.0;
     }
-    else if (elem->topo.zmin + elem->ws.gw > river->topo.zbed)
+    else if (elem->zmin[ie] + elem->gw[ie] > river->zbed[i])
     {
-        avg_h = river->topo.zbed - elem->topo.zmin;
+        avg_h = river->zbed[i] - elem->zmin[ie];
     }
     else
     {
-        avg_h = elem->ws.gw;
+        avg_h = elem->gw[ie];
     }
-    avg_h = AvgH(diff_h, river->ws.gw, avg_h);
-    aquifer_depth = river->topo.zbed - river->topo.zmin;
+    avg_h = AvgH(diff_h, river->gw[i], avg_h);
+    aquifer_depth = river->zbed[i] - river->zmin[i];
 
 #if defined(_ARITH_)
     avg_ksat = 0.5 * (effk + effk_riv);
@@ -492,27 +648,27 @@ double SubFlowElemToRiver(const elem_struct *elem, double effk,
 #endif
     grad_h = diff_h / distance;
 
-    return river->shp.length * avg_ksat * grad_h * avg_h;
+    return river->length[i] * avg_ksat * grad_h * avg_h;
 }
 
-double ChanLeak(const river_wstate_struct *ws, const river_topo_struct *topo,
-    const shp_struct *shp, const matl_struct *matl)
+double ChanLeak(const hydro_river_struct *river, int i)
 {
     double          diff_h;
     double          grad_h;
 
-    if (topo->zbed - (ws->gw + topo->zmin) > 0.0)
+    if (river->zbed[i] - (river->gw[i] + river->zmin[i]) > 0.0)
     {
-        diff_h = ws->stage;
+        diff_h = river->stage[i];
     }
     else
     {
-        diff_h = ws->stage + topo->zbed - (ws->gw + topo->zmin);
+        diff_h = river->stage[i] + river->zbed[i] -
+            (river->gw[i] + river->zmin[i]);
     }
 
-    grad_h = diff_h / matl->bedthick;
+    grad_h = diff_h / river->bedthick[i];
 
-    return matl->ksatv * shp->width * shp->length * grad_h;
+    return river->ksatv[i] * river->width[i] * river->length[i] * grad_h;
 }
 
 double RiverCroSectArea(int order, double depth, double coeff)
@@ -30,23 +30,22 @@ void OS3D(realtype t, realtype stepsize, Chem_Data CD)
 
     // input t and stepsize in the unit of minute
 
-    double        **dconc = (double **)malloc(CD->NumOsv * sizeof (double *));
+    double        **dconc = CD->Dconc;
     int             i, j, k, jj, node_1, node_2, node_3, node_4, abnormalflg,
         nr_tmp;
     double          flux_t, diff_flux, disp_flux, distance, temp_dconc,
         velocity, temp_conc, inv_dist, diff_conc, unit_c, area, r_, beta_,
         var_height, total_prep_mass, timelps, invavg, adpstep;
-    double         *tmpconc = (double *)malloc(CD->NumSpc * sizeof (double));
+    double         *tmpconc = CD->Tmpconc;
 
     abnormalflg = 0;
     unit_c = 1.0 / 1440;
     total_prep_mass = 0.0;
 
-    // Initalize the allocated array
+    // Initalize the scratch array
 
     for (i = 0; i < CD->NumOsv; i++)
     {
-        dconc[i] = (double *)malloc(CD->NumSpc * sizeof (double));
         for (j = 0; j < CD->NumSpc; j++)
             dconc[i][j] = 0.0;
     }
@@ -503,9 +502,4 @@ void OS3D(realtype t, realtype stepsize, Chem_Data CD)
             }
         }
     }
-    for (i = 0; i < CD->NumOsv; i++)
-        free(dconc[i]);
-
-    free(dconc);
-    free(tmpconc);
 }
@@ -1693,6 +1693,12 @@ chem_alloc(char *filename, const void *DS, const Control_Data CS,
     CD->Flux = (face *) malloc(CD->NumFac * sizeof (face));
     k = 0;
 
+    /* Scratch arrays of os3d, allocated once and reused by every call */
+    CD->Dconc = (double **)malloc(CD->NumOsv * sizeof (double *));
+    for (i = 0; i < CD->NumOsv; i++)
+        CD->Dconc[i] = (double *)malloc(CD->NumSpc * sizeof (double));
+    CD->Tmpconc = (double *)malloc(CD->NumSpc * sizeof (double));
+
     double          dist1, dist2, para_a, para_b, para_c, x_0, x_1, y_0, y_1;
     int             index_0, index_1, rivi, control;
 
@@ -204,6 +204,8 @@ typedef struct Chem_Data_structure
     vol_conc       *Vcele;      // An array that stores the volumetric (vol) and chemical (conc) information of grid blocks
     vol_conc        Precipitation;  // The cell that stores the concentrations of chemicals in the rain.
     face           *Flux;       // connections between grid blocks
+    double        **Dconc;      // scratch array of concentration changes in os3d (NumOsv x NumSpc)
+    double         *Tmpconc;    // scratch array of concentrations in os3d (NumSpc)
     species        *chemtype;   // information of chemical species
     Kinetic_Reaction *kinetics; // kinetics constants and dependencies.
     Debye_Huckel    DH;
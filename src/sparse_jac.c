@@ -0,0 +1,317 @@
+#include "pihm.h"
+
+void InitSparseJac(const graph_struct *graph, jac_struct *jac)
+{
+    int             i, j, k;
+    int             nsv;
+    int             ncolor;
+    int            *svnode;
+    int            *color;
+    int            *list;
+    int            *stamp;
+    int            *depth;
+    int            *nbptr;
+    int            *nb;
+
+    PIHMprintf(VL_VERBOSE, "Initialize sparse Jacobian.\n");
+
+    nsv = NumStateVar();
+
+    /* Node of each state variable. State variables not attached to any node
+     * (e.g., lumped soil mineral N) only have diagonal entries */
+    svnode = (int *)malloc(nsv * sizeof(int));
+    for (i = 0; i < nsv; i++)
+    {
+        svnode[i] = -1;
+    }
+    for (i = 0; i < graph->nnode; i++)
+    {
+        for (j = 0; j < graph->nsv[i]; j++)
+        {
+            svnode[graph->sv[i][j]] = i;
+        }
+    }
+
+    /*
+     * Sparsity pattern. Lateral fluxes depend on the friction slopes of
+     * neighbors, so the RHS of a node depends on all state variables of nodes
+     * within two edges. The pattern is structurally symmetric
+     */
+    list = (int *)malloc(graph->nnode * sizeof(int));
+    stamp = (int *)malloc(graph->nnode * sizeof(int));
+    depth = (int *)malloc(graph->nnode * sizeof(int));
+    nbptr = (int *)malloc((graph->nnode + 1) * sizeof(int));
+
+    for (i = 0; i < graph->nnode; i++)
+    {
+        stamp[i] = -1;
+    }
+
+    /* Nodes within two edges of each node */
+    nbptr[0] = 0;
+    for (i = 0; i < graph->nnode; i++)
+    {
+        nbptr[i + 1] = nbptr[i] +
+            NodesWithin(graph, i, 2, list, stamp, depth);
+    }
+
+    nb = (int *)malloc(nbptr[graph->nnode] * sizeof(int));
+
+    for (i = 0; i < graph->nnode; i++)
+    {
+        stamp[i] = -1;
+    }
+    for (i = 0; i < graph->nnode; i++)
+    {
+        NodesWithin(graph, i, 2, &nb[nbptr[i]], stamp, depth);
+    }
+
+    free(list);
+    free(stamp);
+    free(depth);
+
+    jac->indexptrs = (int *)malloc((nsv + 1) * sizeof(int));
+    jac->indexptrs[0] = 0;
+    for (i = 0; i < nsv; i++)
+    {
+        int             nnz = 0;
+
+        if (svnode[i] >= 0)
+        {
+            for (j = nbptr[svnode[i]]; j < nbptr[svnode[i] + 1]; j++)
+            {
+                nnz += graph->nsv[nb[j]];
+            }
+        }
+        else
+        {
+            nnz = 1;
+        }
+
+        jac->indexptrs[i + 1] = jac->indexptrs[i] + nnz;
+    }
+
+    jac->nnz = jac->indexptrs[nsv];
+    jac->indexvals = (int *)malloc(jac->nnz * sizeof(int));
+
+    for (i = 0; i < nsv; i++)
+    {
+        int             ptr;
+
+        ptr = jac->indexptrs[i];
+
+        if (svnode[i] >= 0)
+        {
+            for (j = nbptr[svnode[i]]; j < nbptr[svnode[i] + 1]; j++)
+            {
+                for (k = 0; k < graph->nsv[nb[j]]; k++)
+                {
+                    jac->indexvals[ptr++] = graph->sv[nb[j]][k];
+                }
+            }
+
+            /* Sort indices in ascending order (insertion sort) */
+            for (j = jac->indexptrs[i] + 1; j < jac->indexptrs[i + 1]; j++)
+            {
+                int             ind;
+
+                ind = jac->indexvals[j];
+                k = j - 1;
+                while (k >= jac->indexptrs[i] && jac->indexvals[k] > ind)
+                {
+                    jac->indexvals[k + 1] = jac->indexvals[k];
+                    k--;
+                }
+                jac->indexvals[k + 1] = ind;
+            }
+        }
+        else
+        {
+            jac->indexvals[ptr] = i;
+        }
+    }
+
+    free(nbptr);
+    free(nb);
+
+    /*
+     * Column groups for difference quotients. Two columns can be perturbed
+     * together only when they do not share any row, i.e., when their nodes are
+     * more than four edges apart
+     */
+    color = (int *)malloc(graph->nnode * sizeof(int));
+    ncolor = ColorGraph(graph, 4, color);
+
+    jac->grpptr = (int *)malloc((ncolor * MAXNSV + nsv + 1) * sizeof(int));
+    jac->grpcol = (int *)malloc(nsv * sizeof(int));
+
+    jac->ngroup = 0;
+    jac->grpptr[0] = 0;
+    k = 0;
+    for (i = 0; i < ncolor; i++)
+    {
+        int             m;
+
+        for (m = 0; m < MAXNSV; m++)
+        {
+            for (j = 0; j < graph->nnode; j++)
+            {
+                if (color[j] == i && m < graph->nsv[j])
+                {
+                    jac->grpcol[k++] = graph->sv[j][m];
+                }
+            }
+
+            if (k > jac->grpptr[jac->ngroup])
+            {
+                jac->ngroup++;
+                jac->grpptr[jac->ngroup] = k;
+            }
+        }
+    }
+    for (i = 0; i < nsv; i++)
+    {
+        if (svnode[i] < 0)
+        {
+            jac->grpcol[k++] = i;
+            jac->ngroup++;
+            jac->grpptr[jac->ngroup] = k;
+        }
+    }
+
+    free(color);
+
+    PIHMprintf(VL_VERBOSE, " %d nonzeros, %d column groups.\n", jac->nnz,
+        jac->ngroup);
+
+    /*
+     * Data positions of each column. Rows of each column are the same as the
+     * indices of the corresponding row because of structural symmetry
+     */
+    jac->colpos = (int *)malloc(jac->nnz * sizeof(int));
+
+    for (i = 0; i < nsv; i++)
+    {
+        for (j = jac->indexptrs[i]; j < jac->indexptrs[i + 1]; j++)
+        {
+            int             row;
+            int             lo, hi;
+
+            row = jac->indexvals[j];
+
+            /* Binary search for column i in row */
+            lo = jac->indexptrs[row];
+            hi = jac->indexptrs[row + 1] - 1;
+            while (lo < hi)
+            {
+                int             mid;
+
+                mid = (lo + hi) / 2;
+                if (jac->indexvals[mid] < i)
+                {
+                    lo = mid + 1;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+            jac->colpos[j] = lo;
+        }
+    }
+
+    free(svnode);
+}
+
+int SparseJac(realtype t, N_Vector CV_Y, N_Vector fy, SlsMat JacMat,
+    void *pihm_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+    /*
+     * Sparse Jacobian of ODE() approximated by forward difference quotients.
+     * The infiltration, recharge, ET, and overland flux functions have many
+     * piecewise branches, so the entries are not derived analytically.
+     * Columns that do not share any row are perturbed together, which takes
+     * one RHS evaluation per column group
+     */
+    int             g;
+    int             nsv;
+    double         *y;
+    double         *f0;
+    double         *ytmp;
+    double         *ftmp;
+    double         *inc;
+    double          srur;
+    pihm_struct     pihm;
+    const jac_struct *jac;
+
+    pihm = (pihm_struct)pihm_data;
+    jac = &pihm->jac;
+
+    nsv = NumStateVar();
+
+    /* The sparsity pattern is fixed by the mesh and the river network, so the
+     * symbolic factorization is reused by the solver */
+    memcpy(JacMat->indexptrs, jac->indexptrs, (nsv + 1) * sizeof(int));
+    memcpy(JacMat->indexvals, jac->indexvals, jac->nnz * sizeof(int));
+
+    y = NV_DATA(CV_Y);
+    f0 = NV_DATA(fy);
+    ytmp = NV_DATA(tmp1);
+    ftmp = NV_DATA(tmp2);
+    inc = NV_DATA(tmp3);
+
+    srur = sqrt(UNIT_ROUNDOFF);
+
+    N_VScale(1.0, CV_Y, tmp1);
+
+    /* Perturb one group of columns at a time */
+    for (g = 0; g < jac->ngroup; g++)
+    {
+        int             i;
+
+        for (i = jac->grpptr[g]; i < jac->grpptr[g + 1]; i++)
+        {
+            int             col;
+
+            col = jac->grpcol[i];
+            inc[col] = srur * ((fabs(y[col]) > pihm->ctrl.abstol) ?
+                fabs(y[col]) : pihm->ctrl.abstol);
+            ytmp[col] = y[col] + inc[col];
+        }
+
+        ODE(t, tmp1, tmp2, pihm);
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+        for (i = jac->grpptr[g]; i < jac->grpptr[g + 1]; i++)
+        {
+            int             j;
+            int             col;
+
+            col = jac->grpcol[i];
+            for (j = jac->indexptrs[col]; j < jac->indexptrs[col + 1]; j++)
+            {
+                JacMat->data[jac->colpos[j]] =
+                    (ftmp[jac->indexvals[j]] - f0[jac->indexvals[j]]) /
+                    inc[col];
+            }
+            ytmp[col] = y[col];
+        }
+    }
+
+    /* Restore model fluxes at the unperturbed state, which are used for
+     * output */
+    ODE(t, CV_Y, tmp2, pihm);
+
+    return 0;
+}
+
+void FreeSparseJac(jac_struct *jac)
+{
+    free(jac->indexptrs);
+    free(jac->indexvals);
+    free(jac->grpptr);
+    free(jac->grpcol);
+    free(jac->colpos);
+}
@@ -6,12 +6,21 @@ void Spinup(pihm_struct pihm, N_Vector CV_Y, void *cvode_mem)
     int             first_spin_cycle = 1;
     int             steady;
     int             metyears;
+    double          dw;
     ctrl_struct    *ctrl;
+    spinacc_struct  acc;
+    spinprev_struct prev;
 
     ctrl = &pihm->ctrl;
 
     metyears = (ctrl->endtime - ctrl->starttime) / DAYINSEC / 365;
 
+    if (ctrl->spinup_acc)
+    {
+        InitSpinAcc(&acc);
+        GetHydrolState(CV_Y, acc.x);
+    }
+
     do
     {
         PIHMprintf(VL_NORMAL, "Spinup year: %6d\n", spinyears + 1);
@@ -25,22 +34,452 @@ void Spinup(pihm_struct pihm, N_Vector CV_Y, void *cvode_mem)
             PIHM(pihm, cvode_mem, CV_Y, 0.0);
         }
 
-        /* Reset solver parameters */
-        SetCVodeParam(pihm, cvode_mem, CV_Y);
-
         spinyears += metyears;
 
 #if defined(_BGC_)
         steady = CheckSteadyState(pihm->elem, pihm->siteinfo.area,
             first_spin_cycle, ctrl->endtime - ctrl->starttime,
-            spinyears);
+            spinyears, &prev);
 #else
         steady = CheckSteadyState(pihm->elem, pihm->siteinfo.area,
-            first_spin_cycle, spinyears);
+            first_spin_cycle, spinyears, &prev);
+#endif
+
+        if (ctrl->spinup_acc && !steady)
+        {
+            /* Extrapolate hydrologic states at the beginning of the next
+             * cycle. Limits of extrapolated states include the plain
+             * fixed-point iterate g, which is thus never limited */
+            GetHydrolState(CV_Y, acc.g);
+            SpinupAcc(&acc);
+            dw = SetHydrolState(acc.x, (acc.accelerated) ? acc.g : acc.x,
+                CV_Y, pihm->elem, pihm->river);
+
+            /* Limiting extrapolated states to physical ranges adds or
+             * removes water, which is not conserved by the acceleration */
+            PIHMprintf(VL_NORMAL, "Water added by limiting extrapolated "
+                "states = %lg m3 (%lg m over the domain)\n", dw,
+                dw / pihm->siteinfo.area);
+
+            /* Changes of water storages over the next cycle are measured
+             * from the extrapolated states instead of the end of this
+             * cycle */
+#if defined(_BGC_)
+            CheckSteadyState(pihm->elem, pihm->siteinfo.area, 1,
+                ctrl->endtime - ctrl->starttime, spinyears, &prev);
+#else
+            CheckSteadyState(pihm->elem, pihm->siteinfo.area, 1, spinyears,
+                &prev);
 #endif
+        }
+
+        /* Reset solver parameters */
+        SetCVodeParam(pihm, cvode_mem, CV_Y);
 
         first_spin_cycle = 0;
     } while (spinyears < ctrl->maxspinyears && (!steady));
+
+    if (ctrl->spinup_acc)
+    {
+        FreeSpinAcc(&acc);
+    }
+}
+
+void InitSpinAcc(spinacc_struct *acc)
+{
+    int             k;
+
+    acc->nstate = NUM_HYDROL_ELEM * nelem + NUM_HYDROL_RIVER * nriver;
+    acc->nhist = 0;
+    acc->ncycle = 0;
+    acc->accelerated = 0;
+    acc->fnorm_prev = 0.0;
+
+    acc->x = (double *)malloc(acc->nstate * sizeof(double));
+    acc->g = (double *)malloc(acc->nstate * sizeof(double));
+    acc->f = (double *)malloc(acc->nstate * sizeof(double));
+    acc->gprev = (double *)malloc(acc->nstate * sizeof(double));
+    acc->fprev = (double *)malloc(acc->nstate * sizeof(double));
+    for (k = 0; k < SPINUP_ACC_DEPTH; k++)
+    {
+        acc->dg[k] = (double *)malloc(acc->nstate * sizeof(double));
+        acc->df[k] = (double *)malloc(acc->nstate * sizeof(double));
+    }
+}
+
+void GetHydrolState(N_Vector CV_Y, double *x)
+{
+    /*
+     * Copy hydrologic states from the CVODE state vector. States of each
+     * element (river segment) are stored next to each other
+     */
+    const double   *y;
+    int             i;
+
+    y = NV_DATA(CV_Y);
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        double         *xi;
+
+        xi = x + NUM_HYDROL_ELEM * i;
+        xi[0] = y[SURF(i)];
+        xi[1] = y[UNSAT(i)];
+        xi[2] = y[GW(i)];
+#if defined(_FBR_)
+        xi[3] = y[FBRUNSAT(i)];
+        xi[4] = y[FBRGW(i)];
+#endif
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        double         *xi;
+
+        xi = x + NUM_HYDROL_ELEM * nelem + NUM_HYDROL_RIVER * i;
+        xi[0] = y[RIVSTG(i)];
+        xi[1] = y[RIVGW(i)];
+    }
+}
+
+double SetHydrolState(double *x, const double *xref, N_Vector CV_Y,
+    elem_struct *elem, river_struct *river)
+{
+    /*
+     * Set hydrologic states of model grids and the CVODE state vector.
+     * States are limited to be non-negative, and subsurface water storages
+     * are limited to soil (bedrock) depth. Because model states may slightly
+     * exceed these ranges, the ranges are extended to include reference
+     * states xref, so states equal to xref are never limited. Limited states
+     * are copied back to x. Returns the volume of water added by limiting
+     * states (m3), which is negative when water is removed
+     */
+    double         *y;
+    double          dw = 0.0;
+    int             i;
+
+    y = NV_DATA(CV_Y);
+
+#if defined(_OPENMP)
+# pragma omp parallel for reduction(+: dw)
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        double         *xi;
+        const double   *ri;
+        double          x0[NUM_HYDROL_ELEM];
+        double          xmin, xmax;
+        int             k;
+
+        xi = x + NUM_HYDROL_ELEM * i;
+        ri = xref + NUM_HYDROL_ELEM * i;
+        for (k = 0; k < NUM_HYDROL_ELEM; k++)
+        {
+            x0[k] = xi[k];
+            xmin = (ri[k] < 0.0) ? ri[k] : 0.0;
+            xi[k] = (xi[k] > xmin) ? xi[k] : xmin;
+        }
+        xmax = (ri[2] > elem[i].soil.depth) ? ri[2] : elem[i].soil.depth;
+        xi[2] = (xi[2] < xmax) ? xi[2] : xmax;
+        xmax = (ri[1] > elem[i].soil.depth - xi[2]) ?
+            ri[1] : elem[i].soil.depth - xi[2];
+        xi[1] = (xi[1] < xmax) ? xi[1] : xmax;
+#if defined(_FBR_)
+        xmax = (ri[4] > elem[i].geol.depth) ? ri[4] : elem[i].geol.depth;
+        xi[4] = (xi[4] < xmax) ? xi[4] : xmax;
+        xmax = (ri[3] > elem[i].geol.depth - xi[4]) ?
+            ri[3] : elem[i].geol.depth - xi[4];
+        xi[3] = (xi[3] < xmax) ? xi[3] : xmax;
+#endif
+
+        dw += (xi[0] - x0[0] +
+            (xi[1] - x0[1] + xi[2] - x0[2]) * elem[i].soil.porosity) *
+            elem[i].topo.area;
+#if defined(_FBR_)
+        dw += (xi[3] - x0[3] + xi[4] - x0[4]) * elem[i].geol.porosity *
+            elem[i].topo.area;
+#endif
+
+        y[SURF(i)] = elem[i].ws.surf = xi[0];
+        y[UNSAT(i)] = elem[i].ws.unsat = xi[1];
+        y[GW(i)] = elem[i].ws.gw = xi[2];
+#if defined(_FBR_)
+        y[FBRUNSAT(i)] = elem[i].ws.fbr_unsat = xi[3];
+        y[FBRGW(i)] = elem[i].ws.fbr_gw = xi[4];
+#endif
+
+        elem[i].ws0 = elem[i].ws;
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for reduction(+: dw)
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        double         *xi;
+        const double   *ri;
+        double          x0[NUM_HYDROL_RIVER];
+        double          xmin;
+        int             k;
+
+        xi = x + NUM_HYDROL_ELEM * nelem + NUM_HYDROL_RIVER * i;
+        ri = xref + NUM_HYDROL_ELEM * nelem + NUM_HYDROL_RIVER * i;
+        for (k = 0; k < NUM_HYDROL_RIVER; k++)
+        {
+            x0[k] = xi[k];
+            xmin = (ri[k] < 0.0) ? ri[k] : 0.0;
+            xi[k] = (xi[k] > xmin) ? xi[k] : xmin;
+        }
+
+        dw += (xi[0] - x0[0] + (xi[1] - x0[1]) * river[i].matl.porosity) *
+            river[i].topo.area;
+
+        y[RIVSTG(i)] = river[i].ws.stage = xi[0];
+        y[RIVGW(i)] = river[i].ws.gw = xi[1];
+
+        river[i].ws0 = river[i].ws;
+    }
+
+    return dw;
+}
+
+void SpinupAcc(spinacc_struct *acc)
+{
+    /*
+     * Anderson acceleration of spinup cycles. A spinup cycle is a fixed-point
+     * map from hydrologic states at the beginning of the cycle (x) to states
+     * at the end of the cycle (g). States at the beginning of the next cycle
+     * are extrapolated from changes of states over up to SPINUP_ACC_DEPTH
+     * previous cycles, by minimizing the linearized change of states over
+     * the next cycle. When the change of states over a cycle grows, previous
+     * cycles are discarded. If the cycle started from extrapolated states,
+     * the cycle is rejected and the next cycle starts from the end of the
+     * previous cycle, i.e., the plain fixed-point iterate. Otherwise the next
+     * cycle starts from g
+     */
+    double          gamma[SPINUP_ACC_DEPTH];
+    double          fnorm = 0.0;
+    int             n;
+    int             i, j, k;
+
+    n = acc->nstate;
+
+#if defined(_OPENMP)
+# pragma omp parallel for reduction(+: fnorm)
+#endif
+    for (i = 0; i < n; i++)
+    {
+        acc->f[i] = acc->g[i] - acc->x[i];
+        fnorm += acc->f[i] * acc->f[i];
+    }
+    fnorm = sqrt(fnorm);
+
+    if (acc->accelerated && fnorm > acc->fnorm_prev)
+    {
+        PIHMprintf(VL_NORMAL, "Anderson acceleration: |g - x| grows from %lg "
+            "to %lg. Restart from the end of the previous cycle\n",
+            acc->fnorm_prev, fnorm);
+
+        acc->nhist = 0;
+        acc->accelerated = 0;
+        memcpy(acc->x, acc->gprev, n * sizeof(double));
+
+        return;
+    }
+
+    if (acc->ncycle > 0)
+    {
+        if (fnorm > acc->fnorm_prev)
+        {
+            acc->nhist = 0;
+        }
+        else
+        {
+            if (acc->nhist == SPINUP_ACC_DEPTH)
+            {
+                DropSpinAccHist(acc);
+            }
+
+            k = acc->nhist;
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+            for (i = 0; i < n; i++)
+            {
+                acc->df[k][i] = acc->f[i] - acc->fprev[i];
+                acc->dg[k][i] = acc->g[i] - acc->gprev[i];
+            }
+            acc->nhist++;
+        }
+    }
+
+    memcpy(acc->fprev, acc->f, n * sizeof(double));
+    memcpy(acc->gprev, acc->g, n * sizeof(double));
+    acc->fnorm_prev = fnorm;
+    acc->ncycle++;
+
+    /* Solve the least squares problem using normal equations. The oldest
+     * cycles are discarded if normal equations are singular */
+    while (acc->nhist > 0 && !SolveSpinAcc(acc, gamma))
+    {
+        DropSpinAccHist(acc);
+    }
+
+    PIHMprintf(VL_VERBOSE, "Anderson acceleration: |g - x| = %lg, "
+        "%d previous cycles used\n", fnorm, acc->nhist);
+
+#if defined(_OPENMP)
+# pragma omp parallel for private(j)
+#endif
+    for (i = 0; i < n; i++)
+    {
+        acc->x[i] = acc->g[i];
+        for (j = 0; j < acc->nhist; j++)
+        {
+            acc->x[i] -= gamma[j] * acc->dg[j][i];
+        }
+    }
+
+    acc->accelerated = (acc->nhist > 0);
+}
+
+int SolveSpinAcc(const spinacc_struct *acc, double *gamma)
+{
+    /*
+     * Solve normal equations of the Anderson acceleration least squares
+     * problem using Gaussian elimination with partial pivoting. Returns 0 if
+     * the normal equations are (nearly) singular
+     */
+    double          h[SPINUP_ACC_DEPTH][SPINUP_ACC_DEPTH];
+    double          hmax = 0.0;
+    int             m;
+    int             i, j, k;
+
+    m = acc->nhist;
+
+    for (j = 0; j < m; j++)
+    {
+        for (k = j; k < m; k++)
+        {
+            h[j][k] = StateDotProd(acc->nstate, acc->df[j], acc->df[k]);
+            h[k][j] = h[j][k];
+        }
+        gamma[j] = StateDotProd(acc->nstate, acc->df[j], acc->f);
+
+        hmax = (h[j][j] > hmax) ? h[j][j] : hmax;
+    }
+
+    for (k = 0; k < m; k++)
+    {
+        int             p = k;
+        double          tmp;
+
+        for (i = k + 1; i < m; i++)
+        {
+            p = (fabs(h[i][k]) > fabs(h[p][k])) ? i : p;
+        }
+
+        if (fabs(h[p][k]) <= SPINUP_ACC_COND * hmax)
+        {
+            return 0;
+        }
+
+        if (p != k)
+        {
+            for (j = 0; j < m; j++)
+            {
+                tmp = h[k][j];
+                h[k][j] = h[p][j];
+                h[p][j] = tmp;
+            }
+            tmp = gamma[k];
+            gamma[k] = gamma[p];
+            gamma[p] = tmp;
+        }
+
+        for (i = k + 1; i < m; i++)
+        {
+            double          factor;
+
+            factor = h[i][k] / h[k][k];
+            for (j = k; j < m; j++)
+            {
+                h[i][j] -= factor * h[k][j];
+            }
+            gamma[i] -= factor * gamma[k];
+        }
+    }
+
+    for (k = m - 1; k >= 0; k--)
+    {
+        for (j = k + 1; j < m; j++)
+        {
+            gamma[k] -= h[k][j] * gamma[j];
+        }
+        gamma[k] /= h[k][k];
+    }
+
+    return 1;
+}
+
+double StateDotProd(int n, const double *x, const double *y)
+{
+    double          sum = 0.0;
+    int             i;
+
+#if defined(_OPENMP)
+# pragma omp parallel for reduction(+: sum)
+#endif
+    for (i = 0; i < n; i++)
+    {
+        sum += x[i] * y[i];
+    }
+
+    return sum;
+}
+
+void DropSpinAccHist(spinacc_struct *acc)
+{
+    /*
+     * Discard the oldest cycle in history
+     */
+    double         *dg0;
+    double         *df0;
+    int             k;
+
+    dg0 = acc->dg[0];
+    df0 = acc->df[0];
+    for (k = 0; k < SPINUP_ACC_DEPTH - 1; k++)
+    {
+        acc->dg[k] = acc->dg[k + 1];
+        acc->df[k] = acc->df[k + 1];
+    }
+    acc->dg[SPINUP_ACC_DEPTH - 1] = dg0;
+    acc->df[SPINUP_ACC_DEPTH - 1] = df0;
+
+    acc->nhist--;
+}
+
+void FreeSpinAcc(spinacc_struct *acc)
+{
+    int             k;
+
+    free(acc->x);
+    free(acc->g);
+    free(acc->f);
+    free(acc->gprev);
+    free(acc->fprev);
+    for (k = 0; k < SPINUP_ACC_DEPTH; k++)
+    {
+        free(acc->dg[k]);
+        free(acc->df[k]);
+    }
 }
 
 #if defined(_BGC_)
@@ -65,27 +504,29 @@ void ResetSpinupStat(elem_struct *elem)
 
 #if defined(_BGC_)
 int CheckSteadyState(const elem_struct *elem, double total_area,
-    int first_cycle, int totalt, int spinyears)
+    int first_cycle, int totalt, int spinyears, spinprev_struct *prev)
 #else
 int CheckSteadyState(const elem_struct *elem, double total_area,
-    int first_cycle, int spinyears)
+    int first_cycle, int spinyears, spinprev_struct *prev)
 #endif
 {
     int             i;
     double          totalw = 0.0;
-    static double   totalw_prev = 0.0;
     int             steady;
 #if defined(_BGC_)
     double          t1 = 0.0;
     double          soilc = 0.0;
     double          totalc = 0.0;
-    static double   soilc_prev = 0.0;
 #endif
 #if defined(_FBR_)
     double          fbrgw = 0.0;
-    static double   fbrgw_prev = 0.0;
 #endif
 
+    if (first_cycle)
+    {
+        memset(prev, 0, sizeof(spinprev_struct));
+    }
+
 #if defined(_LUMPED_)
     i = LUMPED;
 #else
@@ -108,16 +549,16 @@ int CheckSteadyState(const elem_struct *elem, double total_area,
             (double)(totalt / DAYINSEC) / total_area;
         totalc += elem[i].spinup.totalc * elem[i].topo.area /
             (double)(totalt / DAYINSEC) / total_area;
-        t1 = (soilc - soilc_prev) / (double)(totalt / DAYINSEC / 365);
+        t1 = (soilc - prev->soilc) / (double)(totalt / DAYINSEC / 365);
 #endif
     }
 
     if (!first_cycle)
     {
         /* Check if domain reaches steady state */
-        steady = (fabs(totalw - totalw_prev) < SPINUP_W_TOLERANCE);
+        steady = (fabs(totalw - prev->totalw) < SPINUP_W_TOLERANCE);
 #if defined(_FBR_)
-        steady = (steady && (fabs(fbrgw - fbrgw_prev) < SPINUP_W_TOLERANCE));
+        steady = (steady && (fabs(fbrgw - prev->fbrgw) < SPINUP_W_TOLERANCE));
 #endif
 #if defined(_BGC_)
         steady = (steady && (fabs(t1) < SPINUP_C_TOLERANCE));
@@ -125,14 +566,14 @@ int CheckSteadyState(const elem_struct *elem, double total_area,
 
         PIHMprintf(VL_NORMAL, "spinyears = %d ", spinyears);
         PIHMprintf(VL_NORMAL, "totalw_prev = %lg totalw = %lg wdif = %lg\n",
-            totalw_prev, totalw, totalw - totalw_prev);
+            prev->totalw, totalw, totalw - prev->totalw);
 #if defined(_FBR_)
         PIHMprintf(VL_NORMAL, "fbrgw_prev = %lg fbrgw = %lg wdif = %lg\n",
-            fbrgw_prev, fbrgw, fbrgw - fbrgw_prev);
+            prev->fbrgw, fbrgw, fbrgw - prev->fbrgw);
 #endif
 #if defined(_BGC_)
         PIHMprintf(VL_NORMAL, "soilc_prev = %lg soilc = %lg pdif = %lg\n",
-            soilc_prev, soilc, t1);
+            prev->soilc, soilc, t1);
 #endif
     }
     else
@@ -140,12 +581,12 @@ int CheckSteadyState(const elem_struct *elem, double total_area,
         steady = 0;
     }
 
-    totalw_prev = totalw;
+    prev->totalw = totalw;
 #if defined(_FBR_)
-    fbrgw_prev = fbrgw;
+    prev->fbrgw = fbrgw;
 #endif
 #if defined(_BGC_)
-    soilc_prev = soilc;
+    prev->soilc = soilc;
 #endif
 
     if (steady)
@@ -0,0 +1,120 @@
+#include "pihm.h"
+
+void InitStepCtrl(const ctrl_struct *ctrl, stepctrl_struct *stepctrl)
+{
+    stepctrl->maxstep = (double)ctrl->stepsize;
+    /* With event coupling, the solver may step over model steps up to the
+     * next coupling event */
+    stepctrl->maxstep_lim = (ctrl->event_cpl) ?
+        (double)ctrl->etstep : (double)ctrl->stepsize;
+    stepctrl->stmin = ctrl->stmin;
+    stepctrl->nncfn = ctrl->nncfn;
+    stepctrl->nnimax = ctrl->nnimax;
+    stepctrl->nnimin = ctrl->nnimin;
+    stepctrl->decr = ctrl->decr;
+    stepctrl->incr = ctrl->incr;
+
+    /* Solver statistics restart from zero when CVODE is (re)initialized */
+    stepctrl->nst0 = 0;
+    stepctrl->ncfn0 = 0;
+    stepctrl->nni0 = 0;
+
+    stepctrl->prcp = 0.0;
+}
+
+void StepCtrlForc(const elem_struct *elem, stepctrl_struct *stepctrl)
+{
+    int             i;
+    double          prcp = 0.0;
+    double          tfill;
+
+    for (i = 0; i < nelem; i++)
+    {
+        prcp = (elem[i].wf.prcp > prcp) ? elem[i].wf.prcp : prcp;
+    }
+
+    if (prcp > stepctrl->prcp)
+    {
+        /* Storm onset or intensification. Limit max step to the time the
+         * additional rainfall takes to fill depression storage, so that the
+         * solver resolves the onset of overland flow instead of failing to
+         * converge over it */
+        tfill = DEPRSTG / (prcp - stepctrl->prcp);
+
+        stepctrl->maxstep = (stepctrl->maxstep < tfill) ?
+            stepctrl->maxstep : tfill;
+        stepctrl->maxstep = (stepctrl->maxstep > stepctrl->stmin) ?
+            stepctrl->maxstep : stepctrl->stmin;
+    }
+
+    stepctrl->prcp = prcp;
+}
+
+void StepCtrl(void *cvode_mem, double dt, stepctrl_struct *stepctrl)
+{
+    long int        nst;
+    long int        ncfn;
+    long int        nni;
+    int             cv_flag;
+    double          nsteps;
+    double          nfails;
+    double          niters;
+
+    cv_flag = CVodeGetNumSteps(cvode_mem, &nst);
+    if (!CheckCVodeFlag(cv_flag))
+    {
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    if (nst == stepctrl->nst0)
+    {
+        /* Sample window was interpolated from previous steps */
+        return;
+    }
+
+    cv_flag = CVodeGetNumNonlinSolvConvFails(cvode_mem, &ncfn);
+    if (!CheckCVodeFlag(cv_flag))
+    {
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    cv_flag = CVodeGetNumNonlinSolvIters(cvode_mem, &nni);
+    if (!CheckCVodeFlag(cv_flag))
+    {
+        PIHMexit(EXIT_FAILURE);
+    }
+
+    nsteps = (double)(nst - stepctrl->nst0);
+    nfails = (double)(ncfn - stepctrl->ncfn0) / nsteps;
+    niters = (double)(nni - stepctrl->nni0) / nsteps;
+
+    if (nfails > stepctrl->nncfn || niters >= stepctrl->nnimax)
+    {
+        stepctrl->maxstep /= stepctrl->decr;
+
+        if (ncfn - stepctrl->ncfn0 > 1)
+        {
+            /* Repeated convergence failures start a cascade. Limit max step
+             * to the mean step the solver achieved over the window */
+            stepctrl->maxstep = (stepctrl->maxstep < dt / nsteps) ?
+                stepctrl->maxstep : dt / nsteps;
+        }
+    }
+
+    if (nfails == 0.0 && niters <= stepctrl->nnimin)
+    {
+        /* Max step recovers by the increase factor per sample window in dry
+         * periods, and per model step when it rains */
+        stepctrl->maxstep *= (stepctrl->prcp > 0.0) ?
+            pow(stepctrl->incr, dt / stepctrl->maxstep_lim) : stepctrl->incr;
+    }
+
+    stepctrl->maxstep = (stepctrl->maxstep < stepctrl->maxstep_lim) ?
+        stepctrl->maxstep : stepctrl->maxstep_lim;
+    stepctrl->maxstep = (stepctrl->maxstep > stepctrl->stmin) ?
+        stepctrl->maxstep : stepctrl->stmin;
+
+    stepctrl->nst0 = nst;
+    stepctrl->ncfn0 = ncfn;
+    stepctrl->nni0 = nni;
+}
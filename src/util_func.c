@@ -1,18 +1,23 @@
 #include "pihm.h"
 #include "optparse.h"
 
-void ParseCmdLineParam(int argc, char *argv[], char *outputdir)
+void ParseCmdLineParam(int argc, char *argv[], ctx_struct *ctx,
+    char *outputdir)
 {
     int             option;
     struct optparse options;
     struct optparse_long longopts[] = {
         {"append",     'a', OPTPARSE_NONE},
+        {"benchmark",  'B', OPTPARSE_REQUIRED},
         {"brief",      'b', OPTPARSE_NONE},
+        {"convert",    'C', OPTPARSE_NONE},
         {"correction", 'c', OPTPARSE_NONE},
         {"debug",      'd', OPTPARSE_NONE},
+        {"cache",      'm', OPTPARSE_NONE},
         {"output",     'o', OPTPARSE_REQUIRED},
         {"silent",     's', OPTPARSE_NONE},
         {"tecplot",    't', OPTPARSE_NONE},
+        {"threads",    'n', OPTPARSE_REQUIRED},
         {"version",    'V', OPTPARSE_NONE},
         {"verbose",    'v', OPTPARSE_NONE},
         {0, 0, 0}
@@ -28,33 +33,60 @@ void ParseCmdLineParam(int argc, char *argv[], char *outputdir)
                 /* Specify output directory */
                 sprintf(outputdir, "output/%s/", options.optarg);
                 break;
+            case 'C':
+                /* Convert time series input files to binary */
+                ctx->convert_mode = 1;
+                break;
             case 'c':
                 /* Surface elevation correction mode */
-                corr_mode = 1;
+                ctx->corr_mode = 1;
+                break;
+            case 'm':
+                /* Use model cache */
+                ctx->cache_mode = 1;
                 break;
             case 'd':
                 /* Debug mode */
-                debug_mode = 1;
+                ctx->debug_mode = 1;
                 break;
             case 't':
                 /* Tecplot output */
-                tecplot = 1;
+                ctx->tecplot = 1;
                 break;
             case 'v':
                 /* Verbose mode */
-                verbose_mode = VL_VERBOSE;
+                ctx->verbose_mode = VL_VERBOSE;
                 break;
             case 'b':
                 /* Brief mode */
-                verbose_mode = VL_BRIEF;
+                ctx->verbose_mode = VL_BRIEF;
                 break;
             case 's':
                 /* Silent mode */
-                verbose_mode = VL_SILENT;
+                ctx->verbose_mode = VL_SILENT;
                 break;
             case 'a':
                 /* Append mode */
-                append_mode = 1;
+                ctx->append_mode = 1;
+                break;
+            case 'B':
+                /* Benchmark RHS evaluations */
+                ctx->benchmark = atoi(options.optarg);
+                break;
+            case 'n':
+                /* Number of OpenMP threads */
+#if defined(_OPENMP)
+                ctx->nthreads = atoi(options.optarg);
+                if (ctx->nthreads < 1)
+                {
+                    PIHMprintf(VL_ERROR,
+                        "Error: Number of threads must be positive.\n");
+                    PIHMexit(EXIT_FAILURE);
+                }
+#else
+                PIHMprintf(VL_NORMAL,
+                    "Warning: OpenMP is not enabled. Option -n is ignored.\n");
+#endif
                 break;
             case 'V':
                 /* Print version number */
@@ -80,9 +112,14 @@ void ParseCmdLineParam(int argc, char *argv[], char *outputdir)
             "Usage: ./pihm [-o output_dir] [-c] [-d] [-t] [-v] [-V]"
             " <project name>\n");
         PIHMprintf(VL_ERROR, "\t-o Specify output directory\n");
+        PIHMprintf(VL_ERROR, "\t-B Benchmark RHS evaluations\n");
         PIHMprintf(VL_ERROR, "\t-b Brief mode\n");
+        PIHMprintf(VL_ERROR, "\t-C Convert time series input files to "
+            "binary\n");
         PIHMprintf(VL_ERROR, "\t-c Correct surface elevation\n");
         PIHMprintf(VL_ERROR, "\t-d Debug mode\n");
+        PIHMprintf(VL_ERROR, "\t-m Use model cache\n");
+        PIHMprintf(VL_ERROR, "\t-n Number of OpenMP threads\n");
         PIHMprintf(VL_ERROR, "\t-t Tecplot output\n");
         PIHMprintf(VL_ERROR, "\t-V Version number\n");
         PIHMprintf(VL_ERROR, "\t-v Verbose mode\n");
@@ -91,7 +128,7 @@ void ParseCmdLineParam(int argc, char *argv[], char *outputdir)
     else
     {
         /* Parse remaining arguments */
-        strcpy(project, optparse_arg(&options));
+        strcpy(ctx->project, optparse_arg(&options));
     }
 }
 
@@ -160,26 +197,40 @@ void CreateOutputDir(char *outputdir)
 
 void BackupInput(const char *outputdir, const filename_struct *filename)
 {
+    /*
+     * Save input files into output directory
+     */
+    const char     *fn[4];
+    const char     *ext[4] = {"para", "calib", "ic", "output"};
     char            system_cmd[MAXSTRING];
+    int             k;
+    int             len;
 
-    /* Save input files into output directory */
-    if (PIHMaccess(filename->para, F_OK) != -1)
-    {
-        sprintf(system_cmd, "cp %s ./%s/%s.para.bak",
-            filename->para, outputdir, project);
-        system(system_cmd);
-    }
-    if (PIHMaccess(filename->calib, F_OK) != -1)
-    {
-        sprintf(system_cmd, "cp %s ./%s/%s.calib.bak",
-            filename->calib, outputdir, project);
-        system(system_cmd);
-    }
-    if (PIHMaccess(filename->ic, F_OK) != -1)
+    fn[0] = filename->para;
+    fn[1] = filename->calib;
+    fn[2] = filename->ic;
+    fn[3] = filename->output;
+
+    for (k = 0; k < 4; k++)
     {
-        sprintf(system_cmd, "cp %s ./%s/%s.ic.bak",
-            filename->ic, outputdir, project);
-        system(system_cmd);
+        if (PIHMaccess(fn[k], F_OK) == -1)
+        {
+            continue;
+        }
+
+        len = snprintf(system_cmd, MAXSTRING, "cp %s ./%s/%s.%s.bak", fn[k],
+            outputdir, project, ext[k]);
+        if (len < 0 || len >= MAXSTRING)
+        {
+            PIHMprintf(VL_ERROR,
+                "Error: Path of the backup of %s is too long.\n", fn[k]);
+            PIHMexit(EXIT_FAILURE);
+        }
+
+        if (system(system_cmd) != 0)
+        {
+            PIHMprintf(VL_NORMAL, "Warning: Failed to back up %s.\n", fn[k]);
+        }
     }
 }
 
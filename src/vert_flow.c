@@ -1,6 +1,6 @@
 #include "pihm.h"
 
-void VerticalFlow(elem_struct *elem, double dt)
+void VerticalFlow(hydro_elem_struct *elem, double dt)
 {
     int             i;
 
@@ -9,30 +9,30 @@ void VerticalFlow(elem_struct *elem, double dt)
 #endif
     for (i = 0; i < nelem; i++)
     {
-        /* Calculate infiltration rate */
-        elem[i].wf.infil = Infil(&elem[i].ws, &elem[i].ws0, &elem[i].wf,
-            &elem[i].topo, &elem[i].soil, dt);
+        VerticalFlowElem(elem, i, dt);
+    }
+}
+
+void VerticalFlowElem(hydro_elem_struct *elem, int i, double dt)
+{
+    /* Calculate infiltration rate */
+    elem->infil[i] = Infil(elem, i, dt);
 
 #if defined(_NOAH_)
-        /* Constrain infiltration by frozen top soil */
-        elem[i].wf.infil *= elem[i].ps.fcr;
+    /* Constrain infiltration by frozen top soil */
+    elem->infil[i] *= elem->fcr[i];
 #endif
 
-        /* Calculate recharge rate */
-        elem[i].wf.rechg = Recharge(&elem[i].ws, &elem[i].wf, &elem[i].soil);
+    /* Calculate recharge rate */
+    elem->rechg[i] = Recharge(elem, i);
 
 #if defined(_FBR_)
-        elem[i].wf.fbr_infil = FbrInfil(&elem[i].ws, &elem[i].soil,
-            &elem[i].geol, &elem[i].topo);
-        elem[i].wf.fbr_rechg = FbrRecharge(&elem[i].ws, &elem[i].wf,
-            &elem[i].geol);
+    elem->fbr_infil[i] = FbrInfil(elem, i);
+    elem->fbr_rechg[i] = FbrRecharge(elem, i);
 #endif
-    }
 }
 
-double Infil(const wstate_struct *ws, const wstate_struct *ws0,
-    const wflux_struct *wf, const topo_struct *topo, const soil_struct *soil,
-    double dt)
+double Infil(const hydro_elem_struct *elem, int i, double dt)
 {
     double          applrate;
     double          wetfrac;
@@ -47,7 +47,7 @@ double Infil(const wstate_struct *ws, const wstate_struct *ws0,
     double          h_u;
     int             j;
 
-    if (ws->unsat + ws->gw > soil->depth)
+    if (elem->unsat[i] + elem->gw[i] > elem->depth[i])
     {
         infil = 0.0;
     }
@@ -58,68 +58,73 @@ double Infil(const wstate_struct *ws, const wstate_struct *ws0,
         applrate = 0.0;
         for (j = 0; j < NUM_EDGE; j++)
         {
-            applrate += -wf->ovlflow[j] / topo->area;
+            applrate += -elem->ovlflow[i][j] / elem->area[i];
         }
         applrate = (applrate > 0.0) ? applrate : 0.0;
-        applrate += wf->pcpdrp;
+        applrate += elem->pcpdrp[i];
 
         if (DEPRSTG > 0.0)
         {
-            wetfrac = ws->surfh / DEPRSTG;
+            wetfrac = elem->surfh[i] / DEPRSTG;
             wetfrac = (wetfrac > 0.0) ? wetfrac : 0.0;
             wetfrac = (wetfrac < 1.0) ? wetfrac : 1.0;
         }
         else
         {
-            wetfrac = (ws->surfh > 0.0) ? 1.0 : 0.0;
+            wetfrac = (elem->surfh[i] > 0.0) ? 1.0 : 0.0;
         }
 
-        if (ws->gw > soil->depth - soil->dinf)
+        if (elem->gw[i] > elem->depth[i] - elem->dinf[i])
         {
             /* Assumption: Dinf < Dmac */
-            dh_by_dz = (ws->surfh + topo->zmax - (ws->gw + topo->zmin)) /
-                (0.5 * (ws->surfh + soil->dinf));
-            dh_by_dz = (ws->surfh <= 0.0 && dh_by_dz > 0.0) ? 0.0 : dh_by_dz;
+            dh_by_dz = (elem->surfh[i] + elem->zmax[i] -
+                (elem->gw[i] + elem->zmin[i])) /
+                (0.5 * (elem->surfh[i] + elem->dinf[i]));
+            dh_by_dz = (elem->surfh[i] <= 0.0 && dh_by_dz > 0.0) ?
+                0.0 : dh_by_dz;
 
             satn = 1.0;
-            satkfunc = KrFunc(soil->beta, satn);
+            satkfunc = KrFunc(elem->beta[i], satn);
 
-            kinf = EffKinf(soil, dh_by_dz, satkfunc, satn, applrate, ws->surfh);
+            kinf = EffKinf(elem, i, dh_by_dz, satkfunc, satn, applrate);
 
             infil = kinf * dh_by_dz;
         }
         else
         {
-            deficit = soil->depth - ws->gw;
+            deficit = elem->depth[i] - elem->gw[i];
 #if defined(_NOAH_)
-            satn = (ws->sh2o[0] - soil->smcmin) / (soil->smcmax - soil->smcmin);
+            satn = (elem->sh2o[i] - elem->smcmin[i]) /
+                (elem->smcmax[i] - elem->smcmin[i]);
 #else
-            satn = ws->unsat / deficit;
+            satn = elem->unsat[i] / deficit;
 #endif
             satn = (satn > 1.0) ? 1.0 : satn;
             satn = (satn < SATMIN) ? SATMIN : satn;
 
-            psi_u = Psi(satn, soil->alpha, soil->beta);
+            psi_u = Psi(satn, elem->alpha[i], elem->beta[i]);
             /* Note: for psi calculation using van Genuchten relation, cutting
              * the psi-sat tail at small saturation can be performed for
              * computational advantage. If you do not want to perform this,
              * comment the statement that follows */
             psi_u = (psi_u > PSIMIN) ? psi_u : PSIMIN;
 
-            h_u = psi_u + topo->zmax - 0.5 * soil->dinf;
-            dh_by_dz = (ws->surfh + topo->zmax - h_u) /
-                (0.5 * (ws->surfh + soil->dinf));
-            dh_by_dz = (ws->surfh <= 0.0 && dh_by_dz > 0.0) ?  0.0 : dh_by_dz;
+            h_u = psi_u + elem->zmax[i] - 0.5 * elem->dinf[i];
+            dh_by_dz = (elem->surfh[i] + elem->zmax[i] - h_u) /
+                (0.5 * (elem->surfh[i] + elem->dinf[i]));
+            dh_by_dz = (elem->surfh[i] <= 0.0 && dh_by_dz > 0.0) ?
+                0.0 : dh_by_dz;
 
-            satkfunc = KrFunc(soil->beta, satn);
+            satkfunc = KrFunc(elem->beta[i], satn);
 
-            kinf = EffKinf(soil, dh_by_dz, satkfunc, satn, applrate, ws->surfh);
+            kinf = EffKinf(elem, i, dh_by_dz, satkfunc, satn, applrate);
 
             infil = kinf * dh_by_dz;
             infil = (infil > 0.0) ? infil : 0.0;
         }
 
-        infil_max = applrate + ((ws0->surf > 0.0) ? ws0->surf / dt : 0.0);
+        infil_max = applrate +
+            ((elem->surf0[i] > 0.0) ? elem->surf0[i] / dt : 0.0);
 
         infil = (infil > infil_max) ? infil_max : infil;
 
@@ -129,8 +134,7 @@ double Infil(const wstate_struct *ws, const wstate_struct *ws0,
     return infil;
 }
 
-double Recharge(const wstate_struct *ws, const wflux_struct *wf,
-    const soil_struct *soil)
+double Recharge(const hydro_elem_struct *elem, int i)
 {
     double          satn;
     double          satkfunc;
@@ -140,64 +144,65 @@ double Recharge(const wstate_struct *ws, const wflux_struct *wf,
     double          deficit;
     double          rechg;
 
-    if (ws->gw > soil->depth - soil->dinf)
+    if (elem->gw[i] > elem->depth[i] - elem->dinf[i])
     {
-        rechg = wf->infil;
+        rechg = elem->infil[i];
     }
     else
     {
-        deficit = soil->depth - ws->gw;
-        satn = ws->unsat / deficit;
+        deficit = elem->depth[i] - elem->gw[i];
+        satn = elem->unsat[i] / deficit;
         satn = (satn > 1.0) ? 1.0 : satn;
         satn = (satn < SATMIN) ? SATMIN : satn;
 
-        satkfunc = KrFunc(soil->beta, satn);
+        satkfunc = KrFunc(elem->beta[i], satn);
 
-        psi_u = Psi(satn, soil->alpha, soil->beta);
+        psi_u = Psi(satn, elem->alpha[i], elem->beta[i]);
 
         dh_by_dz =
-            (0.5 * deficit + psi_u) / (0.5 * (deficit + ws->gw));
+            (0.5 * deficit + psi_u) / (0.5 * (deficit + elem->gw[i]));
 
-        kavg = AvgKv(soil, deficit, ws->gw, satkfunc);
+        kavg = AvgKv(elem, i, deficit, satkfunc);
 
         rechg = kavg * dh_by_dz;
 
-        rechg = (rechg > 0.0 && ws->unsat <= 0.0) ?  0.0 : rechg;
-        rechg = (rechg < 0.0 && ws->gw <= 0.0) ?  0.0 : rechg;
+        rechg = (rechg > 0.0 && elem->unsat[i] <= 0.0) ?  0.0 : rechg;
+        rechg = (rechg < 0.0 && elem->gw[i] <= 0.0) ?  0.0 : rechg;
     }
 
     return rechg;
 }
 
-double AvgKv(const soil_struct *soil, double deficit, double gw,
+double AvgKv(const hydro_elem_struct *elem, int i, double deficit,
     double satkfunc)
 {
     double          k1, k2, k3;
     double          d1, d2, d3;
 
-    if (deficit > soil->dmac)
+    if (deficit > elem->dmac[i])
     {
-        k1 = satkfunc * soil->ksatv;
-        d1 = soil->dmac;
+        k1 = satkfunc * elem->ksatv[i];
+        d1 = elem->dmac[i];
 
-        k2 = satkfunc * soil->ksatv;
-        d2 = deficit - soil->dmac;
+        k2 = satkfunc * elem->ksatv[i];
+        d2 = deficit - elem->dmac[i];
 
-        k3 = soil->ksatv;
-        d3 = gw;
+        k3 = elem->ksatv[i];
+        d3 = elem->gw[i];
     }
     else
     {
-        k1 = satkfunc * soil->ksatv;
+        k1 = satkfunc * elem->ksatv[i];
         d1 = deficit;
 
-        k2 = (soil->areafh > 0.0) ?
-            soil->kmacv * soil->areafh + soil->ksatv * (1.0 - soil->areafh) :
-            soil->ksatv;
-        d2 = soil->dmac - deficit;
+        k2 = (elem->areafh[i] > 0.0) ?
+            elem->kmacv[i] * elem->areafh[i] +
+            elem->ksatv[i] * (1.0 - elem->areafh[i]) :
+            elem->ksatv[i];
+        d2 = elem->dmac[i] - deficit;
 
-        k3 = soil->ksatv;
-        d3 = gw - (soil->dmac - deficit);
+        k3 = elem->ksatv[i];
+        d3 = elem->gw[i] - (elem->dmac[i] - deficit);
     }
 
 #if defined(_ARITH_)
@@ -208,8 +213,8 @@ double AvgKv(const soil_struct *soil, double deficit, double gw,
 #endif
 }
 
-double EffKinf(const soil_struct *soil, double dh_by_dz, double ksatfunc,
-    double elemsatn, double applrate, double surfh)
+double EffKinf(const hydro_elem_struct *elem, int i, double dh_by_dz,
+    double ksatfunc, double elemsatn, double applrate)
 {
     /*
      * For infiltration, macropores act as cracks, and are hydraulically
@@ -226,42 +231,42 @@ double EffKinf(const soil_struct *soil, double dh_by_dz, double ksatfunc,
 #endif
     const double    BETA_CRACK = 2.0;
 
-    if (soil->areafh == 0.0)
+    if (elem->areafh[i] == 0.0)
     {
         /* Matrix */
-        keff = soil->kinfv * ksatfunc;
+        keff = elem->kinfv[i] * ksatfunc;
     }
-    else if (surfh > DEPRSTG)
+    else if (elem->surfh[i] > DEPRSTG)
     {
         /* When surface wet fraction is larger than 1 (surface is totally
          * ponded), i.e., surfh > DEPRSTG, flow situation is macropore control,
          * regardless of the application rate */
-        keff = soil->kinfv * (1.0 - soil->areafh) * ksatfunc +
-            soil->kmacv * soil->areafh;
+        keff = elem->kinfv[i] * (1.0 - elem->areafh[i]) * ksatfunc +
+            elem->kmacv[i] * elem->areafh[i];
     }
     else
     {
-        if (applrate <= dh_by_dz * soil->kinfv * ksatfunc)
+        if (applrate <= dh_by_dz * elem->kinfv[i] * ksatfunc)
         {
             /* Matrix control */
-            keff = soil->kinfv * ksatfunc;
+            keff = elem->kinfv[i] * ksatfunc;
         }
         else
         {
-            kmax = dh_by_dz * (soil->kmacv * soil->areafh +
-                soil->kinfv * (1.0 - soil->areafh) * ksatfunc);
+            kmax = dh_by_dz * (elem->kmacv[i] * elem->areafh[i] +
+                elem->kinfv[i] * (1.0 - elem->areafh[i]) * ksatfunc);
             if (applrate < kmax)
             {
                 /* Application control */
-                keff = soil->kinfv * (1.0 - soil->areafh) * ksatfunc +
-                    soil->kmacv * soil->areafh *
+                keff = elem->kinfv[i] * (1.0 - elem->areafh[i]) * ksatfunc +
+                    elem->kmacv[i] * elem->areafh[i] *
                     KrFunc(BETA_CRACK, elemsatn);
             }
             else
             {
                 /* Macropore control */
-                keff = soil->kinfv * (1.0 - soil->areafh) * ksatfunc +
-                    soil->kmacv * soil->areafh;
+                keff = elem->kinfv[i] * (1.0 - elem->areafh[i]) * ksatfunc +
+                    elem->kmacv[i] * elem->areafh[i];
             }
         }
     }
@@ -281,8 +286,7 @@ double Psi(double satn, double alpha, double beta)
 /*
  * Hydrology for fractured bedrock
  */
-double FbrInfil(const wstate_struct *ws, const soil_struct *soil,
-    const geol_struct *geol, const topo_struct *topo)
+double FbrInfil(const hydro_elem_struct *elem, int i)
 {
     double          deficit;
     double          satn;
@@ -293,35 +297,38 @@ double FbrInfil(const wstate_struct *ws, const soil_struct *soil,
     double          kavg;
     double          infil;
 
-    if (ws->fbr_gw >= geol->depth)
+    if (elem->fbr_gw[i] >= elem->geol_depth[i])
     {
-        infil = -soil->ksatv;
+        infil = -elem->ksatv[i];
     }
     else
     {
-        if (ws->fbr_unsat + ws->fbr_gw > geol->depth || ws->gw <= 0.0)
+        if (elem->fbr_unsat[i] + elem->fbr_gw[i] > elem->geol_depth[i] ||
+            elem->gw[i] <= 0.0)
         {
             infil = 0.0;
         }
         else
         {
-            deficit = geol->depth - ws->fbr_gw;
+            deficit = elem->geol_depth[i] - elem->fbr_gw[i];
 
-            satn = ws->fbr_unsat / deficit;
+            satn = elem->fbr_unsat[i] / deficit;
             satn = (satn > 1.0) ? 1.0 : satn;
             satn = (satn < SATMIN) ? SATMIN : satn;
 
-            psi_u = Psi(satn, geol->alpha, geol->beta);
+            psi_u = Psi(satn, elem->geol_alpha[i], elem->geol_beta[i]);
             psi_u = (psi_u > PSIMIN) ? psi_u : PSIMIN;
 
-            h_u = psi_u + topo->zmin - 0.5 * deficit;
+            h_u = psi_u + elem->zmin[i] - 0.5 * deficit;
 
-            satkfunc = KrFunc(geol->beta, satn);
+            satkfunc = KrFunc(elem->geol_beta[i], satn);
 
-            dh_by_dz = (topo->zmin + ws->gw - h_u) / (0.5 * (ws->gw + deficit));
+            dh_by_dz = (elem->zmin[i] + elem->gw[i] - h_u) /
+                (0.5 * (elem->gw[i] + deficit));
 
-            kavg = (ws->gw + deficit) /
-                (ws->gw / soil->ksatv + deficit / (geol->ksatv * satkfunc));
+            kavg = (elem->gw[i] + deficit) /
+                (elem->gw[i] / elem->ksatv[i] +
+                deficit / (elem->geol_ksatv[i] * satkfunc));
             infil = kavg * dh_by_dz;
         }
     }
@@ -329,8 +336,7 @@ double FbrInfil(const wstate_struct *ws, const soil_struct *soil,
     return infil;
 }
 
-double FbrRecharge(const wstate_struct *ws, const wflux_struct *wf,
-    const geol_struct *geol)
+double FbrRecharge(const hydro_elem_struct *elem, int i)
 {
     double          deficit;
     double          satn;
@@ -340,33 +346,34 @@ double FbrRecharge(const wstate_struct *ws, const wflux_struct *wf,
     double          kavg;
     double          rechg;
 
-    if (ws->fbr_gw >= geol->depth)
+    if (elem->fbr_gw[i] >= elem->geol_depth[i])
     {
-        rechg = wf->fbr_infil;
+        rechg = elem->fbr_infil[i];
     }
     else
     {
-        deficit = geol->depth - ws->fbr_gw;
+        deficit = elem->geol_depth[i] - elem->fbr_gw[i];
 
-        satn = ws->fbr_unsat / deficit;
+        satn = elem->fbr_unsat[i] / deficit;
         satn = (satn > 1.0) ? 1.0 : satn;
         satn = (satn < SATMIN) ? SATMIN : satn;
 
-        psi_u = Psi(satn, geol->alpha, geol->beta);
+        psi_u = Psi(satn, elem->geol_alpha[i], elem->geol_beta[i]);
         psi_u = (psi_u > PSIMIN) ? psi_u : PSIMIN;
 
-        satkfunc = KrFunc(geol->beta, satn);
+        satkfunc = KrFunc(elem->geol_beta[i], satn);
 
-        dh_by_dz = (0.5 * deficit + psi_u) / (0.5 * (deficit + ws->fbr_gw));
+        dh_by_dz = (0.5 * deficit + psi_u) /
+            (0.5 * (deficit + elem->fbr_gw[i]));
 
-        kavg = (ws->fbr_unsat * geol->ksatv * satkfunc +
-             ws->fbr_gw * geol->ksatv) /
-            (ws->fbr_unsat + ws->fbr_gw);
+        kavg = (elem->fbr_unsat[i] * elem->geol_ksatv[i] * satkfunc +
+             elem->fbr_gw[i] * elem->geol_ksatv[i]) /
+            (elem->fbr_unsat[i] + elem->fbr_gw[i]);
 
         rechg = kavg * dh_by_dz;
 
-        rechg = (rechg > 0.0 && ws->fbr_unsat <= 0.0) ? 0.0 : rechg;
-        rechg = (rechg < 0.0 && ws->fbr_gw <= 0.0) ? 0.0 : rechg;
+        rechg = (rechg > 0.0 && elem->fbr_unsat[i] <= 0.0) ? 0.0 : rechg;
+        rechg = (rechg < 0.0 && elem->fbr_gw[i] <= 0.0) ? 0.0 : rechg;
     }
 
     return rechg;
@@ -0,0 +1,59 @@
+#!/bin/sh
+
+# Check that meteorological forcing at the start of simulation is applied at
+# the first model step, e.g.,
+#   sh util/forc_test.sh flux-pihm
+# The model is run for one day from the example input files, with and without
+# precipitation at the start time. Precipitation at the start time of the
+# example falls as snow, so snow water equivalent at the end of the first model
+# step must differ between the two runs
+
+MODEL=$1
+
+PROJECT=short
+STATUS=0
+
+START=$(grep "^START" input/example/example.para |awk '{print $2, $3}')
+END=$(date -u -d "$START 1 day" "+%Y-%m-%d %H:%M")
+
+for PRCP in 0 1; do
+    rm -rf input/$PROJECT output/$PROJECT output/$PROJECT.$PRCP
+    mkdir input/$PROJECT
+    for f in input/example/example.*; do
+        cp $f input/$PROJECT/$PROJECT.${f#input/example/example.}
+    done
+
+    # Write model state at every model step
+    sed -i -e "s/^SIMULATION_MODE .*/SIMULATION_MODE 0/" \
+        -e "s/^INIT_MODE .*/INIT_MODE 0/" \
+        -e "s/^ASCII_OUTPUT .*/ASCII_OUTPUT 1/" \
+        -e "s/^END .*/END $END/" \
+        -e "s/^SNOW .*/SNOW 60/" \
+        -e "s/^MODEL_STEPSIZE .*/MODEL_STEPSIZE 60/" \
+        input/$PROJECT/$PROJECT.para
+
+    if [ $PRCP -eq 1 ]; then
+        # Replace precipitation at the start time (kg m-2 s-1)
+        sed -i "s/^\($START[[:space:]]*\)[^[:space:]]*/\10.00050000/" \
+            input/$PROJECT/$PROJECT.meteo
+    fi
+
+    ./$MODEL -s -o $PROJECT $PROJECT || exit 1
+    mv output/$PROJECT output/$PROJECT.$PRCP
+done
+
+rm -rf input/$PROJECT
+
+# First output line of each run
+A=$(head -n 1 output/$PROJECT.0/$PROJECT.snow.txt)
+B=$(head -n 1 output/$PROJECT.1/$PROJECT.snow.txt)
+if [ "$A" = "$B" ]; then
+    echo "Precipitation at the start time is not applied at the first step."
+    STATUS=1
+else
+    echo "Forcing at the start time is applied at the first model step."
+fi
+
+rm -rf output/$PROJECT.0 output/$PROJECT.1
+
+exit $STATUS
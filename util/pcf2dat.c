@@ -0,0 +1,538 @@
+/*
+ * Convert an MM-PIHM output container file (project.pcf) to binary .dat
+ * files, one for each output variable, as written by models when binary
+ * output is not written to a container. The container format is described
+ * in README.md.
+ *
+ * Usage: pcf2dat [-o dir_name] project.pcf
+ *
+ * Output files (project.var.dat) are written to dir_name, or to the
+ * directory of the container file. If the container file has no chunk index
+ * (e.g., the model exited before closing it), the index is rebuilt from the
+ * chunk headers.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define MAXSTRING           1024
+
+#define CONTAINER_MAGIC     "PIHMOUT"
+#define CONTAINER_IDX_MAGIC "PIHMIDX"
+#define CONTAINER_VERSION   1
+#define SHUFFLE_FILTER      1
+#define CONTAINER_HDR_SIZE  32
+#define CONTAINER_VAR_SIZE  112
+#define CONTAINER_IDX_SIZE  40
+#define CONTAINER_TRL_SIZE  24
+#define CONTAINER_NAME_LEN  64
+
+typedef struct chunkidx_struct
+{
+    int32_t         var;
+    int32_t         rec0;
+    int32_t         nrec;
+    int32_t         item0;
+    int32_t         nitem;
+    int32_t         t0;
+    int32_t         t1;
+    int32_t         size;
+    int64_t         offset;
+} chunkidx_struct;
+
+typedef struct contvar_struct
+{
+    char            name[CONTAINER_NAME_LEN];
+    int32_t         nitem;
+} contvar_struct;
+
+int32_t UnpackInt32(const unsigned char *buf)
+{
+    uint32_t        u = 0;
+    int             k;
+
+    for (k = 0; k < 4; k++)
+    {
+        u |= (uint32_t)buf[k] << (8 * k);
+    }
+
+    return (int32_t)u;
+}
+
+int64_t UnpackInt64(const unsigned char *buf)
+{
+    uint64_t        u = 0;
+    int             k;
+
+    for (k = 0; k < 8; k++)
+    {
+        u |= (uint64_t)buf[k] << (8 * k);
+    }
+
+    return (int64_t)u;
+}
+
+double UnpackDouble(const unsigned char *buf)
+{
+    uint64_t        u = 0;
+    double          value;
+    int             k;
+
+    for (k = 0; k < 8; k++)
+    {
+        u |= (uint64_t)buf[k] << (8 * k);
+    }
+    memcpy(&value, &u, sizeof(double));
+
+    return value;
+}
+
+void UnpackChunkIdx(const unsigned char *buf, chunkidx_struct *idx)
+{
+    idx->var = UnpackInt32(buf);
+    idx->rec0 = UnpackInt32(buf + 4);
+    idx->nrec = UnpackInt32(buf + 8);
+    idx->item0 = UnpackInt32(buf + 12);
+    idx->nitem = UnpackInt32(buf + 16);
+    idx->t0 = UnpackInt32(buf + 20);
+    idx->t1 = UnpackInt32(buf + 24);
+    idx->size = UnpackInt32(buf + 28);
+    idx->offset = UnpackInt64(buf + 32);
+}
+
+int LzDecompress(const unsigned char *src, int n, unsigned char *dst, int cap)
+{
+    /*
+     * Decompress an LZ4 block. Returns decompressed size, or -1 if the block
+     * is corrupt or does not fit in cap bytes
+     */
+    int             ip = 0;
+    int             op = 0;
+
+    while (ip < n)
+    {
+        int             token;
+        int             len;
+        int             offset;
+        int             k;
+
+        /* Literals */
+        token = src[ip++];
+        len = token >> 4;
+        if (len == 15)
+        {
+            int             b;
+
+            do
+            {
+                if (ip >= n)
+                {
+                    return -1;
+                }
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+        }
+        if (ip + len > n || op + len > cap)
+        {
+            return -1;
+        }
+        memcpy(dst + op, src + ip, len);
+        ip += len;
+        op += len;
+
+        /* The last sequence has no match */
+        if (ip == n)
+        {
+            break;
+        }
+
+        /* Match */
+        if (ip + 2 > n)
+        {
+            return -1;
+        }
+        offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op)
+        {
+            return -1;
+        }
+
+        len = token & 15;
+        if (len == 15)
+        {
+            int             b;
+
+            do
+            {
+                if (ip >= n)
+                {
+                    return -1;
+                }
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+        }
+        len += 4;
+        if (op + len > cap)
+        {
+            return -1;
+        }
+
+        /* Matches may overlap the output */
+        for (k = 0; k < len; k++)
+        {
+            dst[op + k] = dst[op - offset + k];
+        }
+        op += len;
+    }
+
+    return op;
+}
+
+int ValidChunk(const chunkidx_struct *idx, int nvar,
+    const contvar_struct *var, int chunk_nt, int64_t end)
+{
+    return (idx->var >= 0 && idx->var < nvar &&
+        idx->nrec >= 1 && idx->nrec <= chunk_nt &&
+        idx->item0 >= 0 && idx->nitem >= 1 &&
+        idx->item0 + idx->nitem <= var[idx->var].nitem &&
+        idx->size >= 1 &&
+        (int64_t)idx->size <= (int64_t)idx->nrec * (idx->nitem + 1) * 8 &&
+        idx->offset + idx->size <= end);
+}
+
+chunkidx_struct *ReadIndex(FILE *fp, int64_t data0, int64_t fsize, int nvar,
+    const contvar_struct *var, int chunk_nt, int *nchunk)
+{
+    /*
+     * Read the chunk index using the trailer, or rebuild it from the chunk
+     * headers following the file header
+     */
+    chunkidx_struct *index = NULL;
+    unsigned char   buf[CONTAINER_IDX_SIZE];
+    int64_t         pos;
+    int             maxchunk = 0;
+    int             i;
+
+    *nchunk = 0;
+
+    if (fsize >= data0 + CONTAINER_TRL_SIZE &&
+        fseek(fp, (long)(fsize - CONTAINER_TRL_SIZE), SEEK_SET) == 0 &&
+        fread(buf, 1, CONTAINER_TRL_SIZE, fp) == CONTAINER_TRL_SIZE &&
+        memcmp(buf + 16, CONTAINER_IDX_MAGIC, strlen(CONTAINER_IDX_MAGIC)) ==
+        0)
+    {
+        pos = UnpackInt64(buf);
+        *nchunk = (int)UnpackInt64(buf + 8);
+
+        if (pos >= data0 && *nchunk >= 0 &&
+            pos + (int64_t)*nchunk * CONTAINER_IDX_SIZE + CONTAINER_TRL_SIZE ==
+            fsize)
+        {
+            index = (chunkidx_struct *)malloc((*nchunk + 1) *
+                sizeof(chunkidx_struct));
+            fseek(fp, (long)pos, SEEK_SET);
+            for (i = 0; i < *nchunk; i++)
+            {
+                if (fread(buf, 1, CONTAINER_IDX_SIZE, fp) !=
+                    CONTAINER_IDX_SIZE)
+                {
+                    break;
+                }
+                UnpackChunkIdx(buf, &index[i]);
+                if (!ValidChunk(&index[i], nvar, var, chunk_nt, pos))
+                {
+                    break;
+                }
+            }
+
+            if (i == *nchunk)
+            {
+                return index;
+            }
+
+            free(index);
+            index = NULL;
+        }
+    }
+
+    fprintf(stderr, "Chunk index is not found. "
+        "Rebuilding it from chunk headers.\n");
+
+    /* Chunks are read until the end of file, or until a header that is
+     * incomplete or does not describe the chunk that follows */
+    *nchunk = 0;
+    pos = data0;
+    fseek(fp, (long)pos, SEEK_SET);
+    while (fread(buf, 1, CONTAINER_IDX_SIZE, fp) == CONTAINER_IDX_SIZE)
+    {
+        chunkidx_struct idx;
+
+        UnpackChunkIdx(buf, &idx);
+        if (idx.offset != pos + CONTAINER_IDX_SIZE ||
+            !ValidChunk(&idx, nvar, var, chunk_nt, fsize))
+        {
+            break;
+        }
+
+        if (*nchunk == maxchunk)
+        {
+            maxchunk = (maxchunk > 0) ? 2 * maxchunk : 1024;
+            index = (chunkidx_struct *)realloc(index,
+                maxchunk * sizeof(chunkidx_struct));
+        }
+        index[*nchunk] = idx;
+        (*nchunk)++;
+
+        pos = idx.offset + idx.size;
+        fseek(fp, (long)pos, SEEK_SET);
+    }
+
+    return index;
+}
+
+int main(int argc, char *argv[])
+{
+    FILE           *fp;
+    const char     *fn = NULL;
+    char            outputdir[MAXSTRING] = "";
+    char            proj[MAXSTRING];
+    unsigned char   hdr[CONTAINER_HDR_SIZE];
+    unsigned char   buf[CONTAINER_VAR_SIZE];
+    contvar_struct *var;
+    chunkidx_struct *index;
+    unsigned char  *packed;
+    unsigned char  *shuffled;
+    unsigned char  *raw;
+    double         *rec;
+    int64_t         data0;
+    int64_t         fsize;
+    int             nvar;
+    int             chunk_nt;
+    int             chunk_ns;
+    int             nchunk;
+    int             maxitem = 0;
+    int             status = EXIT_SUCCESS;
+    int             i, k;
+    char           *ptr;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            strncpy(outputdir, argv[++i], MAXSTRING - 2);
+        }
+        else
+        {
+            fn = argv[i];
+        }
+    }
+
+    if (fn == NULL)
+    {
+        fprintf(stderr, "Usage: %s [-o dir_name] project.pcf\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Project name and default output directory from the file name */
+    ptr = strrchr(fn, '/');
+    strncpy(proj, (ptr != NULL) ? ptr + 1 : fn, MAXSTRING - 1);
+    proj[MAXSTRING - 1] = '\0';
+    if (strlen(proj) > 4 && strcmp(proj + strlen(proj) - 4, ".pcf") == 0)
+    {
+        proj[strlen(proj) - 4] = '\0';
+    }
+    if (outputdir[0] == '\0' && ptr != NULL)
+    {
+        strncpy(outputdir, fn, (size_t)(ptr - fn) + 1);
+        outputdir[ptr - fn + 1] = '\0';
+    }
+    if (outputdir[0] != '\0' && outputdir[strlen(outputdir) - 1] != '/')
+    {
+        strcat(outputdir, "/");
+    }
+
+    fp = fopen(fn, "rb");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Error opening %s.\n", fn);
+        return EXIT_FAILURE;
+    }
+
+    /* File header */
+    if (fread(hdr, 1, CONTAINER_HDR_SIZE, fp) != CONTAINER_HDR_SIZE ||
+        memcmp(hdr, CONTAINER_MAGIC, strlen(CONTAINER_MAGIC) + 1) != 0)
+    {
+        fprintf(stderr, "Error: %s is not an output container file.\n", fn);
+        return EXIT_FAILURE;
+    }
+    if (UnpackInt32(hdr + 8) != CONTAINER_VERSION ||
+        UnpackInt32(hdr + 24) != SHUFFLE_FILTER ||
+        UnpackInt32(hdr + 28) != CONTAINER_VAR_SIZE)
+    {
+        fprintf(stderr, "Error: Container format version %d of %s is not "
+            "supported.\n", UnpackInt32(hdr + 8), fn);
+        return EXIT_FAILURE;
+    }
+    nvar = UnpackInt32(hdr + 12);
+    chunk_nt = UnpackInt32(hdr + 16);
+    chunk_ns = UnpackInt32(hdr + 20);
+
+    /* Variable descriptions. Element ids are not needed */
+    var = (contvar_struct *)malloc(nvar * sizeof(contvar_struct));
+    for (i = 0; i < nvar; i++)
+    {
+        if (fread(buf, 1, CONTAINER_VAR_SIZE, fp) != CONTAINER_VAR_SIZE)
+        {
+            fprintf(stderr, "Error reading %s.\n", fn);
+            return EXIT_FAILURE;
+        }
+        memcpy(var[i].name, buf, CONTAINER_NAME_LEN);
+        var[i].name[CONTAINER_NAME_LEN - 1] = '\0';
+        var[i].nitem = UnpackInt32(buf + 100);
+        maxitem = (var[i].nitem > maxitem) ? var[i].nitem : maxitem;
+        fseek(fp, (long)var[i].nitem * 4, SEEK_CUR);
+    }
+    data0 = ftell(fp);
+
+    fseek(fp, 0L, SEEK_END);
+    fsize = ftell(fp);
+
+    index = ReadIndex(fp, data0, fsize, nvar, var, chunk_nt, &nchunk);
+
+    packed = (unsigned char *)malloc((size_t)(chunk_ns + 1) * chunk_nt * 8);
+    shuffled = (unsigned char *)malloc((size_t)(chunk_ns + 1) * chunk_nt * 8);
+    raw = (unsigned char *)malloc((size_t)(chunk_ns + 1) * chunk_nt * 8);
+    rec = (double *)malloc((size_t)(maxitem + 1) * chunk_nt * sizeof(double));
+
+    for (i = 0; i < nvar; i++)
+    {
+        FILE           *dat;
+        char            dat_fn[3 * MAXSTRING];
+        int             rec0 = -1;
+        int             nrec = 0;
+        int             covered = 0;
+        int             c;
+
+        sprintf(dat_fn, "%s%s.%s.dat", outputdir, proj, var[i].name);
+        dat = fopen(dat_fn, "wb");
+        if (dat == NULL)
+        {
+            fprintf(stderr, "Error opening %s.\n", dat_fn);
+            return EXIT_FAILURE;
+        }
+
+        /* Chunks of a variable are in the order of records, and records are
+         * split into chunks of elements (river segments) */
+        for (c = 0; c <= nchunk; c++)
+        {
+            const chunkidx_struct *idx;
+            int             nraw;
+            int             size;
+            int             j;
+
+            idx = (c < nchunk) ? &index[c] : NULL;
+            if (idx != NULL && idx->var != i)
+            {
+                continue;
+            }
+
+            if (rec0 >= 0 && (idx == NULL || idx->rec0 != rec0))
+            {
+                /* Write records when all their elements have been read */
+                if (covered == var[i].nitem)
+                {
+                    fwrite(rec, sizeof(double),
+                        (size_t)nrec * (var[i].nitem + 1), dat);
+                }
+                else
+                {
+                    fprintf(stderr, "Warning: Records %d to %d of %s are "
+                        "incomplete and not converted.\n", rec0 + 1,
+                        rec0 + nrec, var[i].name);
+                    status = EXIT_FAILURE;
+                }
+                rec0 = -1;
+            }
+
+            if (idx == NULL)
+            {
+                break;
+            }
+
+            if (rec0 < 0)
+            {
+                rec0 = idx->rec0;
+                nrec = idx->nrec;
+                covered = 0;
+            }
+
+            nraw = idx->nrec * (idx->nitem + 1);
+            fseek(fp, (long)idx->offset, SEEK_SET);
+            if (idx->nrec != nrec ||
+                fread(packed, 1, idx->size, fp) != (size_t)idx->size)
+            {
+                fprintf(stderr, "Error reading chunk %d of %s.\n", c + 1, fn);
+                return EXIT_FAILURE;
+            }
+
+            /* Chunks that do not compress are stored uncompressed */
+            if (idx->size == nraw * 8)
+            {
+                memcpy(shuffled, packed, idx->size);
+                size = idx->size;
+            }
+            else
+            {
+                size = LzDecompress(packed, idx->size, shuffled, nraw * 8);
+            }
+            if (size != nraw * 8)
+            {
+                fprintf(stderr, "Error decompressing chunk %d of %s.\n",
+                    c + 1, fn);
+                return EXIT_FAILURE;
+            }
+
+            /* Undo the byte shuffle */
+            for (k = 0; k < 8; k++)
+            {
+                for (j = 0; j < nraw; j++)
+                {
+                    raw[(size_t)j * 8 + k] = shuffled[(size_t)k * nraw + j];
+                }
+            }
+
+            /* Record times followed by the time series of each element */
+            for (k = 0; k < nrec; k++)
+            {
+                rec[(size_t)k * (var[i].nitem + 1)] =
+                    UnpackDouble(raw + (size_t)k * 8);
+            }
+            for (j = 0; j < idx->nitem; j++)
+            {
+                for (k = 0; k < nrec; k++)
+                {
+                    rec[(size_t)k * (var[i].nitem + 1) + 1 + idx->item0 + j] =
+                        UnpackDouble(raw + ((size_t)(j + 1) * nrec + k) * 8);
+                }
+            }
+            covered += idx->nitem;
+        }
+
+        fclose(dat);
+    }
+
+    fclose(fp);
+
+    free(var);
+    free(index);
+    free(packed);
+    free(shuffled);
+    free(raw);
+    free(rec);
+
+    return status;
+}
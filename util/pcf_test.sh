@@ -0,0 +1,47 @@
+#!/bin/sh
+
+# Check that the output container of a model converts back to the .dat
+# output of the same run, e.g.,
+#   sh util/pcf_test.sh pihm
+# The model is run for one day using util/short_run.sh, with .dat and with
+# container output. The container is converted using util/pcf2dat, with and
+# without its chunk index, and the converted files are compared with the
+# .dat files
+
+MODEL=$1
+
+OUTPUT=output/short
+STATUS=0
+
+make pcf2dat || exit 1
+
+sh util/short_run.sh $MODEL OUTPUT_FORMAT 0 || exit 1
+rm -rf $OUTPUT.dat
+mv $OUTPUT $OUTPUT.dat
+
+sh util/short_run.sh $MODEL OUTPUT_FORMAT 1 || exit 1
+
+# Converted files and a copy of the container without its trailer, as
+# left by a model that exits before closing the container
+mkdir $OUTPUT/pcf $OUTPUT/notrl
+SIZE=$(wc -c < $OUTPUT/short.pcf)
+head -c $((SIZE - 24)) $OUTPUT/short.pcf > $OUTPUT/notrl/short.pcf
+
+util/pcf2dat -o $OUTPUT/pcf $OUTPUT/short.pcf || STATUS=1
+util/pcf2dat $OUTPUT/notrl/short.pcf || STATUS=1
+
+for f in $OUTPUT.dat/*.dat; do
+    for d in pcf notrl; do
+        if ! cmp $f $OUTPUT/$d/$(basename $f); then
+            STATUS=1
+        fi
+    done
+done
+
+if [ $STATUS -eq 0 ]; then
+    echo "Output container matches .dat output."
+fi
+
+rm -rf $OUTPUT.dat
+
+exit $STATUS
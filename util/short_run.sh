@@ -0,0 +1,42 @@
+#!/bin/sh
+
+# Run a model for one day using the example input files, e.g.,
+#   sh util/short_run.sh pihm LIN_SOLVER 1
+# Keyword-value pairs following the model name replace the corresponding
+# keywords in the example .para file. Command line options of the model, e.g.,
+# -d, can be given in the OPTIONS environment variable
+
+MODEL=$1
+shift
+
+PROJECT=short
+
+rm -rf input/$PROJECT output/$PROJECT
+mkdir input/$PROJECT
+for f in input/example/example.*; do
+    cp $f input/$PROJECT/$PROJECT.${f#input/example/example.}
+done
+
+PARA=input/$PROJECT/$PROJECT.para
+
+START=$(grep "^START" $PARA |awk '{print $2, $3}')
+END=$(date -u -d "$START 1 day" "+%Y-%m-%d %H:%M")
+
+sed -i -e "s/^SIMULATION_MODE .*/SIMULATION_MODE 0/" \
+    -e "s/^END .*/END $END/" $PARA
+
+while [ $# -ge 2 ]; do
+    if ! grep -q "^$1 " $PARA; then
+        echo "Keyword $1 is not found in $PARA."
+        exit 1
+    fi
+    sed -i "s/^$1 .*/$1 $2/" $PARA
+    shift 2
+done
+
+./$MODEL $OPTIONS -o $PROJECT $PROJECT
+STATUS=$?
+
+rm -rf input/$PROJECT
+
+exit $STATUS
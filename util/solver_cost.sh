@@ -0,0 +1,30 @@
+#!/bin/sh
+
+# Compare the cost of the linear solvers by running a model for one day using
+# the example input files, e.g.,
+#   sh util/solver_cost.sh pihm
+# The model must be compiled with KLU=on. Wall time and CVODE statistics are
+# reported for SPGMR with the block-Jacobi preconditioner and for KLU
+
+MODEL=$1
+
+STATUS=0
+
+for SOLVER in "LIN_SOLVER 0 PRECOND 1" "LIN_SOLVER 1 PRECOND 0"; do
+    echo "$SOLVER:"
+
+    START=$(date +%s.%N)
+    OPTIONS=-d sh util/short_run.sh $MODEL $SOLVER > solver_cost.log
+    if [ $? -ne 0 ]; then
+        cat solver_cost.log
+        STATUS=1
+    fi
+    END=$(date +%s.%N)
+
+    grep "^num of" solver_cost.log
+    echo "wall time = $(echo $START $END |awk '{printf "%.2f", $2 - $1}') s"
+done
+
+rm -f solver_cost.log
+
+exit $STATUS
@@ -0,0 +1,81 @@
+#!/bin/sh
+
+# Spin up a model using the example input files, without (SIMULATION_MODE 1)
+# and with (SIMULATION_MODE 2) Anderson acceleration of spin-up cycles, e.g.,
+#   sh util/spinup_test.sh pihm MAX_SPINUP_YEAR 20
+# Keyword-value pairs following the model name replace the corresponding
+# keywords in the example .para or .calib file. Wall time, number of spin-up
+# years, and total water storage are reported for each run, as well as the
+# maximum and mean absolute differences between the final states of the two
+# runs. The test fails if either run does not reach steady state
+
+MODEL=$1
+shift
+
+PROJECT=spintest
+
+rm -rf input/$PROJECT
+mkdir input/$PROJECT
+for f in input/example/example.*; do
+    cp $f input/$PROJECT/$PROJECT.${f#input/example/example.}
+done
+
+PARA=input/$PROJECT/$PROJECT.para
+CALIB=input/$PROJECT/$PROJECT.calib
+
+while [ $# -ge 2 ]; do
+    if grep -q "^$1 " $PARA; then
+        sed -i "s/^$1 .*/$1 $2/" $PARA
+    elif grep -q "^$1 " $CALIB; then
+        sed -i "s/^$1 .*/$1 $2/" $CALIB
+    else
+        echo "Keyword $1 is not found in $PARA or $CALIB."
+        exit 1
+    fi
+    shift 2
+done
+
+STATUS=0
+
+for MODE in 1 2; do
+    sed -i "s/^SIMULATION_MODE .*/SIMULATION_MODE $MODE/" $PARA
+    rm -rf output/$PROJECT$MODE
+
+    START=$(date +%s.%N)
+    ./$MODEL -o $PROJECT$MODE $PROJECT > $PROJECT$MODE.log
+    if [ $? -ne 0 ]; then
+        cat $PROJECT$MODE.log
+        STATUS=1
+    fi
+    END=$(date +%s.%N)
+
+    echo "SIMULATION_MODE $MODE:"
+    grep "^spinyears\|^Water added\|^Anderson" $PROJECT$MODE.log
+    echo "spin-up years = $(grep -c "^Spinup year" $PROJECT$MODE.log)"
+    echo "wall time = $(echo $START $END |awk '{printf "%.2f", $2 - $1}') s"
+    if ! grep -q "^Reaches steady state" $PROJECT$MODE.log; then
+        echo "Steady state is not reached."
+        STATUS=1
+    fi
+done
+
+# Restart files of both runs are arrays of doubles in the same order
+od -A n -t f8 -v output/${PROJECT}1/restart/*.ic |tr -s ' ' '\n' |
+    grep -v "^$" > $PROJECT.ic1
+od -A n -t f8 -v output/${PROJECT}2/restart/*.ic |tr -s ' ' '\n' |
+    grep -v "^$" > $PROJECT.ic2
+paste $PROJECT.ic1 $PROJECT.ic2 |awk '
+    {
+        d = $1 - $2
+        d = (d < 0) ? -d : d
+        dmax = (d > dmax) ? d : dmax
+        dsum += d
+    }
+    END {
+        printf "max final state difference = %g\n", dmax
+        printf "mean final state difference = %g\n", dsum / NR
+    }'
+
+rm -rf input/$PROJECT ${PROJECT}1.log ${PROJECT}2.log $PROJECT.ic1 $PROJECT.ic2
+
+exit $STATUS